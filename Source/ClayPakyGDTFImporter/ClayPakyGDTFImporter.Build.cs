@@ -52,6 +52,8 @@ public class ClayPakyGDTFImporter : ModuleRules
 				"Engine",
 				"InputCore",
 				"GLTFImporter",
+				"ImageWrapper",
+				"Projects",
 				"RenderCore",
 				"RHI",
 				"Slate",
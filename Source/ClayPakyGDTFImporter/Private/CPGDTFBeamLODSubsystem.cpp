@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFBeamLODSubsystem.h"
+#include "CPGDTFFixtureActor.h"
+#include "Components/CPGDTFBeamSceneComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+namespace CPGDTFBeamLOD {
+
+	/// True if Value is above Threshold. Once above, Value has to go back below Threshold by the Hysteresis margin to return false
+	static bool IsAbove(float Value, float Threshold, float Hysteresis, bool bWasAbove) {
+		if (Threshold <= 0) return false;
+		return Value > Threshold * (bWasAbove ? 1 - Hysteresis : 1 + Hysteresis);
+	}
+
+	/// True if Value is below Threshold. Once below, Value has to go back above Threshold by the Hysteresis margin to return false
+	static bool IsBelow(float Value, float Threshold, float Hysteresis, bool bWasBelow) {
+		if (Threshold <= 0) return false;
+		return Value < Threshold * (bWasBelow ? 1 + Hysteresis : 1 - Hysteresis);
+	}
+}
+
+void UCPGDTFBeamLODSubsystem::Deinitialize() {
+	this->Fixtures.Empty();
+	this->Beams.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UCPGDTFBeamLODSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCPGDTFBeamLODSubsystem, STATGROUP_Tickables);
+}
+
+void UCPGDTFBeamLODSubsystem::RegisterFixture(ACPGDTFFixtureActor* Fixture) {
+	if (Fixture == nullptr || this->Fixtures.Contains(Fixture)) return;
+	this->Fixtures.Add(Fixture);
+	this->bBeamsDirty = true;
+}
+
+void UCPGDTFBeamLODSubsystem::UnregisterFixture(ACPGDTFFixtureActor* Fixture) {
+	if (this->Fixtures.Remove(Fixture) > 0) this->bBeamsDirty = true;
+}
+
+void UCPGDTFBeamLODSubsystem::RebuildBeams() {
+	this->bBeamsDirty = false;
+	this->Beams.Reset();
+	for (ACPGDTFFixtureActor* Fixture : this->Fixtures) {
+		if (!IsValid(Fixture)) continue;
+		for (UCPGDTFBeamSceneComponent* Beam : TInlineComponentArray<UCPGDTFBeamSceneComponent*>(Fixture))
+			this->Beams.Add({ Fixture, Beam });
+	}
+	this->Cursor = 0;
+}
+
+float UCPGDTFBeamLODSubsystem::GatherViews(TArray<FVector>& OutViewLocations) const {
+	UWorld* World = GetWorld();
+	float MaxScreenMultiplier = 0;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController() || PlayerController->PlayerCameraManager == nullptr) continue;
+		OutViewLocations.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+		const float HalfFOV = FMath::DegreesToRadians(FMath::Clamp(PlayerController->PlayerCameraManager->GetFOVAngle(), 1.0f, 170.0f) * 0.5f);
+		const float ScreenMultiplier = 1.0f / FMath::Tan(HalfFOV);
+		MaxScreenMultiplier = FMath::Max(MaxScreenMultiplier, ScreenMultiplier);
+	}
+	if (OutViewLocations.Num() > 0) return MaxScreenMultiplier;
+
+	// No local player: editor viewports and nDisplay views still report where they rendered from
+	OutViewLocations.Append(World->ViewLocationsRenderedLastFrame);
+	return 1.0f;
+}
+
+void UCPGDTFBeamLODSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (this->bBeamsDirty) this->RebuildBeams();
+	const int32 BeamsNum = this->Beams.Num();
+	if (BeamsNum < 1) return;
+
+	TArray<FVector> ViewLocations;
+	const float ScreenMultiplier = this->GatherViews(ViewLocations);
+	if (ViewLocations.Num() < 1) return;
+
+	const int32 ToEvaluate = FMath::Min(BeamsNum, FMath::Max(this->BeamsPerFrame, 1));
+	for (int32 i = 0; i < ToEvaluate; i++) {
+		const FBeamEntry& Entry = this->Beams[this->Cursor];
+		this->Cursor = (this->Cursor + 1) % BeamsNum;
+		UCPGDTFBeamSceneComponent* Beam = Entry.Beam.Get();
+		ACPGDTFFixtureActor* Fixture = Entry.Fixture.Get();
+		if (Beam != nullptr && Fixture != nullptr) UpdateBeamLOD(Beam, Fixture->BeamLODSettings, ViewLocations, ScreenMultiplier);
+	}
+}
+
+void UCPGDTFBeamLODSubsystem::UpdateBeamLOD(UCPGDTFBeamSceneComponent* Beam, const FCPGDTFBeamLODSettings& Settings, const TArray<FVector>& ViewLocations, float ScreenMultiplier) {
+	using namespace CPGDTFBeamLOD;
+
+	const FVector BeamLocation = Beam->GetComponentLocation();
+	float DistanceSquared = TNumericLimits<float>::Max();
+	for (const FVector& ViewLocation : ViewLocations) DistanceSquared = FMath::Min(DistanceSquared, (float)FVector::DistSquared(ViewLocation, BeamLocation));
+	const float Distance = FMath::Sqrt(DistanceSquared);
+	const float Radius = Beam->BeamStaticMeshComponent ? Beam->BeamStaticMeshComponent->Bounds.SphereRadius : Beam->LensRadius;
+	const float ScreenSize = Radius * ScreenMultiplier / FMath::Max(Distance, 1.0f);
+	const float Hysteresis = Settings.Hysteresis;
+
+	const ECPGDTFBeamLOD CurrentLOD = Beam->GetLOD();
+	ECPGDTFBeamLOD NewLOD = ECPGDTFBeamLOD::Full;
+	if (IsBelow(ScreenSize, Settings.FarScreenSize, Hysteresis, CurrentLOD == ECPGDTFBeamLOD::Far)) NewLOD = ECPGDTFBeamLOD::Far;
+	else if (IsBelow(ScreenSize, Settings.ReducedScreenSize, Hysteresis, CurrentLOD != ECPGDTFBeamLOD::Full)) NewLOD = ECPGDTFBeamLOD::Reduced;
+
+	const bool bSpotlights = !IsAbove(Distance, Settings.SpotlightsMaxDistance, Hysteresis, !Beam->GetLODSpotlights());
+	const bool bPointLight = !IsAbove(Distance, Settings.PointLightMaxDistance, Hysteresis, !Beam->GetLODPointLight());
+	const bool bBeamMesh = !IsAbove(Distance, Settings.BeamMaxDistance, Hysteresis, !Beam->GetLODBeamMesh());
+
+	Beam->SetLOD(NewLOD, bSpotlights, bPointLight, bBeamMesh);
+}
@@ -0,0 +1,170 @@
+﻿/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFDMXDispatcherSubsystem.h"
+#include "CPGDTFFixtureActor.h"
+#include "Components/DMXComponents/CPGDTFFixtureComponentBase.h"
+#include "Utils/CPGDTFDMXUniverseView.h"
+#include "Library/DMXEntityFixturePatch.h"
+#include "Algo/BinarySearch.h"
+
+void UCPGDTFDMXDispatcherSubsystem::Deinitialize() {
+	this->Universes.Empty();
+	this->FixturesUniverse.Empty();
+	this->PendingFullPush.Empty();
+	Super::Deinitialize();
+}
+
+void UCPGDTFDMXDispatcherSubsystem::RegisterFixture(ACPGDTFFixtureActor* Fixture, UDMXEntityFixturePatch* FixturePatch) {
+	if (Fixture == nullptr || FixturePatch == nullptr) return;
+	this->UnregisterFixture(Fixture);
+
+	const FCPDMXUniverseKey Key = FCPDMXUniverseKey(FixturePatch->GetParentLibrary(), FixturePatch->GetUniverseID());
+	const int32 PatchOffset = FixturePatch->GetStartingChannel() - 1;
+	FCPDMXUniverseState& State = this->Universes.FindOrAdd(Key);
+
+	for (UCPGDTFFixtureComponentBase* Component : TInlineComponentArray<UCPGDTFFixtureComponentBase*>(Fixture)) {
+		int32 First, Last;
+		if (!Component->GetUniverseByteRange(First, Last)) continue;
+
+		FCPDMXComponentRange Range;
+		Range.First = PatchOffset + First;
+		Range.Last = PatchOffset + Last;
+		Range.PatchOffset = PatchOffset;
+		Range.LastDispatch = 0;
+		Range.Component = Component;
+		Range.Fixture = Fixture;
+
+		const int32 InsertIndex = Algo::UpperBoundBy(State.Ranges, Range.First, &FCPDMXComponentRange::First);
+		State.Ranges.Insert(Range, InsertIndex);
+		State.MaxRangeLength = FMath::Max(State.MaxRangeLength, Range.Last - Range.First + 1);
+	}
+
+	this->FixturesUniverse.Add(Fixture, Key);
+	this->PendingFullPush.Add(Fixture);
+}
+
+void UCPGDTFDMXDispatcherSubsystem::UnregisterFixture(ACPGDTFFixtureActor* Fixture) {
+	FCPDMXUniverseKey Key;
+	if (!this->FixturesUniverse.RemoveAndCopyValue(Fixture, Key)) return;
+	this->PendingFullPush.Remove(Fixture);
+
+	FCPDMXUniverseState* State = this->Universes.Find(Key);
+	if (State == nullptr) return;
+	// Ranges of the fixtures collected without unregistering are removed too
+	State->Ranges.RemoveAll([Fixture](const FCPDMXComponentRange& Range) { return !Range.Fixture.IsValid() || Range.Fixture.Get() == Fixture; });
+	if (State->Ranges.Num() == 0) {
+		this->Universes.Remove(Key);
+		return;
+	}
+	State->MaxRangeLength = 0;
+	for (const FCPDMXComponentRange& Range : State->Ranges) State->MaxRangeLength = FMath::Max(State->MaxRangeLength, Range.Last - Range.First + 1);
+}
+
+void UCPGDTFDMXDispatcherSubsystem::DispatchDMXPacket(ACPGDTFFixtureActor* Fixture, UDMXEntityFixturePatch* FixturePatch) {
+	this->FramesReceived++;
+
+	const FCPDMXUniverseView UniverseView(FixturePatch, Fixture->GetCurrentDMXChannels());
+	if (!UniverseView.IsValid()) return;
+
+	const FCPDMXUniverseKey* Key = this->FixturesUniverse.Find(Fixture);
+	FCPDMXUniverseState* State = Key ? this->Universes.Find(*Key) : nullptr;
+	// Without the whole universe (or if the fixture is not registered) we can't diff anything, so we fall back to the per fixture push
+	if (State == nullptr || !UniverseView.IsUniverseWide()) {
+		this->PushToFixture(Fixture, UniverseView);
+		return;
+	}
+
+	if (this->PendingFullPush.Remove(Fixture) > 0) this->PushToFixture(Fixture, UniverseView);
+
+	TArray<TPair<int32, int32>, TInlineAllocator<16>> DirtyRanges;
+	if (State->PreviousFrame.Num() != UniverseView.Data.Num()) {
+		// First frame of the universe: everything is dirty
+		State->PreviousFrame.SetNumUninitialized(UniverseView.Data.Num());
+		DirtyRanges.Add(TPair<int32, int32>(0, UniverseView.Data.Num() - 1));
+	} else FindDirtyRanges(State->PreviousFrame.GetData(), UniverseView.Data.GetData(), UniverseView.Data.Num(), DirtyRanges);
+	if (DirtyRanges.Num() == 0) return;
+	FMemory::Memcpy(State->PreviousFrame.GetData(), UniverseView.Data.GetData(), UniverseView.Data.Num());
+
+	const uint32 Dispatch = ++State->DispatchCounter;
+	FCPDMXUniverseView ComponentView;
+	ComponentView.Data = UniverseView.Data;
+
+	for (const TPair<int32, int32>& Dirty : DirtyRanges) {
+		this->BytesChanged += Dirty.Value - Dirty.Key + 1;
+
+		// Ranges are sorted by First and none is longer than MaxRangeLength, so only these ones can overlap the dirty range
+		int32 i = Algo::LowerBoundBy(State->Ranges, Dirty.Key - State->MaxRangeLength + 1, &FCPDMXComponentRange::First);
+		for (; i < State->Ranges.Num() && State->Ranges[i].First <= Dirty.Value; i++) {
+			FCPDMXComponentRange& Range = State->Ranges[i];
+			if (Range.Last < Dirty.Key || Range.LastDispatch == Dispatch) continue;
+			Range.LastDispatch = Dispatch;
+
+			UCPGDTFFixtureComponentBase* Component = Range.Component.Get();
+			if (Component == nullptr) continue;
+			ComponentView.PatchOffset = Range.PatchOffset;
+			Component->PushDMXUniverseView(ComponentView);
+			this->ComponentsWoken++;
+		}
+	}
+}
+
+void UCPGDTFDMXDispatcherSubsystem::PushToFixture(ACPGDTFFixtureActor* Fixture, const FCPDMXUniverseView& UniverseView) {
+	for (UCPGDTFFixtureComponentBase* Component : TInlineComponentArray<UCPGDTFFixtureComponentBase*>(Fixture)) {
+		Component->PushDMXUniverseView(UniverseView);
+		this->ComponentsWoken++;
+	}
+}
+
+void UCPGDTFDMXDispatcherSubsystem::ResetCounters() {
+	this->FramesReceived = 0;
+	this->BytesChanged = 0;
+	this->ComponentsWoken = 0;
+}
+
+void UCPGDTFDMXDispatcherSubsystem::FindDirtyRanges(const uint8* Previous, const uint8* Current, int32 Num, TArray<TPair<int32, int32>, TInlineAllocator<16>>& OutRanges) {
+	int32 RangeStart = INDEX_NONE;
+	int32 i = 0;
+	while (i < Num) {
+		// Outside of a dirty range we skip 8 equal bytes at a time
+		if (RangeStart == INDEX_NONE && i + (int32)sizeof(uint64) <= Num) {
+			uint64 PreviousWord, CurrentWord;
+			FMemory::Memcpy(&PreviousWord, Previous + i, sizeof(uint64));
+			FMemory::Memcpy(&CurrentWord, Current + i, sizeof(uint64));
+			if (PreviousWord == CurrentWord) {
+				i += sizeof(uint64);
+				continue;
+			}
+		}
+
+		const bool bChanged = Previous[i] != Current[i];
+		if (bChanged && RangeStart == INDEX_NONE) RangeStart = i;
+		else if (!bChanged && RangeStart != INDEX_NONE) {
+			OutRanges.Add(TPair<int32, int32>(RangeStart, i - 1));
+			RangeStart = INDEX_NONE;
+		}
+		i++;
+	}
+	if (RangeStart != INDEX_NONE) OutRanges.Add(TPair<int32, int32>(RangeStart, Num - 1));
+}
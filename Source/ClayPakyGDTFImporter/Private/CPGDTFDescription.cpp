@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "CPGDTFDescription.h"
+#include "Misc/ScopeRWLock.h"
 
 /*
  * Parses a GDTF Matrix
@@ -65,6 +66,48 @@ FMatrix CPGDTFDescription::ParseMatrix(FString MatrixStr) {
 }
 
 
+/// Interned attributes names. Filled on the first lookup of each name and shared between every fixture
+namespace CPGDTFDescriptionAttributesCache {
+
+	struct FResolvedAttribute {
+		ECPGDTFAttributeType Type;
+		int32 Index;
+	};
+
+	static TMap<FName, FResolvedAttribute> ResolvedAttributes;
+	static FRWLock ResolvedAttributesLock;
+
+	static FResolvedAttribute Resolve(const FName& AttributeName) {
+		{
+			FReadScopeLock ReadLock(ResolvedAttributesLock);
+			if (const FResolvedAttribute* Found = ResolvedAttributes.Find(AttributeName)) return *Found;
+		}
+
+		const FString AttributeString = AttributeName.ToString();
+		FResolvedAttribute Resolved;
+		Resolved.Type = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(AttributeString);
+		Resolved.Index = 0;
+		for (int i = 0; i < AttributeString.Len(); i++) {
+			if (!CPGDTFDescription::IsDigit(AttributeString[i])) continue;
+			for (; i < AttributeString.Len() && CPGDTFDescription::IsDigit(AttributeString[i]); i++)
+				Resolved.Index = Resolved.Index * 10 + (AttributeString[i] - '0');
+			break;
+		}
+
+		FWriteScopeLock WriteLock(ResolvedAttributesLock);
+		ResolvedAttributes.Add(AttributeName, Resolved);
+		return Resolved;
+	}
+}
+
+ECPGDTFAttributeType CPGDTFDescription::GetGDTFAttributeTypeValueFromName(const FName& AttributeName) {
+	return CPGDTFDescriptionAttributesCache::Resolve(AttributeName).Type;
+}
+
+int32 CPGDTFDescription::GetGDTFAttributeIndexFromName(const FName& AttributeName) {
+	return CPGDTFDescriptionAttributesCache::Resolve(AttributeName).Index;
+}
+
 /**
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 15 june 2022
@@ -150,4 +193,15 @@ FString UCPGDTFDescription::GetFixtureSavePath() {
 		FixtureSavePath.LeftInline(Index + 1);
 	}
 	return FixtureSavePath;
+}
+
+/**
+ * Find the spectrum of an emitter
+ *
+ * @param Emitter Name of the emitter
+ * @return Null if the emitter has no measurement
+ */
+const FCPGDTFEmitterSpectrum* UCPGDTFDescription::FindEmitterSpectrum(FName Emitter) const {
+	if (Emitter.IsNone()) return nullptr;
+	return this->EmitterSpectra.Find(Emitter);
 }
\ No newline at end of file
@@ -24,6 +24,10 @@ SOFTWARE.
 
 
 #include "CPGDTFFixtureActor.h"
+#include "CPGDTFDMXDispatcherSubsystem.h"
+#include "CPGDTFFixtureManagerSubsystem.h"
+#include "CPGDTFOcclusionSubsystem.h"
+#include "CPGDTFBeamLODSubsystem.h"
 #include "Factories/CPGDTFFactory.h"
 #include "ClayPakyGDTFImporterLog.h"
 #include "Utils/CPGDTFColorWizard.h"
@@ -84,8 +88,6 @@ void ACPGDTFFixtureActor::BeginDestroy() {
 
 	// If destroy occurs during gameplay 'EndPlay()' is called by Unreal before this method
 
-	this->CheckOcclusionTimer.Invalidate();
-
 	Super::BeginDestroy();
 }
 
@@ -95,11 +97,26 @@ void ACPGDTFFixtureActor::BeginPlay() {
 
 	this->GeometryTree.ReParseGeometryTree(this);
 	this->UpdateProperties();
+	this->BuildTickSchedule();
 
-	if (this->UseDynamicOcclusion)
-		GetWorld()->GetTimerManager().SetTimer(CheckOcclusionTimer, this, &ACPGDTFFixtureActor::CheckOcclusion, FMath::FRandRange(0.1f, 0.3f), true, 0.0f);
+	if (this->UseDynamicOcclusion) {
+		if (UCPGDTFOcclusionSubsystem* Occlusion = GetWorld()->GetSubsystem<UCPGDTFOcclusionSubsystem>())
+			Occlusion->RegisterFixture(this);
+	}
+	if (this->bUseBeamLOD) {
+		if (UCPGDTFBeamLODSubsystem* BeamLOD = GetWorld()->GetSubsystem<UCPGDTFBeamLODSubsystem>())
+			BeamLOD->RegisterFixture(this);
+	}
 
 	this->DMX->OnDMXReceivedRaw.AddDynamic(this, &ACPGDTFFixtureActor::PushNormalizedRawValues);
+	if (UCPGDTFDMXDispatcherSubsystem* Dispatcher = GetWorld()->GetSubsystem<UCPGDTFDMXDispatcherSubsystem>())
+		Dispatcher->RegisterFixture(this, this->DMX->GetFixturePatch());
+	if (this->bTickInFixtureManager) {
+		if (UCPGDTFFixtureManagerSubsystem* Manager = GetWorld()->GetSubsystem<UCPGDTFFixtureManagerSubsystem>()) {
+			Manager->RegisterFixture(this);
+			this->SetActorTickEnabled(false); // The manager ticks us together with all the other fixtures
+		}
+	}
 }
 
 void ACPGDTFFixtureActor::EndPlay(const EEndPlayReason::Type EndPlayReason) {
@@ -107,71 +124,144 @@ void ACPGDTFFixtureActor::EndPlay(const EEndPlayReason::Type EndPlayReason) {
 	Super::EndPlay(EndPlayReason);
 
 	this->DMX->OnDMXReceivedRaw.RemoveAll(this);					// We stop listening DMX packets
-	GetWorld()->GetTimerManager().ClearTimer(CheckOcclusionTimer); // We remove the CheckOcclusion timer
-	GetWorld()->GetTimerManager().ClearAllTimersForObject(this);  // And just in case
+	if (UCPGDTFDMXDispatcherSubsystem* Dispatcher = GetWorld()->GetSubsystem<UCPGDTFDMXDispatcherSubsystem>())
+		Dispatcher->UnregisterFixture(this);
+	if (UCPGDTFFixtureManagerSubsystem* Manager = GetWorld()->GetSubsystem<UCPGDTFFixtureManagerSubsystem>())
+		Manager->UnregisterFixture(this);
+	if (UCPGDTFOcclusionSubsystem* Occlusion = GetWorld()->GetSubsystem<UCPGDTFOcclusionSubsystem>())
+		Occlusion->UnregisterFixture(this);
+	if (UCPGDTFBeamLODSubsystem* BeamLOD = GetWorld()->GetSubsystem<UCPGDTFBeamLODSubsystem>())
+		BeamLOD->UnregisterFixture(this);
+	GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
 }
 
 void ACPGDTFFixtureActor::Tick(float DeltaTime) {
 
 	Super::Tick(DeltaTime);
-	this->ToggleLightVisibility();
 
-	// Interpolation of the DMXComponents
-	// WARNING: The order is important to create the behaviour of real fixtures (cf. Order of different effects in the head of a moving head)
-	
-	// Array with all the DMXComponents of the Actor
-	TInlineComponentArray<UCPGDTFFixtureComponentBase*> DMXComponents = TInlineComponentArray<UCPGDTFFixtureComponentBase*>(this);
+	// When registered to the fixture manager, the same stages are run by UCPGDTFFixtureManagerSubsystem for all the fixtures together
+	this->TickPrePass(DeltaTime);
+	// Only the interpolations of this fixture: the other ones may not have run their effects yet in this frame
+	for (UCPGDTFFixtureComponentBase* Component : this->ColorSourcesTickSchedule) {
+		if (Component->bUseInterpolation) Component->AdvanceInterpolations(DeltaTime);
+	}
+	for (UCPGDTFFixtureComponentBase* Component : this->OtherComponentsTickSchedule) {
+		if (Component->bUseInterpolation) Component->AdvanceInterpolations(DeltaTime);
+	}
+	this->TickColorSourcesPostPass(DeltaTime);
+	this->ComputeBeamColors();
+	this->TickPostPass(DeltaTime);
+}
+
+// Interpolation of the DMXComponents
+// WARNING: The order is important to create the behaviour of real fixtures (cf. Order of different effects in the head of a moving head)
+
+void ACPGDTFFixtureActor::TickPrePass(float DeltaTime) {
+
+	// The schedule is rebuilt only if some component has been registered or unregistered
+	if (!this->bTickScheduleValid) this->BuildTickSchedule();
+
+	// Running effects of every component. They may set new targets before the interpolations are advanced
+	for (UCPGDTFFixtureComponentBase* Component : this->ColorSourcesTickSchedule) {
+		if (Component->bUseInterpolation) Component->InterpolateComponent_PrePass(DeltaTime);
+	}
+	for (UCPGDTFFixtureComponentBase* Component : this->OtherComponentsTickSchedule) {
+		if (Component->bUseInterpolation) Component->InterpolateComponent_PrePass(DeltaTime);
+	}
+}
+
+void ACPGDTFFixtureActor::TickColorSourcesPostPass(float DeltaTime) {
 
 	// Step 1 Color Sources
-	for (TPair<FName, UCPGDTFBeamSceneComponent*> BeamPair : this->GeometryTree.BeamComponents) {
+	for (UCPGDTFFixtureComponentBase* ColorSource : this->ColorSourcesTickSchedule) {
+		if (ColorSource->bUseInterpolation) ColorSource->InterpolateComponent_PostPass(DeltaTime);
+	}
+}
 
-		FCPColorWizard AdditiveWizard;
-		bool bIsAdditivePresent = false;
-		for (UCPGDTFAdditiveColorFixtureComponent* ColorSource : TInlineComponentArray<UCPGDTFAdditiveColorFixtureComponent*>(this)) {
-			if (ColorSource->AttachedBeams.Contains(BeamPair.Value)) {
-				if (ColorSource->bUseInterpolation)
-					ColorSource->InterpolateComponent(DeltaTime);
+void ACPGDTFFixtureActor::ComputeBeamColors() {
+
+	// Step 2 Color of each beam. Only reads the color sources, so it can run outside the game thread
+	for (FCPBeamTickSchedule& Schedule : this->BeamTickSchedules) {
+
+		FLinearColor FinalColor = FLinearColor(1, 1, 1, 1); // If we don't have any additive color source the base light is white
+		if (Schedule.AdditiveSources.Num() > 0) {
+			FCPColorWizard AdditiveWizard;
+			for (UCPGDTFAdditiveColorFixtureComponent* ColorSource : Schedule.AdditiveSources)
 				AdditiveWizard.BlendColor(ColorSource->GetCurrentColor(), 1);
-				DMXComponents.Remove(ColorSource);
-				bIsAdditivePresent = true;
-			}
+			FinalColor = AdditiveWizard.GetColor();
 		}
 
-		bool bIsMacroPresent = false;
-		FLinearColor FinalColor;
-		if (bIsAdditivePresent)
-			FinalColor = AdditiveWizard.GetColor();
-		else
-			FinalColor = FLinearColor(1, 1, 1, 1); // If we don't have any additive color source the base light is white
-		for (UCPGDTFSubstractiveColorFixtureComponent* ColorSource : TInlineComponentArray<UCPGDTFSubstractiveColorFixtureComponent*>(this)) {
-			if (ColorSource->AttachedBeams.Contains(BeamPair.Value)) {
-				if (ColorSource->bUseInterpolation) ColorSource->InterpolateComponent(DeltaTime);
-				UCPGDTFColorWheelFixtureComponent* ColorWheelPtr = Cast<UCPGDTFColorWheelFixtureComponent>(ColorSource);
-
-				if (ColorWheelPtr && ColorWheelPtr->IsMacroColor()) {
-					FinalColor = ColorWheelPtr->ApplyFilter(FLinearColor(1, 1, 1)); // If this is a macro color we overwrite everything and exit the loop
-					bIsMacroPresent = true;
-					break;
-				}
-				if (!bIsMacroPresent) FinalColor = ColorSource->ApplyFilter(FinalColor);
-				DMXComponents.Remove(ColorSource);
+		for (int32 i = 0; i < Schedule.SubstractiveSources.Num(); i++) {
+			UCPGDTFColorWheelFixtureComponent* ColorWheelPtr = Schedule.ColorWheels[i];
+			if (ColorWheelPtr && ColorWheelPtr->IsMacroColor()) {
+				FinalColor = ColorWheelPtr->ApplyFilter(FLinearColor(1, 1, 1)); // If this is a macro color we overwrite everything and exit the loop
+				break;
 			}
+			FinalColor = Schedule.SubstractiveSources[i]->ApplyFilter(FinalColor);
 		}
 
-		BeamPair.Value->SetLightColor(FinalColor);
-	}
-	
-	// Step 3 Color corrections
-	for (UCPGDTFColorCorrectionFixtureComponent* ColorCorrection : TInlineComponentArray<UCPGDTFColorCorrectionFixtureComponent*>(this)) {
-		if (ColorCorrection->bUseInterpolation) ColorCorrection->InterpolateComponent(DeltaTime);
-		DMXComponents.Remove(ColorCorrection);
+		Schedule.StagedColor = FinalColor;
 	}
+}
+
+void ACPGDTFFixtureActor::TickPostPass(float DeltaTime) {
 
+	for (const FCPBeamTickSchedule& Schedule : this->BeamTickSchedules) Schedule.Beam->SetLightColor(Schedule.StagedColor);
+
+	// Step 3 Color corrections
 	// Step 4 Other effects
 	// WARNING: Here the order between the DMXComponents is unknow
+	for (UCPGDTFFixtureComponentBase* Component : this->OtherComponentsTickSchedule) {
+		if (Component->bUseInterpolation) Component->InterpolateComponent_PostPass(DeltaTime);
+	}
+
+	// Everything set on the materials during this frame (DMX packets included) is written once here
+	for (const FCPBeamTickSchedule& Schedule : this->BeamTickSchedules) Schedule.Beam->FlushMaterialParameters();
+}
+
+void ACPGDTFFixtureActor::BuildTickSchedule() {
+
+	this->BeamTickSchedules.Empty(this->GeometryTree.BeamComponents.Num());
+	this->ColorSourcesTickSchedule.Empty();
+	this->OtherComponentsTickSchedule.Empty();
+
+	TInlineComponentArray<UCPGDTFFixtureComponentBase*> DMXComponents(this);
+	TInlineComponentArray<UCPGDTFAdditiveColorFixtureComponent*> AdditiveSources(this);
+	TInlineComponentArray<UCPGDTFSubstractiveColorFixtureComponent*> SubstractiveSources(this);
+	TSet<UCPGDTFFixtureComponentBase*> ScheduledColorSources;
+
+	for (TPair<FName, UCPGDTFBeamSceneComponent*> BeamPair : this->GeometryTree.BeamComponents) {
+		if (BeamPair.Value == nullptr) continue;
+
+		FCPBeamTickSchedule& Schedule = this->BeamTickSchedules.AddDefaulted_GetRef();
+		Schedule.Beam = BeamPair.Value;
+		for (UCPGDTFAdditiveColorFixtureComponent* ColorSource : AdditiveSources) {
+			if (!ColorSource->AttachedBeams.Contains(BeamPair.Value)) continue;
+			Schedule.AdditiveSources.Add(ColorSource);
+			if (!ScheduledColorSources.Contains(ColorSource)) {
+				ScheduledColorSources.Add(ColorSource);
+				this->ColorSourcesTickSchedule.Add(ColorSource);
+			}
+		}
+		for (UCPGDTFSubstractiveColorFixtureComponent* ColorSource : SubstractiveSources) {
+			if (!ColorSource->AttachedBeams.Contains(BeamPair.Value)) continue;
+			Schedule.SubstractiveSources.Add(ColorSource);
+			Schedule.ColorWheels.Add(Cast<UCPGDTFColorWheelFixtureComponent>(ColorSource));
+			if (!ScheduledColorSources.Contains(ColorSource)) {
+				ScheduledColorSources.Add(ColorSource);
+				this->ColorSourcesTickSchedule.Add(ColorSource);
+			}
+		}
+	}
+
+	for (UCPGDTFFixtureComponentBase* Component : DMXComponents) {
+		if (Component->IsA<UCPGDTFColorCorrectionFixtureComponent>()) this->OtherComponentsTickSchedule.Add(Component);
+	}
 	for (UCPGDTFFixtureComponentBase* Component : DMXComponents) {
-		if (Component->bUseInterpolation) Component->InterpolateComponent(DeltaTime);
+		if (!ScheduledColorSources.Contains(Component) && !Component->IsA<UCPGDTFColorCorrectionFixtureComponent>()) this->OtherComponentsTickSchedule.Add(Component);
 	}
+
+	this->bTickScheduleValid = true;
 }
 
 #if WITH_EDITOR
@@ -179,6 +269,14 @@ void ACPGDTFFixtureActor::Tick(float DeltaTime) {
 
 		Super::PostEditChangeProperty(PropertyChangedEvent);
 		this->UpdateProperties();
+
+		//The kernel options are compiled inside the beam material, each combination has its own material instances
+		if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(ACPGDTFFixtureActor, BeamKernelOptions) && this->GDTFDescription) {
+			CPGDTFRenderPipelineBuilder pipelineBuilder = CPGDTFRenderPipelineBuilder(this->GDTFDescription, this->CurrentModeIndex, GetInstanceComponents(), FixturePathInContentBrowser, this->BeamKernelOptions);
+			pipelineBuilder.buildLightRenderPipeline();
+			for (UCPGDTFBeamSceneComponent* Beam : TInlineComponentArray<UCPGDTFBeamSceneComponent*>(this))
+				Beam->SetPipelineMaterialInstances(pipelineBuilder);
+		}
 	}
 #endif
 
@@ -207,7 +305,7 @@ void ACPGDTFFixtureActor::CreateRenderingPipelines(UCPGDTFDescription* FixtureGD
 	for (int modeId = 0; modeId < modes.Num(); modeId++) {
 		this->CurrentModeIndex = modeId;
 		FCPFActorComponentsLoader::LoadDMXComponents(this, FixtureGDTFDescription->GetDMXModes()->DMXModes[this->CurrentModeIndex]);
-		CPGDTFRenderPipelineBuilder pipelineBuilder = CPGDTFRenderPipelineBuilder(FixtureGDTFDescription, this->CurrentModeIndex, GetInstanceComponents(), FixturePathInContentBrowser);
+		CPGDTFRenderPipelineBuilder pipelineBuilder = CPGDTFRenderPipelineBuilder(FixtureGDTFDescription, this->CurrentModeIndex, GetInstanceComponents(), FixturePathInContentBrowser, this->BeamKernelOptions);
 		pipelineBuilder.buildLightRenderPipeline();
 		FCPFActorComponentsLoader::PurgeAllComponents(this);
 	}
@@ -253,9 +351,17 @@ bool ACPGDTFFixtureActor::IsMoving() {
 
 void ACPGDTFFixtureActor::CheckOcclusion() {
 
+	if (UCPGDTFOcclusionSubsystem* Occlusion = GetWorld()->GetSubsystem<UCPGDTFOcclusionSubsystem>())
+		Occlusion->InvalidateFixture(this);
+}
+
+int32 ACPGDTFFixtureActor::GetActiveLightsNum() const {
+
+	int32 LightsNum = 0;
 	for (const TPair<FName, UCPGDTFBeamSceneComponent*> pair : this->GeometryTree.BeamComponents) {
-		pair.Value->CheckOcclusion();
+		if (pair.Value) LightsNum += pair.Value->GetActiveLightsNum();
 	}
+	return LightsNum;
 }
 
 void ACPGDTFFixtureActor::SetLightCastShadow(bool bLightShouldCastShadow) {
@@ -310,16 +416,42 @@ void ACPGDTFFixtureActor::SetLightDistanceMax(float NewLightDistanceMax) {
 void ACPGDTFFixtureActor::PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) {
 	
 	if (this->HasActorBegunPlay()) {
-		auto asd = TInlineComponentArray<UCPGDTFFixtureComponentBase*>(this);
+		// The dispatcher wakes up only the components whose bytes changed, in all the fixtures of the universe
+		if (UCPGDTFDMXDispatcherSubsystem* Dispatcher = GetWorld()->GetSubsystem<UCPGDTFDMXDispatcherSubsystem>()) {
+			Dispatcher->DispatchDMXPacket(this, FixturePatch);
+			return;
+		}
+
+		// The view is built once and shared between all the components
+		const FCPDMXUniverseView UniverseView(FixturePatch, this->GetCurrentDMXChannels());
 		for (UCPGDTFFixtureComponentBase* DMXComponent : TInlineComponentArray<UCPGDTFFixtureComponentBase*>(this)) {
-			DMXComponent->PushNormalizedRawValues(FixturePatch, RawValuesMap);
+			DMXComponent->PushDMXUniverseView(UniverseView);
 		}
 	}
 }
 
+void ACPGDTFFixtureActor::RefreshDMXDispatcherRegistration() {
+	if (!this->HasActorBegunPlay() || GetWorld() == nullptr) return; // BeginPlay() registers us with the current patch
+	if (UCPGDTFDMXDispatcherSubsystem* Dispatcher = GetWorld()->GetSubsystem<UCPGDTFDMXDispatcherSubsystem>()) {
+		Dispatcher->UnregisterFixture(this);
+		Dispatcher->RegisterFixture(this, this->DMX->GetFixturePatch());
+	}
+}
+
+TArrayView<const FDMXImportGDTFDMXChannel> ACPGDTFFixtureActor::GetCurrentDMXChannels() const {
+	if (this->GDTFDescription == nullptr) return TArrayView<const FDMXImportGDTFDMXChannel>();
+	const UDMXImportGDTFDMXModes* Modes = this->GDTFDescription->GetDMXModes();
+	if (Modes == nullptr || !Modes->DMXModes.IsValidIndex(this->CurrentModeIndex)) return TArrayView<const FDMXImportGDTFDMXChannel>();
+	return Modes->DMXModes[this->CurrentModeIndex].DMXChannels;
+}
+
 #if WITH_EDITOR
 void ACPGDTFFixtureActor::ChangeFixtureMode(const UDMXEntityFixturePatch* FixturePatch) {
-	if (FixturePatch->GetActiveModeIndex() == this->CurrentModeIndex) return; // If the mode didn't changed we return
+	if (FixturePatch->GetActiveModeIndex() == this->CurrentModeIndex) {
+		// Same mode, but the address or the universe may have changed: the dispatcher has to recompute our ranges
+		this->RefreshDMXDispatcherRegistration();
+		return;
+	}
 
 	if (FixturePatch->GetActiveModeIndex() < 0 || FixturePatch->GetActiveModeIndex() > this->GDTFDescription->GetDMXModes()->DMXModes.Num() - 1) {
 		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Mode index out of bounds in '%s' on ChangeFixtureMode"), *this->GetName());
@@ -327,6 +459,8 @@ void ACPGDTFFixtureActor::ChangeFixtureMode(const UDMXEntityFixturePatch* Fixtur
 	}
 
 	this->CurrentModeIndex = FixturePatch->GetActiveModeIndex();
+	this->InvalidateTickSchedule();
+	this->RefreshDMXDispatcherRegistration();
 
 	//Unloading all components and geometries and reloading them with the correct dmx mode won't work, since we cannot update the ConstructionScripts once the blueprint has been created.
 	//The current method works by firstly creating a blueprint class for each mode when we firstly import a light, then replacing the current object's blueprint with the selected mode each time we change it.
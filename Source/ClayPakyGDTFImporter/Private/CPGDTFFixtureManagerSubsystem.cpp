@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFFixtureManagerSubsystem.h"
+#include "CPGDTFFixtureActor.h"
+#include "CPGDTFInterpolationSubsystem.h"
+#include "Async/ParallelFor.h"
+
+#define FIXTURE_MANAGER_PARALLEL_MIN_FIXTURES 16 //Below this number of fixtures the colors are blended on the game thread
+
+void UCPGDTFFixtureManagerSubsystem::Deinitialize() {
+	this->Fixtures.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UCPGDTFFixtureManagerSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCPGDTFFixtureManagerSubsystem, STATGROUP_Tickables);
+}
+
+void UCPGDTFFixtureManagerSubsystem::RegisterFixture(ACPGDTFFixtureActor* Fixture) {
+	if (Fixture == nullptr) return;
+	this->Fixtures.AddUnique(Fixture);
+}
+
+void UCPGDTFFixtureManagerSubsystem::UnregisterFixture(ACPGDTFFixtureActor* Fixture) {
+	this->Fixtures.Remove(Fixture);
+}
+
+void UCPGDTFFixtureManagerSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	if (this->Fixtures.Num() < 1) return;
+
+	// Stage 1, game thread: running effects. New targets are set before the interpolations are advanced, so they're consumed in this same frame.
+	// Stages 1, 3 and 5 call into the components and their beams, so they aren't run in parallel: only the stages 2 and 4 are pure computations.
+	// The DMX values are decoded and applied (ApplyEffectToBeam()) when they're received, serially on the game thread, before this tick
+	for (ACPGDTFFixtureActor* Fixture : this->Fixtures) Fixture->TickPrePass(DeltaTime);
+
+	// Stage 2: all the interpolations of the world
+	if (UCPGDTFInterpolationSubsystem* Interpolations = GetWorld()->GetSubsystem<UCPGDTFInterpolationSubsystem>())
+		Interpolations->GetEngine()->AdvanceOncePerFrame(DeltaTime, this->bParallelEvaluation);
+
+	// Stage 3, game thread: current colors of the color sources
+	for (ACPGDTFFixtureActor* Fixture : this->Fixtures) Fixture->TickColorSourcesPostPass(DeltaTime);
+
+	// Stage 4: color blending of each beam into its staging buffer
+	if (this->bParallelEvaluation && this->Fixtures.Num() >= FIXTURE_MANAGER_PARALLEL_MIN_FIXTURES) {
+		ParallelFor(this->Fixtures.Num(), [this](int32 i) { this->Fixtures[i]->ComputeBeamColors(); });
+	} else {
+		for (ACPGDTFFixtureActor* Fixture : this->Fixtures) Fixture->ComputeBeamColors();
+	}
+
+	// Stage 5, game thread: lights and materials writes
+	for (ACPGDTFFixtureActor* Fixture : this->Fixtures) Fixture->TickPostPass(DeltaTime);
+}
@@ -24,13 +24,13 @@ SOFTWARE.
 
 #include "CPGDTFInterpolation.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Async/ParallelFor.h"
 
 #define MAX_FAST_DECELERATION_RATIO 1.5f //Multiplier of the acceleration to get the max Deceleration speed, in case we have to slow down faster then the normal acceleration
+#define INTERPOLATION_ENGINE_PARALLEL_MIN_AWAKE 4096 //Below this number of awake interpolations the task graph overhead is bigger than the update itself
+#define INTERPOLATION_ENGINE_PARALLEL_CHUNK_SIZE 1024
 
 FChannelInterpolation::FChannelInterpolation(float Default) {
-	if(criticalSection == nullptr)
-		criticalSection = new FCriticalSection();
-
 	TargetValue = Default;
 	__EndInterpolation_noLocks(true);
 
@@ -41,10 +41,7 @@ FChannelInterpolation::FChannelInterpolation(float Default) {
 
 void FChannelInterpolation::destroyInterpolation() {
 	//This is not an object destructor, otherwise it would be called continuosly causing unreal engine to just freeze
-	if (criticalSection != nullptr) {
-		delete criticalSection;
-		criticalSection = nullptr;
-	}
+	//Nothing is allocated per instance anymore
 }
 
 void FChannelInterpolation::__EndInterpolation_noLocks(bool snapToTargetValue) {
@@ -380,4 +377,110 @@ void FChannelInterpolation::setFadeAndAcceleration(float RealAcceleration, float
 	this->realFade = RealFade;
 }
 
-#undef MAX_FAST_DECELERATION_RATIO
\ No newline at end of file
+#undef MAX_FAST_DECELERATION_RATIO
+  /****************************************************/
+ /*               Interpolation Engine               */
+/****************************************************/
+
+FCPGDTFInterpolationHandle FCPGDTFInterpolationEngine::Allocate(const FChannelInterpolation& Interpolation) {
+	FCPGDTFInterpolationHandle Handle;
+	Handle.Engine = this;
+	if (FreeSlots.Num() > 0) {
+		Handle.Index = FreeSlots.Pop(false);
+		Interpolations[Handle.Index] = Interpolation;
+		UsedFlags[Handle.Index] = 1;
+		UpdatedFrames[Handle.Index] = MAX_uint64;
+	} else {
+		Handle.Index = Interpolations.Add(Interpolation);
+		AwakeFlags.Add(0);
+		UsedFlags.Add(1);
+		UpdatedFrames.Add(MAX_uint64);
+	}
+	Wake(Handle.Index); // A new interpolation may not be at its target yet
+	return Handle;
+}
+
+void FCPGDTFInterpolationEngine::Release(FCPGDTFInterpolationHandle& Handle) {
+	if (Handle.Engine != this || !UsedFlags.IsValidIndex(Handle.Index) || !UsedFlags[Handle.Index]) return;
+
+	Interpolations[Handle.Index].destroyInterpolation();
+	UsedFlags[Handle.Index] = 0;
+	if (AwakeFlags[Handle.Index]) {
+		AwakeFlags[Handle.Index] = 0;
+		AwakeList.RemoveSingleSwap(Handle.Index, false);
+	}
+	FreeSlots.Add(Handle.Index);
+
+	Handle.Engine = nullptr;
+	Handle.Index = INDEX_NONE;
+}
+
+void FCPGDTFInterpolationEngine::Empty() {
+	for (int32 i = 0; i < Interpolations.Num(); i++)
+		if (UsedFlags[i]) Interpolations[i].destroyInterpolation();
+	Interpolations.Empty();
+	AwakeFlags.Empty();
+	UsedFlags.Empty();
+	UpdatedFrames.Empty();
+	AwakeList.Empty();
+	FreeSlots.Empty();
+}
+
+void FCPGDTFInterpolationEngine::AdvanceAwake(float DeltaSeconds, bool bParallel, bool bOncePerFrame) {
+	const int32 AwakeNum = AwakeList.Num();
+	const uint64 Frame = GFrameCounter;
+	// Each index appears once in AwakeList, so the parallel chunks never write the same slot
+	auto UpdateAt = [this, DeltaSeconds, bOncePerFrame, Frame](int32 Index) {
+		if (bOncePerFrame) {
+			if (UpdatedFrames[Index] == Frame) return;
+			UpdatedFrames[Index] = Frame;
+		}
+		Interpolations[Index].Update(DeltaSeconds);
+	};
+	if (bParallel && AwakeNum >= INTERPOLATION_ENGINE_PARALLEL_MIN_AWAKE) {
+		const int32 ChunksNum = FMath::DivideAndRoundUp(AwakeNum, INTERPOLATION_ENGINE_PARALLEL_CHUNK_SIZE);
+		ParallelFor(ChunksNum, [this, &UpdateAt, AwakeNum](int32 Chunk) {
+			const int32 End = FMath::Min(AwakeNum, (Chunk + 1) * INTERPOLATION_ENGINE_PARALLEL_CHUNK_SIZE);
+			for (int32 i = Chunk * INTERPOLATION_ENGINE_PARALLEL_CHUNK_SIZE; i < End; i++) UpdateAt(AwakeList[i]);
+		});
+	} else {
+		for (int32 i = 0; i < AwakeNum; i++) UpdateAt(AwakeList[i]);
+	}
+
+	Sweep();
+}
+
+void FCPGDTFInterpolationEngine::Sweep() {
+	LastSweptFrame = GFrameCounter;
+	const int32 AwakeNum = AwakeList.Num();
+	int32 StillAwake = 0;
+	for (int32 i = 0; i < AwakeNum; i++) {
+		const int32 Index = AwakeList[i];
+		const FChannelInterpolation& Interpolation = Interpolations[Index];
+
+		//Interpolations that reached their target sleep until someone touches them again
+		if (Interpolation.IsUpdating()) AwakeList[StillAwake++] = Index;
+			else AwakeFlags[Index] = 0;
+	}
+	AwakeList.SetNum(StillAwake, false);
+}
+
+void FCPGDTFInterpolationEngine::Advance(float DeltaSeconds, bool bParallel) {
+	AdvanceAwake(DeltaSeconds, bParallel, false);
+}
+
+void FCPGDTFInterpolationEngine::AdvanceOncePerFrame(float DeltaSeconds, bool bParallel) {
+	AdvanceAwake(DeltaSeconds, bParallel, true);
+}
+
+void FCPGDTFInterpolationEngine::AdvanceHandles(TArrayView<const FCPGDTFInterpolationHandle> Handles, float DeltaSeconds) {
+	const uint64 Frame = GFrameCounter;
+	// Without any AdvanceOncePerFrame() the interpolations that reached their target still have to go back to sleep
+	if (LastSweptFrame != Frame) Sweep();
+	for (const FCPGDTFInterpolationHandle& Handle : Handles) {
+		if (Handle.Engine != this || !UsedFlags.IsValidIndex(Handle.Index) || !AwakeFlags[Handle.Index]) continue;
+		if (UpdatedFrames[Handle.Index] == Frame) continue;
+		UpdatedFrames[Handle.Index] = Frame;
+		Interpolations[Handle.Index].Update(DeltaSeconds);
+	}
+}
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFOcclusionSubsystem.h"
+#include "CPGDTFFixtureActor.h"
+#include "Components/CPGDTFBeamSceneComponent.h"
+#include "Components/ArrowComponent.h"
+#include "Engine/World.h"
+
+#define OCCLUSION_MOVEMENT_LOCATION_TOLERANCE 0.01f //Under this distance (cm) the origin of the beam is considered still
+#define OCCLUSION_MOVEMENT_DIRECTION_TOLERANCE 0.0001f //Under this difference the direction of the beam is considered still
+
+void UCPGDTFOcclusionSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+	this->TraceDelegate.BindUObject(this, &UCPGDTFOcclusionSubsystem::OnTraceCompleted);
+}
+
+void UCPGDTFOcclusionSubsystem::Deinitialize() {
+	this->Fixtures.Empty();
+	this->Beams.Empty();
+	this->BeamsById.Empty();
+	this->TraceDelegate.Unbind();
+	Super::Deinitialize();
+}
+
+TStatId UCPGDTFOcclusionSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCPGDTFOcclusionSubsystem, STATGROUP_Tickables);
+}
+
+void UCPGDTFOcclusionSubsystem::RegisterFixture(ACPGDTFFixtureActor* Fixture) {
+	if (Fixture == nullptr || this->Fixtures.Contains(Fixture)) return;
+	this->Fixtures.Add(Fixture);
+	this->bBeamsDirty = true;
+}
+
+void UCPGDTFOcclusionSubsystem::UnregisterFixture(ACPGDTFFixtureActor* Fixture) {
+	if (this->Fixtures.Remove(Fixture) > 0) this->bBeamsDirty = true;
+}
+
+void UCPGDTFOcclusionSubsystem::InvalidateFixture(ACPGDTFFixtureActor* Fixture) {
+	for (FBeamEntry& Entry : this->Beams) {
+		if (Entry.Fixture == Fixture) Entry.bHasResult = false;
+	}
+}
+
+void UCPGDTFOcclusionSubsystem::RebuildBeams() {
+	this->bBeamsDirty = false;
+
+	TMap<UCPGDTFBeamSceneComponent*, FBeamEntry> OldBeams;
+	for (FBeamEntry& Entry : this->Beams) {
+		if (UCPGDTFBeamSceneComponent* Beam = Entry.Beam.Get()) OldBeams.Add(Beam, Entry);
+	}
+
+	this->Beams.Reset();
+	for (ACPGDTFFixtureActor* Fixture : this->Fixtures) {
+		if (!IsValid(Fixture)) continue;
+		for (UCPGDTFBeamSceneComponent* Beam : TInlineComponentArray<UCPGDTFBeamSceneComponent*>(Fixture)) {
+			if (Beam->OcclusionDirection == nullptr) continue;
+			if (FBeamEntry* OldEntry = OldBeams.Find(Beam)) {
+				this->Beams.Add(*OldEntry);
+			} else {
+				FBeamEntry& Entry = this->Beams.AddDefaulted_GetRef();
+				Entry.Fixture = Fixture;
+				Entry.Beam = Beam;
+				Entry.Id = this->NextBeamId++;
+			}
+		}
+	}
+
+	// Shuffled, so beams of the same fixture aren't all traced in the same frame
+	FRandomStream Random(this->bUseFixedSeed ? this->FixedSeed : (int32)FPlatformTime::Cycles());
+	for (int32 i = this->Beams.Num() - 1; i > 0; i--) this->Beams.Swap(i, Random.RandRange(0, i));
+
+	this->BeamsById.Reset();
+	for (int32 i = 0; i < this->Beams.Num(); i++) this->BeamsById.Add(this->Beams[i].Id, i);
+	this->Cursor = 0;
+}
+
+void UCPGDTFOcclusionSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (this->bBeamsDirty) this->RebuildBeams();
+	const int32 BeamsNum = this->Beams.Num();
+	if (BeamsNum < 1) return;
+
+	UWorld* World = GetWorld();
+	int32 Started = 0;
+	for (int32 Visited = 0; Visited < BeamsNum && Started < this->MaxTracesPerFrame; Visited++) {
+		FBeamEntry& Entry = this->Beams[this->Cursor];
+		this->Cursor = (this->Cursor + 1) % BeamsNum;
+
+		UCPGDTFBeamSceneComponent* Beam = Entry.Beam.Get();
+		if (Entry.PendingTrace.IsValid() || !IsValid(Beam)) continue;
+		if (!Beam->IsLightVisible()) continue; // Blacked out, nothing to occlude
+
+		const FVector Start = Beam->OcclusionDirection->GetComponentLocation();
+		const FVector Direction = Beam->OcclusionDirection->GetForwardVector();
+		if (Entry.bHasResult && Start.Equals(Entry.LastStart, OCCLUSION_MOVEMENT_LOCATION_TOLERANCE) && Direction.Equals(Entry.LastDirection, OCCLUSION_MOVEMENT_DIRECTION_TOLERANCE)) continue;
+
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(CPGDTFBeamOcclusion), false, Entry.Fixture.Get());
+		const FVector End = Start + Direction * Beam->LightDistanceMax;
+		Entry.PendingTrace = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, Params, FCollisionResponseParams::DefaultResponseParam, &this->TraceDelegate, Entry.Id);
+		Entry.LastStart = Start;
+		Entry.LastDirection = Direction;
+		Started++;
+	}
+}
+
+void UCPGDTFOcclusionSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum) {
+	const int32* Index = this->BeamsById.Find(Datum.UserData);
+	if (Index == nullptr) return; // The fixture has been unregistered in the meantime
+	FBeamEntry& Entry = this->Beams[*Index];
+	if (Entry.PendingTrace != Handle) return;
+	Entry.PendingTrace = FTraceHandle();
+	Entry.bHasResult = true;
+	UCPGDTFBeamSceneComponent* Beam = Entry.Beam.Get();
+	if (!IsValid(Beam)) return;
+
+	const FHitResult* Hit = Datum.OutHits.FindByPredicate([](const FHitResult& OutHit) { return OutHit.bBlockingHit; });
+	Beam->SetOcclusionDistance(Hit ? Hit->Distance : -1.0f);
+}
+
+#undef OCCLUSION_MOVEMENT_LOCATION_TOLERANCE
+#undef OCCLUSION_MOVEMENT_DIRECTION_TOLERANCE
@@ -27,10 +27,12 @@ SOFTWARE.
 #include "ClayPakyGDTFImporterLog.h"
 #include "Utils/CPGDTFImporterUtils.h"
 #include "Factories/CPGDTFRenderPipelineBuilder.h"
+#include "CPGDTFFixtureActor.h"
 
-#include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
 
+#define BEAM_LOD_MAX_QUALITY_LEVEL 4.0f //Biggest "DMX Quality Level", same as ECPGDTFFixtureQualityLevel::LowQuality
+
 UCPGDTFBeamSceneComponent::UCPGDTFBeamSceneComponent() {
 
 	PrimaryComponentTick.bCanEverTick = true;
@@ -45,6 +47,21 @@ UCPGDTFBeamSceneComponent::UCPGDTFBeamSceneComponent() {
 	this->LightCastShadow = false;
 }
 
+void UCPGDTFBeamSceneComponent::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) {
+	Super::AddReferencedObjects(InThis, Collector);
+	CastChecked<UCPGDTFBeamSceneComponent>(InThis)->MaterialParameters.AddReferencedObjects(Collector);
+}
+
+void UCPGDTFBeamSceneComponent::OnRegister() {
+	Super::OnRegister();
+	if (ACPGDTFFixtureActor* FixtureActor = Cast<ACPGDTFFixtureActor>(GetOwner())) FixtureActor->InvalidateTickSchedule();
+}
+
+void UCPGDTFBeamSceneComponent::OnUnregister() {
+	if (ACPGDTFFixtureActor* FixtureActor = Cast<ACPGDTFFixtureActor>(GetOwner())) FixtureActor->InvalidateTickSchedule();
+	Super::OnUnregister();
+}
+
 void UCPGDTFBeamSceneComponent::BeginPlay() {
 	
 	Super::BeginPlay();
@@ -56,6 +73,9 @@ void UCPGDTFBeamSceneComponent::BeginPlay() {
 		this->SpotLightMaterialInstanceR = this->SpotLightMaterialInstance;
 	}
 
+	ACPGDTFFixtureActor* FixtureActor = Cast<ACPGDTFFixtureActor>(this->GetOwner());
+	if (FixtureActor) this->LightMode = FixtureActor->BeamLightMode;
+
 	// Create dynamic materials if needed
 	if (!this->DynamicMaterialLens || !this->DynamicMaterialBeam || !this->DynamicMaterialSpotLightR || !this->DynamicMaterialSpotLightG || !this->DynamicMaterialSpotLightB || !this->DynamicMaterialPointLight) {
 
@@ -66,6 +86,10 @@ void UCPGDTFBeamSceneComponent::BeginPlay() {
 		this->DynamicMaterialSpotLightB = UMaterialInstanceDynamic::Create(this->SpotLightMaterialInstanceB, nullptr);
 		this->DynamicMaterialPointLight = UMaterialInstanceDynamic::Create(this->PointLightMaterialInstance, nullptr);
 	}
+	// The single spotlight renders the whole light function, not only one channel of it
+	if (this->IsSingleSpotlight() && this->SpotLightMaterialInstanceSingle && !this->SpotLight) {
+		this->DynamicMaterialSpotLightR = UMaterialInstanceDynamic::Create(this->SpotLightMaterialInstanceSingle, nullptr);
+	}
 
 	// Get lens width (support scaling)
 	if (this->LensStaticMeshComponent) this->LensRadius = this->LensStaticMeshComponent->Bounds.SphereRadius * 0.9f;
@@ -88,15 +112,49 @@ void UCPGDTFBeamSceneComponent::BeginPlay() {
 	if (this->SpotLightB) this->SpotLightB->SetMaterial(0, this->DynamicMaterialSpotLightB);
 	if (this->PointLight) this->PointLight->SetMaterial(0, this->DynamicMaterialPointLight);
 
-	//Apply mask
-	this->DynamicMaterialSpotLightR->SetVectorParameterValue("Spotlight RGB Mask", FVector4(1, 0, 0, 1));
-	this->DynamicMaterialSpotLightG->SetVectorParameterValue("Spotlight RGB Mask", FVector4(0, 1, 0, 1));
-	this->DynamicMaterialSpotLightB->SetVectorParameterValue("Spotlight RGB Mask", FVector4(0, 0, 1, 1));
-	//Set output color
-	if (this->SpotLightR) this->SpotLightR->SetLightColor(FLinearColor(1, 0, 0, 1));
-	if (this->SpotLightG) this->SpotLightG->SetLightColor(FLinearColor(0, 1, 0, 1));
-	if (this->SpotLightB) this->SpotLightB->SetLightColor(FLinearColor(0, 0, 1, 1));
+	if (this->IsSingleSpotlight()) {
+		//The light function is not masked, the color is given by the light itself (see SetLightColor)
+		this->DynamicMaterialSpotLightR->SetVectorParameterValue("Spotlight RGB Mask", FVector4(1, 1, 1, 1));
+		this->DynamicMaterialSpotLightR->SetVectorParameterValue("DMX Color", FLinearColor(1, 1, 1, 1));
+		if (this->SpotLightR) this->SpotLightR->SetLightColor(FLinearColor(1, 1, 1, 1));
+	} else {
+		//Apply mask
+		this->DynamicMaterialSpotLightR->SetVectorParameterValue("Spotlight RGB Mask", FVector4(1, 0, 0, 1));
+		this->DynamicMaterialSpotLightG->SetVectorParameterValue("Spotlight RGB Mask", FVector4(0, 1, 0, 1));
+		this->DynamicMaterialSpotLightB->SetVectorParameterValue("Spotlight RGB Mask", FVector4(0, 0, 1, 1));
+		//Set output color
+		if (this->SpotLightR) this->SpotLightR->SetLightColor(FLinearColor(1, 0, 0, 1));
+		if (this->SpotLightG) this->SpotLightG->SetLightColor(FLinearColor(0, 1, 0, 1));
+		if (this->SpotLightB) this->SpotLightB->SetLightColor(FLinearColor(0, 0, 1, 1));
+	}
 	if (this->SpotLight) this->SpotLight->SetLightColor(FLinearColor(1, 1, 1, 1));
+
+	this->ApplyLightMode();
+	this->UpdateLightVisibility(true);
+}
+
+void UCPGDTFBeamSceneComponent::ApplyLightMode() {
+	if (!this->IsSingleSpotlight()) return;
+
+	// Hidden lights are still added to the scene if registered, so we unregister them too
+	TArray<ULightComponent*, TInlineAllocator<3>> UnusedLights;
+	if (this->SpotLightG && this->SpotLightG != this->SpotLightR) UnusedLights.Add(this->SpotLightG);
+	if (this->SpotLightB && this->SpotLightB != this->SpotLightR) UnusedLights.Add(this->SpotLightB);
+	if (this->PointLight && this->LightMode == ECPGDTFBeamLightMode::SingleSpotlightOnly) UnusedLights.Add(this->PointLight);
+	for (ULightComponent* Light : UnusedLights) {
+		Light->SetVisibility(false);
+		if (Light->IsRegistered()) Light->UnregisterComponent();
+	}
+}
+
+int32 UCPGDTFBeamSceneComponent::GetActiveLightsNum() const {
+	int32 LightsNum = 0;
+	const ULightComponent* Lights[] = { this->SpotLightR, this->SpotLightG, this->SpotLightB, this->PointLight };
+	for (int32 i = 0; i < UE_ARRAY_COUNT(Lights); i++) {
+		if (Lights[i] == nullptr || (i > 0 && Lights[i] == Lights[0])) continue;
+		if (Lights[i]->IsRegistered() && Lights[i]->bAffectsWorld) LightsNum++;
+	}
+	return LightsNum;
 }
 
 // Called during Actor spawn to a specific world
@@ -142,13 +200,34 @@ void UCPGDTFBeamSceneComponent::OnConstruction() {
  * @param FixturePathOnContentBrowser Path of the fixture in Content Browser (ex: "/Game/MyMovingHead")
  * @return True if everything OK.
 */
+void UCPGDTFBeamSceneComponent::SetPipelineMaterialInstances(CPGDTFRenderPipelineBuilder& PipelineBuilder) {
+	this->Modify();
+	this->BeamMaterialInstance = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(PipelineBuilder.getMaterialInterfaceFilename(TEXT("Beam"), true)));
+	this->LensMaterialInstance = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(PipelineBuilder.getMaterialInterfaceFilename(TEXT("Lens"), true)));
+	UMaterialInstance* LightMaterialInstance = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(PipelineBuilder.getMaterialInterfaceFilename(TEXT("Light"), true)));
+	this->SpotLightMaterialInstanceR = LightMaterialInstance;
+	this->SpotLightMaterialInstanceG = LightMaterialInstance;
+	this->SpotLightMaterialInstanceB = LightMaterialInstance;
+	this->SpotLightMaterialInstanceSingle = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(PipelineBuilder.getMaterialInterfaceFilename(TEXT("LightSingle"), true)));
+
+	// BeginPlay creates them again when one of them is missing
+	this->DynamicMaterialBeam = nullptr;
+	this->DynamicMaterialLens = nullptr;
+	this->DynamicMaterialSpotLightR = nullptr;
+	this->DynamicMaterialSpotLightG = nullptr;
+	this->DynamicMaterialSpotLightB = nullptr;
+	if (this->BeamStaticMeshComponent) this->BeamStaticMeshComponent->SetMaterial(0, this->BeamMaterialInstance);
+	if (this->LensStaticMeshComponent) this->LensStaticMeshComponent->SetMaterial(0, this->LensMaterialInstance);
+}
+
 bool UCPGDTFBeamSceneComponent::PreConstruct(UCPGDTFDescriptionGeometryBeam* BeamDescription, FCPGDTFDescriptionModel* Model, FString FixturePathOnContentBrowser, UCPGDTFDescription* gdtfDescription, TArray<UActorComponent*> components, int selectedMode) {
 
 	UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Beam Scene Component pre construct called"));
 	// If the model provided is not the one referenced in the BeamDescription
 	if (Model != nullptr && !BeamDescription->Model.IsEqual(Model->Name)) return false;
 
-	CPGDTFRenderPipelineBuilder pipelineBuilder = CPGDTFRenderPipelineBuilder(gdtfDescription, selectedMode, components, FixturePathOnContentBrowser);
+	ACPGDTFFixtureActor* FixtureActor = Cast<ACPGDTFFixtureActor>(this->GetOwner());
+	CPGDTFRenderPipelineBuilder pipelineBuilder = CPGDTFRenderPipelineBuilder(gdtfDescription, selectedMode, components, FixturePathOnContentBrowser, FixtureActor ? FixtureActor->BeamKernelOptions : FCPGDTFBeamKernelOptions());
 	pipelineBuilder.buildLightRenderPipeline();
 
 	/* Unused GDTF values
@@ -220,6 +299,8 @@ bool UCPGDTFBeamSceneComponent::PreConstruct(UCPGDTFDescriptionGeometryBeam* Bea
 	this->SpotLightMaterialInstanceR = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(AssetPath));
 	this->SpotLightMaterialInstanceG = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(AssetPath));
 	this->SpotLightMaterialInstanceB = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(AssetPath));
+	AssetPath = pipelineBuilder.getMaterialInterfaceFilename(TEXT("LightSingle"), true);
+	this->SpotLightMaterialInstanceSingle = Cast<UMaterialInstance>(FCPGDTFImporterUtils::LoadObjectByPath(AssetPath));
 	this->DynamicMaterialSpotLightR = UMaterialInstanceDynamic::Create(this->SpotLightMaterialInstanceR, nullptr);
 	this->DynamicMaterialSpotLightG = UMaterialInstanceDynamic::Create(this->SpotLightMaterialInstanceG, nullptr);
 	this->DynamicMaterialSpotLightB = UMaterialInstanceDynamic::Create(this->SpotLightMaterialInstanceB, nullptr);
@@ -343,19 +424,27 @@ void UCPGDTFBeamSceneComponent::SetLightColorTemp(float NewLightColorTemp) {
 
 void UCPGDTFBeamSceneComponent::SetLightColor(FLinearColor NewLightColor) {
 
+	static const FName ColorParamName(TEXT("DMX Color"));
+
+	if (NewLightColor != this->VisibilityColor) {
+		this->VisibilityColor = NewLightColor;
+		this->bLightVisibilityDirty = true;
+	}
+
 	//this->SpotLightR->SetLightColor(NewLightColor);
 	//this->SpotLightG->SetLightColor(NewLightColor);
 	//this->SpotLightB->SetLightColor(NewLightColor);
 	this->PointLight->SetLightColor(NewLightColor);
-	if (this->DynamicMaterialBeam) this->DynamicMaterialBeam->SetVectorParameterValue("DMX Color", NewLightColor);
-	if (this->DynamicMaterialLens) this->DynamicMaterialLens->SetVectorParameterValue("DMX Color", NewLightColor);
+	uint32 Slots = FCPGDTFBeamParameterBlock::Beam | FCPGDTFBeamParameterBlock::Lens;
 	if (this->SpotLight) {
 		this->SpotLight->SetLightColor(NewLightColor);
+	} else if (this->IsSingleSpotlight()) {
+		// The light function is white, the single spotlight is colored directly
+		if (this->SpotLightR) this->SpotLightR->SetLightColor(NewLightColor);
 	} else {
-		if (this->DynamicMaterialSpotLightR) this->DynamicMaterialSpotLightR->SetVectorParameterValue("DMX Color", NewLightColor);
-		if (this->DynamicMaterialSpotLightG) this->DynamicMaterialSpotLightG->SetVectorParameterValue("DMX Color", NewLightColor);
-		if (this->DynamicMaterialSpotLightB) this->DynamicMaterialSpotLightB->SetVectorParameterValue("DMX Color", NewLightColor);
+		Slots |= FCPGDTFBeamParameterBlock::SpotLightR | FCPGDTFBeamParameterBlock::SpotLightG | FCPGDTFBeamParameterBlock::SpotLightB;
 	}
+	this->GetMaterialParameters().SetVector(ColorParamName, NewLightColor, Slots);
 }
 
 void UCPGDTFBeamSceneComponent::SetSpotlightLightIntensityScale(float NewSpotlightIntensityScale) {
@@ -380,25 +469,58 @@ void UCPGDTFBeamSceneComponent::SetPointlightIntensityScale(float NewPointlightI
 }
 
 void UCPGDTFBeamSceneComponent::ToggleLightVisibility() {
+	this->UpdateLightVisibility(true);
+}
 
-	if (!this->DynamicMaterialBeam->IsValidLowLevel()) return;
-
-	FHashedMaterialParameterInfo ParameterName = FHashedMaterialParameterInfo("DMX Dimmer");
-	float DimmerValue;
-	if (!this->DynamicMaterialBeam->GetScalarParameterValue(ParameterName, DimmerValue)) return;
+void UCPGDTFBeamSceneComponent::SetVisibilityDimmer(float Dimmer) {
+	if (Dimmer == this->VisibilityDimmer) return;
+	this->VisibilityDimmer = Dimmer;
+	this->bLightVisibilityDirty = true;
+}
 
-	FLinearColor LightColor = FLinearColor(0, 0, 0, 0);
-	if (this->SpotLightR) LightColor += this->SpotLightR->GetLightColor();
-	if (this->SpotLightG) LightColor += this->SpotLightG->GetLightColor();
-	if (this->SpotLightB) LightColor += this->SpotLightB->GetLightColor();
-	LightColor /= 3;
+void UCPGDTFBeamSceneComponent::SetVisibilityShutterOpen(float ShutterOpen) {
+	if (ShutterOpen == this->VisibilityShutterOpen) return;
+	this->VisibilityShutterOpen = ShutterOpen;
+	this->bLightVisibilityDirty = true;
+}
 
-	bool NewVisibility = LightColor != FLinearColor::Black && DimmerValue > 0.0f;
+void UCPGDTFBeamSceneComponent::UpdateLightVisibility(bool bForce) {
+	this->bLightVisibilityDirty = false;
+	this->bLightVisible = this->VisibilityColor != FLinearColor::Black && this->VisibilityDimmer > 0.0f && this->VisibilityShutterOpen > 0.0f;
+
+	const bool bSpotlightsVisible = this->bLightVisible && this->bLODSpotlights;
+	if (bSpotlightsVisible != this->bAppliedSpotlightsVisible || bForce) {
+		this->bAppliedSpotlightsVisible = bSpotlightsVisible;
+		if (this->SpotLightR) this->SpotLightR->SetVisibility(bSpotlightsVisible);
+		if (!this->IsSingleSpotlight()) {
+			if (this->SpotLightG) this->SpotLightG->SetVisibility(bSpotlightsVisible);
+			if (this->SpotLightB) this->SpotLightB->SetVisibility(bSpotlightsVisible);
+		}
+	}
+	// The pointlight was never switched by dimmer and color, only the LOD hides it
+	const bool bPointLightVisible = this->bLODPointLight && this->LightMode != ECPGDTFBeamLightMode::SingleSpotlightOnly;
+	if (bPointLightVisible != this->bAppliedPointLightVisible || bForce) {
+		this->bAppliedPointLightVisible = bPointLightVisible;
+		if (this->PointLight) this->PointLight->SetVisibility(bPointLightVisible);
+	}
+	const bool bBeamMeshVisible = this->bLightVisible && this->bLODBeamMesh;
+	if (bBeamMeshVisible != this->bAppliedBeamMeshVisible || bForce) {
+		this->bAppliedBeamMeshVisible = bBeamMeshVisible;
+		if (this->BeamStaticMeshComponent) this->BeamStaticMeshComponent->SetVisibility(bBeamMeshVisible);
+	}
+}
 
-	if (this->SpotLightR) this->SpotLightR->SetVisibility(NewVisibility);
-	if (this->SpotLightG) this->SpotLightG->SetVisibility(NewVisibility);
-	if (this->SpotLightB) this->SpotLightB->SetVisibility(NewVisibility);
-	if (this->BeamStaticMeshComponent) this->BeamStaticMeshComponent->SetVisibility(NewVisibility);
+void UCPGDTFBeamSceneComponent::SetLOD(ECPGDTFBeamLOD NewLOD, bool bSpotlights, bool bPointLight, bool bBeamMesh) {
+	if (NewLOD != this->LOD) {
+		this->LOD = NewLOD;
+		this->ApplyBeamQuality();
+	}
+	if (bSpotlights != this->bLODSpotlights || bPointLight != this->bLODPointLight || bBeamMesh != this->bLODBeamMesh) {
+		this->bLODSpotlights = bSpotlights;
+		this->bLODPointLight = bPointLight;
+		this->bLODBeamMesh = bBeamMesh;
+		this->bLightVisibilityDirty = true;
+	}
 }
 
 bool UCPGDTFBeamSceneComponent::IsMoving() {
@@ -408,18 +530,12 @@ bool UCPGDTFBeamSceneComponent::IsMoving() {
 	return isNearlyEqual;
 }
 
-void UCPGDTFBeamSceneComponent::CheckOcclusion() {
-
-	if (this->IsMoving()) {
-		FVector Start, End;
-		Start = this->OcclusionDirection->GetComponentLocation();
-		End = this->OcclusionDirection->GetForwardVector() * this->LightDistanceMax + Start;
-		FHitResult OutHit;
-
-		if (UKismetSystemLibrary::LineTraceSingle(this, Start, End, ETraceTypeQuery::TraceTypeQuery1, false, {}, EDrawDebugTrace::Type::None, OutHit, true, FLinearColor::Red, FLinearColor::Green, 10.0f))
-			this->DynamicMaterialBeam->SetScalarParameterValue(FName(""), FMath::Min(OutHit.Distance + 25.0f / this->LightDistanceMax, 1.0f));
-		else this->DynamicMaterialBeam->SetScalarParameterValue(FName(""), 1.0f);
-	}
+void UCPGDTFBeamSceneComponent::SetOcclusionDistance(float HitDistance) {
+	static const FName VisibilityRatioParamName(TEXT("DMX Beam Visibility Ratio"));
+	// The beam ends a bit after the obstacle, so it visibly touches it
+	const float Ratio = HitDistance < 0 || this->LightDistanceMax <= 0 ? 1.0f : FMath::Min((HitDistance + 25.0f) / this->LightDistanceMax, 1.0f);
+	this->GetMaterialParameters().SetScalar(VisibilityRatioParamName, Ratio, FCPGDTFBeamParameterBlock::Beam);
+	if (!this->HasBegunPlay()) this->FlushMaterialParameters();
 }
 
 #if WITH_EDITOR
@@ -468,6 +584,37 @@ void UCPGDTFBeamSceneComponent::UpdateProperties() {
 	this->SetLightDistanceMax(this->LightDistanceMax);
 }
 
+FCPGDTFBeamParameterBlock& UCPGDTFBeamSceneComponent::GetMaterialParameters() {
+	// Dynamic materials may be recreated (BeginPlay, PreConstruct), Bind() returns immediately if they didn't change
+	// With a single spotlight the G and B materials aren't rendered, so their slots aren't bound and the writes to them are skipped
+	const bool bSingle = this->IsSingleSpotlight();
+	UMaterialInstanceDynamic* const Slots[FCPGDTFBeamParameterBlock::SLOTS_NUM] = { this->DynamicMaterialBeam, this->DynamicMaterialLens, this->DynamicMaterialSpotLightR, bSingle ? nullptr : this->DynamicMaterialSpotLightG, bSingle ? nullptr : this->DynamicMaterialSpotLightB, this->DynamicMaterialPointLight };
+	this->MaterialParameters.Bind(Slots);
+	return this->MaterialParameters;
+}
+
+void UCPGDTFBeamSceneComponent::FlushMaterialParameters() {
+	if (this->MaterialParameters.IsDirty()) this->GetMaterialParameters().Flush();
+	if (this->bLightVisibilityDirty) this->UpdateLightVisibility();
+}
+
 void UCPGDTFBeamSceneComponent::SetBeamQuality(float Quality) {
-	if (this->DynamicMaterialBeam) this->DynamicMaterialBeam->SetScalarParameterValue("DMX Quality Level", Quality);
-}
\ No newline at end of file
+	this->BaseBeamQuality = Quality;
+	this->ApplyBeamQuality();
+}
+
+void UCPGDTFBeamSceneComponent::ApplyBeamQuality() {
+	static const FName QualityParamName(TEXT("DMX Quality Level"));
+
+	// The quality level scales the raymarch step size, so bigger values mean less steps
+	float Quality = this->BaseBeamQuality;
+	switch (this->LOD) {
+		case ECPGDTFBeamLOD::Reduced: Quality = FMath::Min(Quality * 2.0f, BEAM_LOD_MAX_QUALITY_LEVEL); break;
+		case ECPGDTFBeamLOD::Far: Quality = FMath::Max(Quality, BEAM_LOD_MAX_QUALITY_LEVEL); break;
+		default: break;
+	}
+	this->GetMaterialParameters().SetScalar(QualityParamName, Quality, FCPGDTFBeamParameterBlock::Beam);
+	if (!this->HasBegunPlay()) this->FlushMaterialParameters();
+}
+
+#undef BEAM_LOD_MAX_QUALITY_LEVEL
@@ -25,7 +25,17 @@ SOFTWARE.
 
 #include "Components/DMXComponents/CPGDTFColorSourceFixtureComponent.h"
 
-FCPDMXColorChannelData::FCPDMXColorChannelData(FDMXImportGDTFDMXChannel Channel, ECPGDTFAttributeType ColorAttribute_) : FCPDMXChannelData(Channel), ColorAttribute(ColorAttribute_){}
+FCPDMXColorChannelData::FCPDMXColorChannelData(FDMXImportGDTFDMXChannel Channel, ECPGDTFAttributeType ColorAttribute_) : FCPDMXChannelData(Channel), ColorAttribute(ColorAttribute_) {
+
+	for (const FDMXImportGDTFLogicalChannel& LogicalChannel : Channel.LogicalChannels) {
+		for (const FDMXImportGDTFChannelFunction& ChannelFunction : LogicalChannel.ChannelFunctions) {
+			if (!ChannelFunction.Emitter.Name.IsNone()) {
+				this->Emitter = ChannelFunction.Emitter.Name;
+				return;
+			}
+		}
+	}
+}
 
 
 void UCPGDTFColorSourceFixtureComponent::BeginPlay(int interpolationsNeededNo, float RealFade, float RealAcceleration, float rangeSize, float defaultValue) {
@@ -26,6 +26,7 @@ SOFTWARE.
 #include "Components/DMXComponents/CPGDTFFixtureComponentBase.h"
 #include "Library/DMXEntityFixturePatch.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "CPGDTFInterpolationSubsystem.h"
 
 UCPGDTFFixtureComponentBase::UCPGDTFFixtureComponentBase() {
 	PrimaryComponentTick.bCanEverTick = false;
@@ -34,10 +35,45 @@ UCPGDTFFixtureComponentBase::UCPGDTFFixtureComponentBase() {
 }
 
 void UCPGDTFFixtureComponentBase::DestroyComponent(bool bPromoteChildren) {
+	// Before lclDestroy() forgets the handles, otherwise the EndPlay() of Super::DestroyComponent() would have nothing to release
+	releaseInterpolations();
 	lclDestroy();
 	Super::DestroyComponent(bPromoteChildren);
 }
 
+void UCPGDTFFixtureComponentBase::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	releaseInterpolations();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCPGDTFFixtureComponentBase::OnRegister() {
+	Super::OnRegister();
+	if (ACPGDTFFixtureActor* ParentFixtureActor = GetParentFixtureActor()) ParentFixtureActor->InvalidateTickSchedule();
+}
+
+void UCPGDTFFixtureComponentBase::OnUnregister() {
+	if (ACPGDTFFixtureActor* ParentFixtureActor = GetParentFixtureActor()) ParentFixtureActor->InvalidateTickSchedule();
+	Super::OnUnregister();
+}
+
+void UCPGDTFFixtureComponentBase::releaseInterpolations() {
+	// The world's engine may already be gone when the component is destroyed by the garbage collector
+	const bool bEngineAlive = this->InterpolationEngine == this->OwnedInterpolationEngine.Get() || this->InterpolationSubsystem.IsValid();
+	if (this->InterpolationEngine != nullptr && bEngineAlive)
+		for (FCPGDTFInterpolationHandle& Handle : this->interpolations) this->InterpolationEngine->Release(Handle);
+	this->interpolations.Empty();
+	this->InterpolationEngine = nullptr;
+}
+
+FCPGDTFInterpolationEngine* UCPGDTFFixtureComponentBase::findInterpolationEngine() {
+	UWorld* World = GetWorld();
+	UCPGDTFInterpolationSubsystem* Subsystem = World ? World->GetSubsystem<UCPGDTFInterpolationSubsystem>() : nullptr;
+	this->InterpolationSubsystem = Subsystem;
+	if (Subsystem != nullptr) return Subsystem->GetEngine();
+	if (!this->OwnedInterpolationEngine.IsValid()) this->OwnedInterpolationEngine = MakeUnique<FCPGDTFInterpolationEngine>();
+	return this->OwnedInterpolationEngine.Get();
+}
+
 ACPGDTFFixtureActor* UCPGDTFFixtureComponentBase::GetParentFixtureActor() {
 	AActor* Parent = GetOwner();
 	if (Parent) {
@@ -79,43 +115,25 @@ bool UCPGDTFFixtureComponentBase::Setup(TArray<FDMXImportGDTFDMXChannel> DMXChan
 }
 
 inline void UCPGDTFFixtureComponentBase::setAllScalarParameters(UCPGDTFBeamSceneComponent* Beam, FName ParameterName, float value) {
-	if (Beam->DynamicMaterialBeam) Beam->DynamicMaterialBeam->SetScalarParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialLens) Beam->DynamicMaterialLens->SetScalarParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightR) Beam->DynamicMaterialSpotLightR->SetScalarParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightG) Beam->DynamicMaterialSpotLightG->SetScalarParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightB) Beam->DynamicMaterialSpotLightB->SetScalarParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialPointLight) Beam->DynamicMaterialPointLight->SetScalarParameterValue(ParameterName, value);
+	Beam->GetMaterialParameters().SetScalar(ParameterName, value);
+	if (!this->HasBegunPlay()) Beam->FlushMaterialParameters(); // Nobody is going to flush it for us
 }
 inline void UCPGDTFFixtureComponentBase::setAllVectorParameters(UCPGDTFBeamSceneComponent* Beam, FName ParameterName, const FVector& value) {
-	if (Beam->DynamicMaterialBeam) Beam->DynamicMaterialBeam->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialLens) Beam->DynamicMaterialLens->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightR) Beam->DynamicMaterialSpotLightR->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightG) Beam->DynamicMaterialSpotLightG->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightB) Beam->DynamicMaterialSpotLightB->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialPointLight) Beam->DynamicMaterialPointLight->SetVectorParameterValue(ParameterName, value);
+	Beam->GetMaterialParameters().SetVector(ParameterName, FLinearColor(value));
+	if (!this->HasBegunPlay()) Beam->FlushMaterialParameters();
 }
 inline void UCPGDTFFixtureComponentBase::setAllVectorParameters(UCPGDTFBeamSceneComponent* Beam, FName ParameterName, const FVector4& value) {
-	if (Beam->DynamicMaterialBeam) Beam->DynamicMaterialBeam->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialLens) Beam->DynamicMaterialLens->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightR) Beam->DynamicMaterialSpotLightR->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightG) Beam->DynamicMaterialSpotLightG->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightB) Beam->DynamicMaterialSpotLightB->SetVectorParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialPointLight) Beam->DynamicMaterialPointLight->SetVectorParameterValue(ParameterName, value);
+	Beam->GetMaterialParameters().SetVector(ParameterName, FLinearColor(value));
+	if (!this->HasBegunPlay()) Beam->FlushMaterialParameters();
 }
 inline void UCPGDTFFixtureComponentBase::setAllTextureParameters(UCPGDTFBeamSceneComponent* Beam, FName ParameterName, UTexture* value) {
-	if (Beam->DynamicMaterialBeam) Beam->DynamicMaterialBeam->SetTextureParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialLens) Beam->DynamicMaterialLens->SetTextureParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightR) Beam->DynamicMaterialSpotLightR->SetTextureParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightG) Beam->DynamicMaterialSpotLightG->SetTextureParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialSpotLightB) Beam->DynamicMaterialSpotLightB->SetTextureParameterValue(ParameterName, value);
-	if (Beam->DynamicMaterialPointLight) Beam->DynamicMaterialPointLight->SetTextureParameterValue(ParameterName, value);
+	Beam->GetMaterialParameters().SetTexture(ParameterName, value);
+	if (!this->HasBegunPlay()) Beam->FlushMaterialParameters();
 }
 
 void UCPGDTFFixtureComponentBase::BeginPlay(int interpolationsNeededNo, float RealFade, float RealAcceleration, float rangeSize, float defaultValue) {
 	initializeInterpolations(interpolationsNeededNo, RealFade, RealAcceleration, rangeSize, defaultValue);
-	for (int i = 0; i < this->channels.Num(); i++) 
-		if (this->channels[i].DMXChannelTree.IsEmpty())
-			this->channels[i].DMXChannelTree.Insert(this->channels[i].GDTFDMXChannelDescription.LogicalChannels[0], this->channels[i].GDTFDMXChannelDescription.Offset.Num());
+	compileChannelTrees();
 	Super::BeginPlay();
 }
 void UCPGDTFFixtureComponentBase::BeginPlay(int interpolationsNeededNo, float RealFade, float RealAcceleration, float maxValue, float minValue, float defaultValue) {
@@ -123,6 +141,7 @@ void UCPGDTFFixtureComponentBase::BeginPlay(int interpolationsNeededNo, float Re
 }
 void UCPGDTFFixtureComponentBase::BeginPlay(TArray<FCPDMXChannelData> interpolationValues) {
 	initializeInterpolations(interpolationValues);
+	compileChannelTrees();
 	Super::BeginPlay();
 }
 void UCPGDTFFixtureComponentBase::BeginPlay(TSet<ECPGDTFAttributeType> mainAttributesGroup) {
@@ -148,24 +167,58 @@ void UCPGDTFFixtureComponentBase::BeginPlay() {
   /*******************************************/
  /*               DMX Related               */
 /*******************************************/
+
+void UCPGDTFFixtureComponentBase::compileChannelTrees() {
+	for (int i = 0; i < this->channels.Num(); i++) {
+		FCPComponentChannelData& channel = this->channels[i];
+		if (channel.DMXChannelTree.IsEmpty())
+			channel.DMXChannelTree.Insert(channel.GDTFDMXChannelDescription.LogicalChannels[0], channel.GDTFDMXChannelDescription.Offset.Num());
+		channel.DMXChannelTree.Compile();
+
+		channel.universeOffsets.Empty();
+		for (int32 Offset : channel.GDTFDMXChannelDescription.Offset) channel.universeOffsets.Add(Offset - 1);
+	}
+}
 	
 void UCPGDTFFixtureComponentBase::PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) {
-	if (this->bIsRawDMXEnabled) {
-		TMap<int32, int32> RawChannelsValues;
-		FixturePatch->GetRawChannelsValues(RawChannelsValues);
-		this->PushDMXRawValues(FixturePatch, RawChannelsValues);
+	ACPGDTFFixtureActor* Fixture = this->GetParentFixtureActor();
+	FCPDMXUniverseView UniverseView(FixturePatch, Fixture ? Fixture->GetCurrentDMXChannels() : TArrayView<const FDMXImportGDTFDMXChannel>());
+	this->PushDMXUniverseView(UniverseView);
+}
+
+void UCPGDTFFixtureComponentBase::PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) {
+	if (!this->bIsRawDMXEnabled || !UniverseView.IsValid()) return;
+
+	for (int i = 0; i < this->channels.Num(); i++) {
+		FCPComponentChannelData& ch = this->channels[i];
+		int32 DMXValue;
+		if (!UniverseView.GetValue(ch.universeOffsets, DMXValue)) continue;
+		if (DMXValue == ch.lastDMXValue || ch.DMXChannelTree.IsEmpty()) continue;
+		this->ApplyEffectToBeam(DMXValue, ch);
 	}
 }
 
+bool UCPGDTFFixtureComponentBase::GetUniverseByteRange(int32& OutFirst, int32& OutLast) const {
+	OutFirst = MAX_int32;
+	OutLast = INDEX_NONE;
+	for (const FCPComponentChannelData& ch : this->channels) {
+		for (int32 Offset : ch.universeOffsets) {
+			OutFirst = FMath::Min(OutFirst, Offset);
+			OutLast = FMath::Max(OutLast, Offset);
+		}
+	}
+	return OutLast != INDEX_NONE;
+}
+
 void UCPGDTFFixtureComponentBase::PushDMXRawValues(UDMXEntityFixturePatch* FixturePatch, const TMap<int32, int32>& RawValuesMap) {
 	for (int i = 0; i < this->channels.Num(); i++) {
-		FCPComponentChannelData ch = this->channels[i];
+		FCPComponentChannelData& ch = this->channels[i];
 		int32 addr = ch.address;
 		const int32* DMXValuePtr = RawValuesMap.Find(addr);
 		if (DMXValuePtr) {
 			int32 DMXValue = *DMXValuePtr;
 			if (ch.DMXChannelTree.IsEmpty()) continue;
-			this->ApplyEffectToBeam(DMXValue, this->channels[i]);
+			this->ApplyEffectToBeam(DMXValue, ch);
 		}
 	}
 }
@@ -174,14 +227,18 @@ void UCPGDTFFixtureComponentBase::ApplyEffectToBeam(int32 DMXValue, FCPComponent
 	if (DMXValue == channel.lastDMXValue) return; //Nothing changed so far
 	channel.lastDMXValue = DMXValue;
 
-	TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> DMXBehaviour = channel.DMXChannelTree.GetBehaviourByDMXValue(DMXValue);
+	// Single lookup in the precompiled table instead of walking the trees
+	const FDMXChannelBehaviour* CompiledBehaviour = channel.DMXChannelTree.FindBehaviour(DMXValue);
 	// If we are unable to find the behaviour in the tree we can't do anything
+	if (CompiledBehaviour == nullptr) return;
+	TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> DMXBehaviour = channel.DMXChannelTree.GetBehaviourPointers(*CompiledBehaviour);
 	if (DMXBehaviour.Key == nullptr || DMXBehaviour.Value == nullptr) return;
-	ECPGDTFAttributeType AttributeType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(DMXBehaviour.Key->Attribute.Name.ToString());
-	float PhysicalValue = UKismetMathLibrary::MapRangeClamped(DMXValue, DMXBehaviour.Value->DMXFrom.Value, DMXBehaviour.Value->DMXTo.Value, DMXBehaviour.Value->PhysicalFrom, DMXBehaviour.Value->PhysicalTo);
+	ECPGDTFAttributeType AttributeType = CompiledBehaviour->AttributeType;
+	float PhysicalValue = CompiledBehaviour->GetPhysicalValue(DMXValue);
 
 	this->ApplyEffectToBeam(DMXValue, channel, DMXBehaviour, AttributeType, PhysicalValue);
 	channel.RunningEffectTypeChannel = AttributeType;
+	channel.RunningEffectIndexChannel = CompiledBehaviour->AttributeIndex;
 }
 
   /****************************************************/
@@ -209,10 +266,11 @@ float UCPGDTFFixtureComponentBase::getFadeFromAccelAndRatio(float accel, float f
 }
 
 void UCPGDTFFixtureComponentBase::SetValueNoInterp(float value, int interpolationId, bool updateInterpObject) {
-	if (value == this->interpolations[interpolationId].lastValue) return;
-	this->interpolations[interpolationId].lastValue = value;
+	FChannelInterpolation& interpolation = this->interpolations[interpolationId].GetNoWake();
+	if (value == interpolation.lastValue) return;
+	interpolation.lastValue = value;
 	
-	if (updateInterpObject) this->interpolations[interpolationId].SetValueNoInterp(value);
+	if (updateInterpObject) this->interpolations[interpolationId]->SetValueNoInterp(value);
 	for (UCPGDTFBeamSceneComponent* component : AttachedBeams) {
 		if (component == nullptr) continue;
 		SetValueNoInterp_BeamInternal(component, value, interpolationId);
@@ -220,8 +278,8 @@ void UCPGDTFFixtureComponentBase::SetValueNoInterp(float value, int interpolatio
 };
 
 void UCPGDTFFixtureComponentBase::SetTargetValue(float value, int interpolationId) {
-	FChannelInterpolation *interpolation = &interpolations[interpolationId];
 	if (this->HasBegunPlay()) {
+		FChannelInterpolation *interpolation = interpolations[interpolationId].operator->();
 		if (this->bUseInterpolation && interpolation->bInterpolationEnabled) {
 			interpolation->setTargetValue(value);
 		} else {
@@ -231,10 +289,20 @@ void UCPGDTFFixtureComponentBase::SetTargetValue(float value, int interpolationI
 	}
 }
 
+float UCPGDTFFixtureComponentBase::GetInterpolationCurrentValue(int interpolationId) const {
+	if (!this->interpolations.IsValidIndex(interpolationId)) return 0;
+	return this->interpolations[interpolationId].Peek().getCurrentValue();
+}
+
+float UCPGDTFFixtureComponentBase::GetInterpolationTargetValue(int interpolationId) const {
+	if (!this->interpolations.IsValidIndex(interpolationId)) return 0;
+	return this->interpolations[interpolationId].Peek().getTargetValue();
+}
+
 void UCPGDTFFixtureComponentBase::updateInterpolation(float deltaSeconds, int interpolationId) {
-	FChannelInterpolation *interpolation = &interpolations[interpolationId];
-	interpolation->Update(deltaSeconds); // Update
-	this->SetValueNoInterp(interpolation->getCurrentValue(), interpolationId, false); //This will return immediately if value has not changed, calling this anyway it's not a huge performance loss
+	// The interpolation has already been updated by the engine, we only have to read it without waking it up
+	const FChannelInterpolation& interpolation = interpolations[interpolationId].Peek();
+	this->SetValueNoInterp(interpolation.getCurrentValue(), interpolationId, false); //This will return immediately if value has not changed, calling this anyway it's not a huge performance loss
 }
 
 void UCPGDTFFixtureComponentBase::initializeInterpolation(FChannelInterpolation& interpolation, float RealFade, float RealAcceleration, float range, float defaultValue, int interpolationId) {
@@ -247,28 +315,46 @@ void UCPGDTFFixtureComponentBase::initializeInterpolation(FChannelInterpolation&
 }
 
 void UCPGDTFFixtureComponentBase::initializeInterpolations(int interpolationsNeededNo, float RealFade, float RealAcceleration, float range, float defaultValue) {
-	interpolations.Empty();
+	releaseInterpolations();
+	this->InterpolationEngine = findInterpolationEngine();
 	for (int i = 0; i < interpolationsNeededNo; i++) {
 		FChannelInterpolation interpolation;
 		initializeInterpolation(interpolation, RealFade, RealAcceleration, range, defaultValue, i);
-		interpolations.Add(interpolation);
+		interpolations.Add(this->InterpolationEngine->Allocate(interpolation));
 	}
 }
 
 void UCPGDTFFixtureComponentBase::initializeInterpolations(TArray<FCPDMXChannelData> interpolationValues) {
-	interpolations.Empty();
+	releaseInterpolations();
+	this->InterpolationEngine = findInterpolationEngine();
 	for (int i = 0; i < interpolationValues.Num(); i++) {
 		FChannelInterpolation interpolation;
 		fixMissingAccelFadeValues(interpolationValues[i], i);
 		initializeInterpolation(interpolation, interpolationValues[i].interpolationFade, interpolationValues[i].interpolationAcceleration, FMath::Abs(interpolationValues[i].MaxValue - interpolationValues[i].MinValue), interpolationValues[i].DefaultValue, i);
-		interpolations.Add(interpolation);
+		interpolations.Add(this->InterpolationEngine->Allocate(interpolation));
 	}
 }
 
 void UCPGDTFFixtureComponentBase::InterpolateComponent(float deltaSeconds) {
+	if (this->AttachedBeams.Num() < 1) return;
+	// The running effects set their targets first, so they're consumed in this same frame
+	InterpolateComponent_PrePass(deltaSeconds);
+	AdvanceInterpolations(deltaSeconds);
+	InterpolateComponent_PostPass(deltaSeconds);
+}
+
+void UCPGDTFFixtureComponentBase::AdvanceInterpolations(float deltaSeconds) {
+	if (this->InterpolationEngine != nullptr) this->InterpolationEngine->AdvanceHandles(this->interpolations, deltaSeconds);
+}
+
+void UCPGDTFFixtureComponentBase::InterpolateComponent_PrePass(float deltaSeconds) {
 	if (this->AttachedBeams.Num() < 1) return;
 	for (int i = 0; i < this->channels.Num(); i++) 
 		InterpolateComponent_BeamInternal(deltaSeconds, this->channels[i]);
+}
+
+void UCPGDTFFixtureComponentBase::InterpolateComponent_PostPass(float deltaSeconds) {
+	if (this->AttachedBeams.Num() < 1) return;
 	for (int i = 0; i < this->interpolations.Num(); i++)
 		updateInterpolation(deltaSeconds, i);
 }
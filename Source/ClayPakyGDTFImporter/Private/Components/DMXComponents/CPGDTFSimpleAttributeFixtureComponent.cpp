@@ -62,5 +62,5 @@ void UCPGDTFSimpleAttributeFixtureComponent::SetTargetValue(float AbsoluteValue)
 }
 
 bool UCPGDTFSimpleAttributeFixtureComponent::IsTargetValid(float Target) {
-	return this->HasBegunPlay() ? this->interpolations[0].IsTargetValid(Target, SkipThreshold) : false;
+	return this->HasBegunPlay() ? this->interpolations[0].GetNoWake().IsTargetValid(Target, SkipThreshold) : false;
 }
\ No newline at end of file
@@ -43,6 +43,9 @@ bool UCPGDTFColorWheelFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChannel> D
 	TextureLoadPathFrosted.Append("/textures/" + SanitizedWheelName + "/Wheel_" + SanitizedWheelName + "_Frosted.Wheel_" + SanitizedWheelName + "_Frosted");
 	this->WheelTexture = Cast<UTexture2D>(FCPGDTFImporterUtils::LoadObjectByPath(TextureLoadPath));
 	this->WheelTextureFrosted = Cast<UTexture2D>(FCPGDTFImporterUtils::LoadObjectByPath(TextureLoadPathFrosted));
+	FString TextureArrayLoadPath = this->GetParentFixtureActor()->FixturePathInContentBrowser + "/textures/" + SanitizedWheelName + "/Wheel_" + SanitizedWheelName;
+	this->WheelTextureArray = Cast<UTexture>(FCPGDTFImporterUtils::LoadObjectByPath(TextureArrayLoadPath + "_Array.Wheel_" + SanitizedWheelName + "_Array"));
+	this->WheelTextureFrostedArray = Cast<UTexture>(FCPGDTFImporterUtils::LoadObjectByPath(TextureArrayLoadPath + "_Frosted_Array.Wheel_" + SanitizedWheelName + "_Frosted_Array"));
 	this->bUseInterpolation = true;
 	this->bIsRawDMXEnabled = true;
 
@@ -54,7 +57,7 @@ void UCPGDTFColorWheelFixtureComponent::BeginPlay() {
 	FCPDMXChannelData wheelData = *this->attributesData.getChannelData(ECPGDTFAttributeType::Color_n_WheelIndex);
 	fixMissingAccelFadeValues(wheelData, 0);
 	Super::BeginPlay(1, wheelData.interpolationFade, wheelData.interpolationAcceleration, this->WheelColors.Num(), 0);
-	this->interpolations[0].bSpeedCapEnabled = false;
+	this->interpolations[0]->bSpeedCapEnabled = false;
 
 	for (UCPGDTFBeamSceneComponent* Beam : this->AttachedBeams) {
 
@@ -66,6 +69,9 @@ void UCPGDTFColorWheelFixtureComponent::BeginPlay() {
 
 		setAllTextureParameters(Beam, diskName, this->WheelTexture);
 		setAllTextureParameters(Beam, diskFrostedName, this->WheelTextureFrosted);
+		// Only the beams built with the WheelTextureArrays kernel option have these parameters
+		if (this->WheelTextureArray) setAllTextureParameters(Beam, *CPGDTFRenderPipelineBuilder::getDiskArrayParamName(FCPGDTFWheelImporter::WheelType::Color, false, this->mAttributeIndexNo), this->WheelTextureArray);
+		if (this->WheelTextureFrostedArray) setAllTextureParameters(Beam, *CPGDTFRenderPipelineBuilder::getDiskArrayParamName(FCPGDTFWheelImporter::WheelType::Color, true, this->mAttributeIndexNo), this->WheelTextureFrostedArray);
 		setAllScalarParameters(Beam, numSlot, this->WheelColors.Num());
 		#ifdef ENABLE_OLD_RENDER
 			setAllTextureParameters(Beam, "DMX Color Disk", this->WheelTexture);
@@ -143,13 +149,13 @@ void UCPGDTFColorWheelFixtureComponent::ApplyEffectToBeam(int32 DMXValue, FCPCom
 		case ECPGDTFAttributeType::ColorMacro_n_: // Color Macro or virtual color wheel
 			this->ColorWheelPeriod = 0;
 			this->CurrentTime = 0;
-			this->interpolations[0].SetValueNoInterp(physicalValue + (float)DMXBehaviour.Value->WheelSlotIndex);
+			this->interpolations[0]->SetValueNoInterp(physicalValue + (float)DMXBehaviour.Value->WheelSlotIndex);
 			this->SetValueNoInterp_OverWrite(physicalValue + (float)DMXBehaviour.Value->WheelSlotIndex);
 			break;
 
 		case ECPGDTFAttributeType::Color_n_WheelSpin:
 			// We stop interpolation
-			this->interpolations[0].EndInterpolation(false);
+			this->interpolations[0]->EndInterpolation(false);
 
 			this->CurrentTime = 0;
 			if (physicalValue == 0) this->ColorWheelPeriod = 0;
@@ -158,7 +164,7 @@ void UCPGDTFColorWheelFixtureComponent::ApplyEffectToBeam(int32 DMXValue, FCPCom
 
 		case ECPGDTFAttributeType::Color_n_WheelRandom:
 			// We stop interpolation
-			this->interpolations[0].EndInterpolation(false);
+			this->interpolations[0]->EndInterpolation(false);
 
 			// Here the Physical value is a frenquency in Hz. If the GDTF use default physical values we fallback on default ones
 			if (DMXBehaviour.Value->PhysicalFrom == 0 && DMXBehaviour.Value->PhysicalTo == 1) this->ColorWheelPeriod = UKismetMathLibrary::MapRangeClamped(DMXValue, DMXBehaviour.Value->DMXFrom.Value, DMXBehaviour.Value->DMXTo.Value, 0.2, 5);
@@ -175,18 +181,18 @@ void UCPGDTFColorWheelFixtureComponent::InterpolateComponent_BeamInternal(float
 
 	switch (channel.RunningEffectTypeChannel) {
 		case ECPGDTFAttributeType::ColorMacro_n_:
-			SetValueNoInterp_OverWrite(this->interpolations[0].getCurrentValue());
+			SetValueNoInterp_OverWrite(this->interpolations[0].GetNoWake().getCurrentValue());
 			break;
 
 		case ECPGDTFAttributeType::Color_n_WheelSpin:
 			if (this->ColorWheelPeriod == 0) break;
 		
-			WheelIndex = (this->interpolations[0].getCurrentValue() + (this->WheelColors.Num()) * (deltaSeconds / this->ColorWheelPeriod));
+			WheelIndex = (this->interpolations[0].GetNoWake().getCurrentValue() + (this->WheelColors.Num()) * (deltaSeconds / this->ColorWheelPeriod));
 			WheelIndex = FMath::Fmod(WheelIndex, this->WheelColors.Num());
 			if(WheelIndex < 0)
 				WheelIndex += this->WheelColors.Num();
 			this->SetValueNoInterp(WheelIndex, 0);
-			this->interpolations[0].SetValueNoInterp(WheelIndex);
+			this->interpolations[0]->SetValueNoInterp(WheelIndex);
 			break;
 
 		case ECPGDTFAttributeType::Color_n_WheelRandom:
@@ -242,7 +248,7 @@ void UCPGDTFColorWheelFixtureComponent::SetValueNoInterp_OverWrite(float WheelIn
 	for (UCPGDTFBeamSceneComponent* Component : this->AttachedBeams) {
 		Component->ResetLightColorTemp();
 		Component->SetLightColor(FLinearColor(1, 1, 1)); // Set White base color
-		this->interpolations[0].lastValue = WheelIndex;
+		this->interpolations[0].GetNoWake().lastValue = WheelIndex;
 		SetValueNoInterp_BeamInternal(Component, WheelIndex, 0);
 		this->bIsMacroColor = true;
 	}
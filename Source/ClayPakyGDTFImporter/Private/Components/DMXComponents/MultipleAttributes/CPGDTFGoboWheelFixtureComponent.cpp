@@ -41,6 +41,12 @@ bool UCPGDTFGoboWheelFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChannel> DM
 	TextureLoadPathFrosted.Append("/textures/" + SanitizedWheelName + "/Wheel_" + SanitizedWheelName + "_Frosted.Wheel_" + SanitizedWheelName + "_Frosted");
 	this->WheelTexture = Cast<UTexture2D>(FCPGDTFImporterUtils::LoadObjectByPath(TextureLoadPath));
 	this->WheelTextureFrosted = Cast<UTexture2D>(FCPGDTFImporterUtils::LoadObjectByPath(TextureLoadPathFrosted));
+	FString TextureArrayLoadPath = this->GetParentFixtureActor()->FixturePathInContentBrowser + "/textures/" + SanitizedWheelName + "/Wheel_" + SanitizedWheelName;
+	this->WheelTextureArray = Cast<UTexture>(FCPGDTFImporterUtils::LoadObjectByPath(TextureArrayLoadPath + "_Array.Wheel_" + SanitizedWheelName + "_Array"));
+	this->WheelTextureFrostedArray = Cast<UTexture>(FCPGDTFImporterUtils::LoadObjectByPath(TextureArrayLoadPath + "_Frosted_Array.Wheel_" + SanitizedWheelName + "_Frosted_Array"));
+	// Only imported with 'Wheel Frost Levels' > 0, in place of the plain and frosted textures
+	this->WheelTextureFrostChain = Cast<UTexture>(FCPGDTFImporterUtils::LoadObjectByPath(TextureArrayLoadPath + "_FrostChain.Wheel_" + SanitizedWheelName + "_FrostChain"));
+	this->WheelTextureFrostChainArray = Cast<UTexture>(FCPGDTFImporterUtils::LoadObjectByPath(TextureArrayLoadPath + "_FrostChain_Array.Wheel_" + SanitizedWheelName + "_FrostChain_Array"));
 	this->NbrGobos = Wheel.Slots.Num();
 	this->bIsRawDMXEnabled = true;
 
@@ -59,8 +65,8 @@ void UCPGDTFGoboWheelFixtureComponent::BeginPlay() {
 	data.Add(goboRotData);
 	data.Add(wheelRotData);
 	Super::BeginPlay(data);
-	this->interpolations[InterpolationIds::WHEEL_ROTATION].bSpeedCapEnabled = false;
-	this->interpolations[InterpolationIds::GOBO_ROTATION].bSpeedCapEnabled = false;
+	this->interpolations[InterpolationIds::WHEEL_ROTATION]->bSpeedCapEnabled = false;
+	this->interpolations[InterpolationIds::GOBO_ROTATION]->bSpeedCapEnabled = false;
 
 	for (UCPGDTFBeamSceneComponent* Beam : this->AttachedBeams) {
 
@@ -72,12 +78,20 @@ void UCPGDTFGoboWheelFixtureComponent::BeginPlay() {
 
 		UE_LOG_CPGDTFIMPORTER(Display, TEXT("UCPGDTFGoboWheelFixtureComponent::BeginPlay: Got params names. Disk: '%s'\t Frosted: '%s'\t Num: '%s'"), *diskName.ToString(), *diskFrostedName.ToString(), *numSlot.ToString());
 
-		setAllTextureParameters(Beam, diskName, this->WheelTexture);
-		setAllTextureParameters(Beam, diskFrostedName, this->WheelTextureFrosted);
+		// Not imported with 'Wheel Frost Levels' > 0, the frost chain replaces them
+		if (this->WheelTexture) setAllTextureParameters(Beam, diskName, this->WheelTexture);
+		if (this->WheelTextureFrosted) setAllTextureParameters(Beam, diskFrostedName, this->WheelTextureFrosted);
+		// Only the beams built with the WheelTextureArrays kernel option have these parameters
+		if (this->WheelTextureArray) setAllTextureParameters(Beam, *CPGDTFRenderPipelineBuilder::getDiskArrayParamName(FCPGDTFWheelImporter::WheelType::Gobo, false, this->mAttributeIndexNo), this->WheelTextureArray);
+		if (this->WheelTextureFrostedArray) setAllTextureParameters(Beam, *CPGDTFRenderPipelineBuilder::getDiskArrayParamName(FCPGDTFWheelImporter::WheelType::Gobo, true, this->mAttributeIndexNo), this->WheelTextureFrostedArray);
+		// Only the pipelines built with the FrostMipChain kernel option have these parameters, on the beam, the lens and the light
+		if (this->WheelTextureFrostChain) setAllTextureParameters(Beam, *CPGDTFRenderPipelineBuilder::getDiskFrostChainParamName(FCPGDTFWheelImporter::WheelType::Gobo, this->mAttributeIndexNo, false), this->WheelTextureFrostChain);
+		if (this->WheelTextureFrostChainArray) setAllTextureParameters(Beam, *CPGDTFRenderPipelineBuilder::getDiskFrostChainParamName(FCPGDTFWheelImporter::WheelType::Gobo, this->mAttributeIndexNo, true), this->WheelTextureFrostChainArray);
 		setAllScalarParameters(Beam, numSlot, this->NbrGobos);
 		#ifdef ENABLE_OLD_RENDER //Keeping them for test old lights
-			setAllTextureParameters(Beam, "DMX Gobo Disk", this->WheelTexture);
-			setAllTextureParameters(Beam, "DMX Gobo Disk Frosted", this->WheelTextureFrosted);
+			// The mip 0 of the frost chain is the plain disk
+			setAllTextureParameters(Beam, "DMX Gobo Disk", this->WheelTexture ? this->WheelTexture : this->WheelTextureFrostChain);
+			if (this->WheelTextureFrosted) setAllTextureParameters(Beam, "DMX Gobo Disk Frosted", this->WheelTextureFrosted);
 			setAllScalarParameters(Beam, "DMX Gobo Num Mask", this->NbrGobos);
 		#endif
 	}
@@ -168,7 +182,7 @@ void UCPGDTFGoboWheelFixtureComponent::ApplyEffectToBeam(int32 DMXValue, FCPComp
 		case ECPGDTFAttributeType::Gobo_n_PosRotate: // Gobo rotation
 			if (this->channels.Num() < 2) this->SetTargetValue((float)DMXBehaviour.Value->WheelSlotIndex, InterpolationIds::WHEEL_ROTATION); // If there is only one channel set the Gobo
 			// We stop interpolation
-			this->interpolations[InterpolationIds::GOBO_ROTATION].EndInterpolation(false);
+			this->interpolations[InterpolationIds::GOBO_ROTATION]->EndInterpolation(false);
 
 			if (channel.RunningEffectTypeChannel != AttributeType) this->RotationCurrentTime = 0;
 			if (physicalValue == 0) this->GoboRotationPeriod = 0;
@@ -178,7 +192,7 @@ void UCPGDTFGoboWheelFixtureComponent::ApplyEffectToBeam(int32 DMXValue, FCPComp
 		case ECPGDTFAttributeType::Gobo_n_WheelSpin:
 		case ECPGDTFAttributeType::Gobo_n_SelectSpin: // Gobo wheel rotation
 			// We stop interpolation
-			this->interpolations[InterpolationIds::GOBO_ROTATION].EndInterpolation(false);
+			this->interpolations[InterpolationIds::GOBO_ROTATION]->EndInterpolation(false);
 
 			if (channel.RunningEffectTypeChannel != AttributeType) this->WheelCurrentTime = 0;
 			if (physicalValue == 0) this->GoboWheelPeriod = 0;
@@ -190,7 +204,7 @@ void UCPGDTFGoboWheelFixtureComponent::ApplyEffectToBeam(int32 DMXValue, FCPComp
 		case ECPGDTFAttributeType::Gobo_n_PosShake: // Gobo shake
 			//if (this->channels.Num() < 2) this->SetTargetValue((float)DMXBehaviour.Value->WheelSlotIndex, InterpolationIds::WHEEL_ROTATION); // If there is only one channel set the Gobo
 			// We stop interpolation
-			this->interpolations[InterpolationIds::GOBO_ROTATION].EndInterpolation(false);
+			this->interpolations[InterpolationIds::GOBO_ROTATION]->EndInterpolation(false);
 
 			if (channel.RunningEffectTypeChannel != AttributeType) this->WheelCurrentTime = 0;
 			if (physicalValue == 0) this->GoboWheelPeriod = 0;
@@ -217,7 +231,7 @@ void UCPGDTFGoboWheelFixtureComponent::InterpolateComponent_BeamInternal(float d
 
 			if (this->GoboRotationPeriod == 0) break;
 
-			WheelIndex = this->interpolations[InterpolationIds::GOBO_ROTATION].getCurrentValue() + 360.0f * (deltaSeconds / this->GoboRotationPeriod);
+			WheelIndex = this->interpolations[InterpolationIds::GOBO_ROTATION].GetNoWake().getCurrentValue() + 360.0f * (deltaSeconds / this->GoboRotationPeriod);
 			WheelIndex = FMath::Fmod(WheelIndex, 360);
 			if (WheelIndex < 0)
 				WheelIndex += 360;
@@ -229,7 +243,7 @@ void UCPGDTFGoboWheelFixtureComponent::InterpolateComponent_BeamInternal(float d
 
 			if (this->GoboWheelPeriod == 0) break;
 
-			WheelIndex = (this->interpolations[InterpolationIds::WHEEL_ROTATION].getCurrentValue() + this->NbrGobos * (deltaSeconds / this->GoboWheelPeriod));
+			WheelIndex = (this->interpolations[InterpolationIds::WHEEL_ROTATION].GetNoWake().getCurrentValue() + this->NbrGobos * (deltaSeconds / this->GoboWheelPeriod));
 			WheelIndex = FMath::Fmod(WheelIndex, this->NbrGobos);
 			if (WheelIndex < 0)
 				WheelIndex += this->NbrGobos;
@@ -136,7 +136,7 @@ void UCPGDTFMovementFixtureComponent::ApplyEffectToBeam(int32 DMXValue, FCPCompo
 					//Some fixtures have a switch to turn this feature (called shortcuts) on or off, but since it's not defined in GDTF I had
 					//to arbitrary choose what I should do globally. I ended up choosing always this path without first checking if the light is in the first
 					//180 degree of the rotation, so you will always get the same "deterministic" effect when you both stop the continuous rotation too early or too late
-					this->interpolations[type].offset(-360 * (*dir));
+					this->interpolations[type]->offset(-360 * (*dir));
 					this->SetTargetValue(value, type);
 					*dir = 0;
 				}
@@ -175,7 +175,7 @@ void UCPGDTFMovementFixtureComponent::InterpolateComponent_BeamInternal(float de
 	float val = pulseManager->InterpolatePulse(deltaSeconds);
 	bool loopback = pulseManager->hasLoopedBack();
 	//If we have looped, let's offset our value back of 360 degrees
-	if (loopback) this->interpolations[type].offset(-360 * dir);
+	if (loopback) this->interpolations[type]->offset(-360 * dir);
 	//We set the target value to a relative position from our "normal" value specified from the plain Pan/Tilt attribute
 	this->SetTargetValue(value + val * dir * 360, type);
 }
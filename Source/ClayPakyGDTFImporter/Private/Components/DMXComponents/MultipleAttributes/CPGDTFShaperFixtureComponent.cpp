@@ -74,7 +74,7 @@ bool UCPGDTFShaperFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChannel> DMXCh
 		for (int i = 0; i < ch.LogicalChannels.Num(); i++) {
 			for (int j = 0; j < ch.LogicalChannels[i].ChannelFunctions.Num(); j++) {
 				FDMXImportGDTFChannelFunction cf = ch.LogicalChannels[i].ChannelFunctions[j];
-				ECPGDTFAttributeType attrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(cf.Attribute.Name.ToString());
+				ECPGDTFAttributeType attrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(cf.Attribute.Name);
 
 				if (attrType == ECPGDTFAttributeType::Blade_n_Rot) {
 					abMode = false;
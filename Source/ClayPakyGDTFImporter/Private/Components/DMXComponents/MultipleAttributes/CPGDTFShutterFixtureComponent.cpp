@@ -45,8 +45,8 @@ void UCPGDTFShutterFixtureComponent::BeginPlay() {
 	intensityData.DefaultValue = 1;
 	data.Add(intensityData); //intensity
 	Super::BeginPlay(data);
-	interpolations[InterpolationIds::STROBE].bInterpolationEnabled = false;
-	interpolations[InterpolationIds::INTENSITY].bInterpolationEnabled = false;
+	interpolations[InterpolationIds::STROBE]->bInterpolationEnabled = false;
+	interpolations[InterpolationIds::INTENSITY]->bInterpolationEnabled = false;
 	this->SetValueNoInterp(0.0f, InterpolationIds::INTENSITY);
 	this->SetValueNoInterp(0.0f, InterpolationIds::STROBE);
 }
@@ -188,14 +188,17 @@ void UCPGDTFShutterFixtureComponent::InterpolateComponent_BeamInternal(float del
 }
 
 void UCPGDTFShutterFixtureComponent::SetValueNoInterp_BeamInternal(UCPGDTFBeamSceneComponent* Beam, float value, int interpolationId) {
+	static const FName StrobeFrequencyParamName(TEXT("DMX Strobe Frequency"));
+	static const FName StrobeOpenParamName(TEXT("DMX Strobe Open"));
 	InterpolationIds iid = (InterpolationIds)interpolationId;
 	switch (iid) {
 		case InterpolationIds::STROBE: {
-			setAllScalarParameters(Beam, "DMX Strobe Frequency", value);
+			setAllScalarParameters(Beam, StrobeFrequencyParamName, value);
 			break;
 		}
 		case InterpolationIds::INTENSITY: {
-			setAllScalarParameters(Beam, "DMX Strobe Open", value);
+			setAllScalarParameters(Beam, StrobeOpenParamName, value);
+			Beam->SetVisibilityShutterOpen(value);
 			break;
 		}
 	}
@@ -37,7 +37,7 @@ void UCPGDTFCTOFixtureComponent::BeginPlay() {
 	FCPDMXChannelData cd;
 	data.Add(cd);
 	Super::BeginPlay(data);
-	interpolations[0].bInterpolationEnabled = false;
+	interpolations[0]->bInterpolationEnabled = false;
 	this->bIsRawDMXEnabled = true; // Just to make sure
 	this->IsCTOEnabled = false;
 }
@@ -37,7 +37,7 @@ bool UCPGDTFAdditiveColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTFDMXC
 	
 	for (FDMXImportGDTFDMXChannel Channel : InputsAvailables) {
 		
-		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(Channel.LogicalChannels[0].Attribute.Name.ToString());
+		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(Channel.LogicalChannels[0].Attribute.Name);
 
 		switch (AttrType) {
 
@@ -94,25 +94,58 @@ bool UCPGDTFAdditiveColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTFDMXC
 			break;
 		}
 	}
+
+	// Spectral mixing only if every LED of the engine has a measured emitter, a partial mix would be worse than the fixed colors
+	ACPGDTFFixtureActor* FixtureActor = this->GetParentFixtureActor();
+	const UCPGDTFDescription* Description = FixtureActor ? FixtureActor->GDTFDescription : nullptr;
+	FVector3f FullPowerXYZ = FVector3f::ZeroVector;
+	this->bSpectralMixing = Description != nullptr;
+	// The emitters' XYZ are in candela only when their measurement gives the luminous intensity: they can't be mixed with the ones in the unit of the measured energies
+	bool bCandela = false, bEnergyUnit = false;
+	for (FCPDMXColorChannelData* DMXChannel : this->GetColorChannels()) {
+		if (!DMXChannel->IsAddressValid() || !this->bSpectralMixing) continue;
+		const FCPGDTFEmitterSpectrum* Spectrum = Description->FindEmitterSpectrum(DMXChannel->Emitter);
+		if (Spectrum == nullptr || !Spectrum->IsValid()) this->bSpectralMixing = false;
+		else {
+			DMXChannel->EmitterXYZ = Spectrum->XYZ;
+			FullPowerXYZ += Spectrum->XYZ;
+			(Spectrum->LuminousIntensity > 0 ? bCandela : bEnergyUnit) = true;
+		}
+	}
+	if (bCandela && bEnergyUnit) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("%s: some emitters are measured in candela and some aren't, the spectral mixing is disabled"), *this->GetName());
+		this->bSpectralMixing = false;
+	}
+	const FLinearColor FullPowerColor = FCPColorWizard::ColorXYZToLinearRGB(FullPowerXYZ);
+	this->SpectralNormalization = FMath::Max3(FullPowerColor.R, FullPowerColor.G, FullPowerColor.B);
+	this->bSpectralMixing &= this->SpectralNormalization > 0;
+
 	return true;
 }
 
-void UCPGDTFAdditiveColorSourceFixtureComponent::PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) {
+TArray<FCPDMXColorChannelData*, TFixedAllocator<16>> UCPGDTFAdditiveColorSourceFixtureComponent::GetColorChannels() {
+	return { &DMXChannelRed, &DMXChannelGreen, &DMXChannelBlue, &DMXChannelWhite,
+		&DMXChannelCyan, &DMXChannelMagenta, &DMXChannelYellow, &DMXChannelAmber,
+		&DMXChannelLime, &DMXChannelBlueGreen, &DMXChannelLightBlue, &DMXChannelPurple,
+		&DMXChannelPink, &DMXChannelWarmWhite, &DMXChannelCoolWhite, &DMXChannelUV };
+}
+
+void UCPGDTFAdditiveColorSourceFixtureComponent::PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) {
 
 	FCPColorWizard ColorWizard = FCPColorWizard();
 
 	// We use pointers here to reduce memory consumption
-	TArray<FCPDMXColorChannelData*> DMXChannels = { &DMXChannelRed, &DMXChannelGreen, &DMXChannelBlue, &DMXChannelWhite,
-		&DMXChannelCyan, &DMXChannelMagenta, &DMXChannelYellow, &DMXChannelAmber,
-		&DMXChannelLime, &DMXChannelBlueGreen, &DMXChannelLightBlue, &DMXChannelPurple,
-		&DMXChannelPink, &DMXChannelWarmWhite, &DMXChannelCoolWhite, &DMXChannelUV};
-
-	for (FCPDMXColorChannelData* DMXChannel : DMXChannels) {
+	for (FCPDMXColorChannelData* DMXChannel : this->GetColorChannels()) {
 
 		if (DMXChannel->IsAddressValid()) {
-			const float* TargetValuePtr = RawValuesMap.Map.Find(DMXChannel->address);
-			if (TargetValuePtr) {
-				const float RemappedValue = FMath::Max(0.0f, FMath::Min(1.0f, *TargetValuePtr));
+			float TargetValue;
+			if (UniverseView.GetNormalizedValue(DMXChannel->GetAddresses(), TargetValue)) {
+				const float RemappedValue = FMath::Max(0.0f, FMath::Min(1.0f, TargetValue));
+
+				if (this->bSpectralMixing) {
+					ColorWizard.AddEmitter(DMXChannel->EmitterXYZ, RemappedValue);
+					continue;
+				}
 
 				switch (DMXChannel->ColorAttribute) {
 
@@ -171,5 +204,5 @@ void UCPGDTFAdditiveColorSourceFixtureComponent::PushNormalizedRawValues(UDMXEnt
 		}
 	}
 
-	this->CurrentColor = ColorWizard.GetColor();
+	this->CurrentColor = this->bSpectralMixing ? ColorWizard.GetEmittersColor(this->SpectralNormalization) : ColorWizard.GetColor();
 }
\ No newline at end of file
@@ -38,7 +38,7 @@ bool UCPGDTFCIEColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChanne
 	
 	for (FDMXImportGDTFDMXChannel Channel : InputsAvailables) {
 		
-		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(Channel.LogicalChannels[0].Attribute.Name.ToString());
+		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(Channel.LogicalChannels[0].Attribute.Name);
 
 		switch (AttrType) {
 
@@ -59,18 +59,18 @@ bool UCPGDTFCIEColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChanne
 	return true;
 }
 
-void UCPGDTFCIEColorSourceFixtureComponent::PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) {
+void UCPGDTFCIEColorSourceFixtureComponent::PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) {
 
 	// We use pointers here to reduce memory consumption
-	TArray<FCPDMXColorChannelData*> DMXChannels = { &DMXChannelX, &DMXChannelY, &DMXChannelYY};
+	FCPDMXColorChannelData* DMXChannels[] = { &DMXChannelX, &DMXChannelY, &DMXChannelYY};
 	FDMXColorCIE CIEColor;
 
 	for (FCPDMXColorChannelData* DMXChannel : DMXChannels) {
 
 		if (DMXChannel->IsAddressValid()) {
-			const float* TargetValuePtr = RawValuesMap.Map.Find(DMXChannel->address);
-			if (TargetValuePtr) {
-				const float RemappedValue = FMath::Lerp(DMXChannel->MinValue, DMXChannel->MaxValue, *TargetValuePtr);
+			float TargetValue;
+			if (UniverseView.GetNormalizedValue(DMXChannel->GetAddresses(), TargetValue)) {
+				const float RemappedValue = FMath::Lerp(DMXChannel->MinValue, DMXChannel->MaxValue, TargetValue);
 
 				switch (DMXChannel->ColorAttribute) {
 
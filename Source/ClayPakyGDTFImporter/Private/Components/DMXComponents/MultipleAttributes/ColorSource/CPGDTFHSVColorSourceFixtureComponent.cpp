@@ -38,7 +38,7 @@ bool UCPGDTFHSVColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChanne
 	
 	for (FDMXImportGDTFDMXChannel Channel : InputsAvailables) {
 		
-		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(Channel.LogicalChannels[0].Attribute.Name.ToString());
+		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(Channel.LogicalChannels[0].Attribute.Name);
 
 		switch (AttrType) {
 
@@ -59,18 +59,18 @@ bool UCPGDTFHSVColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTFDMXChanne
 	return true;
 }
 
-void UCPGDTFHSVColorSourceFixtureComponent::PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) {
+void UCPGDTFHSVColorSourceFixtureComponent::PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) {
 
 	// We use pointers here to reduce memory consumption
-	TArray<FCPDMXColorChannelData*> DMXChannels = { &DMXChannelH, &DMXChannelS, &DMXChannelV};
+	FCPDMXColorChannelData* DMXChannels[] = { &DMXChannelH, &DMXChannelS, &DMXChannelV};
 	float H = 0, S = 0, V = 0;
 
 	for (FCPDMXColorChannelData* DMXChannel : DMXChannels) {
 
 		if (DMXChannel->IsAddressValid()) {
-			const float* TargetValuePtr = RawValuesMap.Map.Find(DMXChannel->address);
-			if (TargetValuePtr) {
-				const float RemappedValue = FMath::Lerp(DMXChannel->MinValue, DMXChannel->MaxValue, *TargetValuePtr);
+			float TargetValue;
+			if (UniverseView.GetNormalizedValue(DMXChannel->GetAddresses(), TargetValue)) {
+				const float RemappedValue = FMath::Lerp(DMXChannel->MinValue, DMXChannel->MaxValue, TargetValue);
 
 				switch (DMXChannel->ColorAttribute) {
 
@@ -37,7 +37,7 @@ bool UCPGDTFSubstractiveColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTF
 	
 	for (FDMXImportGDTFDMXChannel Channel : InputsAvailables) {
 		
-		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(Channel.LogicalChannels[0].Attribute.Name.ToString());
+		ECPGDTFAttributeType AttrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(Channel.LogicalChannels[0].Attribute.Name);
 
 		switch (AttrType) {
 
@@ -67,20 +67,20 @@ bool UCPGDTFSubstractiveColorSourceFixtureComponent::Setup(TArray<FDMXImportGDTF
 	return true;
 }
 
-void UCPGDTFSubstractiveColorSourceFixtureComponent::PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) {
+void UCPGDTFSubstractiveColorSourceFixtureComponent::PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) {
 
 	FLinearColor FilterColor = FLinearColor(0, 0, 0); // The filter color is the complementary one of the rendered one
 
 	// We use pointers here to reduce memory consumption
-	TArray<FCPDMXColorChannelData*> DMXChannels = { &DMXChannelRed, &DMXChannelGreen, &DMXChannelBlue,
+	FCPDMXColorChannelData* DMXChannels[] = { &DMXChannelRed, &DMXChannelGreen, &DMXChannelBlue,
 		&DMXChannelCyan, &DMXChannelMagenta, &DMXChannelYellow};
 
 	for (FCPDMXColorChannelData* DMXChannel : DMXChannels) {
 
 		if (DMXChannel->IsAddressValid()) {
-			const float* TargetValuePtr = RawValuesMap.Map.Find(DMXChannel->address);
-			if (TargetValuePtr) {
-				const float RemappedValue = FMath::Max(0.0f, FMath::Min(1.0f, *TargetValuePtr));
+			float TargetValue;
+			if (UniverseView.GetNormalizedValue(DMXChannel->GetAddresses(), TargetValue)) {
+				const float RemappedValue = FMath::Max(0.0f, FMath::Min(1.0f, TargetValue));
 
 				switch (DMXChannel->ColorAttribute) {
 
@@ -38,5 +38,7 @@ void UCPGDTFDimmerFixtureComponent::BeginPlay() {
 }
 
 void UCPGDTFDimmerFixtureComponent::SetValueNoInterp_BeamInternal(UCPGDTFBeamSceneComponent* Beam, float Intensity, int interpolationId) {
-	setAllScalarParameters(Beam, TEXT("DMX Dimmer"), Intensity);
+	static const FName DimmerParamName(TEXT("DMX Dimmer"));
+	setAllScalarParameters(Beam, DimmerParamName, Intensity);
+	Beam->SetVisibilityDimmer(Intensity);
 }
\ No newline at end of file
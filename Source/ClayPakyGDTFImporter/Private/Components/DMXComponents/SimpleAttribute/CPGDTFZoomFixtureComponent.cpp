@@ -40,7 +40,8 @@ void UCPGDTFZoomFixtureComponent::SetValueNoInterp_BeamInternal(UCPGDTFBeamScene
 
 	float HalfAngle = Angle / 2.0f; // / 2.0 because the angle in Unreal is between the center and the border of the beam
 	
-	setAllScalarParameters(Beam, "DMX Zoom", HalfAngle);
+	static const FName ZoomParamName(TEXT("DMX Zoom"));
+	setAllScalarParameters(Beam, ZoomParamName, HalfAngle);
 	if (Beam->SpotLightR) {
 		Beam->SpotLightR->SetOuterConeAngle(HalfAngle);
 		Beam->SpotLightR->SetInnerConeAngle(HalfAngle * 0.85f); /// TODO \todo Find something on GDTF to be more accurate
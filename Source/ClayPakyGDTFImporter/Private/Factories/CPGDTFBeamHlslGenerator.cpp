@@ -24,15 +24,26 @@ SOFTWARE.
 
 
 #include "Factories/CPGDTFBeamHlslGenerator.h"
+#include "ClayPakyGDTFImporterLog.h"
+#include "Misc/ScopeLock.h"
 
 #define TEMPLATE_PLACEHOLDER "/*__HLSL_GENERATE_PIPELINE__*/"
+//Placeholders of the raymarch kernel. When no kernel option is enabled they're replaced with the original code, so the output doesn't change
+#define KERNEL_FUNCTIONS_PLACEHOLDER "/*__HLSL_KERNEL_FUNCTIONS__*/"
+#define KERNEL_SCURVE_PLACEHOLDER "/*__HLSL_KERNEL_SCURVE__*/"
+#define KERNEL_SETUP_PLACEHOLDER "/*__HLSL_KERNEL_SETUP__*/"
+#define KERNEL_STEP_PLACEHOLDER "/*__HLSL_KERNEL_STEP__*/"
+#define KERNEL_CLIPPED_PLACEHOLDER "/*__HLSL_KERNEL_CLIPPED__*/"
+#define KERNEL_ACCUMULATE_PLACEHOLDER "/*__HLSL_KERNEL_ACCUMULATE__*/"
+
+#define KERNEL_EARLY_OUT_RATIO 0.01f //The march stops when the biggest possible contribution of the remaining steps is under this fraction of the accumulated one
 
 #define BASE_TEMPLATE "																						\n\
 struct FunctionsWrapper {																					\n\
 	float sCurve(float f){																					\n\
 		const float exp = -4;																				\n\
 		f = saturate(f);																					\n\
-		return 1 / (1 + pow((f / (1.125 - f)), exp));														\n\
+		return "KERNEL_SCURVE_PLACEHOLDER";																\n\
 	}																										\n\
 																											\n\
 	void rotateUV(float2 texCoor, float rads, out float x, out float y) {									\n\
@@ -88,6 +99,7 @@ struct FunctionsWrapper {																					\n\
 		float passed = y > eq;																				\n\
 		return mapLineValue(passed, d, frost, 1);															\n\
 	}																										\n\
+"KERNEL_FUNCTIONS_PLACEHOLDER"																				\n\
 };																											\n\
 																											\n\
 float traversalDepth = FDepth - NDepth;																		\n\
@@ -98,12 +110,12 @@ float Adj = AdjOpp.x;																						\n\
 float Opp = AdjOpp.y + ConeRadius;																			\n\
 																											\n\
 float3 cumul = 0;																							\n\
+"KERNEL_SETUP_PLACEHOLDER"																					\n\
 																											\n\
 for (uint i = 0; i < numSteps; i++) {																		\n\
 																											\n\
 	/* Position & depth at rayHit */																		\n\
-	float3 pos = NSlice + posOffset * i;																	\n\
-	float depth = NDepth + StepSize * i;																	\n\
+"KERNEL_STEP_PLACEHOLDER"																					\n\
 																											\n\
 	float dist = length(pos);																				\n\
 	float falloff = 1.0f - (dist / MaxDistance);															\n\
@@ -124,7 +136,7 @@ for (uint i = 0; i < numSteps; i++) {																		\n\
 																											\n\
 	/* Soft clipping with scene depth. */																	\n\
 	float dClip = saturate((ScDepth - depth) / SoftClipSize);												\n\
-	if(dClip == 0) continue;																				\n\
+	if(dClip == 0) "KERNEL_CLIPPED_PLACEHOLDER";															\n\
 																											\n\
 	/* UVs from pos */																						\n\
 	pos.xy = saturate(pos.xy + 0.5);																		\n\
@@ -143,11 +155,41 @@ for (uint i = 0; i < numSteps; i++) {																		\n\
 	float invsqr = 1.0f / (dist * dist);																	\n\
 																											\n\
 	/* Add to Result */																						\n\
-	cumul += (1.f / numSteps) * outputSample * dClip * invsqr * falloff;									\n\
+"KERNEL_ACCUMULATE_PLACEHOLDER"																				\n\
 }																											\n\
 return cumul;																								\n\
 "
 
+bool FCPGDTFBeamHlslDescriptor::operator==(const FCPGDTFBeamHlslDescriptor& Other) const {
+	for (int i = 0; i < FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE; i++)
+		if (this->WheelsNo[i] != Other.WheelsNo[i]) return false;
+	return this->bIris == Other.bIris && this->Blades == Other.Blades && this->KernelFlags == Other.KernelFlags;
+}
+
+uint32 GetTypeHash(const FCPGDTFBeamHlslDescriptor& Descriptor) {
+	uint32 hash = GetTypeHash(Descriptor.bIris);
+	for (int i = 0; i < FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE; i++)
+		hash = HashCombine(hash, GetTypeHash(Descriptor.WheelsNo[i]));
+	for (const TPair<int, bool>& blade : Descriptor.Blades)
+		hash = HashCombine(hash, HashCombine(GetTypeHash(blade.Key), GetTypeHash(blade.Value)));
+	return HashCombine(hash, GetTypeHash(Descriptor.KernelFlags));
+}
+
+FString FCPGDTFBeamHlslDescriptor::ToString() const {
+	FString str = FString::Printf(TEXT("C%dG%dA%dP%dE%d|I%d|B"),
+		this->WheelsNo[FCPGDTFWheelImporter::WheelType::Color], this->WheelsNo[FCPGDTFWheelImporter::WheelType::Gobo], this->WheelsNo[FCPGDTFWheelImporter::WheelType::Animation],
+		this->WheelsNo[FCPGDTFWheelImporter::WheelType::Prism], this->WheelsNo[FCPGDTFWheelImporter::WheelType::Effects], this->bIris ? 1 : 0);
+	for (int i = 0; i < this->Blades.Num(); i++)
+		str += FString::Printf(TEXT("%s%d%s"), i > 0 ? TEXT(",") : TEXT(""), this->Blades[i].Key, this->Blades[i].Value ? TEXT("ab") : TEXT("rot"));
+	if (this->KernelFlags != ECPGDTFBeamKernelFlags::None) str += FString::Printf(TEXT("|K%d"), this->KernelFlags);
+	return str;
+}
+
+namespace CPGDTFBeamHlslGeneratorCache {
+	static FCriticalSection Mutex;
+	static TMap<FCPGDTFBeamHlslDescriptor, FString> Codes;
+}
+
 /**
  * Generates the HLSL code for the custom expression block of the beam's pipeline
  *
@@ -155,11 +197,48 @@ return cumul;																								\n\
  * @date 09 january 2023
 */
 FString CPGDTFBeamHlslGenerator::generateCode() {
+	return generateCode(this->mDescriptor);
+}
+
+FString CPGDTFBeamHlslGenerator::generateCode(const FCPGDTFBeamHlslDescriptor& descriptor) {
+	using namespace CPGDTFBeamHlslGeneratorCache;
+	FScopeLock lock(&Mutex);
+	if (const FString* code = Codes.Find(descriptor)) return *code;
+
+	FString code = generateCodeUncached(descriptor);
+	Codes.Add(descriptor, code);
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFBeamHlslGenerator: generated variant %d '%s'"), Codes.Num(), *descriptor.ToString());
+	return code;
+}
+
+int32 CPGDTFBeamHlslGenerator::getCachedVariantsNum() {
+	using namespace CPGDTFBeamHlslGeneratorCache;
+	FScopeLock lock(&Mutex);
+	return Codes.Num();
+}
+
+void CPGDTFBeamHlslGenerator::emptyCache() {
+	using namespace CPGDTFBeamHlslGeneratorCache;
+	FScopeLock lock(&Mutex);
+	Codes.Empty();
+}
+
+FString CPGDTFBeamHlslGenerator::generateCodeUncached(const FCPGDTFBeamHlslDescriptor& descriptor) {
 	FString outputCode = TEXT(BASE_TEMPLATE);
 	FString placeholderCode = TEXT("");
 
+	const bool bAdaptiveSteps = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::AdaptiveSteps) != 0;
+	const bool bEarlyTermination = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::EarlyTermination) != 0;
+	const bool bHoistInvariants = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::HoistInvariants) != 0;
+	const bool bFastPow = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::FastPow) != 0;
+	const bool bJitteredLowSteps = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::JitteredLowSteps) != 0;
+	const bool bWheelTextureArrays = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::WheelTextureArrays) != 0;
+	const bool bFrostMipChain = (descriptor.KernelFlags & ECPGDTFBeamKernelFlags::FrostMipChain) != 0;
+	//Code placed before the raymarch loop (loop invariant values)
+	FString setupCode = TEXT("");
+
 	FString callText = TEXT("_fncs.{0}");
-	FString powText = FString::Printf(TEXT("pow(%s, 0.66)"), *callText);
+	FString powText = bFastPow ? FString::Printf(TEXT("_fncs.pow066(%s)"), *callText) : FString::Printf(TEXT("pow(%s, 0.66)"), *callText);
 
 	FString textAdd = FString::Printf(TEXT("\toutputSample = outputSample - 1 + %s;\n"), *powText); //outputSample = outputSample - (1 - FUNCTION)
 	/*
@@ -176,7 +255,7 @@ FString CPGDTFBeamHlslGenerator::generateCode() {
 
 	FString frostVarName = CPGDTFRenderPipelineBuilder::getInputFrostName();
 
-	if (mIrisEnabled) {
+	if (descriptor.bIris) {
 		FString irisName = CPGDTFRenderPipelineBuilder::getInputIrisName();
 		placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleIris(pos.xy, %s, %s)"), *irisName, *frostVarName) });
 	}
@@ -191,28 +270,49 @@ FString CPGDTFBeamHlslGenerator::generateCode() {
 		FCPGDTFWheelImporter::WheelType wheelType = (FCPGDTFWheelImporter::WheelType) i;
 		switch (i) {
 			case FCPGDTFWheelImporter::WheelType::Color: {
-				for (int j = 0; j < this->mWheelsNo[i]; j++) {
+				for (int j = 0; j < descriptor.WheelsNo[i]; j++) {
 					FString textureVarName = CPGDTFRenderPipelineBuilder::getInputTextureName(wheelType, false, j);
 					FString numSlotVarName = CPGDTFRenderPipelineBuilder::getInputNumSlotsName(wheelType, j);
 					FString indexVarName = CPGDTFRenderPipelineBuilder::getInputIndexName(wheelType, j);
 
-					placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleWheel(%s, %sSampler, pos.xy, %s, %s)"), *textureVarName, *textureVarName, *numSlotVarName, *indexVarName) });
+					if (bWheelTextureArrays) {
+						placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleWheelArray(%s, %sSampler, pos.xy, %s)"), *textureVarName, *textureVarName, *indexVarName) });
+					} else if (bHoistInvariants) {
+						setupCode += FString::Printf(TEXT("float2 %sST = float2(1 / %s, %s / %s);\n"), *textureVarName, *numSlotVarName, *indexVarName, *numSlotVarName);
+						placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleWheelST(%s, %sSampler, pos.xy, %sST)"), *textureVarName, *textureVarName, *textureVarName) });
+					} else placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleWheel(%s, %sSampler, pos.xy, %s, %s)"), *textureVarName, *textureVarName, *numSlotVarName, *indexVarName) });
 				}
 				break;
 			}
 			case FCPGDTFWheelImporter::WheelType::Gobo: {
-				for (int j = 0; j < this->mWheelsNo[i]; j++) {
-					FString textureVarName = CPGDTFRenderPipelineBuilder::getInputTextureName(wheelType, true, j);
+				for (int j = 0; j < descriptor.WheelsNo[i]; j++) {
+					FString textureVarName = CPGDTFRenderPipelineBuilder::getInputTextureName(wheelType, !bFrostMipChain, j);
 					FString numSlotVarName = CPGDTFRenderPipelineBuilder::getInputNumSlotsName(wheelType, j);
 					FString indexVarName = CPGDTFRenderPipelineBuilder::getInputIndexName(wheelType, j);
+					FString lodText = TEXT("0");
+					if (bFrostMipChain) { //Mip 1 is the former frosted texture, the frost value moves up to the last (most frosted) mip
+						FString dimensionsText = bWheelTextureArrays ? TEXT("{0}W, {0}H, {0}Slices, {0}Levels") : TEXT("{0}W, {0}H, {0}Levels");
+						setupCode += FString::Format(*(TEXT("uint {0}W, {0}H, {0}Slices, {0}Levels;\n{0}.GetDimensions(0, ") + dimensionsText + TEXT(");\n")), { textureVarName });
+						setupCode += FString::Format(TEXT("float {0}Lod = min(1, {0}Levels - 1.0) + saturate({1}) * max({0}Levels - 2.0, 0);\n"), { textureVarName, frostVarName });
+						lodText = textureVarName + TEXT("Lod");
+					}
 					//TODO: Add gobo rotation part
-					placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheel(%s, %sSampler, pos.xy, %s, %s)"), *textureVarName, *textureVarName, *numSlotVarName, *indexVarName) });
+					if (bWheelTextureArrays) {
+						if (bFrostMipChain) placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheelArrayLevel(%s, %sSampler, pos.xy, %s, %s)"), *textureVarName, *textureVarName, *indexVarName, *lodText) });
+						else placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheelArray(%s, %sSampler, pos.xy, %s)"), *textureVarName, *textureVarName, *indexVarName) });
+					} else if (bHoistInvariants) {
+						setupCode += FString::Printf(TEXT("float2 %sST = float2(1 / %s, %s / %s);\n"), *textureVarName, *numSlotVarName, *indexVarName, *numSlotVarName);
+						if (bFrostMipChain) placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheelSTLevel(%s, %sSampler, pos.xy, %sST, %s)"), *textureVarName, *textureVarName, *textureVarName, *lodText) });
+						else placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheelST(%s, %sSampler, pos.xy, %sST)"), *textureVarName, *textureVarName, *textureVarName) });
+					} else if (bFrostMipChain) {
+						placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheelLevel(%s, %sSampler, pos.xy, %s, %s, %s)"), *textureVarName, *textureVarName, *numSlotVarName, *indexVarName, *lodText) });
+					} else placeholderCode = placeholderCode + FString::Format(*textMul, { FString::Printf(TEXT("sampleWheel(%s, %sSampler, pos.xy, %s, %s)"), *textureVarName, *textureVarName, *numSlotVarName, *indexVarName) });
 					foundGobo = true;
 				}
 				break;
 			}
 			case FCPGDTFWheelImporter::WheelType::Animation: { //TODO Implement a real animation wheel
-				for (int j = 0; j < this->mWheelsNo[i]; j++) {
+				for (int j = 0; j < descriptor.WheelsNo[i]; j++) {
 					FString textureVarName = CPGDTFRenderPipelineBuilder::getInputTextureName(wheelType, true, j);
 					FString indexVarName = CPGDTFRenderPipelineBuilder::getInputIndexName(wheelType, j);
 					//placeholderCode = placeholderCode + FString::Printf(textMul, FString::Printf(TEXT("sampleWheel(%s, %sSampler, pos.xy, %s, %s)"), textureVarName, textureVarName, numSlotVarName, indexVarName));
@@ -227,26 +327,115 @@ FString CPGDTFBeamHlslGenerator::generateCode() {
 	}
 
 	if (!foundGobo) //Filter the beam shape anyway if there's no gobo present
-		placeholderCode = placeholderCode + TEXT("outputSample *= pow(TXTpGobo.SampleLevel(TXTpGoboSampler, pos.xy, 0).x, 0.66);");
+		placeholderCode = placeholderCode + (bFastPow ? TEXT("outputSample *= _fncs.pow066(TXTpGobo.SampleLevel(TXTpGoboSampler, pos.xy, 0).x);") : TEXT("outputSample *= pow(TXTpGobo.SampleLevel(TXTpGoboSampler, pos.xy, 0).x, 0.66);"));
 	
 	/*************************************
 	*               SHAPER               *
 	*************************************/
 
-	for (int i = 0; i < mShapers.Num(); i++) {
-		FString orientationVarName = CPGDTFRenderPipelineBuilder::getInputBladeOrientationName(mShapers[i]->getOrientation());
-		FString bRotVarName = CPGDTFRenderPipelineBuilder::getInputBladeABRotName(false, mShapers[i]->getOrientation());
-		FString aVarName = CPGDTFRenderPipelineBuilder::getInputBladeABRotName(true, mShapers[i]->getOrientation());
+	for (const TPair<int, bool>& blade : descriptor.Blades) {
+		FString orientationVarName = CPGDTFRenderPipelineBuilder::getInputBladeOrientationName(blade.Key);
+		FString bRotVarName = CPGDTFRenderPipelineBuilder::getInputBladeABRotName(false, blade.Key);
+		FString aVarName = CPGDTFRenderPipelineBuilder::getInputBladeABRotName(true, blade.Key);
 
-		if (mShapers[i]->isInAbMode()) { //a+b mode
-			placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleBladeAB(pos.xy, %s, %s, %s, %s)"), *aVarName, *bRotVarName, *orientationVarName, *frostVarName) });
+		if (bHoistInvariants) { //cos and sin of the orientation are computed once
+			setupCode += FString::Printf(TEXT("float2 %sCS = float2(cos(%s), sin(%s));\n"), *orientationVarName, *orientationVarName, *orientationVarName);
+			orientationVarName += TEXT("CS");
+		}
+		const TCHAR* suffix = bHoistInvariants ? TEXT("CS") : TEXT("");
+
+		if (blade.Value) { //a+b mode
+			placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleBladeAB%s(pos.xy, %s, %s, %s, %s)"), suffix, *aVarName, *bRotVarName, *orientationVarName, *frostVarName) });
 		} else { //a + rot mode
-			placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleBladeARot(pos.xy, %s, %s, %s, %s)"), *aVarName, *bRotVarName, *orientationVarName, *frostVarName) });
+			placeholderCode = placeholderCode + FString::Format(*textAdd, { FString::Printf(TEXT("sampleBladeARot%s(pos.xy, %s, %s, %s, %s)"), suffix, *aVarName, *bRotVarName, *orientationVarName, *frostVarName) });
 		}
 	}
 
+	/*************************************
+	*               KERNEL               *
+	*************************************/
+
+	FString functionsCode = TEXT("");
+	FString sCurveCode = TEXT("1 / (1 + pow((f / (1.125 - f)), exp))");
+	FString stepCode = TEXT("float3 pos = NSlice + posOffset * i;\nfloat depth = NDepth + StepSize * i;");
+	FString clippedCode = TEXT("continue");
+	FString weightCode = TEXT("(1.f / numSteps)");
+
+	if (bHoistInvariants) {
+		functionsCode += TEXT("float4 sampleWheelST(Texture2D txt, SamplerState txtSampler, float2 texCoor, float2 scaleOffset){\n");
+		functionsCode += TEXT("texCoor.x = texCoor.x * scaleOffset.x + scaleOffset.y;\n");
+		functionsCode += TEXT("return txt.SampleLevel(txtSampler, texCoor, 0);\n}\n");
+		functionsCode += TEXT("void rotateUVCS(float2 texCoor, float2 cs, out float x, out float y) {\n");
+		functionsCode += TEXT("x = cs.x * (texCoor.x - 0.5) + cs.y * (texCoor.y - 0.5) + 0.5;\n");
+		functionsCode += TEXT("y = cs.y * (texCoor.x - 0.5) - cs.x * (texCoor.y - 0.5) + 0.5;\n}\n");
+		functionsCode += TEXT("float sampleBladeABCS(float2 texCoor, float a, float b, float2 cs, float frost){\n");
+		functionsCode += TEXT("float x, y;\nrotateUVCS(texCoor, cs, x, y);\nfloat eq = (x * (b - a)) + a;\n");
+		functionsCode += TEXT("return mapLineValue(y > eq, abs(y - eq), frost, 1);\n}\n");
+		functionsCode += TEXT("float sampleBladeARotCS(float2 texCoor, float a, float rotRads, float2 cs, float frost){\n");
+		functionsCode += TEXT("float x, y;\nrotateUVCS(texCoor, cs, x, y);\nfloat eq = rotRads * x - (rotRads * 0.5) + a;\n");
+		functionsCode += TEXT("return mapLineValue(y > eq, abs(y - eq), frost, 1);\n}\n");
+	}
+
+	if (bWheelTextureArrays) { //Same scrolling as the strip (a fractional index shows two slots side by side), but each slot is sampled inside its own slice so its borders never filter the neighbour ones
+		functionsCode += TEXT("float4 sampleWheelArray(Texture2DArray txt, SamplerState txtSampler, float2 texCoor, float index){\n");
+		functionsCode += TEXT("float x = texCoor.x + index;\nfloat slice = floor(x);\n");
+		functionsCode += TEXT("return txt.SampleLevel(txtSampler, float3(x - slice, texCoor.y, slice), 0);\n}\n");
+	}
+
+	if (bFrostMipChain) { //Same as the other wheel samplers, on the mip chosen by the frost
+		if (bWheelTextureArrays) {
+			functionsCode += TEXT("float4 sampleWheelArrayLevel(Texture2DArray txt, SamplerState txtSampler, float2 texCoor, float index, float lod){\n");
+			functionsCode += TEXT("float x = texCoor.x + index;\nfloat slice = floor(x);\n");
+			functionsCode += TEXT("return txt.SampleLevel(txtSampler, float3(x - slice, texCoor.y, slice), lod);\n}\n");
+		} else if (bHoistInvariants) {
+			functionsCode += TEXT("float4 sampleWheelSTLevel(Texture2D txt, SamplerState txtSampler, float2 texCoor, float2 scaleOffset, float lod){\n");
+			functionsCode += TEXT("texCoor.x = texCoor.x * scaleOffset.x + scaleOffset.y;\n");
+			functionsCode += TEXT("return txt.SampleLevel(txtSampler, texCoor, lod);\n}\n");
+		} else {
+			functionsCode += TEXT("float4 sampleWheelLevel(Texture2D txt, SamplerState txtSampler, float2 texCoor, float nSlots, float index, float lod){\n");
+			functionsCode += TEXT("texCoor.x = texCoor.x / nSlots + index / nSlots;\n");
+			functionsCode += TEXT("return txt.SampleLevel(txtSampler, texCoor, lod);\n}\n");
+		}
+	}
+
+	if (bFastPow) { //pow(f, 0.66) ~= sqrt(f) * (0.717 + 0.283 * f), max error 0.027 in [0, 1]. The sCurve is rewritten without pow, same result
+		functionsCode += TEXT("float pow066(float f){ f = saturate(f); return sqrt(f) * (0.717 + 0.283 * f); }\n");
+		functionsCode += TEXT("float4 pow066(float4 f){ f = saturate(f); return sqrt(f) * (0.717 + 0.283 * f); }\n");
+		sCurveCode = TEXT("f * f * f * f / (f * f * f * f + (1.125 - f) * (1.125 - f) * (1.125 - f) * (1.125 - f))");
+	}
+
+	if (bJitteredLowSteps) { //Half the steps, starting from a per pixel and per frame interleaved gradient noise offset. The temporal AA/TSR accumulates the frames
+		setupCode += TEXT("numSteps = (numSteps + 1) / 2;\n");
+		setupCode += TEXT("float stepOffset = frac(52.9829189 * frac(dot(Parameters.SvPosition.xy + View.StateFrameIndexMod8 * float2(47, 17), float2(0.06711056, 0.00583715))));\n");
+	} else if (bAdaptiveSteps) setupCode += TEXT("float stepOffset = 0.5;\n");
+
+	if (bAdaptiveSteps) { //Quadratic distribution of the steps, denser on the lens side of the ray. Each step is weighted by the length of the segment it covers
+		setupCode += TEXT("float3 rayDir = FSlice - NSlice;\nbool lensAtFar = dot(FSlice, FSlice) < dot(NSlice, NSlice);\n");
+		stepCode = TEXT("float u = (i + stepOffset) / numSteps;\nfloat v = lensAtFar ? 1 - u : u;\nfloat t = lensAtFar ? 1 - v * v : v * v;\n");
+		stepCode += TEXT("float stepWeight = 2 * v / numSteps;\nfloat3 pos = NSlice + rayDir * t;\nfloat depth = NDepth + traversalDepth * t;");
+		weightCode = TEXT("stepWeight");
+	} else if (bJitteredLowSteps) {
+		setupCode += TEXT("float3 rayDir = FSlice - NSlice;\n");
+		stepCode = TEXT("float t = (i + stepOffset) / numSteps;\nfloat3 pos = NSlice + rayDir * t;\nfloat depth = NDepth + traversalDepth * t;");
+	}
+
+	FString accumulateCode = FString::Printf(TEXT("cumul += %s * outputSample * dClip * invsqr * falloff;"), *weightCode);
+	if (bEarlyTermination) {
+		//The scene depth only grows along the ray, so once it clips a step it clips all the next ones
+		clippedCode = TEXT("break");
+		//When the ray moves away from the lens the inverse square and the linear falloff only decrease, so we can bound what's left to accumulate
+		setupCode += FString::Printf(TEXT("bool movingAway = dot(NSlice, FSlice - NSlice) >= 0;\nfloat maxStepWeight = %s / numSteps;\n"), bAdaptiveSteps ? TEXT("2.f") : TEXT("1.f"));
+		accumulateCode += FString::Printf(TEXT("\nif (movingAway && (numSteps - i - 1) * maxStepWeight * invsqr * falloff < %f * max(cumul.x, max(cumul.y, cumul.z))) break;"), KERNEL_EARLY_OUT_RATIO);
+	}
+
 	FString from = TEXT(TEMPLATE_PLACEHOLDER); //idk why I can't use it directly
 	outputCode = outputCode.Replace(*from, *placeholderCode, ESearchCase::CaseSensitive);
+	outputCode = outputCode.Replace(TEXT(KERNEL_FUNCTIONS_PLACEHOLDER), *functionsCode, ESearchCase::CaseSensitive);
+	outputCode = outputCode.Replace(TEXT(KERNEL_SCURVE_PLACEHOLDER), *sCurveCode, ESearchCase::CaseSensitive);
+	outputCode = outputCode.Replace(TEXT(KERNEL_SETUP_PLACEHOLDER), *setupCode, ESearchCase::CaseSensitive);
+	outputCode = outputCode.Replace(TEXT(KERNEL_STEP_PLACEHOLDER), *stepCode, ESearchCase::CaseSensitive);
+	outputCode = outputCode.Replace(TEXT(KERNEL_CLIPPED_PLACEHOLDER), *clippedCode, ESearchCase::CaseSensitive);
+	outputCode = outputCode.Replace(TEXT(KERNEL_ACCUMULATE_PLACEHOLDER), *accumulateCode, ESearchCase::CaseSensitive);
 
 	TArray<FString> lines;
 	outputCode.ParseIntoArray(lines, TEXT("\n"), false);
@@ -260,17 +449,29 @@ FString CPGDTFBeamHlslGenerator::generateCode() {
 
 void CPGDTFBeamHlslGenerator::setWheels(int* wheelsNo) {
 	for (int i = 0; i < FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE; i++)
-		this->mWheelsNo[i] = wheelsNo[i];
+		this->mDescriptor.WheelsNo[i] = wheelsNo[i];
 }
 void CPGDTFBeamHlslGenerator::setShapers(TArray<UCPGDTFShaperFixtureComponent*> shapers) {
-	this->mShapers = shapers;
+	this->mDescriptor.Blades.Empty(shapers.Num());
+	for (UCPGDTFShaperFixtureComponent* shaper : shapers)
+		this->mDescriptor.Blades.Add(TPair<int, bool>(shaper->getOrientation(), shaper->isInAbMode()));
 }
 void CPGDTFBeamHlslGenerator::setIris(bool irisEnabled) {
-	mIrisEnabled = irisEnabled;
+	this->mDescriptor.bIris = irisEnabled;
+}
+void CPGDTFBeamHlslGenerator::setKernelFlags(uint8 kernelFlags) {
+	this->mDescriptor.KernelFlags = kernelFlags;
 }
 
 CPGDTFBeamHlslGenerator::CPGDTFBeamHlslGenerator(){}
 CPGDTFBeamHlslGenerator::~CPGDTFBeamHlslGenerator(){}
 
 #undef TEMPLATE_PLACEHOLDER
+#undef KERNEL_FUNCTIONS_PLACEHOLDER
+#undef KERNEL_SCURVE_PLACEHOLDER
+#undef KERNEL_SETUP_PLACEHOLDER
+#undef KERNEL_STEP_PLACEHOLDER
+#undef KERNEL_CLIPPED_PLACEHOLDER
+#undef KERNEL_ACCUMULATE_PLACEHOLDER
+#undef KERNEL_EARLY_OUT_RATIO
 #undef BASE_TEMPLATE
\ No newline at end of file
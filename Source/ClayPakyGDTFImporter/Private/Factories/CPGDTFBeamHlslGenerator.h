@@ -28,18 +28,35 @@ SOFTWARE.
 #include "Factories/CPGDTFRenderPipelineBuilder.h"
 #include "Factories/Importers/Wheels/CPGDTFWheelImporter.h"
 
+/**
+ * Features of the beam's pipeline that change the generated HLSL code. <br>
+ * The generated code is a pure function of this descriptor: fixtures/modes with the same descriptor share the same code (and so the same shader)
+ */
+struct FCPGDTFBeamHlslDescriptor {
+	//Number of wheels per each WheelType
+	int WheelsNo[FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE] = {};
+	//If true the iris is included inside the code pipeline
+	bool bIris = false;
+	//One entry per shaper blade: its orientation and true if it's in a+b mode (false for a+rot mode)
+	TArray<TPair<int, bool>> Blades;
+	//Raymarch kernel optimizations (ECPGDTFBeamKernelFlags)
+	uint8 KernelFlags = ECPGDTFBeamKernelFlags::None;
+
+	bool operator==(const FCPGDTFBeamHlslDescriptor& Other) const;
+	friend uint32 GetTypeHash(const FCPGDTFBeamHlslDescriptor& Descriptor);
+
+	/// Short human readable form, used for logs (EG: "C1G2A0P0E0|I1|B1ab,2rot|K3")
+	FString ToString() const;
+};
+
 /**
  * Generates the HLSL code for the custom expression block of the beam's pipeline
  */
 class CPGDTFBeamHlslGenerator
 {
 private:
-	//Number of wheels per each WheelType
-	int mWheelsNo[FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE];
-	//Attached shaper blades
-	TArray<UCPGDTFShaperFixtureComponent*> mShapers;
-	//If true we should include the iris inside the code pipeline
-	bool mIrisEnabled;
+	//Features of the pipeline we're generating
+	FCPGDTFBeamHlslDescriptor mDescriptor;
 public:
 
 	/**
@@ -50,6 +67,31 @@ public:
 	*/
 	FString generateCode();
 
+	/**
+	 * Returns the HLSL code of the given descriptor, generating it only the first time the descriptor is seen. Thread safe
+	 *
+	 * @param descriptor Features of the pipeline
+	 * @return HLSL code for the custom expression block of the beam's pipeline
+	*/
+	static FString generateCode(const FCPGDTFBeamHlslDescriptor& descriptor);
+
+	/**
+	 * Generates the HLSL code of the given descriptor, without looking at the cache
+	 *
+	 * @param descriptor Features of the pipeline
+	 * @return HLSL code for the custom expression block of the beam's pipeline
+	*/
+	static FString generateCodeUncached(const FCPGDTFBeamHlslDescriptor& descriptor);
+
+	/// Number of different descriptors generated since the start (or the last emptyCache)
+	static int32 getCachedVariantsNum();
+	/// Forgets all the generated code
+	static void emptyCache();
+
+	FORCEINLINE const FCPGDTFBeamHlslDescriptor& getDescriptor() const {
+		return mDescriptor;
+	}
+
 	/**
 	 * @author Luca Sorace - Clay Paky S.R.L.
 	 * @date 09 january 2023 (Happy new year!)
@@ -59,6 +101,7 @@ public:
 	void setWheels(int* wheelsNo);
 	void setShapers(TArray<UCPGDTFShaperFixtureComponent*> shapers);
 	void setIris(bool irisEnabled);
+	void setKernelFlags(uint8 kernelFlags);
 
 
 	CPGDTFBeamHlslGenerator();
@@ -145,6 +145,9 @@ UObject* UCPGDTFFactory::FactoryCreateFile(UClass* InClass, UObject* InParent, F
 		ImportUI->bImportTextures = true;
 	}
 
+	// Opened once and shared by the description, wheels and 3D models importers until the end of the import
+	TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(InFilename);
+
 	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: UCPGDTFFactory::FactoryCreateFile CALLED - creating xlr"));
 	// Creation of the XML Importer object
 	FCPGDTFDescriptionImporter XMLImporter = FCPGDTFDescriptionImporter(InParent->GetPackage(), InName, Flags, InFilename);
@@ -195,7 +198,7 @@ UObject* UCPGDTFFactory::FactoryCreateFile(UClass* InClass, UObject* InParent, F
 
 	if (ImportUI->bImportTextures) { // Import textures Wheels to ContentBrowser
 
-		FCPGDTFWheelImporter WheelsImporter = FCPGDTFWheelImporter(InParent->GetPackage(), InFilename, XMLImporter.GetXML());
+		FCPGDTFWheelImporter WheelsImporter = FCPGDTFWheelImporter(InParent->GetPackage(), InFilename, XMLImporter.GetWheelSlotsMedia());
 		if (!WheelsImporter.Import()) { // If something happened on wheels import we notify the user
 
 			const FText Message = FText::Format(LOCTEXT("ImportFailed_Generic", "Error on '{0}' GDTF textures import.\nPlease see Output Log for details."), FText::FromString(InFilename));
@@ -204,14 +207,14 @@ UObject* UCPGDTFFactory::FactoryCreateFile(UClass* InClass, UObject* InParent, F
 		} else if (ImportUI->bImportXML) {
 
 			WheelsImporter.LinkTexturesToGDTFDescription(XMLDescription);
-			WheelsImporter.CreateGDTFWheelsTextures(XMLDescription, InParent->GetName());
+			WheelsImporter.CreateGDTFWheelsTextures(XMLDescription, InParent->GetName(), WheelsImporter.GetDecodedSlots(), ImportUI->bCreateWheelTextureArrays, ImportUI->WheelFrostLevels);
 		}
 	}
 
 	if (ImportUI->bImportModels) { // Import 3D models to Content Browser
 		try {
 
-			FCPGDTF3DModelsImporter ModelsImporter = FCPGDTF3DModelsImporter(InParent->GetPackage(), InFilename, XMLImporter.GetXML());
+			FCPGDTF3DModelsImporter ModelsImporter = FCPGDTF3DModelsImporter(InParent->GetPackage(), InFilename, XMLDescription, XMLImporter.GetDataVersion());
 			if (!ModelsImporter.Import()) { // If something appened on wheels import we notify the user
 
 				const FText Message = FText::Format(LOCTEXT("ImportFailed_Generic", "Error on '{0}' GDTF models import.\nPlease see Output Log for details."), FText::FromString(InFilename));
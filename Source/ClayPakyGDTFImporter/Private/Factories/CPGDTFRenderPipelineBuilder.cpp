@@ -27,6 +27,10 @@ SOFTWARE.
 
 #include "Factories/CPGDTFRenderPipelineBuilder.h"
 #include "Factories/CPGDTFBeamHlslGenerator.h"
+#include "Misc/SecureHash.h"
+#include "Engine/Texture2DArray.h"
+#include "UObject/Package.h"
+#include "IO/IoHash.h"
 
 #define FIND_DESCRIPTION_BASE "__RENDER_PIPELINE_BUILDER"
 #define FIND_DESCR_INPUT TEXT("__INPUT"  FIND_DESCRIPTION_BASE)
@@ -44,6 +48,10 @@ SOFTWARE.
 #define MATERIAL_TYPE_BEAM TEXT("Beam")
 #define MATERIAL_TYPE_LENS TEXT("Lens")
 #define MATERIAL_TYPE_LIGHT TEXT("Light")
+#define MATERIAL_TYPE_LIGHT_SINGLE TEXT("LightSingle")
+
+#define SHARED_PIPELINES_BASEPATH TEXT("/Game/ClayPakyGDTFShared/lightRenderingPipeline/") //Materials shared between all the fixtures/modes with the same pipeline hash
+#define PIPELINE_LAYOUT_VERSION 4 //Bump it each time this builder changes the expressions it generates, so the shared materials are generated again
 
 #define BEAM_EDITOR_STARTING_X -768
 #define BEAM_EDITOR_STARTING_Y 1200
@@ -71,32 +79,145 @@ SOFTWARE.
  * @param selectedMode Index of the current active dmx mode/profile
  * @param components Components attached to this light
  * @param fixturePathOnContentBrowser base path of the fixture in the content brower
+ * @param kernelOptions Optimizations of the beam raymarch kernel set on the actor. Any option stores the material instances in a Kernel<flags> subfolder of the mode
  */
-CPGDTFRenderPipelineBuilder::CPGDTFRenderPipelineBuilder(UCPGDTFDescription* gdtfDescription, int selectedMode, TArray<UActorComponent*> components, FString fixturePathOnContentBrowser) {
+CPGDTFRenderPipelineBuilder::CPGDTFRenderPipelineBuilder(UCPGDTFDescription* gdtfDescription, int selectedMode, TArray<UActorComponent*> components, FString fixturePathOnContentBrowser, FCPGDTFBeamKernelOptions kernelOptions) {
 	UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: Instancing"));
+	this->mKernelFlags = kernelOptions.GetFlags();
 	this->mSelectedMode = selectedMode;
 	this->mGdtfDescription = gdtfDescription;
 	this->mWheels = Cast<UDMXImportGDTFWheels>(gdtfDescription->Wheels)->Wheels;
 	this->mSanitizedName = UPackageTools::SanitizePackageName(Cast<UDMXImportGDTFFixtureType>(gdtfDescription->FixtureType)->Name.ToString());
 
 	if (fixturePathOnContentBrowser.EndsWith("/")) fixturePathOnContentBrowser.RemoveAt(fixturePathOnContentBrowser.Len() - 1);
-	fixturePathOnContentBrowser.Append("/lightRenderingPipeline/");
-	fixturePathOnContentBrowser.Append(FString::FromInt(selectedMode));
-	fixturePathOnContentBrowser.Append("/");
-	this->mBasePackagePath = fixturePathOnContentBrowser;
-	UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: name='%s', pathMaterial='%s'"), *this->mSanitizedName, *this->mBasePackagePath);
+	const FString fixturePath = fixturePathOnContentBrowser;
 
 	for (FDMXImportGDTFWheel wheel : this->mWheels) {
 		FCPGDTFWheelImporter::WheelType wType = FCPGDTFWheelImporter::GetWheelType(this->mGdtfDescription, wheel.Name, selectedMode);
 		this->mWheelsNo[wType]++;
 	}
 
+	//The texture arrays are created only by the imports with 'Create Wheel Texture Arrays', without them the beam would sample the default array
+	if ((this->mKernelFlags & ECPGDTFBeamKernelFlags::WheelTextureArrays) != 0 && !areWheelTexturesImported(fixturePath, false)) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: '%s' has been imported without 'Create Wheel Texture Arrays', the WheelTextureArrays kernel option is ignored"), *this->mSanitizedName);
+		this->mKernelFlags &= ~ECPGDTFBeamKernelFlags::WheelTextureArrays;
+	}
+	//The frost mip chain samples textures created only by the imports with 'Wheel Frost Levels' > 0, without them the beam would lose its frost
+	if ((this->mKernelFlags & ECPGDTFBeamKernelFlags::FrostMipChain) != 0 && !areWheelTexturesImported(fixturePath, true)) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: '%s' has been imported without 'Wheel Frost Levels', the FrostMipChain kernel option is ignored"), *this->mSanitizedName);
+		this->mKernelFlags &= ~ECPGDTFBeamKernelFlags::FrostMipChain;
+	}
+	//Those imports don't create the frosted textures anymore, so their gobos can only be frosted by the frost chain
+	if ((this->mKernelFlags & ECPGDTFBeamKernelFlags::FrostMipChain) == 0 && this->mWheelsNo[FCPGDTFWheelImporter::WheelType::Gobo] > 0 && areWheelTexturesImported(fixturePath, true)) {
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: '%s' has been imported with 'Wheel Frost Levels', the FrostMipChain kernel option is forced"), *this->mSanitizedName);
+		this->mKernelFlags |= ECPGDTFBeamKernelFlags::FrostMipChain;
+	}
+
+	fixturePathOnContentBrowser.Append("/lightRenderingPipeline/");
+	fixturePathOnContentBrowser.Append(FString::FromInt(selectedMode));
+	fixturePathOnContentBrowser.Append("/");
+	//The kernel options are set per actor: each combination gets its own material instances, so actors of the same fixture with different options don't re-parent each other's
+	if (this->mKernelFlags != ECPGDTFBeamKernelFlags::None) fixturePathOnContentBrowser.Append(FString::Printf(TEXT("Kernel%d/"), this->mKernelFlags));
+	this->mBasePackagePath = fixturePathOnContentBrowser;
+	UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: name='%s', pathMaterial='%s'"), *this->mSanitizedName, *this->mBasePackagePath);
+
 	for (int i = 0; i < components.Num(); i++) {
 		UCPGDTFShaperFixtureComponent *shaper = Cast<UCPGDTFShaperFixtureComponent>(components[i]);
 		if (shaper != nullptr) { shapers.Add(shaper); continue; }
 		UCPGDTFIrisFixtureComponent *iris = Cast<UCPGDTFIrisFixtureComponent>(components[i]);
 		if (iris) { hasIris = true; continue; }
 	}
+
+	//Generate custom hsls code with the correct features pipelined
+	CPGDTFBeamHlslGenerator beamHlslGenerator = CPGDTFBeamHlslGenerator();
+	beamHlslGenerator.setWheels(this->mWheelsNo);
+	beamHlslGenerator.setShapers(this->shapers);
+	beamHlslGenerator.setIris(this->hasIris);
+	beamHlslGenerator.setKernelFlags(this->mKernelFlags);
+	this->mBeamHlslCode = beamHlslGenerator.generateCode();
+
+	this->mPipelineHash = this->computePipelineHash();
+	this->mSharedPackagePath = FString(SHARED_PIPELINES_BASEPATH) + this->mPipelineHash + TEXT("/");
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: pipeline hash='%s', pathSharedMaterial='%s'"), *this->mPipelineHash, *this->mSharedPackagePath);
+}
+
+/**
+ * Generates the path of a master material cloned by cloneMaterialInterface
+ *
+ * @param materialType Beam|Lens|Light, with or without the leading '_'
+ * @return Object path of the master material (EG: CLAYPAKY_PLUGIN_CONTENT_BASEPATH/MaterialInstances/Master/M_Beam_Master.M_Beam_Master)
+*/
+FString CPGDTFRenderPipelineBuilder::getMasterMaterialPath(FString materialType) {
+	if (!materialType.StartsWith(TEXT("_"))) materialType = TEXT("_") + materialType;
+	FString masterMaterialPath = FCPGDTFImporterUtils::CLAYPAKY_PLUGIN_CONTENT_BASEPATH;
+	return masterMaterialPath + TEXT("MaterialInstances/Master/M") + materialType + TEXT("_Master.M") + materialType + TEXT("_Master");
+}
+
+/**
+ * Computes a hash of everything that shapes the generated materials: wheels, iris, shapers, the beam's HLSL code, the version of the expressions layout
+ * and the saved hash of the master materials (whose expressions are copied, unlike the material functions that are only referenced).
+ * Two fixtures/modes with the same hash generate the same materials, so they share them and only their material instances differ
+ *
+ * @return Hex string of the MD5 of the pipeline descriptor
+*/
+FString CPGDTFRenderPipelineBuilder::computePipelineHash() {
+	FString descriptor = FString::Printf(TEXT("layout=%d;iris=%d;wheels="), PIPELINE_LAYOUT_VERSION, this->hasIris ? 1 : 0);
+	for (int i = 0; i < FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE; i++) descriptor += FString::Printf(TEXT("%d,"), this->mWheelsNo[i]);
+	descriptor += TEXT(";shapers=");
+	for (UCPGDTFShaperFixtureComponent* shaper : this->shapers) descriptor += FString::Printf(TEXT("%d:%d,"), shaper->getOrientation(), shaper->isInAbMode() ? 1 : 0);
+	descriptor += TEXT(";masters=");
+	for (const TCHAR* materialType : { MATERIAL_TYPE_BEAM, MATERIAL_TYPE_LENS, MATERIAL_TYPE_LIGHT }) {
+		UObject* master = FCPGDTFImporterUtils::LoadObjectByPath(getMasterMaterialPath(materialType));
+		descriptor += (master ? LexToString(master->GetPackage()->GetSavedHash()) : FString(TEXT("missing"))) + TEXT(",");
+	}
+	descriptor += TEXT(";hlsl=") + this->mBeamHlslCode;
+	return FMD5::HashAnsiString(*descriptor);
+}
+
+/**
+ * Loads the one slice texture array used as default value of the wheels texture arrays parameters, creating it from defaultTexture the first time
+ *
+ * @param defaultTexture Texture of the slice
+ * @return The default texture array, or defaultTexture if the array can't be created
+*/
+UTexture* CPGDTFRenderPipelineBuilder::getDefaultWheelArrayTexture(UTexture2D* defaultTexture) {
+	const FString assetName = TEXT("T_DefaultWheelArray");
+	UTexture2DArray* defaultArray = Cast<UTexture2DArray>(FCPGDTFImporterUtils::IsAssetExisting(assetName, SHARED_PIPELINES_BASEPATH));
+	if (defaultArray) return defaultArray;
+	if (!defaultTexture) return nullptr;
+
+	UPackage* package = CreatePackage(*(FString(SHARED_PIPELINES_BASEPATH) + assetName));
+	defaultArray = NewObject<UTexture2DArray>(package, *assetName, RF_Public | RF_Standalone);
+	defaultArray->SourceTextures.Add(defaultTexture);
+	defaultArray->SRGB = defaultTexture->SRGB;
+	if (!defaultArray->UpdateSourceFromSourceTextures(true)) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: unable to create the default wheel texture array"));
+		return defaultTexture;
+	}
+	defaultArray->UpdateResource();
+	package->MarkPackageDirty();
+	FAssetRegistryModule::AssetCreated(defaultArray);
+	return defaultArray;
+}
+
+/**
+ * Checks that the wheel textures needed by a kernel option have been created by the import
+ *
+ * @param fixturePath Path of the fixture in the content browser
+ * @param frostChain If true checks the frost chains of the gobo wheels (in their array version with the WheelTextureArrays option), otherwise the texture arrays of the color and gobo wheels
+ * @return True if every wheel has its texture
+*/
+bool CPGDTFRenderPipelineBuilder::areWheelTexturesImported(const FString& fixturePath, bool frostChain) {
+	const bool bWheelTextureArrays = (this->mKernelFlags & ECPGDTFBeamKernelFlags::WheelTextureArrays) != 0;
+	for (const FDMXImportGDTFWheel& wheel : this->mWheels) {
+		FCPGDTFWheelImporter::WheelType wType = FCPGDTFWheelImporter::GetWheelType(this->mGdtfDescription, wheel.Name, this->mSelectedMode);
+		if (wType != FCPGDTFWheelImporter::WheelType::Gobo && (frostChain || wType != FCPGDTFWheelImporter::WheelType::Color)) continue;
+		const bool array = frostChain ? bWheelTextureArrays : true;
+		if (FCPGDTFImporterUtils::LoadObjectByPath(FCPGDTFWheelImporter::GetWheelTexturePath(fixturePath, wheel.Name, false, array, frostChain))) continue;
+		//The gobo wheels imported with the frost chain have its array instead of the plain one
+		if (frostChain || wType != FCPGDTFWheelImporter::WheelType::Gobo || !FCPGDTFImporterUtils::LoadObjectByPath(FCPGDTFWheelImporter::GetWheelTexturePath(fixturePath, wheel.Name, false, true, true))) return false;
+	}
+	return true;
 }
 
 CPGDTFRenderPipelineBuilder::~CPGDTFRenderPipelineBuilder() {}
@@ -109,54 +230,74 @@ CPGDTFRenderPipelineBuilder::~CPGDTFRenderPipelineBuilder() {}
  * @param materialType String with the name of the material (EG: in the material M_Beam_Master that string should be "Beam")
  * @param linkOutputFnc function to run to link outputs of the newly created material
  * @param middleCode function that should edit the newly created material, after it has been fully set up
+ * @param dstMaterialType Name used for the newly created material and material instance, if different from materialType (EG: a variant of the same master material)
  * @return true if everything went well :)
 */
-bool CPGDTFRenderPipelineBuilder::cloneMaterialInterface(FString materialType, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& linkOutputFnc, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode) {
+bool CPGDTFRenderPipelineBuilder::cloneMaterialInterface(FString materialType, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& linkOutputFnc, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode, FString dstMaterialType) {
 	FString errorMsg = "";
 	bool allOk = true;
 
 	materialType = TEXT("_") + materialType;
-	FString mName = getMaterialFilename(materialType, false);
-	FString miName = getMaterialInterfaceFilename(materialType, false);
+	dstMaterialType = dstMaterialType.IsEmpty() ? materialType : TEXT("_") + dstMaterialType;
+	FString mName = getMaterialFilename(dstMaterialType, false);
+	FString miName = getMaterialInterfaceFilename(dstMaterialType, false);
 
 	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Running cloneMaterialInterface with mName='%s'"), *mName);
 
-	//Create an empty destination material
-	UPackage* materialPackage = CreatePackage(*(this->mBasePackagePath + mName));
-	auto materialFactory = NewObject<UMaterialFactoryNew>();
-	UMaterial* dstMaterial = (UMaterial*)materialFactory->FactoryCreateNew(UMaterial::StaticClass(), materialPackage, *mName, RF_Standalone | RF_Public, NULL, GWarn);
-	UMaterialEditorOnlyData* dstMaterialData = dstMaterial->GetEditorOnlyData();
-
-	FAssetRegistryModule::AssetCreated(dstMaterial);
-	materialPackage->FullyLoad();
-	materialPackage->SetDirtyFlag(true);
-	dstMaterial->PreEditChange(NULL);
+	//Another fixture/mode with the same pipeline may have already generated this material
+	UMaterial* dstMaterial = Cast<UMaterial>(FCPGDTFImporterUtils::LoadObjectByPath(this->mSharedPackagePath + mName + TEXT(".") + mName));
+	if (dstMaterial) {
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Reusing shared material '%s'"), *mName);
+	} else {
+
+		//Create an empty destination material
+		UPackage* materialPackage = CreatePackage(*(this->mSharedPackagePath + mName));
+		auto materialFactory = NewObject<UMaterialFactoryNew>();
+		dstMaterial = (UMaterial*)materialFactory->FactoryCreateNew(UMaterial::StaticClass(), materialPackage, *mName, RF_Standalone | RF_Public, NULL, GWarn);
+		UMaterialEditorOnlyData* dstMaterialData = dstMaterial->GetEditorOnlyData();
+
+		FAssetRegistryModule::AssetCreated(dstMaterial);
+		materialPackage->FullyLoad();
+		materialPackage->SetDirtyFlag(true);
+		dstMaterial->PreEditChange(NULL);
+
+		//Loads the master/source material
+		FString masterMaterialPath = getMasterMaterialPath(materialType);
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Material path: '%s'"), *masterMaterialPath);
+		UMaterial* srcMaterial = Cast<UMaterial>(FCPGDTFImporterUtils::LoadObjectByPath(masterMaterialPath));
+
+		//Copy the material expression nodes
+		TArray<TObjectPtr<UMaterialExpression>> dstExpression;
+		TArray<TObjectPtr<UMaterialExpression>> dstExpressionComment;
+		TArray<TObjectPtr<UMaterialExpression>> srcExpression = srcMaterial->GetEditorOnlyData()->ExpressionCollection.Expressions;
+		TArray<TObjectPtr<UMaterialExpressionComment>> srcExpressionComment = srcMaterial->GetEditorOnlyData()->ExpressionCollection.EditorComments;
+		UMaterialExpression::CopyMaterialExpressions(srcExpression, srcExpressionComment, dstMaterial, nullptr, dstExpression, dstExpressionComment);
+		//Link the nodes to output
+		if(linkOutputFnc) allOk &= linkOutputFnc(dstMaterial, dstMaterialData, dstExpression);
+		//Update material propetries
+		copyUMaterialDetails(dstMaterial, srcMaterial);
+
+		//Run middle code
+		if(middleCode) allOk &= middleCode(dstMaterial, dstMaterialData, dstExpression);
+
+		//We need to run these anyway
+		dstMaterial->PostEditChange();
+		dstMaterial->MarkPackageDirty();
+		dstMaterial->GetOuter()->MarkPackageDirty();
+		FGlobalComponentReregisterContext recreateComponents; //Is this really useful?
+	}
 
-	//Loads the master/source material
-	FString masterMaterialPath = FCPGDTFImporterUtils::CLAYPAKY_PLUGIN_CONTENT_BASEPATH;
-	masterMaterialPath = masterMaterialPath + TEXT("MaterialInstances/Master/M") + materialType + TEXT("_Master.M") + materialType + TEXT("_Master");
-	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Material path: '%s'"), *masterMaterialPath);
-	UMaterial* srcMaterial = Cast<UMaterial>(FCPGDTFImporterUtils::LoadObjectByPath(masterMaterialPath));
-
-	//Copy the material expression nodes
-	TArray<TObjectPtr<UMaterialExpression>> dstExpression;
-	TArray<TObjectPtr<UMaterialExpression>> dstExpressionComment;
-	TArray<TObjectPtr<UMaterialExpression>> srcExpression = srcMaterial->GetEditorOnlyData()->ExpressionCollection.Expressions;
-	TArray<TObjectPtr<UMaterialExpressionComment>> srcExpressionComment = srcMaterial->GetEditorOnlyData()->ExpressionCollection.EditorComments;
-	UMaterialExpression::CopyMaterialExpressions(srcExpression, srcExpressionComment, dstMaterial, nullptr, dstExpression, dstExpressionComment);
-	//Link the nodes to output
-	if(linkOutputFnc) allOk &= linkOutputFnc(dstMaterial, dstMaterialData, dstExpression);
-	//Update material propetries
-	copyUMaterialDetails(dstMaterial, srcMaterial);
-
-	//Run middle code
-	if(middleCode) allOk &= middleCode(dstMaterial, dstMaterialData, dstExpression);
-
-	//We need to run these anyway
-	dstMaterial->PostEditChange();
-	dstMaterial->MarkPackageDirty();
-	dstMaterial->GetOuter()->MarkPackageDirty();
-	FGlobalComponentReregisterContext recreateComponents; //Is this really useful?
+	//The material instance is already there, we just have to point it to the (maybe different) shared material
+	UMaterialInstanceConstant* existingInstance = Cast<UMaterialInstanceConstant>(FCPGDTFImporterUtils::LoadObjectByPath(this->mBasePackagePath + miName + TEXT(".") + miName));
+	if (allOk && existingInstance) {
+		if (existingInstance->Parent != dstMaterial) {
+			existingInstance->PreEditChange(NULL);
+			existingInstance->Parent = dstMaterial;
+			existingInstance->PostEditChange();
+			existingInstance->MarkPackageDirty();
+		}
+		return true;
+	}
 
 	if (allOk) {
 		//Create a new empty material instance
@@ -209,14 +350,8 @@ bool CPGDTFRenderPipelineBuilder::buildBeamPipeline() {
 			if (meCustom) {
 				MeBlocksMover* meBlocksMover = new MeBlocksMover(BEAM_EDITOR_STARTING_X, BEAM_EDITOR_STARTING_Y, 0, true);
 
-				//Update the code of the custom block
-				//Generate custom hsls code with the correct features pipelined
-				CPGDTFBeamHlslGenerator beamHlslGenerator = CPGDTFBeamHlslGenerator();
-				beamHlslGenerator.setWheels(this->mWheelsNo);
-				beamHlslGenerator.setShapers(this->shapers);
-				beamHlslGenerator.setIris(this->hasIris);
-				FString finalCode = beamHlslGenerator.generateCode();
-				meCustom->Code = finalCode;
+				//Update the code of the custom block, generated in the constructor
+				meCustom->Code = this->mBeamHlslCode;
 
 				/*************************************
 				*               GENERAL              *
@@ -234,6 +369,10 @@ bool CPGDTFRenderPipelineBuilder::buildBeamPipeline() {
 				FString defaultTexturePath = FCPGDTFImporterUtils::CLAYPAKY_PLUGIN_CONTENT_BASEPATH;
 				defaultTexturePath += TEXT("MaterialInstances/Textures/T_Circle_01.T_Circle_01");
 				UTexture2D* defaultTexture = Cast<UTexture2D>(FCPGDTFImporterUtils::LoadObjectByPath(defaultTexturePath));
+				//With texture arrays the color/gobo wheels are sampled one slice per slot (see CPGDTFBeamHlslGenerator sampleWheelArray)
+				const bool bWheelTextureArrays = (this->mKernelFlags & ECPGDTFBeamKernelFlags::WheelTextureArrays) != 0;
+				UTexture* defaultArrayTexture = bWheelTextureArrays ? getDefaultWheelArrayTexture(defaultTexture) : nullptr;
+				const bool bFrostMipChain = (this->mKernelFlags & ECPGDTFBeamKernelFlags::FrostMipChain) != 0;
 				//Add parameters and inputs to the custom block
 				for (int i = 0; i < FCPGDTFWheelImporter::WheelType::WHEEL_TYPE_SIZE; i++) {
 					FCPGDTFWheelImporter::WheelType wheelType = (FCPGDTFWheelImporter::WheelType) i;
@@ -255,8 +394,14 @@ bool CPGDTFRenderPipelineBuilder::buildBeamPipeline() {
 						}
 
 						//Add texture parameter
+						//With the frost mip chain the gobos sample the frost from the mips of their frost chain texture (see CPGDTFBeamHlslGenerator)
+						if (wheelType == FCPGDTFWheelImporter::WheelType::Gobo && bFrostMipChain) {
+							addTextureInputToBeamPipeline(dstMaterial, getDiskFrostChainParamName(wheelType, j, bWheelTextureArrays), getInputTextureName(wheelType, false, j), meCustom, bWheelTextureArrays ? defaultArrayTexture : defaultTexture, meBlocksMover);
+							continue;
+						}
 						bool frosted = wheelType == FCPGDTFWheelImporter::WheelType::Gobo || wheelType == FCPGDTFWheelImporter::WheelType::Animation;
-						addTextureInputToBeamPipeline(dstMaterial, getDiskParamName(wheelType, frosted, j), getInputTextureName(wheelType, frosted, j), meCustom, defaultTexture, meBlocksMover);
+						if (bWheelTextureArrays) addTextureInputToBeamPipeline(dstMaterial, getDiskArrayParamName(wheelType, frosted, j), getInputTextureName(wheelType, frosted, j), meCustom, defaultArrayTexture, meBlocksMover);
+						else addTextureInputToBeamPipeline(dstMaterial, getDiskParamName(wheelType, frosted, j), getInputTextureName(wheelType, frosted, j), meCustom, defaultTexture, meBlocksMover);
 					}
 				}
 				
@@ -326,14 +471,19 @@ bool CPGDTFRenderPipelineBuilder::buildMaterialInstancePipeline() {
 	FString errorMsg = "";
 	bool allOk = true;
 
-	FString name = this->mSanitizedName + TEXT("_RenderPipeline");
-	FString mfName = TEXT("MF_") + name;
-	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Running buildMaterialInstancePipeline with mfName='%s' and basePath='%s'"), *mfName, *this->mBasePackagePath);
+	FString mfName = getRenderPipelineFunctionFilename();
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Running buildMaterialInstancePipeline with mfName='%s' and basePath='%s'"), *mfName, *this->mSharedPackagePath);
+
+	//Shared with the other fixtures/modes with the same pipeline
+	if (FCPGDTFImporterUtils::LoadObjectByPath(this->mSharedPackagePath + mfName + TEXT(".") + mfName)) {
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: Reusing shared material function '%s'"), *mfName);
+		return true;
+	}
 
 	MeBlocksMover* meModulesMover = new MeBlocksMover(0, 0, MI_EDITOR_MI_BLOCK_DISTANCE_X, false);
 	
 	//Creates an empty destination material function
-	UPackage* materialPackage = CreatePackage(*(this->mBasePackagePath + mfName));
+	UPackage* materialPackage = CreatePackage(*(this->mSharedPackagePath + mfName));
 	auto materialFactory = NewObject<UMaterialFunctionFactoryNew>();
 	UMaterialFunction* dstMaterial = (UMaterialFunction*)materialFactory->FactoryCreateNew(UMaterialFunction::StaticClass(), materialPackage, *mfName, RF_Standalone | RF_Public, NULL, GWarn);
 	UMaterialFunctionEditorOnlyData* dstMaterialData = dstMaterial->GetEditorOnlyData();
@@ -425,6 +575,11 @@ bool CPGDTFRenderPipelineBuilder::buildMaterialInstancePipeline() {
 				case FCPGDTFWheelImporter::WheelType::Animation:
 				{
 					if (wheelType == FCPGDTFWheelImporter::WheelType::Animation) break; //TODO Implement a real animation wheel
+					if (wheelType == FCPGDTFWheelImporter::WheelType::Gobo && (this->mKernelFlags & ECPGDTFBeamKernelFlags::FrostMipChain) != 0) {
+						previousParameter = addFrostChainWheelToMiPipeline(dstMaterial, wheelType, j, previousParameter, frostParam, defaultTexture, meParamsMover);
+						meModulesMover->moveMaterialExpression(previousParameter);
+						break;
+					}
 					//Creates a new material function call node
 					UMaterialExpressionMaterialFunctionCall* currentNode = generateMaterialExpression<UMaterialExpressionMaterialFunctionCall>(dstMaterial);
 					dstMaterialData->ExpressionCollection.AddExpression(currentNode);
@@ -556,10 +711,19 @@ bool CPGDTFRenderPipelineBuilder::linkLensPipeline(const std::function<bool(UMat
  * Clones the Light's material instance and changes the rendering function material to the one we've previously created in buildMaterialInstancePipeline()
  * @author Luca Sorace - Clay Paky S.R.L.
  * @date 20 december 2022
+ *
+ * @param middleCode function that links the rendering function material
+ * @param singleSpotlight if true builds the variant used by ECPGDTFBeamLightMode::SingleSpotlight: the whole light function is rendered by a single spotlight, so the RGB mask defaults to white
 */
-bool CPGDTFRenderPipelineBuilder::linkSpotlightPipeline(const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode) {
+bool CPGDTFRenderPipelineBuilder::linkSpotlightPipeline(const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode, bool singleSpotlight) {
 	return cloneMaterialInterface(MATERIAL_TYPE_LIGHT,
-		[](UMaterial* dstMaterial, UMaterialEditorOnlyData* dstMaterialData, TArray<TObjectPtr<UMaterialExpression>> dstExpression) {
+		[singleSpotlight](UMaterial* dstMaterial, UMaterialEditorOnlyData* dstMaterialData, TArray<TObjectPtr<UMaterialExpression>> dstExpression) {
+			if (singleSpotlight) {
+				for (UMaterialExpression* expression : dstExpression) {
+					UMaterialExpressionVectorParameter* meMask = Cast<UMaterialExpressionVectorParameter>(expression);
+					if (meMask && meMask->ParameterName == FName(TEXT("Spotlight RGB Mask"))) meMask->DefaultValue = FLinearColor(1, 1, 1, 1);
+				}
+			}
 			//Link the nodes to output
 			UMaterialExpressionMultiply* meEmissiveColor = searchMaterialExpressionByDesc<UMaterialExpressionMultiply>(dstExpression, FIND_DESCR_EMISSIVECOLOR);
 			if (meEmissiveColor) {
@@ -568,7 +732,8 @@ bool CPGDTFRenderPipelineBuilder::linkSpotlightPipeline(const std::function<bool
 			} else UE_LOG_CPGDTFIMPORTER(Warning, TEXT("CPGDTFRenderPipelineBuilder: linkSpotlightPipeline > FIND_DESCR_EMISSIVECOLOR not found\n"));
 			return false;
 		},
-		middleCode
+		middleCode,
+		singleSpotlight ? MATERIAL_TYPE_LIGHT_SINGLE : TEXT("")
 	);
 }
 
@@ -583,14 +748,13 @@ bool CPGDTFRenderPipelineBuilder::buildLightRenderPipeline() {
 	auto middleCode = [&](UMaterial* dstMaterial, UMaterialEditorOnlyData* dstMaterialData, TArray<TObjectPtr<UMaterialExpression>> dstExpression) {
 		UMaterialExpressionMultiply* meInput = searchMaterialExpressionByDesc<UMaterialExpressionMultiply>(dstExpression, FIND_DESCR_INPUT);
 		if (meInput) {
-			FString name = this->mSanitizedName + TEXT("_RenderPipeline");
-			FString mfName = TEXT("MF_") + name;
+			FString mfName = getRenderPipelineFunctionFilename();
 
 			//FString masterMaterialPath = FCPGDTFImporterUtils::CLAYPAKY_PLUGIN_CONTENT_BASEPATH;
 			//masterMaterialPath = masterMaterialPath + TEXT("MaterialInstances/MaterialFunctions/MF_DMXDimmer.MF_DMXDimmer");
 
 			//Loads the master/source material
-			UMaterialFunctionInterface* materialFunction = Cast<UMaterialFunctionInterface>(FCPGDTFImporterUtils::LoadObjectByPath(*(this->mBasePackagePath + mfName + TEXT(".") + mfName)));
+			UMaterialFunctionInterface* materialFunction = Cast<UMaterialFunctionInterface>(FCPGDTFImporterUtils::LoadObjectByPath(*(this->mSharedPackagePath + mfName + TEXT(".") + mfName)));
 
 			//Adds material function 
 			UMaterialExpressionMaterialFunctionCall* mfCall = generateMaterialExpression<UMaterialExpressionMaterialFunctionCall>(dstMaterial);
@@ -606,7 +770,7 @@ bool CPGDTFRenderPipelineBuilder::buildLightRenderPipeline() {
 		return false;
 	};
 
-	bool ret = this->buildBeamPipeline() && this->buildMaterialInstancePipeline()  && this->linkLensPipeline(middleCode) && this->linkSpotlightPipeline(middleCode);
+	bool ret = this->buildBeamPipeline() && this->buildMaterialInstancePipeline()  && this->linkLensPipeline(middleCode) && this->linkSpotlightPipeline(middleCode) && this->linkSpotlightPipeline(middleCode, true);
 	UE_LOG_CPGDTFIMPORTER(Display, TEXT("CPGDTFRenderPipelineBuilder: buildLightRenderPipeline > Exiting with result: %d\n"), ret);
 	return ret;
 }
@@ -708,7 +872,7 @@ UMaterialExpressionScalarParameter* CPGDTFRenderPipelineBuilder::addScalarInputT
 	 * @param defaultSamplerType Optional: The default sampler type of the texture. Default: Linear Color
 	 * @return The just added texture parameter
 	*/
-UMaterialExpressionTextureObjectParameter* CPGDTFRenderPipelineBuilder::addTextureInputToBeamPipeline(UMaterial* beamMaterial, FString paramName, FString inputName, UMaterialExpressionCustom* meCustom, UTexture2D* defaultTexture, MeBlocksMover* mover, EMaterialSamplerType defaultSamplerType) {
+UMaterialExpressionTextureObjectParameter* CPGDTFRenderPipelineBuilder::addTextureInputToBeamPipeline(UMaterial* beamMaterial, FString paramName, FString inputName, UMaterialExpressionCustom* meCustom, UTexture* defaultTexture, MeBlocksMover* mover, EMaterialSamplerType defaultSamplerType) {
 	UMaterialExpressionTextureObjectParameter* texParam = generateMaterialExpression<UMaterialExpressionTextureObjectParameter>(beamMaterial);
 	texParam->ParameterName = FName(*paramName);
 	texParam->Group = FName(TEXT("Runtime Parameters"));
@@ -771,6 +935,48 @@ UMaterialExpressionTextureObjectParameter* CPGDTFRenderPipelineBuilder::addTextu
 	if (mover) mover->moveMaterialExpression(texParam, EDITOR_TEXTURE_OBJECT_SIZE_Y);
 	return texParam;
 }
+/**
+ * Adds a wheel sampling its frost chain to the material instance pipeline, in place of MF_DMXWheel and its frosted texture.
+ * The frost value biases the mip chosen by the hardware towards the mips 1+, chosen like the beam does
+ *
+ * @param dstMaterial Material function of the pipeline
+ * @param wheelType Wheel type
+ * @param wheelNo number of wheel per wheelType (EG: Gobo0, Gobo1, Color0, etc)
+ * @param previousParameter Previous node of the pipeline
+ * @param frostParam Frost parameter of the pipeline
+ * @param defaultTexture The default texture of the frost chain param
+ * @param mover Automatically positions the new parameters
+ * @return The custom expression sampling the wheel, next node of the pipeline
+*/
+UMaterialExpressionCustom* CPGDTFRenderPipelineBuilder::addFrostChainWheelToMiPipeline(UMaterialFunction* dstMaterial, FCPGDTFWheelImporter::WheelType wheelType, int wheelNo, UMaterialExpression* previousParameter, UMaterialExpression* frostParam, UTexture2D* defaultTexture, MeBlocksMover* mover) {
+	UMaterialFunctionEditorOnlyData* dstMaterialData = dstMaterial->GetEditorOnlyData();
+
+	UMaterialExpressionTextureObjectParameter* texParam = addTextureParameterToMiPipeline(dstMaterial, getDiskFrostChainParamName(wheelType, wheelNo, false), defaultTexture, mover);
+	UMaterialExpressionScalarParameter* numSlotParam = addScalarParameterToMiPipeline(dstMaterial, getNumSlotsParamName(wheelType, wheelNo), mover, 1);
+	UMaterialExpressionScalarParameter* wheelIndexParam = addScalarParameterToMiPipeline(dstMaterial, getIndexParamName(wheelType, wheelNo), mover);
+	UMaterialExpressionTextureCoordinate* texCoord = generateMaterialExpression<UMaterialExpressionTextureCoordinate>(dstMaterial);
+	dstMaterialData->ExpressionCollection.AddExpression(texCoord);
+	mover->moveMaterialExpression(texCoord, EDITOR_CONSTANT_SIZE_Y);
+
+	UMaterialExpressionCustom* meCustom = generateMaterialExpression<UMaterialExpressionCustom>(dstMaterial);
+	meCustom->Description = TEXT("Frost chain wheel");
+	meCustom->OutputType = ECustomMaterialOutputType::CMOT_Float3;
+	meCustom->Inputs.Empty();
+	const TPair<const TCHAR*, UMaterialExpression*> inputs[] = { { TEXT("previous"), previousParameter }, { TEXT("frost"), frostParam }, { TEXT("disk"), texParam }, { TEXT("nSlots"), numSlotParam }, { TEXT("index"), wheelIndexParam }, { TEXT("texCoor"), texCoord } };
+	for (const TPair<const TCHAR*, UMaterialExpression*>& input : inputs) {
+		FCustomInput& customInput = meCustom->Inputs.AddDefaulted_GetRef();
+		customInput.InputName = FName(input.Key);
+		customInput.Input.Connect(0, input.Value);
+	}
+	//Same strip mapping as MF_DMXWheel and the beam, same mip 1+ as the beam at full frost.
+	//A single sample with the hardware mip as the base, so the distant lenses don't shimmer without frost
+	meCustom->Code = TEXT("uint w, h, levels;\ndisk.GetDimensions(0, w, h, levels);\n");
+	meCustom->Code += TEXT("float frostLod = min(1, levels - 1.0) + saturate(frost) * max(levels - 2.0, 0);\n");
+	meCustom->Code += TEXT("float2 uv = float2(texCoor.x / nSlots + index / nSlots, texCoor.y);\n");
+	meCustom->Code += TEXT("return previous.rgb * disk.SampleBias(diskSampler, uv, lerp(0, frostLod, saturate(frost))).rgb;");
+	dstMaterialData->ExpressionCollection.AddExpression(meCustom);
+	return meCustom;
+}
 
 
 /**
@@ -792,16 +998,28 @@ FString CPGDTFRenderPipelineBuilder::getFileName(FString prepend, FString materi
 	return name;
 }
 /**
- * Generates the filename of a Material in the fixture's personal render pipeline builder folder
+ * Generates the filename of a Material in the shared render pipeline folder of this pipeline hash
  * @author Luca Sorace - Clay Paky S.R.L.
  * @date 13 january 2023
  *
  * @param materialType Beam|Lens|Spotlight
- * @param addPath if true the full path to the fixture's personal render pipeline builder folder is prepended
+ * @param addPath if true the full path to the shared render pipeline folder is prepended
  * @return The generated path/file name of the Material
 */
 FString CPGDTFRenderPipelineBuilder::getMaterialFilename(FString materialType, bool addPath) {
-	return getFileName(TEXT("M_"), materialType, TEXT("_MASTER"), addPath);
+	FString _materialType = materialType;
+	if (!_materialType.StartsWith(TEXT("_"))) _materialType = TEXT("_") + _materialType;
+	FString name = TEXT("M_LRP_") + this->mPipelineHash + _materialType + TEXT("_MASTER");
+	if (addPath) name = this->mSharedPackagePath + name + TEXT(".") + name;
+	return name;
+}
+/**
+ * Generates the filename of the Material Function containing the rendering pipeline, in the shared render pipeline folder
+ *
+ * @return The generated file name of the Material Function
+*/
+FString CPGDTFRenderPipelineBuilder::getRenderPipelineFunctionFilename() {
+	return TEXT("MF_LRP_") + this->mPipelineHash + TEXT("_RenderPipeline");
 }
 /**
  * Generates the filename of a Material Interface in the fixture's personal render pipeline builder folder
@@ -931,6 +1149,9 @@ void CPGDTFRenderPipelineBuilder::copyUMaterialDetails(UMaterial* dstMaterial, U
 #undef MATERIAL_TYPE_BEAM
 #undef MATERIAL_TYPE_LENS
 #undef MATERIAL_TYPE_LIGHT
+#undef MATERIAL_TYPE_LIGHT_SINGLE
+#undef SHARED_PIPELINES_BASEPATH
+#undef PIPELINE_LAYOUT_VERSION
 
 #undef EDITOR_MINI_BLOCK_SIZE
 #undef EDITOR_BLOCK_SIZE
@@ -26,48 +26,177 @@ SOFTWARE.
 #include "Factories/CPGDTFUnzip.h"
 #include "ClayPakyGDTFImporterLog.h"
 #include "Libs/MiniZ/miniz.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 
+/// Wraps the miniz reader so miniz.h stays out of the header
+struct FCPGDTFArchiveZip {
+    mz_zip_archive Archive;
+};
+
+namespace CPGDTFArchiveCache {
+    static FCriticalSection Mutex;
+    /// Archives currently in use, by full path
+    static TMap<FString, TWeakPtr<FCPGDTFArchive>> Archives;
+}
+
+TSharedPtr<FCPGDTFArchive> FCPGDTFArchive::Open(const FString& GDTFFullPath) {
+    using namespace CPGDTFArchiveCache;
+    const FString FullPath = FPaths::ConvertRelativePathToFull(GDTFFullPath);
+
+    FScopeLock Lock(&Mutex);
+    if (TWeakPtr<FCPGDTFArchive>* Existing = Archives.Find(FullPath)) {
+        TSharedPtr<FCPGDTFArchive> Archive = Existing->Pin();
+        if (Archive.IsValid()) return Archive;
+    }
+
+    TSharedPtr<FCPGDTFArchive> Archive = MakeShareable(new FCPGDTFArchive(FullPath));
+    if (!Archive->Load()) {
+        Archives.Remove(FullPath);
+        return nullptr;
+    }
+    Archives.Add(FullPath, Archive);
+    return Archive;
+}
+
+FCPGDTFArchive::FCPGDTFArchive(const FString& GDTFFullPath) : Path(GDTFFullPath), Zip(MakeUnique<FCPGDTFArchiveZip>()) {
+    memset(&this->Zip->Archive, 0, sizeof(this->Zip->Archive)); // Setup of the memory
+}
+
+FCPGDTFArchive::~FCPGDTFArchive() {
+    mz_zip_reader_end(&this->Zip->Archive);
+}
+
+bool FCPGDTFArchive::Load() {
+    // The whole file stays in memory, GDTFs are small and each entry is then read without touching the disk again
+    if (!FFileHelper::LoadFileToArray(this->FileData, *this->Path)) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to read GDTF file : %s"), *this->Path);
+        return false;
+    }
+    if (!mz_zip_reader_init_mem(&this->Zip->Archive, this->FileData.GetData(), this->FileData.Num(), 0)) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to open GDTF file : %s"), ANSI_TO_TCHAR(mz_zip_get_error_string(mz_zip_get_last_error(&this->Zip->Archive))));
+        return false;
+    }
+
+    // Central directory parsed once
+    const mz_uint FilesNum = mz_zip_reader_get_num_files(&this->Zip->Archive);
+    this->Entries.Reserve(FilesNum);
+    char Filename[MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE];
+    for (mz_uint i = 0; i < FilesNum; i++) {
+        if (mz_zip_reader_is_file_a_directory(&this->Zip->Archive, i)) continue;
+        if (!mz_zip_reader_get_filename(&this->Zip->Archive, i, Filename, sizeof(Filename))) continue;
+        this->Entries.Add(NormalizeName(UTF8_TO_TCHAR(Filename)), (int32)i);
+    }
+    UE_LOG_CPGDTFIMPORTER(Display, TEXT("GDTF archive '%s' opened, %d files"), *this->Path, this->Entries.Num());
+    return true;
+}
+
+FString FCPGDTFArchive::NormalizeName(const FString& Filename) {
+    FString Name = Filename.Replace(TEXT("\\"), TEXT("/"));
+    while (Name.StartsWith(TEXT("./")) || Name.StartsWith(TEXT("/"))) Name.RightChopInline(Name.StartsWith(TEXT("/")) ? 1 : 2);
+    return Name;
+}
+
+int32 FCPGDTFArchive::FindEntry(const FString& Filename) const {
+    const int32* Index = this->Entries.Find(NormalizeName(Filename));
+    return Index ? *Index : INDEX_NONE;
+}
+
+bool FCPGDTFArchive::Contains(const FString& Filename) const {
+    return this->FindEntry(Filename) != INDEX_NONE;
+}
+
+int64 FCPGDTFArchive::GetFileSize(const FString& Filename) const {
+    const int32 Index = this->FindEntry(Filename);
+    if (Index == INDEX_NONE) return -1;
+
+    FScopeLock Lock(&this->Mutex);
+    mz_zip_archive_file_stat Stat;
+    if (!mz_zip_reader_file_stat(&this->Zip->Archive, Index, &Stat)) return -1;
+    return (int64)Stat.m_uncomp_size;
+}
+
+bool FCPGDTFArchive::Extract(const FString& Filename, TArray<uint8>& OutBuffer) const {
+    const int64 Size = this->GetFileSize(Filename);
+    if (Size < 0 || Size > MAX_int32) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("File %s not found in GDTF"), *Filename);
+        return false;
+    }
+    OutBuffer.SetNumUninitialized((int32)Size, false); // Keeps the allocation if the buffer is reused
+    return this->Extract(Filename, OutBuffer.GetData(), Size);
+}
+
+bool FCPGDTFArchive::Extract(const FString& Filename, void* Buffer, int64 BufferSize) const {
+    const int32 Index = this->FindEntry(Filename);
+    if (Index == INDEX_NONE) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("File %s not found in GDTF"), *Filename);
+        return false;
+    }
+
+    FScopeLock Lock(&this->Mutex);
+    if (!mz_zip_reader_extract_to_mem(&this->Zip->Archive, Index, Buffer, BufferSize, 0)) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to extract %s file : %s"), *Filename, ANSI_TO_TCHAR(mz_zip_get_error_string(mz_zip_get_last_error(&this->Zip->Archive))));
+        return false;
+    }
+    return true;
+}
+
+bool FCPGDTFArchive::ExtractStreaming(const FString& Filename, TFunctionRef<bool(int64 Offset, const void* Data, int64 Size)> Callback) const {
+    const int32 Index = this->FindEntry(Filename);
+    if (Index == INDEX_NONE) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("File %s not found in GDTF"), *Filename);
+        return false;
+    }
+
+    // Returning less bytes than received makes miniz stop the extraction
+    mz_file_write_func Write = [](void* Opaque, mz_uint64 Offset, const void* Data, size_t Size) -> size_t {
+        TFunctionRef<bool(int64, const void*, int64)>& Fnc = *(TFunctionRef<bool(int64, const void*, int64)>*)Opaque;
+        return Fnc((int64)Offset, Data, (int64)Size) ? Size : 0;
+    };
+
+    FScopeLock Lock(&this->Mutex);
+    if (!mz_zip_reader_extract_to_callback(&this->Zip->Archive, Index, Write, &Callback, 0)) {
+        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to extract %s file : %s"), *Filename, ANSI_TO_TCHAR(mz_zip_get_error_string(mz_zip_get_last_error(&this->Zip->Archive))));
+        return false;
+    }
+    return true;
+}
+
+FString FCPGDTFArchive::ExtractText(const FString& Filename) const {
+    TArray<uint8> Buffer;
+    if (!this->Extract(Filename, Buffer)) return FString();
+
+    FString FileString;
+    FFileHelper::BufferToString(FileString, Buffer.GetData(), Buffer.Num());
+    return FileString;
+}
 
 /**
     * Extract any type of file from the GDTF archive
     * @author Dorian Gardes - Clay Paky S.R.L.
     * @date 29 april 2022
     *
-    * @return void* => buffer readed
+    * @return void* => buffer readed, to be released with free()
     * @return  int  => buffer size
     */
 std::tuple<void*, int> UCPGDTFUnzip::ExtractFileFromGDTFArchive(const FString& GDTFFullPath, const FString Filename) {
 
-    mz_zip_archive zip_archive; // Struct containing the zip archive metadata in memory
-    memset(&zip_archive, 0, sizeof(zip_archive)); // Setup of the memory
+    TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(GDTFFullPath);
+    if (!Archive.IsValid()) return std::tuple<void*, int> {nullptr, 0};
 
-    //Opening of the zip file.
-    if (!mz_zip_reader_init_file(&zip_archive, TCHAR_TO_ANSI(*GDTFFullPath), 0)) {
-        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to open GDTF file : %s"), mz_zip_get_error_string(mz_zip_get_last_error(&zip_archive)));
-        mz_zip_reader_end(&zip_archive);
-        return std::tuple<void*, int> {nullptr, 0};
-    }
-
-    // Looking for the file inside the archive
-    int file_index = mz_zip_reader_locate_file(&zip_archive, TCHAR_TO_ANSI(*Filename), NULL, 0);
-    if (file_index == -1) {
+    const int64 FileSize = Archive->GetFileSize(Filename);
+    if (FileSize < 0 || FileSize > MAX_int32) {
         UE_LOG_CPGDTFIMPORTER(Warning, TEXT("File %s not found in GDTF"), *Filename);
-        mz_zip_reader_end(&zip_archive);
         return std::tuple<void*, int> {nullptr, 0};
     }
 
-    // Reading the file
-    void* fileContent = nullptr;
-    size_t fileContentSize = 0;
-    fileContent = mz_zip_reader_extract_to_heap(&zip_archive, file_index, &fileContentSize, NULL);
-    if (!fileContent) {
-        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to extract %s file : %s"), *Filename, mz_zip_get_error_string(mz_zip_get_last_error(&zip_archive)));
-        mz_zip_reader_end(&zip_archive);
+    void* fileContent = malloc(FileSize > 0 ? FileSize : 1);
+    if (!Archive->Extract(Filename, fileContent, FileSize)) {
+        free(fileContent);
         return std::tuple<void*, int> {nullptr, 0};
     }
-
-    mz_zip_reader_end(&zip_archive);
-    return std::tuple<void*, int> {fileContent, fileContentSize};
+    return std::tuple<void*, int> {fileContent, (int)FileSize};
 }
 
 /**
@@ -77,17 +206,8 @@ std::tuple<void*, int> UCPGDTFUnzip::ExtractFileFromGDTFArchive(const FString& G
     */
 FString UCPGDTFUnzip::ExtractTextFileFromGDTFArchive(const FString& GDTFFullPath, const FString Filename) {
 
-    // Extraction with generic function
-    std::tuple<void*, int> bufferTuple = ExtractFileFromGDTFArchive(GDTFFullPath, Filename);
-    if (!std::get<0>(bufferTuple)) { // Check if read problems
-        UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to extract %s file from GDTF archive."), *Filename);
-        return FString();
-    }
-    else {
-        FString FileString;
-        // Conversion to real string to remove strange characters at the end of the void* buffer
-        FileString.Append((char*)std::get<0>(bufferTuple), std::get<1>(bufferTuple));
-        free(std::get<0>(bufferTuple)); // Free memory
-        return FileString;
-    }
-}
\ No newline at end of file
+    TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(GDTFFullPath);
+    FString FileString = Archive.IsValid() ? Archive->ExtractText(Filename) : FString();
+    if (FileString.IsEmpty()) UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Failed to extract %s file from GDTF archive."), *Filename);
+    return FileString;
+}
@@ -25,8 +25,91 @@ SOFTWARE.
 
 #pragma once
 #include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "HAL/CriticalSection.h"
 
-/// Helpers to manipulate GDTF archives
+struct FCPGDTFArchiveZip;
+
+/**
+ * GDTF archive opened once and kept in memory, with its central directory indexed by name. <br>
+ * The archives are shared by path: while someone (EG: the factory during an import) holds a reference every Open() on the same file
+ * returns the same instance, so the description, wheels and 3D models importers don't reopen and reparse the zip for each file.
+ * Extractions are thread safe.
+ */
+class FCPGDTFArchive {
+
+public:
+    /**
+     * Returns the archive of the given GDTF file, opening and indexing it only if nobody is already using it
+     *
+     * @param GDTFFullPath Path of the GDTF file on disk
+     * @return The shared archive, or nullptr if the file can't be read
+     */
+    static TSharedPtr<FCPGDTFArchive> Open(const FString& GDTFFullPath);
+
+    ~FCPGDTFArchive();
+
+    /// Path of the GDTF file on disk
+    FORCEINLINE const FString& GetPath() const { return this->Path; }
+
+    /// True if the archive contains the file. Names are case insensitive and '\\' is the same as '/'
+    bool Contains(const FString& Filename) const;
+
+    /// Uncompressed size of the file, -1 if it's not in the archive
+    int64 GetFileSize(const FString& Filename) const;
+
+    /**
+     * Extracts a file in a caller-provided buffer, resized to the file size. Reusing the same buffer avoids an allocation per file
+     *
+     * @param Filename Path of the file inside the archive
+     * @param OutBuffer Buffer where the file is extracted
+     * @return True if the file has been extracted
+     */
+    bool Extract(const FString& Filename, TArray<uint8>& OutBuffer) const;
+
+    /**
+     * Extracts a file in a caller-provided memory area, that must be at least GetFileSize() bytes big
+     *
+     * @param Filename Path of the file inside the archive
+     * @param Buffer Destination memory
+     * @param BufferSize Size of the destination memory
+     * @return True if the file has been extracted
+     */
+    bool Extract(const FString& Filename, void* Buffer, int64 BufferSize) const;
+
+    /**
+     * Extracts a file in chunks, without holding it all in memory
+     *
+     * @param Filename Path of the file inside the archive
+     * @param Callback Called for each decompressed chunk with its offset inside the file. Must return false to stop the extraction
+     * @return True if the whole file has been extracted
+     */
+    bool ExtractStreaming(const FString& Filename, TFunctionRef<bool(int64 Offset, const void* Data, int64 Size)> Callback) const;
+
+    /// Extracts a text file (EG: description.xml). Returns an empty string on error
+    FString ExtractText(const FString& Filename) const;
+
+private:
+    FCPGDTFArchive(const FString& GDTFFullPath);
+    /// Reads the file and indexes its central directory. Returns false if it's not a valid zip
+    bool Load();
+    /// Index of the entry in the zip, INDEX_NONE if missing
+    int32 FindEntry(const FString& Filename) const;
+    /// Key used by the index: forward slashes, no leading "./" or "/"
+    static FString NormalizeName(const FString& Filename);
+
+    FString Path;
+    /// Whole GDTF file. The zip reader works directly on this memory
+    TArray64<uint8> FileData;
+    TUniquePtr<FCPGDTFArchiveZip> Zip;
+    /// Normalized name -> zip entry index. FString keys compare case insensitively
+    TMap<FString, int32> Entries;
+    /// miniz readers aren't thread safe
+    mutable FCriticalSection Mutex;
+};
+
+
+/// Helpers to manipulate GDTF archives. They go through the shared FCPGDTFArchive of the file
 class UCPGDTFUnzip {
 
 public:
@@ -35,8 +35,321 @@ SOFTWARE.
 #include "XmlNode.h"
 #include "XmlFile.h"
 #include "CPGDTFDescriptionImporter.h"
+#include "CPGDTFXmlReader.h"
+#include "Misc/FileHelper.h"
+#include "Utils/CPGDTFColorWizard.h"
 
 #define PHYSICAL_CHANNEL_SET_PLACEHOLDER -694316420.0f
+// Attribute of the channel functions without feature, not declared in the AttributeDefinitions
+#define NO_FEATURE_ATTRIBUTE FName("NoFeature")
+
+namespace CPGDTFDescriptionImporter {
+
+	/**
+	 * Channel sets without PhysicalFrom/PhysicalTo get them interpolated from their channel function, from the last DMX value to the first
+	 * @param ImportLogicalChannel Logical channel to fix
+	 * @param OffsetsNo Number of bytes of the DMX channel
+	 */
+	static void FixChannelSetsPhysical(FCPDMXImportGDTFLogicalChannel& ImportLogicalChannel, int32 OffsetsNo) {
+
+		int lastDmx = (1 << 8 * OffsetsNo) - 1;
+		for (int cfIdx = ImportLogicalChannel.ChannelFunctions.Num() - 1; cfIdx >= 0; cfIdx--) {
+			FDMXImportGDTFChannelFunction* cf = &ImportLogicalChannel.ChannelFunctions[cfIdx];
+			float physicalDiff = cf->PhysicalTo - cf->PhysicalFrom;
+			int endAddress = lastDmx, startAddress = cf->DMXFrom.Value;
+			int addrDiff = endAddress - startAddress;
+
+			for (int csIdx = cf->ChannelSets.Num() - 1; csIdx >= 0; csIdx--) {
+				FDMXImportGDTFChannelSet* cs = &cf->ChannelSets[csIdx];
+				FDMXImportGDTFChannelSet* csPrev = csIdx > 0 ? &cf->ChannelSets[csIdx - 1] : nullptr;;
+				int currentAddress = cs->DMXFrom.Value;
+				lastDmx = currentAddress - 1;
+
+				//actual fix
+				//current->from
+				if (cs->PhysicalFrom == PHYSICAL_CHANNEL_SET_PLACEHOLDER)
+					cs->PhysicalFrom = (physicalDiff * ((float)(currentAddress - startAddress)) / addrDiff) + cf->PhysicalFrom; //phys : diffPhys = dmx : diffDmx
+				//prev->to
+				if (csPrev != nullptr && csPrev->PhysicalTo == PHYSICAL_CHANNEL_SET_PLACEHOLDER)
+					csPrev->PhysicalTo = cs->PhysicalFrom;
+				//current->to. If it hasn't already fixed, it means we're the first channelset, so our to-value should be obtained from the channel function
+				if (cs->PhysicalTo == PHYSICAL_CHANNEL_SET_PLACEHOLDER)
+					cs->PhysicalTo = cf->PhysicalTo;
+			}
+		}
+	}
+
+	/// Fills a name to index map of a section, keeping the first element of each name
+	template <typename TItem> static void IndexByName(const TArray<TItem>& Items, TMap<FName, int32>& OutIndices) {
+		OutIndices.Empty(Items.Num());
+		for (int32 i = 0; i < Items.Num(); i++) {
+			if (!OutIndices.Contains(Items[i].Name)) OutIndices.Add(Items[i].Name, i);
+		}
+	}
+
+	/// Calls Visitor on a geometry and all its childrens
+	static void ForEachGeometry(const UCPGDTFDescriptionGeometryBase* Geometry, TFunctionRef<void(const UCPGDTFDescriptionGeometryBase*)> Visitor) {
+		Visitor(Geometry);
+		for (const UCPGDTFDescriptionGeometryBase* Child : Geometry->Childrens) {
+			if (Child != nullptr) ForEachGeometry(Child, Visitor);
+		}
+	}
+
+	/// Names of the emitters used by the channel functions: only their measurements are read
+	static void CollectReferencedEmitters(const UCPGDTFDescription* Description, TSet<FName>& OutEmitters) {
+		for (const FDMXImportGDTFDMXMode& DMXMode : Cast<UDMXImportGDTFDMXModes>(Description->DMXModes)->DMXModes)
+			for (const FDMXImportGDTFDMXChannel& DMXChannel : DMXMode.DMXChannels)
+				for (const FDMXImportGDTFLogicalChannel& LogicalChannel : DMXChannel.LogicalChannels)
+					for (const FDMXImportGDTFChannelFunction& ChannelFunction : LogicalChannel.ChannelFunctions)
+						if (!ChannelFunction.Emitter.Name.IsNone()) OutEmitters.Add(ChannelFunction.Emitter.Name);
+	}
+
+	/// Sorts the points of a spectrum by wavelength and computes its CIE XYZ, scaled to the luminous intensity when the measurement gives it
+	static void FinishEmitterSpectrum(FCPGDTFEmitterSpectrum& Spectrum) {
+		bool bSorted = true;
+		for (int32 i = 1; i < Spectrum.WaveLengths.Num() && bSorted; i++) bSorted = Spectrum.WaveLengths[i - 1] <= Spectrum.WaveLengths[i];
+		if (!bSorted) {
+			TArray<int32> Order;
+			for (int32 i = 0; i < Spectrum.WaveLengths.Num(); i++) Order.Add(i);
+			Order.Sort([&Spectrum](int32 A, int32 B) { return Spectrum.WaveLengths[A] < Spectrum.WaveLengths[B]; });
+			TArray<float> WaveLengths, Energies;
+			WaveLengths.Reserve(Order.Num());
+			Energies.Reserve(Order.Num());
+			for (int32 Index : Order) {
+				WaveLengths.Add(Spectrum.WaveLengths[Index]);
+				Energies.Add(Spectrum.Energies[Index]);
+			}
+			Spectrum.WaveLengths = MoveTemp(WaveLengths);
+			Spectrum.Energies = MoveTemp(Energies);
+		}
+
+		Spectrum.XYZ = FCPColorWizard::SpectrumToXYZ(Spectrum.WaveLengths, Spectrum.Energies);
+		if (Spectrum.LuminousIntensity > 0 && Spectrum.XYZ.Y > 0) Spectrum.XYZ *= Spectrum.LuminousIntensity / Spectrum.XYZ.Y;
+	}
+
+	/// Rewinds the reader on a child found by FindChildren and enters it. Returns false if the child wasn't found
+	static bool EnterChild(FCPGDTFXmlReader& Reader, const FCPGDTFXmlReader::FMark& Mark, int32& OutDepth) {
+		if (!Mark.IsValid()) return false;
+		Reader.Rewind(Mark);
+		if (Reader.Next() != FCPGDTFXmlReader::EToken::StartElement) return false;
+		OutDepth = Reader.GetDepth();
+		return true;
+	}
+
+
+	/**
+	 * Attributes of an XML DOM node behind the same interface of FCPGDTFXmlReader. <br>
+	 * The fields of every element are read by the templates below, with one of these or with the reader on the StartElement: the two parsers only differ in how they walk the document
+	 */
+	class FXmlNodeAttributes {
+
+	public:
+
+		explicit FXmlNodeAttributes(const FXmlNode* InNode) : Node(InNode) {}
+
+		FORCEINLINE FString GetAttribute(const ANSICHAR* Name) const { return this->Node->GetAttribute(FString(Name)).TrimStartAndEnd(); }
+		FORCEINLINE FName GetAttributeName(const ANSICHAR* Name) const { return FName(*this->GetAttribute(Name)); }
+		FORCEINLINE FString GetAttributeTemp(const ANSICHAR* Name) const { return this->GetAttribute(Name); }
+		FORCEINLINE bool IsAttributeEmpty(const ANSICHAR* Name) const { return this->GetAttribute(Name).IsEmpty(); }
+		template <typename TType> bool ParseAttribute(const ANSICHAR* Name, TType& OutValue) const { return LexTryParseString(OutValue, *this->GetAttribute(Name)); }
+
+	private:
+
+		const FXmlNode* Node;
+	};
+
+	template <typename TElement> static void ReadFixtureType(const TElement& Element, UDMXImportGDTFFixtureType* FixtureType, FString& OutThumbnailFileName) {
+		OutThumbnailFileName = Element.GetAttribute("Thumbnail");
+		FixtureType->Description = Element.GetAttribute("Description");
+		FixtureType->FixtureTypeID = Element.GetAttribute("FixtureTypeID");
+		FixtureType->LongName = Element.GetAttribute("LongName");
+		FixtureType->Manufacturer = Element.GetAttribute("Manufacturer");
+		FixtureType->Name = Element.GetAttributeName("Name");
+		FixtureType->ShortName = Element.GetAttribute("ShortName");
+		FixtureType->RefFT = Element.GetAttribute("RefFT");
+	}
+
+	template <typename TElement> static void ReadFeatureGroup(const TElement& Element, FDMXImportGDTFFeatureGroup& OutFeatureGroup) {
+		OutFeatureGroup.Name = Element.GetAttributeName("Name");
+		OutFeatureGroup.Pretty = Element.GetAttribute("Pretty");
+	}
+
+	template <typename TElement> static void ReadAttribute(const TElement& Element, UDMXImportGDTFAttributeDefinitions* AttributeDefinitions, FCPGDTFDescriptionAttribute& OutAttribute) {
+		OutAttribute.Name = Element.GetAttributeName("Name");
+		OutAttribute.Type = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(OutAttribute.Name);
+		OutAttribute.Pretty = Element.GetAttribute("Pretty");
+		OutAttribute.ActivationGroup.Name = Element.GetAttributeName("ActivationGroup");
+		AttributeDefinitions->FindFeature(Element.GetAttributeTemp("Feature"), OutAttribute.Feature);
+		OutAttribute.MainAttribute = Element.GetAttribute("MainAttribute");
+		OutAttribute.PhysicalUnit = DMXImport::GetEnumValueFromString<EDMXImportGDTFPhysicalUnit>(Element.GetAttributeTemp("PhysicalUnit"));
+		OutAttribute.Color = DMXImport::ParseColorCIE(Element.GetAttributeTemp("Color"));
+	}
+
+	/// The image is imported by the FCPGDTFWheelImporter, that links it to the slot's MediaFileName
+	template <typename TElement> static void ReadWheelSlot(const TElement& Element, FName WheelName, FDMXImportGDTFWheelSlot& OutWheelSlot, TArray<FCPGDTFWheelImporter::FWheelSlotMedia>& OutSlotsMedia) {
+		OutWheelSlot.Name = Element.GetAttributeName("Name");
+		OutWheelSlot.Color = DMXImport::ParseColorCIE(Element.GetAttributeTemp("Color"));
+		if (Element.IsAttributeEmpty("MediaFileName")) return;
+		OutSlotsMedia.Add({ WheelName.ToString(), OutWheelSlot.Name.ToString(), Element.GetAttribute("MediaFileName") });
+	}
+
+	/// The measurement points are not stored in the emitter's Measurement: they slow the GDTF Description editor down. See EmitterSpectra
+	template <typename TElement> static void ReadEmitter(const TElement& Element, FDMXImportGDTFEmitter& OutEmitter) {
+		OutEmitter.Name = Element.GetAttributeName("Name");
+		OutEmitter.Color = DMXImport::ParseColorCIE(Element.GetAttributeTemp("Color"));
+		OutEmitter.DiodePart = Element.GetAttribute("DiodePart");
+		Element.ParseAttribute("DominantWaveLength", OutEmitter.DominantWaveLength);
+	}
+
+	template <typename TElement> static void ReadColorSpace(const TElement& Element, FDMXImportGDTFColorSpace& OutColorSpace) {
+		OutColorSpace.Mode = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFMode>(Element.GetAttributeTemp("Mode"));
+		OutColorSpace.Description = Element.GetAttribute("Description");
+		OutColorSpace.Red = DMXImport::ParseColorCIE(Element.GetAttributeTemp("Red"));
+		OutColorSpace.Blue = DMXImport::ParseColorCIE(Element.GetAttributeTemp("Blue"));
+		OutColorSpace.Green = DMXImport::ParseColorCIE(Element.GetAttributeTemp("Green"));
+		OutColorSpace.WhitePoint = DMXImport::ParseColorCIE(Element.GetAttributeTemp("WhitePoint"));
+	}
+
+	template <typename TElement> static void ReadModel(const TElement& Element, FCPGDTFDescriptionModel& OutModel) {
+		OutModel.Name = Element.GetAttributeName("Name");
+		Element.ParseAttribute("Length", OutModel.Length);
+		OutModel.Length *= 100.0f; // Conversion from GDTF meters to Unreal centimeters default unit
+		Element.ParseAttribute("Width", OutModel.Width);
+		OutModel.Width *= 100.0f; // Conversion from GDTF meters to Unreal centimeters default unit
+		Element.ParseAttribute("Height", OutModel.Height);
+		OutModel.Height *= 100.0f; // Conversion from GDTF meters to Unreal centimeters default unit
+		OutModel.PrimitiveType = CPGDTFDescription::GetEnumValueFromString<ECPGDTFDescriptionModelsPrimitiveType>(Element.GetAttributeTemp("PrimitiveType"));
+		OutModel.File = Element.GetAttributeName("File");
+	}
+
+	template <typename TElement> static void ReadDMXMode(const TElement& Element, FDMXImportGDTFDMXMode& OutDMXMode) {
+		OutDMXMode.Name = Element.GetAttributeName("Name");
+		OutDMXMode.Geometry = Element.GetAttributeName("Geometry");
+	}
+
+	/**
+	 * Reads a DMX channel, without its logical channels
+	 * @param OutInitialFunction Name of the channel function giving the default value, to resolve once the logical channels are read
+	 * @return False if the channel has no valid offset and must be ignored
+	 */
+	template <typename TElement> static bool ReadDMXChannel(const TElement& Element, FCPDMXImportGDTFDMXChannel& OutDMXChannel, FString& OutInitialFunction) {
+		// Ignore Channels that do not specify a valid offset.
+		// E.g. 'Robe Lighting s.r.o.@Robin 800X LEDWash.gdtf' specifies virtual Dimmer channels that have no offset and cannot be accessed.
+		if (!OutDMXChannel.ParseOffset(Element.GetAttributeTemp("Offset"))) return false;
+
+		OutDMXChannel.Highlight = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("Highlight"));
+		OutDMXChannel.Geometry = Element.GetAttributeName("Geometry");
+		Element.ParseAttribute("DMXBreak", OutDMXChannel.DMXBreak);
+		OutInitialFunction = Element.GetAttribute("InitialFunction");
+		return true;
+	}
+
+	template <typename TElement> static void ReadChannelSet(const TElement& Element, FDMXImportGDTFChannelSet& OutChannelSet) {
+		OutChannelSet.Name = *Element.GetAttributeTemp("Name");
+		OutChannelSet.DMXFrom = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("DMXFrom"));
+		if (Element.ParseAttribute("WheelSlotIndex", OutChannelSet.WheelSlotIndex))
+			OutChannelSet.WheelSlotIndex--; // The starting index is 1 in GDTF Spec
+
+		if (Element.IsAttributeEmpty("PhysicalFrom")) OutChannelSet.PhysicalFrom = PHYSICAL_CHANNEL_SET_PLACEHOLDER;
+		else Element.ParseAttribute("PhysicalFrom", OutChannelSet.PhysicalFrom);
+
+		if (Element.IsAttributeEmpty("PhysicalTo")) OutChannelSet.PhysicalTo = PHYSICAL_CHANNEL_SET_PLACEHOLDER;
+		else Element.ParseAttribute("PhysicalTo", OutChannelSet.PhysicalTo);
+	}
+
+	/// A channel function without channel sets gets one covering all its range
+	static void AddDefaultChannelSet(FCPDMXImportGDTFChannelFunction& ChannelFunction) {
+		FDMXImportGDTFChannelSet ImportChannelSet;
+		ImportChannelSet.Name = ChannelFunction.Name.ToString();
+		ImportChannelSet.DMXFrom = ChannelFunction.DMXFrom;
+		ImportChannelSet.PhysicalFrom = ChannelFunction.PhysicalFrom;
+		ImportChannelSet.PhysicalTo = ChannelFunction.PhysicalTo;
+		ChannelFunction.ChannelSets.Add(ImportChannelSet);
+	}
+
+	template <typename TElement> static void ReadRelation(const TElement& Element, FDMXImportGDTFRelation& OutRelation) {
+		OutRelation.Name = Element.GetAttribute("Name");
+		OutRelation.Master = Element.GetAttribute("Master");
+		OutRelation.Follower = Element.GetAttribute("Follower");
+		OutRelation.Type = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFType>(Element.GetAttributeTemp("Type"));
+	}
+
+	/**
+	 * An emitter may be measured at several physical values of its channel: the one nearest to full power, so the highest, is kept
+	 *
+	 * @param bFound True if a measurement of the emitter was already kept
+	 * @param InOutPhysical Physical value of the kept measurement, updated if Element is better
+	 * @return True if Element must be kept instead of the previous one
+	 */
+	template <typename TElement> static bool IsBestMeasurement(const TElement& Element, bool bFound, float& InOutPhysical) {
+		float Physical = 0;
+		Element.ParseAttribute("Physical", Physical);
+		if (bFound && Physical <= InOutPhysical) return false;
+		InOutPhysical = Physical;
+		return true;
+	}
+
+	template <typename TElement> static void ReadMeasurement(const TElement& Element, FCPGDTFEmitterSpectrum& OutSpectrum) {
+		Element.ParseAttribute("Physical", OutSpectrum.Physical);
+		Element.ParseAttribute("LuminousIntensity", OutSpectrum.LuminousIntensity);
+	}
+
+	template <typename TElement> static void ReadMeasurementPoint(const TElement& Element, FCPGDTFEmitterSpectrum& OutSpectrum) {
+		float WaveLength = 0, Energy = 0;
+		Element.ParseAttribute("WaveLength", WaveLength);
+		Element.ParseAttribute("Energy", Energy);
+		OutSpectrum.WaveLengths.Add(WaveLength);
+		OutSpectrum.Energies.Add(Energy);
+	}
+
+	/// Instantiates the geometry object of a tag. Null if the geometry type is unknown
+	static UCPGDTFDescriptionGeometryBase* CreateGeometry(UCPGDTFDescription* DescriptionRoot, const FString& Tag) {
+		switch (CPGDTFDescription::GetEnumValueFromString<ECPGDTFDescriptionGeometryType>(Tag)) {
+		case ECPGDTFDescriptionGeometryType::Geometry: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometry>();
+		case ECPGDTFDescriptionGeometryType::Axis: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryAxis>();
+		case ECPGDTFDescriptionGeometryType::FilterBeam: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterBeam>();
+		case ECPGDTFDescriptionGeometryType::FilterColor: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterColor>();
+		case ECPGDTFDescriptionGeometryType::FilterGobo: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterGobo>();
+		case ECPGDTFDescriptionGeometryType::FilterShaper: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterShaper>();
+		case ECPGDTFDescriptionGeometryType::Beam: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryBeam>();
+		case ECPGDTFDescriptionGeometryType::GeometryReference: return DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryReference>();
+		default: return nullptr;
+		}
+	}
+
+	/// Reads the attributes of a geometry, the common ones and the ones of its type
+	template <typename TElement> static void ReadGeometry(const TElement& Element, UCPGDTFDescriptionGeometryBase* Geometry) {
+		// Base
+		Geometry->Name = Element.GetAttributeName("Name");
+		Geometry->Position = CPGDTFDescription::ParseMatrix(Element.GetAttributeTemp("Position"));
+		Geometry->Model = Element.GetAttributeName("Model");
+
+		if (UCPGDTFDescriptionGeometryBeam* GeometryBeam = Cast<UCPGDTFDescriptionGeometryBeam>(Geometry)) { // Beam specific
+			GeometryBeam->LampType = DMXImport::GetEnumValueFromString<EDMXImportGDTFLampType>(Element.GetAttributeTemp("LampType"));
+			Element.ParseAttribute("PowerConsumption", GeometryBeam->PowerConsumption);
+			Element.ParseAttribute("LuminousFlux", GeometryBeam->LuminousFlux);
+			Element.ParseAttribute("ColorTemperature", GeometryBeam->ColorTemperature);
+			Element.ParseAttribute("BeamAngle", GeometryBeam->BeamAngle);
+			Element.ParseAttribute("FieldAngle", GeometryBeam->FieldAngle);
+			Element.ParseAttribute("BeamRadius", GeometryBeam->BeamRadius);
+			GeometryBeam->BeamType = CPGDTFDescription::GetEnumValueFromString<ECPGDTFDescriptionGeometryBeamType>(Element.GetAttributeTemp("BeamType"));
+			Element.ParseAttribute("ColorRenderingIndex", GeometryBeam->ColorRenderingIndex);
+			Element.ParseAttribute("RectangleRatio", GeometryBeam->RectangleRatio);
+			Element.ParseAttribute("ThrowRatio", GeometryBeam->ThrowRatio);
+
+		} else if (UCPGDTFDescriptionGeometryReference* GeometryReference = Cast<UCPGDTFDescriptionGeometryReference>(Geometry)) { // GeometryReference specific
+			GeometryReference->Geometry = Element.GetAttributeName("Geometry");
+		}
+	}
+
+	template <typename TElement> static void ReadBreak(const TElement& Element, FDMXImportGDTFBreak& OutBreak) {
+		// Depending on the GDTF spec the Offset node may be called either 'DMXOffset' or 'Offset'
+		Element.ParseAttribute(Element.IsAttributeEmpty("DMXOffset") ? "Offset" : "DMXOffset", OutBreak.DMXOffset);
+
+		// Depending on the GDTF spec the Break node may be called either 'DMXBreak' or 'Break'
+		Element.ParseAttribute(Element.IsAttributeEmpty("DMXBreak") ? "Break" : "DMXBreak", OutBreak.DMXBreak);
+	}
+}
 
 /**
  * Creates the Importer of GDTF Descriptions
@@ -58,15 +371,20 @@ FCPGDTFDescriptionImporter::FCPGDTFDescriptionImporter(UPackage* Package, FName
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 04 may 2022
  */
-UCPGDTFDescription* FCPGDTFDescriptionImporter::Import() {
+UCPGDTFDescription* FCPGDTFDescriptionImporter::Import(bool bStreaming) {
 
-	FXmlFile* XML = ExtractXML();
-	if (XML == nullptr) {
+	if (!this->ExtractXMLBytes()) {
 		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Error extracting description.xml from GDTF archive"));
 		return nullptr;
 	}
-	this->XMLFile = XML;
 
+	// The pull parser only reads UTF-8, the (rare) UTF-16 descriptions go through the DOM
+	if (bStreaming && !FCPGDTFXmlReader::IsWideDocument(this->XMLBytes.GetData(), this->XMLBytes.Num())) return this->ParseXMLStreaming();
+
+	if (this->GetXML() == nullptr) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Error reading description.xml from GDTF archive"));
+		return nullptr;
+	}
 	UCPGDTFDescription* Asset = ParseXML();
 	return Asset;
 }
@@ -81,18 +399,13 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::Import() {
 UTexture2D* FCPGDTFDescriptionImporter::ImportThumbnail(UCPGDTFDescription* XMLDescription) {
 
 	// Check if the GDTF Description is already imported
-	if (this->XMLFile == nullptr) {
+	if (this->XMLBytes.Num() == 0) {
 		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Import GDTF before the thumbnail"));
 		return nullptr;
 	}
 
-	// Get Filename in XML
-	FString ThumbnailFileName;
-	const FXmlNode* FixtureTypeNode = this->XMLFile->GetRootNode()->GetFirstChildNode(); // Get the FixtureTypeNode
-	if (FixtureTypeNode) {
-		ThumbnailFileName = FixtureTypeNode->GetAttribute("Thumbnail").TrimStartAndEnd();
-	}
-
+	// Filename read with the description
+	const FString& ThumbnailFileName = this->ThumbnailFileName;
 	if (ThumbnailFileName.Equals("")) {
 		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Thumbnail filename not found in GDTF description"));
 		return nullptr;
@@ -114,7 +427,8 @@ UTexture2D* FCPGDTFDescriptionImporter::ImportThumbnail(UCPGDTFDescription* XMLD
  */
 const FXmlFile* FCPGDTFDescriptionImporter::GetXML() {
 	
-	return this->XMLFile;
+	if (!this->XMLFile.IsValid() && this->XMLBytes.Num() > 0) this->XMLFile = TUniquePtr<FXmlFile>(this->ExtractXML());
+	return this->XMLFile.Get();
 }
 
 /**
@@ -123,45 +437,24 @@ const FXmlFile* FCPGDTFDescriptionImporter::GetXML() {
  * @date 04 may 2022
  */
 UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
-
-	// Create new GDTF asset
-	UCPGDTFDescription* ImportObject = NewObject<UCPGDTFDescription>(this->Package, this->AssetName, this->Flags | RF_Public);
-
-	UDMXImportGDTFFixtureType* GDTFFixtureType = ImportObject->CreateNewObject<UDMXImportGDTFFixtureType>();
-	ImportObject->FixtureType = GDTFFixtureType;
-
-	UDMXImportGDTFAttributeDefinitions* GDTFAttributeDefinitions = ImportObject->CreateNewObject<UDMXImportGDTFAttributeDefinitions>();
-	ImportObject->AttributeDefinitions = GDTFAttributeDefinitions;
-
-	UDMXImportGDTFWheels* GDTFWheels = ImportObject->CreateNewObject<UDMXImportGDTFWheels>();
-	ImportObject->Wheels = GDTFWheels;
-
-	UDMXImportGDTFPhysicalDescriptions* GDTFPhysicalDescriptions = ImportObject->CreateNewObject<UDMXImportGDTFPhysicalDescriptions>();
-	ImportObject->PhysicalDescriptions = GDTFPhysicalDescriptions;
-
-	UCPGDTFDescriptionModels* GDTFModels = ImportObject->CreateNewObject<UCPGDTFDescriptionModels>();
-	ImportObject->Models = GDTFModels;
-
-	UCPGDTFDescriptionGeometries* GDTFGeometries = ImportObject->CreateNewObject<UCPGDTFDescriptionGeometries>();
-	ImportObject->Geometries = GDTFGeometries;
-
-	UDMXImportGDTFDMXModes* GDTFDMXModes = ImportObject->CreateNewObject<UDMXImportGDTFDMXModes>();
-	ImportObject->DMXModes = GDTFDMXModes;
-
-	UDMXImportGDTFProtocols* GDTFProtocols = ImportObject->CreateNewObject<UDMXImportGDTFProtocols>();
-	ImportObject->Protocols = GDTFProtocols;
+	using namespace CPGDTFDescriptionImporter;
+	using FNode = FXmlNodeAttributes;
+
+	UCPGDTFDescription* ImportObject = this->CreateDescription();
+	UDMXImportGDTFAttributeDefinitions* GDTFAttributeDefinitions = Cast<UDMXImportGDTFAttributeDefinitions>(ImportObject->AttributeDefinitions);
+	UDMXImportGDTFWheels* GDTFWheels = Cast<UDMXImportGDTFWheels>(ImportObject->Wheels);
+	UDMXImportGDTFPhysicalDescriptions* GDTFPhysicalDescriptions = Cast<UDMXImportGDTFPhysicalDescriptions>(ImportObject->PhysicalDescriptions);
+	UCPGDTFDescriptionModels* GDTFModels = Cast<UCPGDTFDescriptionModels>(ImportObject->Models);
+	UCPGDTFDescriptionGeometries* GDTFGeometries = Cast<UCPGDTFDescriptionGeometries>(ImportObject->Geometries);
+	UDMXImportGDTFDMXModes* GDTFDMXModes = Cast<UDMXImportGDTFDMXModes>(ImportObject->DMXModes);
+	UDMXImportGDTFProtocols* GDTFProtocols = Cast<UDMXImportGDTFProtocols>(ImportObject->Protocols);
 
 	if (const FXmlNode* XmlNode = this->XMLFile->GetRootNode())
 	{
+		this->DataVersion = FNode(XmlNode).GetAttribute("DataVersion");
 		if (const FXmlNode* FixtureTypeNode = XmlNode->FindChildNode("FixtureType"))
 		{
-			GDTFFixtureType->Description = FixtureTypeNode->GetAttribute("Description").TrimStartAndEnd();
-			GDTFFixtureType->FixtureTypeID = FixtureTypeNode->GetAttribute("FixtureTypeID").TrimStartAndEnd();
-			GDTFFixtureType->LongName = FixtureTypeNode->GetAttribute("LongName").TrimStartAndEnd();
-			GDTFFixtureType->Manufacturer = FixtureTypeNode->GetAttribute("Manufacturer").TrimStartAndEnd();
-			GDTFFixtureType->Name = FName(*FixtureTypeNode->GetAttribute("Name").TrimStartAndEnd());
-			GDTFFixtureType->ShortName = FixtureTypeNode->GetAttribute("ShortName").TrimStartAndEnd();
-			GDTFFixtureType->RefFT = FixtureTypeNode->GetAttribute("RefFT").TrimStartAndEnd();
+			ReadFixtureType(FNode(FixtureTypeNode), Cast<UDMXImportGDTFFixtureType>(ImportObject->FixtureType), this->ThumbnailFileName);
 
 			if (const FXmlNode* AttributeDefinitionsNode = FixtureTypeNode->FindChildNode("AttributeDefinitions"))
 			{
@@ -170,7 +463,7 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 					for (const FXmlNode* ActivationGroupNode : ActivationGroupsNode->GetChildrenNodes())
 					{
 						FDMXImportGDTFActivationGroup ActivationGroup;
-						ActivationGroup.Name = FName(*ActivationGroupNode->GetAttribute("Name").TrimStartAndEnd());
+						ActivationGroup.Name = FNode(ActivationGroupNode).GetAttributeName("Name");
 						GDTFAttributeDefinitions->ActivationGroups.Add(ActivationGroup);
 					}
 				}
@@ -179,21 +472,17 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				{
 					for (const FXmlNode* FeatureGroupNode : FeatureGroupsNode->GetChildrenNodes())
 					{
-						if (FeatureGroupNode != nullptr)
-						{
-							FDMXImportGDTFFeatureGroup FeatureGroup;
-							FeatureGroup.Name = FName(*FeatureGroupNode->GetAttribute("Name").TrimStartAndEnd());
-							FeatureGroup.Pretty = FeatureGroupNode->GetAttribute("Pretty").TrimStartAndEnd();
-
-							for (const FXmlNode* FeatureNode : FeatureGroupNode->GetChildrenNodes())
-							{
-								FDMXImportGDTFFeature Feature;
-								Feature.Name = FName(*FeatureNode->GetAttribute("Name").TrimStartAndEnd());
-								FeatureGroup.Features.Add(Feature);
-							}
+						FDMXImportGDTFFeatureGroup FeatureGroup;
+						ReadFeatureGroup(FNode(FeatureGroupNode), FeatureGroup);
 
-							GDTFAttributeDefinitions->FeatureGroups.Add(FeatureGroup);
+						for (const FXmlNode* FeatureNode : FeatureGroupNode->GetChildrenNodes())
+						{
+							FDMXImportGDTFFeature Feature;
+							Feature.Name = FNode(FeatureNode).GetAttributeName("Name");
+							FeatureGroup.Features.Add(Feature);
 						}
+
+						GDTFAttributeDefinitions->FeatureGroups.Add(FeatureGroup);
 					}
 				}
 
@@ -201,19 +490,9 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				{
 					for (const FXmlNode* AttributeNode : AttributesNode->GetChildrenNodes())
 					{
-						if (AttributeNode != nullptr)
-						{
-							FCPGDTFDescriptionAttribute Attribute;
-							Attribute.Name = FName(*AttributeNode->GetAttribute("Name").TrimStartAndEnd());
-							Attribute.Type = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(Attribute.Name.ToString());
-							Attribute.Pretty = AttributeNode->GetAttribute("Pretty").TrimStartAndEnd();
-							Attribute.ActivationGroup.Name = FName(*AttributeNode->GetAttribute("ActivationGroup").TrimStartAndEnd());
-							GDTFAttributeDefinitions->FindFeature(AttributeNode->GetAttribute("Feature").TrimStartAndEnd(), Attribute.Feature);
-							Attribute.MainAttribute = AttributeNode->GetAttribute ("MainAttribute").TrimStartAndEnd ();
-							Attribute.PhysicalUnit = DMXImport::GetEnumValueFromString<EDMXImportGDTFPhysicalUnit>(AttributeNode->GetAttribute("PhysicalUnit").TrimStartAndEnd());
-							Attribute.Color = DMXImport::ParseColorCIE(AttributeNode->GetAttribute("Color").TrimStartAndEnd());
-							GDTFAttributeDefinitions->Attributes.Add(Attribute);
-						}
+						FCPGDTFDescriptionAttribute Attribute;
+						ReadAttribute(FNode(AttributeNode), GDTFAttributeDefinitions, Attribute);
+						GDTFAttributeDefinitions->Attributes.Add(Attribute);
 					}
 				}
 			}
@@ -223,13 +502,12 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				for (const FXmlNode* WheelNode : WheelsNode->GetChildrenNodes())
 				{
 					FDMXImportGDTFWheel ImportWheel;
-					ImportWheel.Name = FName(*WheelNode->GetAttribute("Name").TrimStartAndEnd());
+					ImportWheel.Name = FNode(WheelNode).GetAttributeName("Name");
 
 					for (const FXmlNode* SlotNode : WheelNode->GetChildrenNodes())
 					{
 						FDMXImportGDTFWheelSlot ImportWheelSlot;
-						ImportWheelSlot.Name = FName(*SlotNode->GetAttribute("Name").TrimStartAndEnd());
-						ImportWheelSlot.Color = DMXImport::ParseColorCIE(SlotNode->GetAttribute("Color").TrimStartAndEnd());
+						ReadWheelSlot(FNode(SlotNode), ImportWheel.Name, ImportWheelSlot, this->WheelSlotsMedia);
 						ImportWheel.Slots.Add(ImportWheelSlot);
 					}
 
@@ -237,6 +515,9 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				}
 			}
 
+			// Measurements of the emitters, read once we know which emitters are used
+			TArray<TPair<FName, const FXmlNode*>> MeasurementNodes;
+
 			if (const FXmlNode* PhysicalDescriptionsNode = FixtureTypeNode->FindChildNode("PhysicalDescriptions"))
 			{
 				if (const FXmlNode* EmittersNode = PhysicalDescriptionsNode->FindChildNode("Emitters"))
@@ -244,35 +525,15 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 					for (const FXmlNode* EmitterNode : EmittersNode->GetChildrenNodes())
 					{
 						FDMXImportGDTFEmitter ImportEmitter;
+						ReadEmitter(FNode(EmitterNode), ImportEmitter);
 
-						ImportEmitter.Name = FName(*EmitterNode->GetAttribute("Name").TrimStartAndEnd());
-						ImportEmitter.Color = DMXImport::ParseColorCIE(EmitterNode->GetAttribute("Color").TrimStartAndEnd());
-						ImportEmitter.DiodePart = EmitterNode->GetAttribute("DiodePart").TrimStartAndEnd();
-						LexTryParseString(ImportEmitter.DominantWaveLength, *EmitterNode->GetAttribute("DominantWaveLength").TrimStartAndEnd());
-						ImportEmitter.DiodePart = EmitterNode->GetAttribute("DiodePart").TrimStartAndEnd();
-
-						/* Disabled for now. Unused by Unreal and slow down the GDTF Description editor because represent a lot of values
-						if (const FXmlNode* MeasurementNode = EmitterNode->FindChildNode("Measurement"))
-						{
-							FDMXImportGDTFMeasurement ImportMeasurement;
-
-							LexTryParseString(ImportMeasurement.Physical, *MeasurementNode->GetAttribute("DominantWaveLength").TrimStartAndEnd());
-							LexTryParseString(ImportMeasurement.LuminousIntensity, *MeasurementNode->GetAttribute("LuminousIntensity").TrimStartAndEnd());
-							LexTryParseString(ImportMeasurement.Transmission, *MeasurementNode->GetAttribute("Transmission").TrimStartAndEnd());
-							ImportMeasurement.InterpolationTo = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFInterpolationTo>(MeasurementNode->GetAttribute("InterpolationTo").TrimStartAndEnd());
-
-							for (const FXmlNode* MeasurementPointNode : MeasurementNode->GetChildrenNodes())
-							{
-								FDMXImportGDTFMeasurementPoint ImportMeasurementPoint;
-
-								LexTryParseString(ImportMeasurementPoint.Energy, *MeasurementPointNode->GetAttribute("Energy").TrimStartAndEnd());
-								LexTryParseString(ImportMeasurementPoint.WaveLength, *MeasurementPointNode->GetAttribute("WaveLength").TrimStartAndEnd());
-
-								ImportMeasurement.MeasurementPoints.Add(ImportMeasurementPoint);
-							}
-
-							ImportEmitter.Measurement = ImportMeasurement;
-						}*/
+						// The measurement points are not stored in ImportEmitter.Measurement: they slow the GDTF Description editor down. See EmitterSpectra
+						const FXmlNode* MeasurementNode = nullptr;
+						float MeasurementPhysical = 0;
+						for (const FXmlNode* ChildNode : EmitterNode->GetChildrenNodes()) {
+							if (ChildNode->GetTag() == TEXT("Measurement") && IsBestMeasurement(FNode(ChildNode), MeasurementNode != nullptr, MeasurementPhysical)) MeasurementNode = ChildNode;
+						}
+						if (MeasurementNode != nullptr) MeasurementNodes.Emplace(ImportEmitter.Name, MeasurementNode);
 
 						GDTFPhysicalDescriptions->Emitters.Add(ImportEmitter);
 					}
@@ -280,15 +541,7 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 
 				if (const FXmlNode* ColorSpaceNode = PhysicalDescriptionsNode->FindChildNode("ColorSpace"))
 				{
-					FDMXImportGDTFColorSpace ImportColorSpace;
-					ImportColorSpace.Mode = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFMode>(ColorSpaceNode->GetAttribute("Mode").TrimStartAndEnd());
-					ImportColorSpace.Description = ColorSpaceNode->GetAttribute("Description").TrimStartAndEnd();
-					ImportColorSpace.Red = DMXImport::ParseColorCIE(ColorSpaceNode->GetAttribute("Red").TrimStartAndEnd());
-					ImportColorSpace.Blue = DMXImport::ParseColorCIE(ColorSpaceNode->GetAttribute("Blue").TrimStartAndEnd());
-					ImportColorSpace.Green = DMXImport::ParseColorCIE(ColorSpaceNode->GetAttribute("Green").TrimStartAndEnd());
-					ImportColorSpace.WhitePoint = DMXImport::ParseColorCIE(ColorSpaceNode->GetAttribute("WhitePoint").TrimStartAndEnd());
-
-					GDTFPhysicalDescriptions->ColorSpace = ImportColorSpace;
+					ReadColorSpace(FNode(ColorSpaceNode), GDTFPhysicalDescriptions->ColorSpace);
 				}
 			}
 
@@ -297,17 +550,7 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				for (const FXmlNode* ModelNode : ModelsNode->GetChildrenNodes())
 				{
 					FCPGDTFDescriptionModel ImportModel;
-
-					ImportModel.Name = FName(*ModelNode->GetAttribute("Name").TrimStartAndEnd());
-					LexTryParseString(ImportModel.Length, *ModelNode->GetAttribute("Length").TrimStartAndEnd());
-					ImportModel.Length *= 100.0f; // Conversion from GDTF meters to Unreal centimeters default unit
-					LexTryParseString(ImportModel.Width, *ModelNode->GetAttribute("Width").TrimStartAndEnd());
-					ImportModel.Width *= 100.0f; // Conversion from GDTF meters to Unreal centimeters default unit
-					LexTryParseString(ImportModel.Height, *ModelNode->GetAttribute("Height").TrimStartAndEnd());
-					ImportModel.Height *= 100.0f; // Conversion from GDTF meters to Unreal centimeters default unit
-					ImportModel.PrimitiveType = CPGDTFDescription::GetEnumValueFromString<ECPGDTFDescriptionModelsPrimitiveType>(ModelNode->GetAttribute("PrimitiveType").TrimStartAndEnd());
-					ImportModel.File = FName(*ModelNode->GetAttribute("File").TrimStartAndEnd());
-
+					ReadModel(FNode(ModelNode), ImportModel);
 					GDTFModels->Models.Add(ImportModel);
 				}
 			}
@@ -320,6 +563,9 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				}
 			}
 
+			// The DMX modes reference the sections above by name
+			this->IndexReferencedSections(ImportObject);
+
 			// Depending on the GDTF spec the Break node may be called either 'DMXModes' or 'Modes'.
 			const FXmlNode* const ModesNode = FCPGDTFDescriptionImporter::FindChildNodeEvenIfDMXSubstringIsMissing(*FixtureTypeNode, TEXT("DMXModes"));
 			if (ModesNode)
@@ -327,8 +573,7 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 				for (const FXmlNode* DMXModeNode : ModesNode->GetChildrenNodes())
 				{
 					FDMXImportGDTFDMXMode DMXGDTFDescriptionDMXMode;
-					DMXGDTFDescriptionDMXMode.Name = FName(*DMXModeNode->GetAttribute("Name").TrimStartAndEnd());
-					DMXGDTFDescriptionDMXMode.Geometry = FName(*DMXModeNode->GetAttribute("Geometry").TrimStartAndEnd());
+					ReadDMXMode(FNode(DMXModeNode), DMXGDTFDescriptionDMXMode);
 
 					// Depending on the GDTF spec in use modes may be stored in the "Modes" or "DMXModes" node.
 					const FXmlNode* const ChannelsNode = FCPGDTFDescriptionImporter::FindChildNodeEvenIfDMXSubstringIsMissing(*DMXModeNode, TEXT("DMXChannels"));
@@ -337,117 +582,36 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 						for (const FXmlNode* DMXChannelNode : ChannelsNode->GetChildrenNodes())
 						{
 							FCPDMXImportGDTFDMXChannel ImportDMXChannel;
-
-							// Ignore Channels that do not specify a valid offset.
-							// E.g. 'Robe Lighting s.r.o.@Robin 800X LEDWash.gdtf' specifies virtual Dimmer channels that have no offset and cannot be accessed.
-							if (!ImportDMXChannel.ParseOffset(DMXChannelNode->GetAttribute("Offset").TrimStartAndEnd()))
-							{
-								continue;
-							}
-
-							ImportDMXChannel.Highlight = FDMXImportGDTFDMXValue (DMXChannelNode->GetAttribute("Highlight").TrimStartAndEnd());
-							ImportDMXChannel.Geometry = FName(*DMXChannelNode->GetAttribute("Geometry").TrimStartAndEnd());
-							LexTryParseString(ImportDMXChannel.DMXBreak, *DMXChannelNode->GetAttribute("DMXBreak").TrimStartAndEnd());
+							FString InitialFunction;
+							if (!ReadDMXChannel(FNode(DMXChannelNode), ImportDMXChannel, InitialFunction)) continue;
 
 							for (const FXmlNode* LogicalChannelNode : DMXChannelNode->GetChildrenNodes()) {
 								FCPDMXImportGDTFLogicalChannel ImportLogicalChannel;
-
-								GDTFAttributeDefinitions->FindAtributeByName(*LogicalChannelNode->GetAttribute("Attribute").TrimStartAndEnd(), ImportLogicalChannel.Attribute);
-								ImportLogicalChannel.Snap = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFSnap>(LogicalChannelNode->GetAttribute("Snap").TrimStartAndEnd());
-								ImportLogicalChannel.Master = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFMaster>(LogicalChannelNode->GetAttribute("Master").TrimStartAndEnd());
-
-								LexTryParseString(ImportLogicalChannel.MibFade, *LogicalChannelNode->GetAttribute("MibFade").TrimStartAndEnd());
-								LexTryParseString(ImportLogicalChannel.DMXChangeTimeLimit, *LogicalChannelNode->GetAttribute("DMXChangeTimeLimit").TrimStartAndEnd());
+								this->ReadLogicalChannel(FNode(LogicalChannelNode), ImportObject, ImportLogicalChannel);
 
 								for (const FXmlNode* ChannelFunctionNode : LogicalChannelNode->GetChildrenNodes()) {
-
 									FCPDMXImportGDTFChannelFunction ImportChannelFunction;
-									ImportChannelFunction.Name = FName(*ChannelFunctionNode->GetAttribute("Name").TrimStartAndEnd());
-									GDTFAttributeDefinitions->FindAtributeByName(*ChannelFunctionNode->GetAttribute("Attribute").TrimStartAndEnd(), ImportChannelFunction.Attribute);
-									ImportChannelFunction.OriginalAttribute = *ChannelFunctionNode->GetAttribute("OriginalAttribute").TrimStartAndEnd();
-									ImportChannelFunction.DMXFrom = FDMXImportGDTFDMXValue(ChannelFunctionNode->GetAttribute("DMXFrom").TrimStartAndEnd());
-									ImportChannelFunction.DMXValue = FDMXImportGDTFDMXValue(ChannelFunctionNode->GetAttribute("DMXValue").TrimStartAndEnd());
-									ImportChannelFunction.Default = FDMXImportGDTFDMXValue(ChannelFunctionNode->GetAttribute("Default").TrimStartAndEnd());
-
-									LexTryParseString(ImportChannelFunction.PhysicalFrom, *ChannelFunctionNode->GetAttribute("PhysicalFrom").TrimStartAndEnd());
-									if (ChannelFunctionNode->GetAttribute("PhysicalTo").TrimStartAndEnd().IsEmpty()) ImportChannelFunction.PhysicalTo = 1.0f;
-									else LexTryParseString(ImportChannelFunction.PhysicalTo, *ChannelFunctionNode->GetAttribute("PhysicalTo").TrimStartAndEnd());
-									LexTryParseString(ImportChannelFunction.RealFade, *ChannelFunctionNode->GetAttribute("RealFade").TrimStartAndEnd());
-									LexTryParseString(ImportChannelFunction.RealAcceleration, *ChannelFunctionNode->GetAttribute("RealAcceleration").TrimStartAndEnd());
-
-									GDTFWheels->FindWeelByName(*ChannelFunctionNode->GetAttribute("Wheel").TrimStartAndEnd(), ImportChannelFunction.Wheel);
-									GDTFPhysicalDescriptions->FindEmitterByName(*ChannelFunctionNode->GetAttribute("Emitter").TrimStartAndEnd(), ImportChannelFunction.Emitter);
-
-									ImportChannelFunction.DMXInvert = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFDMXInvert>(ChannelFunctionNode->GetAttribute("DMXInvert").TrimStartAndEnd());
-									ImportChannelFunction.ModeMaster = *ChannelFunctionNode->GetAttribute("ModeMaster").TrimStartAndEnd();
-									ImportChannelFunction.ModeFrom = FDMXImportGDTFDMXValue(ChannelFunctionNode->GetAttribute("ModeFrom").TrimStartAndEnd());
-									ImportChannelFunction.ModeTo = FDMXImportGDTFDMXValue(ChannelFunctionNode->GetAttribute("ModeTo").TrimStartAndEnd());
-
-									if (ChannelFunctionNode->GetChildrenNodes().Num() > 0) {
-										for (const FXmlNode* ChannelSetNode : ChannelFunctionNode->GetChildrenNodes()) {
-											FDMXImportGDTFChannelSet ImportChannelSet;
-
-											ImportChannelSet.Name = *ChannelSetNode->GetAttribute("Name").TrimStartAndEnd();
-											ImportChannelSet.DMXFrom = FDMXImportGDTFDMXValue(ChannelSetNode->GetAttribute("DMXFrom").TrimStartAndEnd());
-											if (LexTryParseString(ImportChannelSet.WheelSlotIndex, *ChannelSetNode->GetAttribute("WheelSlotIndex").TrimStartAndEnd()))
-												ImportChannelSet.WheelSlotIndex--; // The starting index is 1 in GDTF Spec
-
-											if (ChannelSetNode->GetAttribute("PhysicalFrom").TrimStartAndEnd().IsEmpty()) {
-												ImportChannelSet.PhysicalFrom = PHYSICAL_CHANNEL_SET_PLACEHOLDER;
-											} else LexTryParseString(ImportChannelSet.PhysicalFrom, *ChannelSetNode->GetAttribute("PhysicalFrom").TrimStartAndEnd());
-
-											if (ChannelSetNode->GetAttribute("PhysicalTo").TrimStartAndEnd().IsEmpty()) {
-												ImportChannelSet.PhysicalTo = PHYSICAL_CHANNEL_SET_PLACEHOLDER;
-											} else LexTryParseString(ImportChannelSet.PhysicalTo, *ChannelSetNode->GetAttribute("PhysicalTo").TrimStartAndEnd());
-
-											ImportChannelFunction.ChannelSets.Add(ImportChannelSet);
-										}
-									} else {
+									this->ReadChannelFunction(FNode(ChannelFunctionNode), ImportObject, ImportChannelFunction);
+
+									for (const FXmlNode* ChannelSetNode : ChannelFunctionNode->GetChildrenNodes()) {
 										FDMXImportGDTFChannelSet ImportChannelSet;
-										ImportChannelSet.Name = ImportChannelFunction.Name.ToString();
-										ImportChannelSet.DMXFrom = ImportChannelFunction.DMXFrom;
-										ImportChannelSet.PhysicalFrom = ImportChannelFunction.PhysicalFrom;
-										ImportChannelSet.PhysicalTo = ImportChannelFunction.PhysicalTo;
+										ReadChannelSet(FNode(ChannelSetNode), ImportChannelSet);
 										ImportChannelFunction.ChannelSets.Add(ImportChannelSet);
 									}
-									
+									if (ImportChannelFunction.ChannelSets.Num() == 0) AddDefaultChannelSet(ImportChannelFunction);
+
 									ImportLogicalChannel.ChannelFunctions.Add(ImportChannelFunction);
 								}
 
 								//Fix the channelset physical from/to
-								int lastDmx = (1 << 8 * ImportDMXChannel.Offset.Num()) - 1;
-								for (int cfIdx = ImportLogicalChannel.ChannelFunctions.Num() - 1; cfIdx >= 0; cfIdx--) {
-									FDMXImportGDTFChannelFunction* cf = &ImportLogicalChannel.ChannelFunctions[cfIdx];
-									float physicalDiff = cf->PhysicalTo - cf->PhysicalFrom;
-									int endAddress = lastDmx, startAddress = cf->DMXFrom.Value;
-									int addrDiff = endAddress - startAddress;
-
-									for (int csIdx = cf->ChannelSets.Num() - 1; csIdx >= 0; csIdx--) {
-										FDMXImportGDTFChannelSet* cs = &cf->ChannelSets[csIdx];
-										FDMXImportGDTFChannelSet* csPrev = csIdx > 0 ? &cf->ChannelSets[csIdx - 1] : nullptr;;
-										int currentAddress = cs->DMXFrom.Value;
-										lastDmx = currentAddress - 1;
-
-										//actual fix
-										//current->from
-										if (cs->PhysicalFrom == PHYSICAL_CHANNEL_SET_PLACEHOLDER)
-											cs->PhysicalFrom = (physicalDiff * ((float)(currentAddress - startAddress)) / addrDiff) + cf->PhysicalFrom; //phys : diffPhys = dmx : diffDmx
-										//prev->to
-										if (csPrev != nullptr && csPrev->PhysicalTo == PHYSICAL_CHANNEL_SET_PLACEHOLDER)
-											csPrev->PhysicalTo = cs->PhysicalFrom;
-										//current->to. If it hasn't already fixed, it means we're the first channelset, so our to-value should be obtained from the channel function
-										if (cs->PhysicalTo == PHYSICAL_CHANNEL_SET_PLACEHOLDER)
-											cs->PhysicalTo = cf->PhysicalTo;
-									}
-								}
+								FixChannelSetsPhysical(ImportLogicalChannel, ImportDMXChannel.Offset.Num());
 
 								ImportDMXChannel.LogicalChannels.Add(ImportLogicalChannel);
 							}
 							
 							//Set the default dmxchannel value
-							FString initialFunction = DMXChannelNode->GetAttribute("InitialFunction").TrimStartAndEnd();
-							if (!initialFunction.IsEmpty())
-								ImportDMXChannel.Default = ImportDMXChannel.getChannelFunctionByName(initialFunction)->Default;
+							if (!InitialFunction.IsEmpty())
+								ImportDMXChannel.Default = ImportDMXChannel.getChannelFunctionByName(InitialFunction)->Default;
 
 							DMXGDTFDescriptionDMXMode.DMXChannels.Add(ImportDMXChannel);
 						}
@@ -458,11 +622,7 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 						for (const FXmlNode* RelationNode : RelationsNode->GetChildrenNodes())
 						{
 							FDMXImportGDTFRelation ImportRelation;
-							ImportRelation.Name = RelationNode->GetAttribute("Name").TrimStartAndEnd();
-							ImportRelation.Master = RelationNode->GetAttribute("Master").TrimStartAndEnd();
-							ImportRelation.Follower = RelationNode->GetAttribute("Follower").TrimStartAndEnd();
-							ImportRelation.Type = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFType>(RelationNode->GetAttribute("Type").TrimStartAndEnd());
-
+							ReadRelation(FNode(RelationNode), ImportRelation);
 							DMXGDTFDescriptionDMXMode.Relations.Add(ImportRelation);
 						}
 					}
@@ -472,7 +632,7 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 						for (const FXmlNode* FTMacroNode : FTMacrosNode->GetChildrenNodes())
 						{
 							FDMXImportGDTFFTMacro ImportFTMacro;
-							ImportFTMacro.Name = FName(*FTMacroNode->GetAttribute("Name").TrimStartAndEnd());
+							ImportFTMacro.Name = FNode(FTMacroNode).GetAttributeName("Name");
 							DMXGDTFDescriptionDMXMode.FTMacros.Add(ImportFTMacro);
 						}
 					}
@@ -488,14 +648,409 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
 					GDTFProtocols->Protocols.Add(FName(*ProtocolNode->GetTag()));
 				}
 			}
+
+			TSet<FName> ReferencedEmitters;
+			CollectReferencedEmitters(ImportObject, ReferencedEmitters);
+			for (const TPair<FName, const FXmlNode*>& Measurement : MeasurementNodes) {
+				if (!ReferencedEmitters.Contains(Measurement.Key) || ImportObject->FindEmitterSpectrum(Measurement.Key) != nullptr) continue;
+
+				FCPGDTFEmitterSpectrum Spectrum;
+				Spectrum.Emitter = Measurement.Key;
+				ReadMeasurement(FNode(Measurement.Value), Spectrum);
+				for (const FXmlNode* PointNode : Measurement.Value->GetChildrenNodes()) ReadMeasurementPoint(FNode(PointNode), Spectrum);
+
+				FinishEmitterSpectrum(Spectrum);
+				ImportObject->EmitterSpectra.Add(Measurement.Key, MoveTemp(Spectrum));
+			}
+
+			this->CheckGeometryReferences(ImportObject);
+		}
+	}
+
+	return ImportObject;
+}
+
+/**
+ * Read the XML bytes with the pull parser and create the GDTF Description, without building the XML DOM
+ *
+ * @return May be null if the XML file is malformed
+ */
+UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXMLStreaming() {
+	using namespace CPGDTFDescriptionImporter;
+	using FMark = FCPGDTFXmlReader::FMark;
+
+	FCPGDTFXmlReader Reader(this->XMLBytes.GetData(), this->XMLBytes.Num());
+
+	// First pass on the root: finds the FixtureType and checks that the whole document is well formed before creating anything
+	static const ANSICHAR* const RootTags[] = { "FixtureType" };
+	TArray<FMark> RootMarks;
+	if (Reader.Next() == FCPGDTFXmlReader::EToken::StartElement) {
+		this->DataVersion = Reader.GetAttribute("DataVersion");
+		Reader.FindChildren(RootTags, RootMarks);
+	}
+	if (Reader.HasError() || Reader.Next() != FCPGDTFXmlReader::EToken::EndOfDocument) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Malformed description.xml: %s"), Reader.HasError() ? *Reader.GetError() : TEXT("no root element"));
+		return nullptr;
+	}
+
+	UCPGDTFDescription* ImportObject = this->CreateDescription();
+	UDMXImportGDTFAttributeDefinitions* GDTFAttributeDefinitions = Cast<UDMXImportGDTFAttributeDefinitions>(ImportObject->AttributeDefinitions);
+	UDMXImportGDTFWheels* GDTFWheels = Cast<UDMXImportGDTFWheels>(ImportObject->Wheels);
+	UDMXImportGDTFPhysicalDescriptions* GDTFPhysicalDescriptions = Cast<UDMXImportGDTFPhysicalDescriptions>(ImportObject->PhysicalDescriptions);
+	UCPGDTFDescriptionModels* GDTFModels = Cast<UCPGDTFDescriptionModels>(ImportObject->Models);
+	UCPGDTFDescriptionGeometries* GDTFGeometries = Cast<UCPGDTFDescriptionGeometries>(ImportObject->Geometries);
+	UDMXImportGDTFDMXModes* GDTFDMXModes = Cast<UDMXImportGDTFDMXModes>(ImportObject->DMXModes);
+	UDMXImportGDTFProtocols* GDTFProtocols = Cast<UDMXImportGDTFProtocols>(ImportObject->Protocols);
+
+	int32 FixtureTypeDepth;
+	if (!EnterChild(Reader, RootMarks[0], FixtureTypeDepth)) return ImportObject;
+
+	ReadFixtureType(Reader, Cast<UDMXImportGDTFFixtureType>(ImportObject->FixtureType), this->ThumbnailFileName);
+
+	// The sections are read in the same order than the DOM parser: the DMX modes reference the attributes, wheels and emitters whatever their position in the file
+	enum { AttributeDefinitions, Wheels, PhysicalDescriptions, Models, Geometries, DMXModes, Modes, Protocols };
+	static const ANSICHAR* const FixtureTypeTags[] = { "AttributeDefinitions", "Wheels", "PhysicalDescriptions", "Models", "Geometries", "DMXModes", "Modes", "Protocols" };
+	TArray<FMark> Sections;
+	Reader.FindChildren(FixtureTypeTags, Sections);
+	int32 SectionDepth, Depth;
+
+	// Measurements of the emitters, only located during the first pass: the points are read once we know which emitters are used
+	TArray<TPair<FName, FMark>> MeasurementMarks;
+
+	if (EnterChild(Reader, Sections[AttributeDefinitions], SectionDepth)) {
+
+		enum { ActivationGroups, FeatureGroups, Attributes };
+		static const ANSICHAR* const AttributeDefinitionsTags[] = { "ActivationGroups", "FeatureGroups", "Attributes" };
+		TArray<FMark> Marks;
+		Reader.FindChildren(AttributeDefinitionsTags, Marks);
+
+		if (EnterChild(Reader, Marks[ActivationGroups], Depth)) {
+			while (Reader.NextChild(Depth)) {
+				FDMXImportGDTFActivationGroup ActivationGroup;
+				ActivationGroup.Name = Reader.GetAttributeName("Name");
+				GDTFAttributeDefinitions->ActivationGroups.Add(ActivationGroup);
+			}
+		}
+
+		if (EnterChild(Reader, Marks[FeatureGroups], Depth)) {
+			while (Reader.NextChild(Depth)) {
+				FDMXImportGDTFFeatureGroup FeatureGroup;
+				ReadFeatureGroup(Reader, FeatureGroup);
+				const int32 FeatureGroupDepth = Reader.GetDepth();
+				while (Reader.NextChild(FeatureGroupDepth)) {
+					FDMXImportGDTFFeature Feature;
+					Feature.Name = Reader.GetAttributeName("Name");
+					FeatureGroup.Features.Add(Feature);
+				}
+				GDTFAttributeDefinitions->FeatureGroups.Add(FeatureGroup);
+			}
+		}
+
+		if (EnterChild(Reader, Marks[Attributes], Depth)) {
+			while (Reader.NextChild(Depth)) {
+				FCPGDTFDescriptionAttribute Attribute;
+				ReadAttribute(Reader, GDTFAttributeDefinitions, Attribute);
+				GDTFAttributeDefinitions->Attributes.Add(Attribute);
+			}
+		}
+	}
+
+	if (EnterChild(Reader, Sections[Wheels], SectionDepth)) {
+		while (Reader.NextChild(SectionDepth)) {
+			FDMXImportGDTFWheel ImportWheel;
+			ImportWheel.Name = Reader.GetAttributeName("Name");
+			const int32 WheelDepth = Reader.GetDepth();
+			while (Reader.NextChild(WheelDepth)) {
+				FDMXImportGDTFWheelSlot ImportWheelSlot;
+				ReadWheelSlot(Reader, ImportWheel.Name, ImportWheelSlot, this->WheelSlotsMedia);
+				ImportWheel.Slots.Add(ImportWheelSlot);
+			}
+			GDTFWheels->Wheels.Add(ImportWheel);
+		}
+	}
+
+	if (EnterChild(Reader, Sections[PhysicalDescriptions], SectionDepth)) {
+
+		enum { Emitters, ColorSpace };
+		static const ANSICHAR* const PhysicalDescriptionsTags[] = { "Emitters", "ColorSpace" };
+		TArray<FMark> Marks;
+		Reader.FindChildren(PhysicalDescriptionsTags, Marks);
+
+		if (EnterChild(Reader, Marks[Emitters], Depth)) {
+			while (Reader.NextChild(Depth)) {
+				FDMXImportGDTFEmitter ImportEmitter;
+				ReadEmitter(Reader, ImportEmitter);
+
+				FMark MeasurementMark;
+				float MeasurementPhysical = 0;
+				const int32 EmitterDepth = Reader.GetDepth();
+				while (Reader.NextChild(EmitterDepth)) {
+					if (Reader.IsTag("Measurement") && IsBestMeasurement(Reader, MeasurementMark.IsValid(), MeasurementPhysical)) MeasurementMark = Reader.GetMark();
+				}
+				if (MeasurementMark.IsValid()) MeasurementMarks.Emplace(ImportEmitter.Name, MeasurementMark);
+
+				GDTFPhysicalDescriptions->Emitters.Add(ImportEmitter);
+			}
+		}
+
+		if (EnterChild(Reader, Marks[ColorSpace], Depth)) {
+			ReadColorSpace(Reader, GDTFPhysicalDescriptions->ColorSpace);
+		}
+	}
+
+	if (EnterChild(Reader, Sections[Models], SectionDepth)) {
+		while (Reader.NextChild(SectionDepth)) {
+			FCPGDTFDescriptionModel ImportModel;
+			ReadModel(Reader, ImportModel);
+			GDTFModels->Models.Add(ImportModel);
 		}
 	}
 
+	if (EnterChild(Reader, Sections[Geometries], SectionDepth)) {
+		while (Reader.NextChild(SectionDepth)) {
+			GDTFGeometries->Geometries.Add(this->ParseGeometriesElement(ImportObject, Reader));
+		}
+	}
+
+	// The DMX modes reference the sections above by name
+	this->IndexReferencedSections(ImportObject);
+
+	// Depending on the GDTF spec the Break node may be called either 'DMXModes' or 'Modes'.
+	if (EnterChild(Reader, Sections[DMXModes].IsValid() ? Sections[DMXModes] : Sections[Modes], SectionDepth)) {
+		while (Reader.NextChild(SectionDepth)) {
+			FDMXImportGDTFDMXMode DMXGDTFDescriptionDMXMode;
+			ReadDMXMode(Reader, DMXGDTFDescriptionDMXMode);
+
+			enum { DMXChannels, Channels, Relations, FTMacros };
+			static const ANSICHAR* const DMXModeTags[] = { "DMXChannels", "Channels", "Relations", "FTMacros" };
+			TArray<FMark> Marks;
+			Reader.FindChildren(DMXModeTags, Marks);
+
+			// Depending on the GDTF spec in use modes may be stored in the "Modes" or "DMXModes" node.
+			if (EnterChild(Reader, Marks[DMXChannels].IsValid() ? Marks[DMXChannels] : Marks[Channels], Depth)) {
+				while (Reader.NextChild(Depth)) {
+					FCPDMXImportGDTFDMXChannel ImportDMXChannel;
+					FString InitialFunction;
+					if (!ReadDMXChannel(Reader, ImportDMXChannel, InitialFunction)) continue;
+
+					const int32 DMXChannelDepth = Reader.GetDepth();
+					while (Reader.NextChild(DMXChannelDepth)) {
+						FCPDMXImportGDTFLogicalChannel ImportLogicalChannel;
+						this->ReadLogicalChannel(Reader, ImportObject, ImportLogicalChannel);
+
+						const int32 LogicalChannelDepth = Reader.GetDepth();
+						while (Reader.NextChild(LogicalChannelDepth)) {
+							FCPDMXImportGDTFChannelFunction ImportChannelFunction;
+							this->ReadChannelFunction(Reader, ImportObject, ImportChannelFunction);
+
+							const int32 ChannelFunctionDepth = Reader.GetDepth();
+							while (Reader.NextChild(ChannelFunctionDepth)) {
+								FDMXImportGDTFChannelSet ImportChannelSet;
+								ReadChannelSet(Reader, ImportChannelSet);
+								ImportChannelFunction.ChannelSets.Add(ImportChannelSet);
+							}
+							if (ImportChannelFunction.ChannelSets.Num() == 0) AddDefaultChannelSet(ImportChannelFunction);
+
+							ImportLogicalChannel.ChannelFunctions.Add(ImportChannelFunction);
+						}
+
+						//Fix the channelset physical from/to
+						FixChannelSetsPhysical(ImportLogicalChannel, ImportDMXChannel.Offset.Num());
+
+						ImportDMXChannel.LogicalChannels.Add(ImportLogicalChannel);
+					}
+
+					//Set the default dmxchannel value
+					if (!InitialFunction.IsEmpty())
+						ImportDMXChannel.Default = ImportDMXChannel.getChannelFunctionByName(InitialFunction)->Default;
+
+					DMXGDTFDescriptionDMXMode.DMXChannels.Add(ImportDMXChannel);
+				}
+			}
+
+			if (EnterChild(Reader, Marks[Relations], Depth)) {
+				while (Reader.NextChild(Depth)) {
+					FDMXImportGDTFRelation ImportRelation;
+					ReadRelation(Reader, ImportRelation);
+					DMXGDTFDescriptionDMXMode.Relations.Add(ImportRelation);
+				}
+			}
+
+			if (EnterChild(Reader, Marks[FTMacros], Depth)) {
+				while (Reader.NextChild(Depth)) {
+					FDMXImportGDTFFTMacro ImportFTMacro;
+					ImportFTMacro.Name = Reader.GetAttributeName("Name");
+					DMXGDTFDescriptionDMXMode.FTMacros.Add(ImportFTMacro);
+				}
+			}
+
+			GDTFDMXModes->DMXModes.Add(DMXGDTFDescriptionDMXMode);
+		}
+	}
+
+	if (EnterChild(Reader, Sections[Protocols], SectionDepth)) {
+		while (Reader.NextChild(SectionDepth)) {
+			const FAnsiStringView Tag = Reader.GetTag();
+			GDTFProtocols->Protocols.Add(FName(Tag.Len(), Tag.GetData()));
+		}
+	}
+
+	TSet<FName> ReferencedEmitters;
+	CollectReferencedEmitters(ImportObject, ReferencedEmitters);
+	for (const TPair<FName, FMark>& Measurement : MeasurementMarks) {
+		if (!ReferencedEmitters.Contains(Measurement.Key) || ImportObject->FindEmitterSpectrum(Measurement.Key) != nullptr) continue;
+		if (!EnterChild(Reader, Measurement.Value, Depth)) continue;
+
+		FCPGDTFEmitterSpectrum Spectrum;
+		Spectrum.Emitter = Measurement.Key;
+		ReadMeasurement(Reader, Spectrum);
+		while (Reader.NextChild(Depth)) ReadMeasurementPoint(Reader, Spectrum);
+
+		FinishEmitterSpectrum(Spectrum);
+		ImportObject->EmitterSpectra.Add(Measurement.Key, MoveTemp(Spectrum));
+	}
+
+	this->CheckGeometryReferences(ImportObject);
 	return ImportObject;
 }
 
 /**
- * Extract and read description.xml inside GDTF archive.
+ * Build the name to index maps of the attributes, wheels, emitters and geometries. To call once these sections are parsed, before the DMX modes
+ */
+void FCPGDTFDescriptionImporter::IndexReferencedSections(UCPGDTFDescription* Description) {
+	using namespace CPGDTFDescriptionImporter;
+
+	// Like the linear searches the first element wins if a name is used twice
+	IndexByName(Cast<UDMXImportGDTFAttributeDefinitions>(Description->AttributeDefinitions)->Attributes, this->AttributeIndices);
+	IndexByName(Cast<UDMXImportGDTFWheels>(Description->Wheels)->Wheels, this->WheelIndices);
+	IndexByName(Cast<UDMXImportGDTFPhysicalDescriptions>(Description->PhysicalDescriptions)->Emitters, this->EmitterIndices);
+
+	const TArray<UCPGDTFDescriptionGeometryBase*>& Geometries = Cast<UCPGDTFDescriptionGeometries>(Description->Geometries)->Geometries;
+	this->GeometryIndices.Empty(Geometries.Num());
+	this->GeometryNames.Empty();
+	for (int32 i = 0; i < Geometries.Num(); i++) {
+		if (Geometries[i] == nullptr) continue;
+		if (!this->GeometryIndices.Contains(Geometries[i]->Name)) this->GeometryIndices.Add(Geometries[i]->Name, i);
+		ForEachGeometry(Geometries[i], [this](const UCPGDTFDescriptionGeometryBase* Geometry) { this->GeometryNames.Add(Geometry->Name); });
+	}
+}
+
+/**
+ * Find an element of a section by its name with the maps of IndexReferencedSections(). Reports the dangling references
+ */
+template <typename TItem> bool FCPGDTFDescriptionImporter::ResolveReference(const TMap<FName, int32>& Indices, const TArray<TItem>& Items, FName Name, TItem& OutItem, const TCHAR* Section) {
+	if (const int32* Index = Indices.Find(Name)) {
+		OutItem = Items[*Index];
+		return true;
+	}
+	if (!Name.IsNone() && Name != NO_FEATURE_ATTRIBUTE) this->ReportDanglingReference(Section, Name);
+	return false;
+}
+
+/**
+ * Reads a logical channel, without its channel functions, resolving its attribute
+ */
+template <typename TElement> void FCPGDTFDescriptionImporter::ReadLogicalChannel(const TElement& Element, UCPGDTFDescription* Description, FCPDMXImportGDTFLogicalChannel& OutLogicalChannel) {
+	this->ResolveReference(this->AttributeIndices, Cast<UDMXImportGDTFAttributeDefinitions>(Description->AttributeDefinitions)->Attributes, Element.GetAttributeName("Attribute"), OutLogicalChannel.Attribute, TEXT("Attribute"));
+	OutLogicalChannel.Snap = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFSnap>(Element.GetAttributeTemp("Snap"));
+	OutLogicalChannel.Master = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFMaster>(Element.GetAttributeTemp("Master"));
+	Element.ParseAttribute("MibFade", OutLogicalChannel.MibFade);
+	Element.ParseAttribute("DMXChangeTimeLimit", OutLogicalChannel.DMXChangeTimeLimit);
+}
+
+/**
+ * Reads a channel function, without its channel sets, resolving its attribute, wheel and emitter
+ */
+template <typename TElement> void FCPGDTFDescriptionImporter::ReadChannelFunction(const TElement& Element, UCPGDTFDescription* Description, FCPDMXImportGDTFChannelFunction& OutChannelFunction) {
+	OutChannelFunction.Name = Element.GetAttributeName("Name");
+	this->ResolveReference(this->AttributeIndices, Cast<UDMXImportGDTFAttributeDefinitions>(Description->AttributeDefinitions)->Attributes, Element.GetAttributeName("Attribute"), OutChannelFunction.Attribute, TEXT("Attribute"));
+	OutChannelFunction.OriginalAttribute = *Element.GetAttributeTemp("OriginalAttribute");
+	OutChannelFunction.DMXFrom = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("DMXFrom"));
+	OutChannelFunction.DMXValue = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("DMXValue"));
+	OutChannelFunction.Default = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("Default"));
+
+	Element.ParseAttribute("PhysicalFrom", OutChannelFunction.PhysicalFrom);
+	if (Element.IsAttributeEmpty("PhysicalTo")) OutChannelFunction.PhysicalTo = 1.0f;
+	else Element.ParseAttribute("PhysicalTo", OutChannelFunction.PhysicalTo);
+	Element.ParseAttribute("RealFade", OutChannelFunction.RealFade);
+	Element.ParseAttribute("RealAcceleration", OutChannelFunction.RealAcceleration);
+
+	this->ResolveReference(this->WheelIndices, Cast<UDMXImportGDTFWheels>(Description->Wheels)->Wheels, Element.GetAttributeName("Wheel"), OutChannelFunction.Wheel, TEXT("Wheel"));
+	this->ResolveReference(this->EmitterIndices, Cast<UDMXImportGDTFPhysicalDescriptions>(Description->PhysicalDescriptions)->Emitters, Element.GetAttributeName("Emitter"), OutChannelFunction.Emitter, TEXT("Emitter"));
+
+	OutChannelFunction.DMXInvert = CPGDTFDescription::GetEnumValueFromString<EDMXImportGDTFDMXInvert>(Element.GetAttributeTemp("DMXInvert"));
+	OutChannelFunction.ModeMaster = *Element.GetAttributeTemp("ModeMaster");
+	OutChannelFunction.ModeFrom = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("ModeFrom"));
+	OutChannelFunction.ModeTo = FDMXImportGDTFDMXValue(Element.GetAttributeTemp("ModeTo"));
+}
+
+/**
+ * Check that the geometries referenced by the geometry references, DMX modes and DMX channels exist
+ */
+void FCPGDTFDescriptionImporter::CheckGeometryReferences(UCPGDTFDescription* Description) {
+	using namespace CPGDTFDescriptionImporter;
+
+	for (const UCPGDTFDescriptionGeometryBase* TopLevelGeometry : Cast<UCPGDTFDescriptionGeometries>(Description->Geometries)->Geometries) {
+		if (TopLevelGeometry == nullptr) continue;
+		ForEachGeometry(TopLevelGeometry, [this](const UCPGDTFDescriptionGeometryBase* Geometry) {
+			if (Geometry->Type != ECPGDTFDescriptionGeometryType::GeometryReference) return;
+			const FName Referenced = Cast<UCPGDTFDescriptionGeometryReference>(Geometry)->Geometry;
+			if (!this->GeometryIndices.Contains(Referenced)) this->ReportDanglingReference(TEXT("Geometry"), Referenced);
+		});
+	}
+
+	for (const FDMXImportGDTFDMXMode& DMXMode : Cast<UDMXImportGDTFDMXModes>(Description->DMXModes)->DMXModes) {
+		if (!DMXMode.Geometry.IsNone() && !this->GeometryIndices.Contains(DMXMode.Geometry)) this->ReportDanglingReference(TEXT("Geometry"), DMXMode.Geometry);
+		for (const FDMXImportGDTFDMXChannel& DMXChannel : DMXMode.DMXChannels) {
+			if (!DMXChannel.Geometry.IsNone() && !this->GeometryNames.Contains(DMXChannel.Geometry)) this->ReportDanglingReference(TEXT("Geometry"), DMXChannel.Geometry);
+		}
+	}
+}
+
+/// Warns once per name about a reference to a missing element
+void FCPGDTFDescriptionImporter::ReportDanglingReference(const TCHAR* Section, FName Name) {
+	bool bAlreadyReported = false;
+	this->DanglingReferences.Add(FString::Printf(TEXT("%s/%s"), Section, *Name.ToString()), &bAlreadyReported);
+	if (!bAlreadyReported) UE_LOG_CPGDTFIMPORTER(Warning, TEXT("%s: reference to the missing %s '%s'"), *this->AssetName.ToString(), Section, *Name.ToString());
+}
+
+/**
+ * Create the GDTF Description asset and its empty sub objects
+ */
+UCPGDTFDescription* FCPGDTFDescriptionImporter::CreateDescription() {
+
+	// Create new GDTF asset
+	UCPGDTFDescription* ImportObject = NewObject<UCPGDTFDescription>(this->Package, this->AssetName, this->Flags | RF_Public);
+
+	UDMXImportGDTFFixtureType* GDTFFixtureType = ImportObject->CreateNewObject<UDMXImportGDTFFixtureType>();
+	ImportObject->FixtureType = GDTFFixtureType;
+
+	UDMXImportGDTFAttributeDefinitions* GDTFAttributeDefinitions = ImportObject->CreateNewObject<UDMXImportGDTFAttributeDefinitions>();
+	ImportObject->AttributeDefinitions = GDTFAttributeDefinitions;
+
+	UDMXImportGDTFWheels* GDTFWheels = ImportObject->CreateNewObject<UDMXImportGDTFWheels>();
+	ImportObject->Wheels = GDTFWheels;
+
+	UDMXImportGDTFPhysicalDescriptions* GDTFPhysicalDescriptions = ImportObject->CreateNewObject<UDMXImportGDTFPhysicalDescriptions>();
+	ImportObject->PhysicalDescriptions = GDTFPhysicalDescriptions;
+
+	UCPGDTFDescriptionModels* GDTFModels = ImportObject->CreateNewObject<UCPGDTFDescriptionModels>();
+	ImportObject->Models = GDTFModels;
+
+	UCPGDTFDescriptionGeometries* GDTFGeometries = ImportObject->CreateNewObject<UCPGDTFDescriptionGeometries>();
+	ImportObject->Geometries = GDTFGeometries;
+
+	UDMXImportGDTFDMXModes* GDTFDMXModes = ImportObject->CreateNewObject<UDMXImportGDTFDMXModes>();
+	ImportObject->DMXModes = GDTFDMXModes;
+
+	UDMXImportGDTFProtocols* GDTFProtocols = ImportObject->CreateNewObject<UDMXImportGDTFProtocols>();
+	ImportObject->Protocols = GDTFProtocols;
+
+	return ImportObject;
+}
+
+/**
+ * Read description.xml bytes extracted from the GDTF archive into an XML DOM.
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 04 may 2022
  *
@@ -503,16 +1058,36 @@ UCPGDTFDescription* FCPGDTFDescriptionImporter::ParseXML() {
  */
 FXmlFile* FCPGDTFDescriptionImporter::ExtractXML() {
 
-	const FString XMLString = UCPGDTFUnzip::ExtractTextFileFromGDTFArchive(this->GDTFPath, FString("description.xml"));
+	if (this->XMLBytes.Num() == 0) return nullptr;
 
+	FString XMLString;
+	FFileHelper::BufferToString(XMLString, this->XMLBytes.GetData(), this->XMLBytes.Num());
 	if (XMLString.Equals("")) return nullptr;
 	else {
 
 		FXmlFile* XmlFileObj = new FXmlFile();
 		XmlFileObj->LoadFile(XMLString, EConstructMethod::ConstructFromBuffer);
 		if (XmlFileObj->IsValid()) return XmlFileObj;
-		else return nullptr;
+		else {
+			delete XmlFileObj;
+			return nullptr;
+		}
+	}
+}
+
+/**
+ * Extract description.xml bytes from the GDTF archive
+ *
+ * @return False if the file can't be extracted
+ */
+bool FCPGDTFDescriptionImporter::ExtractXMLBytes() {
+
+	TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(this->GDTFPath);
+	if (!Archive.IsValid() || !Archive->Extract(FString("description.xml"), this->XMLBytes)) {
+		this->XMLBytes.Empty();
+		return false;
 	}
+	return this->XMLBytes.Num() > 0;
 }
 
 /**
@@ -536,118 +1111,69 @@ const FXmlNode* FCPGDTFDescriptionImporter::FindChildNodeEvenIfDMXSubstringIsMis
 	return nullptr;
 }
 
-/**
-* Depending on the GDTF Spec, some XML Attribute Names might start with or without DMX.
-*
-* @param ParentNode		The Parent Node to search in
-* @param AttributeNameWithDMXTag The Attribute Name with DMX tag. This is the correct form, e.g. 'DMXMode', not 'Mode', 'DMXChannels', not 'Channels'.
-* @return					Returns the Attribute as String
-*/
-FString FCPGDTFDescriptionImporter::FindAttributeEvenIfDMXSubstringIsMissing(const FXmlNode& ParentNode, const FString& AttributeNameWithDMXTag)
-{
-	FString Attribute = ParentNode.GetAttribute(AttributeNameWithDMXTag).TrimStartAndEnd();
-	if (Attribute.IsEmpty())
-	{
-		Attribute = ParentNode.GetAttribute(AttributeNameWithDMXTag.RightChop(3)).TrimStartAndEnd();
-	}
-
-	return Attribute;
-}
-
 /**
  * Parse an XML geometry node and all his childrens recursively
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 14 june 2022
 */
 UCPGDTFDescriptionGeometryBase* FCPGDTFDescriptionImporter::ParseGeometriesNode(UCPGDTFDescription* DescriptionRoot, const FXmlNode* GeometryNode) {
+	using namespace CPGDTFDescriptionImporter;
 
-	UCPGDTFDescriptionGeometryBase* Geometry;
-	UCPGDTFDescriptionGeometryBeam* GeometryBeam;
-	UCPGDTFDescriptionGeometryReference* GeometryReference;
-
-	// Instantiation of the right object
-	switch (CPGDTFDescription::GetEnumValueFromString<ECPGDTFDescriptionGeometryType>(GeometryNode->GetTag())) {
-
-	case ECPGDTFDescriptionGeometryType::Geometry:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometry>();
-		break;
-	case ECPGDTFDescriptionGeometryType::Axis:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryAxis>();
-		break;
-	case ECPGDTFDescriptionGeometryType::FilterBeam:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterBeam>();
-		break;
-	case ECPGDTFDescriptionGeometryType::FilterColor:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterColor>();
-		break;
-	case ECPGDTFDescriptionGeometryType::FilterGobo:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterGobo>();
-		break;
-	case ECPGDTFDescriptionGeometryType::FilterShaper:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryFilterShaper>();
-		break;
-	case ECPGDTFDescriptionGeometryType::Beam:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryBeam>();
-		break;
-	case ECPGDTFDescriptionGeometryType::GeometryReference:
-		Geometry = DescriptionRoot->CreateNewObject<UCPGDTFDescriptionGeometryReference>();
-		break;
-	default:
-		return nullptr;
-	}
+	UCPGDTFDescriptionGeometryBase* Geometry = CreateGeometry(DescriptionRoot, GeometryNode->GetTag());
+	if (Geometry == nullptr) return nullptr;
+	ReadGeometry(FXmlNodeAttributes(GeometryNode), Geometry);
 
-	// Base
-	Geometry->Name = FName(*GeometryNode->GetAttribute("Name").TrimStartAndEnd());
-	Geometry->Position = CPGDTFDescription::ParseMatrix(GeometryNode->GetAttribute("Position").TrimStartAndEnd());
-	Geometry->Model = FName(*GeometryNode->GetAttribute("Model").TrimStartAndEnd());
-
-	// Fill the specific object properties
-	switch (Geometry->Type) {
-
-	case ECPGDTFDescriptionGeometryType::Beam: // Beam specific
-		GeometryBeam = Cast<UCPGDTFDescriptionGeometryBeam>(Geometry);
-		GeometryBeam->LampType = DMXImport::GetEnumValueFromString<EDMXImportGDTFLampType>(GeometryNode->GetAttribute("LampType").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->PowerConsumption, *GeometryNode->GetAttribute("PowerConsumption").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->LuminousFlux, *GeometryNode->GetAttribute("LuminousFlux").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->ColorTemperature, *GeometryNode->GetAttribute("ColorTemperature").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->BeamAngle, *GeometryNode->GetAttribute("BeamAngle").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->FieldAngle, *GeometryNode->GetAttribute("FieldAngle").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->BeamRadius, *GeometryNode->GetAttribute("BeamRadius").TrimStartAndEnd());
-		GeometryBeam->BeamType = CPGDTFDescription::GetEnumValueFromString<ECPGDTFDescriptionGeometryBeamType>(GeometryNode->GetAttribute("BeamType").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->ColorRenderingIndex, *GeometryNode->GetAttribute("ColorRenderingIndex").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->RectangleRatio, *GeometryNode->GetAttribute("RectangleRatio").TrimStartAndEnd());
-		LexTryParseString(GeometryBeam->ThrowRatio, *GeometryNode->GetAttribute("ThrowRatio").TrimStartAndEnd());
-		break;
-
-	case ECPGDTFDescriptionGeometryType::GeometryReference: // GeometryReference specific
-		GeometryReference = Cast<UCPGDTFDescriptionGeometryReference>(Geometry);
-		GeometryReference->Geometry = FName(*GeometryNode->GetAttribute("Geometry").TrimStartAndEnd());
+	if (UCPGDTFDescriptionGeometryReference* GeometryReference = Cast<UCPGDTFDescriptionGeometryReference>(Geometry)) {
 		for (const FXmlNode* BreakNode : GeometryNode->GetChildrenNodes()) {
 			FDMXImportGDTFBreak ImportBreak;
+			ReadBreak(FXmlNodeAttributes(BreakNode), ImportBreak);
+			GeometryReference->Breaks.Add(ImportBreak);
+		}
+		return Geometry; // A geometry reference can't have any child
+	}
 
-			// Depending on the GDTF spec the Offset node may be called either 'DMXOffset' or 'Offset'
-			const FString DMXOffsetAttribute = FCPGDTFDescriptionImporter::FindAttributeEvenIfDMXSubstringIsMissing(*BreakNode, TEXT("DMXOffset"));
-			LexTryParseString(ImportBreak.DMXOffset, *DMXOffsetAttribute);
+	// Import childrens recursively
+	for (const FXmlNode* GeometryChild : GeometryNode->GetChildrenNodes()) {
+		Geometry->Childrens.Add(this->ParseGeometriesNode(DescriptionRoot, GeometryChild));
+	}
 
-			// Depending on the GDTF spec the Break node may be called either 'DMXBreak' or 'Break'
-			const FString DMXBreakAttribute = FCPGDTFDescriptionImporter::FindAttributeEvenIfDMXSubstringIsMissing(*BreakNode, TEXT("DMXBreak"));
-			LexTryParseString(ImportBreak.DMXBreak, *DMXBreakAttribute);
+	// Return to parent
+	return Geometry;
+}
 
+/**
+ * Parse the geometry element the reader is on and all his childrens recursively, same as ParseGeometriesNode
+ *
+ * @param DescriptionRoot Outer of the geometries
+ * @param Reader Reader on the StartElement of the geometry, left somewhere inside the geometry
+ * @return May be null if the geometry type is unknown
+*/
+UCPGDTFDescriptionGeometryBase* FCPGDTFDescriptionImporter::ParseGeometriesElement(UCPGDTFDescription* DescriptionRoot, FCPGDTFXmlReader& Reader) {
+	using namespace CPGDTFDescriptionImporter;
+
+	const FAnsiStringView Tag = Reader.GetTag();
+	UCPGDTFDescriptionGeometryBase* Geometry = CreateGeometry(DescriptionRoot, FString(Tag.Len(), Tag.GetData()));
+	if (Geometry == nullptr) return nullptr; // The caller skips the element with its childrens
+	ReadGeometry(Reader, Geometry);
+
+	const int32 GeometryDepth = Reader.GetDepth();
+	if (UCPGDTFDescriptionGeometryReference* GeometryReference = Cast<UCPGDTFDescriptionGeometryReference>(Geometry)) {
+		while (Reader.NextChild(GeometryDepth)) {
+			FDMXImportGDTFBreak ImportBreak;
+			ReadBreak(Reader, ImportBreak);
 			GeometryReference->Breaks.Add(ImportBreak);
 		}
 		return Geometry; // A geometry reference can't have any child
-
-	default:
-		break; // For other object types every field was specified before switch
 	}
 
 	// Import childrens recursively
-	for (const FXmlNode* GeometryChild : GeometryNode->GetChildrenNodes()) {
-		Geometry->Childrens.Add(this->ParseGeometriesNode(DescriptionRoot, GeometryChild));
+	while (Reader.NextChild(GeometryDepth)) {
+		Geometry->Childrens.Add(this->ParseGeometriesElement(DescriptionRoot, Reader));
 	}
 
 	// Return to parent
 	return Geometry;
 }
 
-#undef PHYSICAL_CHANNEL_SET_PLACEHOLDER
\ No newline at end of file
+#undef PHYSICAL_CHANNEL_SET_PLACEHOLDER
+#undef NO_FEATURE_ATTRIBUTE
\ No newline at end of file
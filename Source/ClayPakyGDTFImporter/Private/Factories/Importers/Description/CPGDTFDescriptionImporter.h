@@ -28,8 +28,13 @@ SOFTWARE.
 #include "CoreMinimal.h"
 #include "XMLFile.h"
 #include "Engine/Texture.h"
+#include "Templates/UniquePtr.h"
+#include "Factories/Importers/Wheels/CPGDTFWheelImporter.h"
 
 class UCPGDTFDescriptionImporter;
+class FCPGDTFXmlReader;
+struct FCPDMXImportGDTFLogicalChannel;
+struct FCPDMXImportGDTFChannelFunction;
 
 /**
  * GDTF XML Importer
@@ -49,8 +54,32 @@ private:
 	/** Path of the GDTF file on disk */
 	FString GDTFPath;
 
-	/** XML Description extracted from GDTF archive */
-	const FXmlFile* XMLFile;
+	/** Bytes of description.xml extracted from GDTF archive */
+	TArray<uint8> XMLBytes;
+
+	/** XML Description, built from XMLBytes only when someone asks for it */
+	TUniquePtr<FXmlFile> XMLFile;
+
+	/** Name of the thumbnail file in the GDTF archive, read with the description */
+	FString ThumbnailFileName;
+
+	/** Version of the GDTF format (DataVersion of the root node), read with the description */
+	FString DataVersion;
+
+	/** Wheel slots with an image in the GDTF archive, read with the description */
+	TArray<FCPGDTFWheelImporter::FWheelSlotMedia> WheelSlotsMedia;
+
+	/** Name to index maps of the sections referenced by the DMX modes, built once by IndexReferencedSections() */
+	TMap<FName, int32> AttributeIndices;
+	TMap<FName, int32> WheelIndices;
+	TMap<FName, int32> EmitterIndices;
+	/** Top level geometries, referenced by the DMX modes and the geometry references */
+	TMap<FName, int32> GeometryIndices;
+	/** Names of the geometries of every level, referenced by the DMX channels */
+	TSet<FName> GeometryNames;
+
+	/** References already reported as dangling, to warn only once per name */
+	TSet<FString> DanglingReferences;
 
 public:
 
@@ -65,8 +94,10 @@ public:
 	 * Import the GDTF Description from a GDTF file
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 04 may 2022
+	 *
+	 * @param bStreaming If true the description is read by the pull parser, without building the XML DOM. False for the DOM parser (used by the benchmarks)
 	 */
-	UCPGDTFDescription* Import();
+	UCPGDTFDescription* Import(bool bStreaming = true);
 
 	/**
 	 * Import the GDTF Thumbnail from a GDTF file
@@ -78,14 +109,24 @@ public:
 	UTexture2D* ImportThumbnail(UCPGDTFDescription* XMLDescription);
 
 	/**
-	 * Get the XML Description representing the Fixture
+	 * Get the version of the GDTF format of the description, read by the Import
+	 */
+	inline const FString& GetDataVersion() const { return this->DataVersion; }
+
+	/**
+	 * Get the wheel slots with an image in the GDTF archive, read by the Import
+	 */
+	inline const TArray<FCPGDTFWheelImporter::FWheelSlotMedia>& GetWheelSlotsMedia() const { return this->WheelSlotsMedia; }
+
+private:
+
+	/**
+	 * Get the XML Description representing the Fixture. The DOM is built on the first call, only by the DOM parser
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 06 may 2022
 	 */
 	const FXmlFile* GetXML();
 
-private:
-
 	/**
 	 * Parse the XML file and create the GDTF Description
 	 * @author Dorian Gardes - Clay Paky S.R.L.
@@ -93,6 +134,18 @@ private:
 	 */
 	UCPGDTFDescription* ParseXML();
 
+	/**
+	 * Read the XML bytes with the pull parser and create the GDTF Description, without building the XML DOM
+	 *
+	 * @return May be null if the XML file is malformed
+	 */
+	UCPGDTFDescription* ParseXMLStreaming();
+
+	/**
+	 * Create the GDTF Description asset and its empty sub objects
+	 */
+	UCPGDTFDescription* CreateDescription();
+
 	/**
 	 * Parse an XML geometry node and all his childrens recursively
 	 * @author Dorian Gardes - Clay Paky S.R.L.
@@ -101,7 +154,53 @@ private:
 	UCPGDTFDescriptionGeometryBase* ParseGeometriesNode(UCPGDTFDescription* DescriptionRoot, const FXmlNode* GeometryNode);
 
 	/**
-	 * Extract and read description.xml inside GDTF archive.
+	 * Same as ParseGeometriesNode with the pull parser. The reader must be on the StartElement of the geometry
+	 */
+	UCPGDTFDescriptionGeometryBase* ParseGeometriesElement(UCPGDTFDescription* DescriptionRoot, FCPGDTFXmlReader& Reader);
+
+	/**
+	 * Build the name to index maps of the attributes, wheels, emitters and geometries. To call once these sections are parsed, before the DMX modes
+	 */
+	void IndexReferencedSections(UCPGDTFDescription* Description);
+
+	/**
+	 * Find an element of a section by its name with the maps of IndexReferencedSections(). Reports the dangling references
+	 *
+	 * @param Indices Map of the section
+	 * @param Items Elements of the section
+	 * @param Name Referenced name. None is not an error, the reference is just missing
+	 * @param OutItem Copy of the element found, untouched otherwise
+	 * @param Section Name of the section for the diagnostics
+	 * @return True if the element was found
+	 */
+	template <typename TItem> bool ResolveReference(const TMap<FName, int32>& Indices, const TArray<TItem>& Items, FName Name, TItem& OutItem, const TCHAR* Section);
+
+	/**
+	 * Field readers of the DMX channels' children that resolve references, shared by both parsers like the ones of the CPGDTFDescriptionImporter namespace
+	 *
+	 * @param Element XML DOM node (CPGDTFDescriptionImporter::FXmlNodeAttributes) or FCPGDTFXmlReader on the StartElement
+	 * @param Description Description being filled, its referenced sections must be indexed
+	 */
+	template <typename TElement> void ReadLogicalChannel(const TElement& Element, UCPGDTFDescription* Description, FCPDMXImportGDTFLogicalChannel& OutLogicalChannel);
+	template <typename TElement> void ReadChannelFunction(const TElement& Element, UCPGDTFDescription* Description, FCPDMXImportGDTFChannelFunction& OutChannelFunction);
+
+	/**
+	 * Check that the geometries referenced by the geometry references, DMX modes and DMX channels exist
+	 */
+	void CheckGeometryReferences(UCPGDTFDescription* Description);
+
+	/// Warns once per name about a reference to a missing element
+	void ReportDanglingReference(const TCHAR* Section, FName Name);
+
+	/**
+	 * Extract description.xml bytes from the GDTF archive
+	 *
+	 * @return False if the file can't be extracted
+	 */
+	bool ExtractXMLBytes();
+
+	/**
+	 * Read description.xml bytes extracted from the GDTF archive into an XML DOM.
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 04 may 2022
 	 *
@@ -117,13 +216,4 @@ private:
 	 * @return					Returns a pointer to the child node, or nullptr if the child cannot be found
 	 */
 	static const FXmlNode* FindChildNodeEvenIfDMXSubstringIsMissing(const FXmlNode& ParentNode, const FString& AttributeNameWithDMXTag);
-
-	/**
-	 * Depending on the GDTF Spec, some XML Attribute Names might start with or without DMX.
-	 *
-	 * @param ParentNode		The Parent Node to search in
-	 * @param AttributeNameWithDMXTag The Attribute Name with DMX tag. This is the correct form, e.g. 'DMXMode', not 'Mode', 'DMXChannels', not 'Channels'.
-	 * @return					Returns the Attribute as String
-	 */
-	static FString FindAttributeEvenIfDMXSubstringIsMissing(const FXmlNode& ParentNode, const FString& AttributeNameWithDMXTag);
 };
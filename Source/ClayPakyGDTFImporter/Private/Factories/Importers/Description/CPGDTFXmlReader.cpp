@@ -0,0 +1,362 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFXmlReader.h"
+
+// Longest entity we decode: '&#x10FFFF;'
+#define XML_READER_MAX_ENTITY_LEN 10
+
+namespace CPGDTFXmlReader {
+
+	FORCEINLINE bool IsSpace(ANSICHAR Char) {
+		return Char == ' ' || Char == '\t' || Char == '\r' || Char == '\n';
+	}
+
+	FORCEINLINE FAnsiStringView Trim(FAnsiStringView View) {
+		const ANSICHAR* First = View.GetData();
+		const ANSICHAR* Last = First + View.Len();
+		while (First < Last && IsSpace(*First)) First++;
+		while (Last > First && IsSpace(*(Last - 1))) Last--;
+		return FAnsiStringView(First, (int32)(Last - First));
+	}
+
+	FORCEINLINE void AppendUTF8(const ANSICHAR* Data, int32 Len, FString& Out) {
+		if (Len <= 0) return;
+		FUTF8ToTCHAR Converted(Data, Len);
+		Out.AppendChars(Converted.Get(), Converted.Length());
+	}
+
+	FORCEINLINE void AppendCodepoint(uint32 Codepoint, FString& Out) {
+		if (sizeof(TCHAR) == 2 && Codepoint > 0xFFFF) { // UTF-16 surrogates pair
+			Codepoint -= 0x10000;
+			Out.AppendChar((TCHAR)(0xD800 + (Codepoint >> 10)));
+			Out.AppendChar((TCHAR)(0xDC00 + (Codepoint & 0x3FF)));
+		} else Out.AppendChar((TCHAR)Codepoint);
+	}
+
+	/// Decodes the entity between '&' and ';'. Returns false if it's not a valid entity
+	static bool DecodeEntity(FAnsiStringView Entity, FString& Out) {
+		if (Entity.Equals("amp", ESearchCase::CaseSensitive)) Out.AppendChar(TEXT('&'));
+		else if (Entity.Equals("lt", ESearchCase::CaseSensitive)) Out.AppendChar(TEXT('<'));
+		else if (Entity.Equals("gt", ESearchCase::CaseSensitive)) Out.AppendChar(TEXT('>'));
+		else if (Entity.Equals("quot", ESearchCase::CaseSensitive)) Out.AppendChar(TEXT('"'));
+		else if (Entity.Equals("apos", ESearchCase::CaseSensitive)) Out.AppendChar(TEXT('\''));
+		else if (Entity.Len() > 1 && Entity[0] == '#') {
+			const bool bHex = Entity[1] == 'x' || Entity[1] == 'X';
+			uint32 Codepoint = 0;
+			int32 Index = bHex ? 2 : 1;
+			if (Index >= Entity.Len()) return false;
+			for (; Index < Entity.Len(); Index++) {
+				const ANSICHAR Char = Entity[Index];
+				uint32 Digit;
+				if (Char >= '0' && Char <= '9') Digit = Char - '0';
+				else if (bHex && Char >= 'a' && Char <= 'f') Digit = Char - 'a' + 10;
+				else if (bHex && Char >= 'A' && Char <= 'F') Digit = Char - 'A' + 10;
+				else return false;
+				Codepoint = Codepoint * (bHex ? 16 : 10) + Digit;
+				if (Codepoint > 0x10FFFF) return false;
+			}
+			if (Codepoint == 0) return false;
+			AppendCodepoint(Codepoint, Out);
+		} else return false;
+		return true;
+	}
+}
+
+/**
+ * Creates a reader on the bytes of a document. The bytes must stay alive as long as the reader
+ *
+ * @param Data UTF-8 document, with or without BOM
+ * @param Size Size of the document in bytes
+ */
+FCPGDTFXmlReader::FCPGDTFXmlReader(const uint8* Data, int64 Size) {
+	this->Begin = (const ANSICHAR*)Data;
+	this->End = this->Begin + Size;
+	// UTF-8 BOM
+	if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF) this->Begin += 3;
+	this->Cursor = this->Begin;
+	this->ElementBegin = this->Begin;
+	this->Depth = 0;
+	this->bPendingEnd = false;
+}
+
+bool FCPGDTFXmlReader::IsWideDocument(const uint8* Data, int64 Size) {
+	return Size >= 2 && ((Data[0] == 0xFF && Data[1] == 0xFE) || (Data[0] == 0xFE && Data[1] == 0xFF));
+}
+
+/**
+ * Reads the next element start or end
+ */
+FCPGDTFXmlReader::EToken FCPGDTFXmlReader::Next() {
+	using namespace CPGDTFXmlReader;
+
+	if (this->HasError()) return EToken::Error;
+	this->Attributes.Reset();
+
+	if (this->bPendingEnd) { // End of a '<Tag/>'
+		this->bPendingEnd = false;
+		this->Tag = this->Stack.Pop(false);
+		this->Depth--;
+		return EToken::EndElement;
+	}
+
+	for (;;) {
+		// Text between tags is ignored
+		while (this->Cursor < this->End && *this->Cursor != '<') this->Cursor++;
+		if (this->Cursor >= this->End) return this->Depth == 0 ? EToken::EndOfDocument : this->SetError(TEXT("Unexpected end of document"));
+		this->ElementBegin = this->Cursor;
+		if (this->End - this->Cursor < 2) return this->SetError(TEXT("Unexpected end of document"));
+
+		const ANSICHAR Kind = this->Cursor[1];
+		if (Kind == '?') { // Declaration and processing instructions
+			if (!this->SkipTo("?>")) return this->SetError(TEXT("Unterminated processing instruction"));
+			continue;
+		}
+		if (Kind == '!') {
+			const FAnsiStringView Rest(this->Cursor, (int32)FMath::Min<int64>(this->End - this->Cursor, 9));
+			if (Rest.StartsWith("<!--")) {
+				if (!this->SkipTo("-->")) return this->SetError(TEXT("Unterminated comment"));
+			} else if (Rest.StartsWith("<![CDATA[")) {
+				if (!this->SkipTo("]]>")) return this->SetError(TEXT("Unterminated CDATA"));
+			} else { // DOCTYPE, with its optional internal subset
+				int32 Brackets = 0;
+				for (; this->Cursor < this->End; this->Cursor++) {
+					if (*this->Cursor == '[') Brackets++;
+					else if (*this->Cursor == ']') Brackets--;
+					else if (*this->Cursor == '>' && Brackets <= 0) break;
+				}
+				if (this->Cursor >= this->End) return this->SetError(TEXT("Unterminated DOCTYPE"));
+				this->Cursor++;
+			}
+			continue;
+		}
+
+		if (Kind == '/') { // End tag
+			this->Cursor += 2;
+			const ANSICHAR* NameBegin = this->Cursor;
+			while (this->Cursor < this->End && !IsSpace(*this->Cursor) && *this->Cursor != '>') this->Cursor++;
+			const FAnsiStringView Name(NameBegin, (int32)(this->Cursor - NameBegin));
+			this->SkipSpaces();
+			if (this->Cursor >= this->End || *this->Cursor != '>') return this->SetError(TEXT("Malformed end tag"));
+			this->Cursor++;
+			if (this->Stack.Num() == 0 || !this->Stack.Last().Equals(Name, ESearchCase::CaseSensitive)) return this->SetError(TEXT("Mismatched end tag"));
+			this->Tag = this->Stack.Pop(false);
+			this->Depth--;
+			return EToken::EndElement;
+		}
+
+		// Start tag
+		this->Cursor++;
+		const ANSICHAR* NameBegin = this->Cursor;
+		while (this->Cursor < this->End && !IsSpace(*this->Cursor) && *this->Cursor != '/' && *this->Cursor != '>') this->Cursor++;
+		if (this->Cursor == NameBegin) return this->SetError(TEXT("Element without name"));
+		const FAnsiStringView Name(NameBegin, (int32)(this->Cursor - NameBegin));
+
+		for (;;) {
+			this->SkipSpaces();
+			if (this->Cursor >= this->End) return this->SetError(TEXT("Unterminated start tag"));
+			if (*this->Cursor == '>') {
+				this->Cursor++;
+				break;
+			}
+			if (*this->Cursor == '/') {
+				if (this->End - this->Cursor < 2 || this->Cursor[1] != '>') return this->SetError(TEXT("Malformed start tag"));
+				this->Cursor += 2;
+				this->bPendingEnd = true;
+				break;
+			}
+
+			// Attribute: Name = "Value" or 'Value'
+			const ANSICHAR* AttributeBegin = this->Cursor;
+			while (this->Cursor < this->End && !IsSpace(*this->Cursor) && *this->Cursor != '=' && *this->Cursor != '/' && *this->Cursor != '>') this->Cursor++;
+			const FAnsiStringView AttributeName(AttributeBegin, (int32)(this->Cursor - AttributeBegin));
+			this->SkipSpaces();
+			if (AttributeName.IsEmpty() || this->Cursor >= this->End || *this->Cursor != '=') return this->SetError(TEXT("Malformed attribute"));
+			this->Cursor++;
+			this->SkipSpaces();
+			if (this->Cursor >= this->End || (*this->Cursor != '"' && *this->Cursor != '\'')) return this->SetError(TEXT("Unquoted attribute value"));
+			const ANSICHAR Quote = *this->Cursor++;
+			const ANSICHAR* ValueBegin = this->Cursor;
+			const ANSICHAR* ValueEnd = ValueBegin;
+			while (ValueEnd < this->End && *ValueEnd != Quote) ValueEnd++;
+			if (ValueEnd >= this->End) return this->SetError(TEXT("Unterminated attribute value"));
+			this->Cursor = ValueEnd + 1;
+			this->Attributes.Add({ AttributeName, FAnsiStringView(ValueBegin, (int32)(ValueEnd - ValueBegin)) });
+		}
+
+		this->Tag = Name;
+		this->Stack.Add(Name);
+		this->Depth++;
+		return EToken::StartElement;
+	}
+}
+
+/**
+ * Moves to the next child of an element, skipping the rest of the current child and all its descendants
+ *
+ * @param ParentDepth Depth of the parent element, as returned by GetDepth() on its StartElement
+ * @return False when the parent element is closed (or the document ends)
+ */
+bool FCPGDTFXmlReader::NextChild(int32 ParentDepth) {
+	for (;;) {
+		switch (this->Next()) {
+		case EToken::StartElement:
+			if (this->Depth == ParentDepth + 1) return true;
+			break;
+		case EToken::EndElement:
+			if (this->Depth < ParentDepth) return false;
+			break;
+		default:
+			return false;
+		}
+	}
+}
+
+/**
+ * Finds the first child of the current element for each tag, like FXmlNode::FindChildNode, without parsing them. The reader is left after the current element
+ *
+ * @param Tags Tags to look for
+ * @param OutMarks Marks of the children, in the same order than the tags. Invalid for the tags not found
+ */
+void FCPGDTFXmlReader::FindChildren(TArrayView<const ANSICHAR* const> Tags, TArray<FMark>& OutMarks) {
+	OutMarks.Init(FMark(), Tags.Num());
+	const int32 ParentDepth = this->Depth;
+	while (this->NextChild(ParentDepth)) {
+		for (int32 i = 0; i < Tags.Num(); i++) {
+			if (!OutMarks[i].IsValid() && this->IsTag(Tags[i])) OutMarks[i] = this->GetMark();
+		}
+	}
+}
+
+/// Mark of the current element
+FCPGDTFXmlReader::FMark FCPGDTFXmlReader::GetMark() const {
+	FMark Mark;
+	Mark.Position = this->ElementBegin - this->Begin;
+	Mark.Depth = this->Depth - 1;
+	if (this->Stack.Num() >= 2) Mark.ParentTag = this->Stack[this->Stack.Num() - 2];
+	return Mark;
+}
+
+/// Moves back (or forward) to an element: the next call to Next() returns its StartElement
+void FCPGDTFXmlReader::Rewind(const FMark& Mark) {
+	if (!Mark.IsValid() || this->HasError()) return;
+	this->Cursor = this->Begin + Mark.Position;
+	this->bPendingEnd = false;
+	this->Attributes.Reset();
+	// The mark is a child of the current element or of one of its ancestors: they're still on the stack, apart from its parent that might be closed
+	this->Stack.SetNum(FMath::Min(this->Stack.Num(), FMath::Max(Mark.Depth - 1, 0)), false);
+	if (Mark.Depth > 0) this->Stack.Add(Mark.ParentTag);
+	this->Depth = Mark.Depth;
+}
+
+/// Trimmed value of an attribute as it's written in the document (no entities decoding). Empty if the attribute is missing
+FAnsiStringView FCPGDTFXmlReader::GetRawAttribute(const ANSICHAR* Name) const {
+	for (const FAttribute& Attribute : this->Attributes) {
+		if (Attribute.Name.Equals(Name, ESearchCase::CaseSensitive)) return CPGDTFXmlReader::Trim(Attribute.Value);
+	}
+	return FAnsiStringView();
+}
+
+/// Trimmed value of an attribute, same as FXmlNode::GetAttribute(Name).TrimStartAndEnd()
+FString FCPGDTFXmlReader::GetAttribute(const ANSICHAR* Name) const {
+	const FAnsiStringView Raw = this->GetRawAttribute(Name);
+	FString Value;
+	Value.Reserve(Raw.Len());
+	FCPGDTFXmlReader::AppendDecoded(Raw, Value);
+	return Value;
+}
+
+/// Value of an attribute interned into an FName, without intermediate FString
+FName FCPGDTFXmlReader::GetAttributeName(const ANSICHAR* Name) const {
+	const FAnsiStringView Raw = this->GetRawAttribute(Name);
+	if (Raw.IsEmpty()) return NAME_None;
+
+	// Plain ASCII names (almost all of them) go straight to the names table
+	bool bPlain = true;
+	for (const ANSICHAR Char : Raw) {
+		if ((uint8)Char >= 0x80 || Char == '&') {
+			bPlain = false;
+			break;
+		}
+	}
+	if (bPlain) return FName(Raw.Len(), Raw.GetData());
+	return FName(*this->GetAttributeTemp(Name));
+}
+
+/**
+ * Value of an attribute in a string owned by the reader, reused by every call: no allocation once it's big enough.
+ * To be consumed right away (EG: parsed), it's overwritten by the next call
+ */
+const FString& FCPGDTFXmlReader::GetAttributeTemp(const ANSICHAR* Name) const {
+	this->Temp.Reset();
+	FCPGDTFXmlReader::AppendDecoded(this->GetRawAttribute(Name), this->Temp);
+	return this->Temp;
+}
+
+/// Appends the decoded (UTF-8 and entities) value to a string
+void FCPGDTFXmlReader::AppendDecoded(FAnsiStringView Raw, FString& Out) {
+	using namespace CPGDTFXmlReader;
+
+	const ANSICHAR* Chunk = Raw.GetData();
+	const ANSICHAR* Last = Chunk + Raw.Len();
+	for (const ANSICHAR* Char = Chunk; Char < Last; Char++) {
+		if (*Char != '&') continue;
+		const ANSICHAR* Semicolon = Char + 1;
+		while (Semicolon < Last && *Semicolon != ';' && Semicolon - Char <= XML_READER_MAX_ENTITY_LEN) Semicolon++;
+		if (Semicolon >= Last || *Semicolon != ';') continue; // Not an entity, kept as is
+
+		AppendUTF8(Chunk, (int32)(Char - Chunk), Out);
+		if (!DecodeEntity(FAnsiStringView(Char + 1, (int32)(Semicolon - Char - 1)), Out)) AppendUTF8(Char, (int32)(Semicolon + 1 - Char), Out);
+		Chunk = Semicolon + 1;
+		Char = Semicolon;
+	}
+	AppendUTF8(Chunk, (int32)(Last - Chunk), Out);
+}
+
+FCPGDTFXmlReader::EToken FCPGDTFXmlReader::SetError(const TCHAR* Message) {
+	int32 Line = 1;
+	for (const ANSICHAR* Char = this->Begin; Char < this->Cursor && Char < this->End; Char++) if (*Char == '\n') Line++;
+	this->Error = FString::Printf(TEXT("%s at line %d"), Message, Line);
+	this->Cursor = this->End;
+	return EToken::Error;
+}
+
+/// Moves the cursor after the next occurrence of Pattern. Returns false if it's not found
+bool FCPGDTFXmlReader::SkipTo(const ANSICHAR* Pattern) {
+	const int32 PatternLen = FCStringAnsi::Strlen(Pattern);
+	for (; this->End - this->Cursor >= PatternLen; this->Cursor++) {
+		if (FMemory::Memcmp(this->Cursor, Pattern, PatternLen) == 0) {
+			this->Cursor += PatternLen;
+			return true;
+		}
+	}
+	this->Cursor = this->End;
+	return false;
+}
+
+void FCPGDTFXmlReader::SkipSpaces() {
+	while (this->Cursor < this->End && CPGDTFXmlReader::IsSpace(*this->Cursor)) this->Cursor++;
+}
+
+#undef XML_READER_MAX_ENTITY_LEN
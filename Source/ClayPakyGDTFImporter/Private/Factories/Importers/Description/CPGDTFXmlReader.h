@@ -0,0 +1,168 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+
+/**
+ * Pull parser of the GDTF description.xml. <br>
+ * Works in place on the UTF-8 bytes extracted from the archive: tags and attribute values are views on these bytes, so walking the document
+ * allocates nothing. Values are converted (entities and UTF-8 decoded, trimmed) only when they are asked for, directly into an FName, a number or
+ * a reused temporary string. <br>
+ * Comments, processing instructions, DOCTYPE, CDATA and text between tags are skipped: GDTF stores everything in attributes.
+ */
+class FCPGDTFXmlReader {
+
+public:
+
+	enum class EToken : uint8 {
+		/// Start of an element (also returned for '<Tag/>', followed by its EndElement)
+		StartElement,
+		EndElement,
+		EndOfDocument,
+		/// Malformed document, see GetError()
+		Error
+	};
+
+	/// Position of an element, to come back to it with Rewind()
+	struct FMark {
+		int64 Position = INDEX_NONE;
+		/// Depth of the parent element
+		int32 Depth = 0;
+		FAnsiStringView ParentTag;
+		FORCEINLINE bool IsValid() const { return this->Position != INDEX_NONE; }
+	};
+
+	/**
+	 * Creates a reader on the bytes of a document. The bytes must stay alive as long as the reader
+	 *
+	 * @param Data UTF-8 document, with or without BOM
+	 * @param Size Size of the document in bytes
+	 */
+	FCPGDTFXmlReader(const uint8* Data, int64 Size);
+
+	/// True if the document starts with an UTF-16/32 BOM, that this reader can't parse
+	static bool IsWideDocument(const uint8* Data, int64 Size);
+
+	/**
+	 * Reads the next element start or end
+	 */
+	EToken Next();
+
+	/**
+	 * Moves to the next child of an element, skipping the rest of the current child and all its descendants
+	 *
+	 * @param ParentDepth Depth of the parent element, as returned by GetDepth() on its StartElement
+	 * @return False when the parent element is closed (or the document ends)
+	 */
+	bool NextChild(int32 ParentDepth);
+
+	/**
+	 * Finds the first child of the current element for each tag, like FXmlNode::FindChildNode, without parsing them. The reader is left after the current element
+	 *
+	 * @param Tags Tags to look for
+	 * @param OutMarks Marks of the children, in the same order than the tags. Invalid for the tags not found
+	 */
+	void FindChildren(TArrayView<const ANSICHAR* const> Tags, TArray<FMark>& OutMarks);
+
+	/// Mark of the current element
+	FMark GetMark() const;
+
+	/// Moves back (or forward) to an element: the next call to Next() returns its StartElement
+	void Rewind(const FMark& Mark);
+
+	/// Depth of the current element (of its parent after an EndElement). The root element is at depth 1
+	FORCEINLINE int32 GetDepth() const { return this->Depth; }
+
+	/// Tag of the current element
+	FORCEINLINE FAnsiStringView GetTag() const { return this->Tag; }
+
+	/// True if the tag of the current element is Tag
+	FORCEINLINE bool IsTag(const ANSICHAR* InTag) const { return this->Tag.Equals(InTag, ESearchCase::CaseSensitive); }
+
+	/// Error message when Next() returned EToken::Error
+	FORCEINLINE const FString& GetError() const { return this->Error; }
+
+	/// True if the document is malformed. NextChild() and FindChildren() stop on errors, so it must be checked once the parse is done
+	FORCEINLINE bool HasError() const { return !this->Error.IsEmpty(); }
+
+	/*********************************************
+	*   ATTRIBUTES OF THE CURRENT StartElement   *
+	*********************************************/
+
+	/// Trimmed value of an attribute as it's written in the document (no entities decoding). Empty if the attribute is missing
+	FAnsiStringView GetRawAttribute(const ANSICHAR* Name) const;
+
+	/// True if the attribute is missing or only made of spaces
+	FORCEINLINE bool IsAttributeEmpty(const ANSICHAR* Name) const { return this->GetRawAttribute(Name).IsEmpty(); }
+
+	/// Trimmed value of an attribute, same as FXmlNode::GetAttribute(Name).TrimStartAndEnd()
+	FString GetAttribute(const ANSICHAR* Name) const;
+
+	/// Value of an attribute interned into an FName, without intermediate FString
+	FName GetAttributeName(const ANSICHAR* Name) const;
+
+	/**
+	 * Value of an attribute in a string owned by the reader, reused by every call: no allocation once it's big enough.
+	 * To be consumed right away (EG: parsed), it's overwritten by the next call
+	 */
+	const FString& GetAttributeTemp(const ANSICHAR* Name) const;
+
+	/// Parses an attribute with LexTryParseString. OutValue is untouched if the attribute is missing or invalid
+	template <typename TType> bool ParseAttribute(const ANSICHAR* Name, TType& OutValue) const {
+		return LexTryParseString(OutValue, *this->GetAttributeTemp(Name));
+	}
+
+private:
+
+	struct FAttribute {
+		FAnsiStringView Name;
+		FAnsiStringView Value;
+	};
+
+	/// Appends the decoded (UTF-8 and entities) value to a string
+	static void AppendDecoded(FAnsiStringView Raw, FString& Out);
+
+	EToken SetError(const TCHAR* Message);
+	bool SkipTo(const ANSICHAR* Pattern);
+	void SkipSpaces();
+
+	const ANSICHAR* Begin;
+	const ANSICHAR* End;
+	const ANSICHAR* Cursor;
+	/// Start of the current element, for GetMark()
+	const ANSICHAR* ElementBegin;
+
+	int32 Depth;
+	/// The current element was '<Tag/>': the next Next() closes it
+	bool bPendingEnd;
+	FAnsiStringView Tag;
+	/// Tags of the open elements
+	TArray<FAnsiStringView, TInlineAllocator<32>> Stack;
+	TArray<FAttribute, TInlineAllocator<32>> Attributes;
+	mutable FString Temp;
+	FString Error;
+};
@@ -33,14 +33,17 @@ SOFTWARE.
  * Creates the Importer of GDTF 3D models
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 10 may 2022
+ *
+ * @param Description GDTF Description already imported
+ * @param DataVersion Version of the GDTF format of the description
  */
-FCPGDTF3DModelsImporter::FCPGDTF3DModelsImporter(UPackage* Package, FString GDTFPath, const FXmlFile* XMLFile) {
+FCPGDTF3DModelsImporter::FCPGDTF3DModelsImporter(UPackage* Package, FString GDTFPath, UCPGDTFDescription* Description, const FString& DataVersion) {
 
 	this->Package = Package;
 	this->GDTFPath = GDTFPath;
-	this->XMLFile = XMLFile;
+	this->Description = Description;
 
-	FString VersionStr = XMLFile->GetRootNode()->GetAttribute("DataVersion");
+	FString VersionStr = DataVersion;
 	TArray<FString> VersionArray;
 	VersionStr.ParseIntoArray(VersionArray, TEXT("."), true);
 	TArray<FString> MinVersionArray;
@@ -74,21 +77,18 @@ FCPGDTF3DModelsImporter::FCPGDTF3DModelsImporter(UPackage* Package, FString GDTF
 bool FCPGDTF3DModelsImporter::Import() {
 
 	// If the fixture doesn't have models our work is done
-	if (!this->XMLFile->GetRootNode()->GetFirstChildNode()->FindChildNode("Models")) return true;
-	// Same if the models node is empty
-	if (!this->XMLFile->GetRootNode()->GetFirstChildNode()->FindChildNode("Models")->GetFirstChildNode()) return true;
+	UCPGDTFDescriptionModels* Models = Cast<UCPGDTFDescriptionModels>(this->Description->Models);
+	if (Models == nullptr) return true;
 
 	// We import the models
 	bool bEverythingOK = true;
-	const FXmlNode* ModelNode = this->XMLFile->GetRootNode()->GetFirstChildNode()->FindChildNode("Models")->GetFirstChildNode();
-	while (ModelNode != nullptr) {
+	for (const FCPGDTFDescriptionModel& Model : Models->Models) {
 
-		if (!this->Import3DModel(ModelNode)) {
-			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Failed to import model '%s'"), *ModelNode->GetAttribute("Name"));
-			FCPGDTFImporterUtils::SendNotification("3D model import failed", FString::Printf(TEXT("Failed to import model '%s'"), *ModelNode->GetAttribute("Name")), SNotificationItem::CS_Fail);
+		if (!this->Import3DModel(Model)) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Failed to import model '%s'"), *Model.Name.ToString());
+			FCPGDTFImporterUtils::SendNotification("3D model import failed", FString::Printf(TEXT("Failed to import model '%s'"), *Model.Name.ToString()), SNotificationItem::CS_Fail);
 			bEverythingOK = false;
 		}
-		ModelNode = ModelNode->GetNextNode();
 	}
 
 	return bEverythingOK;
@@ -99,14 +99,14 @@ bool FCPGDTF3DModelsImporter::Import() {
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 10 may 2022
  *
- * @param ModelXML XML Node representing the model
+ * @param Model Description of the model
  */
-bool FCPGDTF3DModelsImporter::Import3DModel(const FXmlNode* ModelXML) {
+bool FCPGDTF3DModelsImporter::Import3DModel(const FCPGDTFDescriptionModel& Model) {
 
 	// This model doesn't have a 3D model
-	if (ModelXML->GetAttribute("File").Equals("")) return true;
+	if (Model.File.IsNone()) return true;
 
-	UObject* model = FCPGDTFImporterUtils::Import3DModel(this->GDTFPath, ModelXML->GetAttribute("Name"), ModelXML->GetAttribute("File"), this->Package->GetName() + TEXT("/models"));
+	UObject* model = FCPGDTFImporterUtils::Import3DModel(this->GDTFPath, Model.Name.ToString(), Model.File.ToString(), this->Package->GetName() + TEXT("/models"));
 	return model != nullptr;
 }
 
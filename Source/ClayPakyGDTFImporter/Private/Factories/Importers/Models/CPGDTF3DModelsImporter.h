@@ -25,7 +25,6 @@ SOFTWARE.
 #pragma once
 
 #include "CoreMinimal.h"
-#include "XMLFile.h"
 #include "CPGDTFDescription.h"
 
 class UCPGDTF3DModelsImporter;
@@ -43,8 +42,8 @@ private:
 	/** Path of the GDTF file on disk */
 	FString GDTFPath;
 
-	/** XML Description extracted from GDTF archive */
-	const FXmlFile* XMLFile;
+	/** GDTF Description already imported, listing the models */
+	UCPGDTFDescription* Description;
 
 	/** Minimal version of GDTF supported by 3D models importer */
 	FString MIN_GDTF_VERSION_SUPPORTED = "1.2";
@@ -55,8 +54,11 @@ public:
 	 * Creates the Importer of GDTF 3D models
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 10 may 2022
+	 *
+	 * @param Description GDTF Description already imported
+	 * @param DataVersion Version of the GDTF format of the description
 	 */
-	FCPGDTF3DModelsImporter(UPackage* Package, FString GDTFPath, const FXmlFile* XMLFile);
+	FCPGDTF3DModelsImporter(UPackage* Package, FString GDTFPath, UCPGDTFDescription* Description, const FString& DataVersion);
 
 	/**
 	 * Import the 3D models from a GDTF file
@@ -74,7 +76,7 @@ private:
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 10 may 2022
 	 *
-	 * @param ModelXML XML Node representing the model
+	 * @param Model Description of the model
 	 */
-	bool Import3DModel(const FXmlNode* ModelXML);
+	bool Import3DModel(const FCPGDTFDescriptionModel& Model);
 };
@@ -26,13 +26,19 @@ SOFTWARE.
 #include "ClayPakyGDTFImporterLog.h"
 #include "Utils/CPGDTFImporterUtils.h"
 #include "Utils/CPGDTFColorWizard.h"
-#include "XMLFile.h"
 #include "ObjectTools.h"
 #include "PackageTools.h"
 #include "Rendering/Texture2DResource.h"
 #include "Engine/Texture.h"
-#include "Libs/FastGaussianBlur/FastGaussianBlur.h"
+#include "Engine/Texture2DArray.h"
+#include "Utils/CPGDTFFrostBlur.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Factories/CPGDTFUnzip.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "ImageUtils.h"
+#include "Modules/ModuleManager.h"
+#include "Async/ParallelFor.h"
 
 // We limit the size of each gobo at 256x256 to preserve performances
 #define CP_GOBO_SIZE 256
@@ -41,12 +47,14 @@ SOFTWARE.
 * Creates the Importer of GDTF textures (gobos, prisms, colors wheels ...)
 * @author Dorian Gardes - Clay Paky S.R.L.
 * @date 06 may 2022
+*
+* @param SlotsMedia Slots with an image, read by the GDTF Description import
 */
-FCPGDTFWheelImporter::FCPGDTFWheelImporter(UPackage* Package, FString GDTFPath, const FXmlFile* XMLFile) {
+FCPGDTFWheelImporter::FCPGDTFWheelImporter(UPackage* Package, FString GDTFPath, const TArray<FWheelSlotMedia>& SlotsMedia) {
 	
 	this->Package = CreatePackage(*(Package->GetName() + "/textures/")); // We store all the textures on a subfolder
 	this->GDTFPath = GDTFPath;
-	this->XMLFile = XMLFile;
+	this->SlotsMedia = SlotsMedia;
 }
 
 /**
@@ -58,18 +66,72 @@ FCPGDTFWheelImporter::FCPGDTFWheelImporter(UPackage* Package, FString GDTFPath,
  */
 bool FCPGDTFWheelImporter::Import() {
 
-	// If the fixture doesn't have wheels our work is done
-	if (!this->XMLFile->GetRootNode()->GetFirstChildNode()->FindChildNode("Wheels")) return true;
-	// Same if the wheels node is empty
-	if (!this->XMLFile->GetRootNode()->GetFirstChildNode()->FindChildNode("Wheels")->GetFirstChildNode()) return true;
+	// If the fixture doesn't have wheel slots with an image our work is done
+	if (this->SlotsMedia.Num() == 0) return true;
+
+	// Slot image to import and its decoded pixels
+	struct FSlotImage {
+		FString WheelName;
+		FString SlotName;
+		FString FileName;
+		TArray<FColor> Pixels;
+		int32 SizeX = 0;
+		int32 SizeY = 0;
+		TArray<FColor> GoboPixels;
+		bool bDecoded = false;
+	};
+
+	// We list the slots of all the wheels
+	TArray<FSlotImage> Slots;
+	for (const FWheelSlotMedia& SlotMedia : this->SlotsMedia) {
+		FSlotImage& Slot = Slots.AddDefaulted_GetRef();
+		Slot.WheelName = SlotMedia.WheelName;
+		Slot.SlotName = SlotMedia.SlotName;
+		Slot.FileName = TEXT("wheels/") + SlotMedia.MediaFileName + TEXT(".png");
+	}
 
-	// We import the wheels
-	bool bEverythingOK = true;
-	const FXmlNode* WheelNode = this->XMLFile->GetRootNode()->GetFirstChildNode()->FindChildNode("Wheels")->GetFirstChildNode();
-	while (WheelNode != nullptr) {
-	
-		if (!this->ImportWheel(WheelNode)) bEverythingOK = false;
-		WheelNode = WheelNode->GetNextNode();
+	TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(this->GDTFPath);
+	if (!Archive.IsValid()) {
+		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Unable to open GDTF archive '%s'."), *this->GDTFPath);
+		return false;
+	}
+	// The module manager isn't thread safe: the module is resolved on the game thread and handed to the workers
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+	// Extraction, decoding and resizing of the images are independent: one task per slot
+	ParallelFor(Slots.Num(), [&Slots, &Archive, &ImageWrapperModule](int32 SlotIndex) {
+		FSlotImage& Slot = Slots[SlotIndex];
+		TArray<uint8> Compressed;
+		if (!Archive->Extract(Slot.FileName, Compressed)) return;
+		if (!FCPGDTFWheelImporter::DecodeSlotImage_Internal(ImageWrapperModule, Compressed, Slot.Pixels, Slot.SizeX, Slot.SizeY)) return;
+
+		if (Slot.SizeX == CP_GOBO_SIZE && Slot.SizeY == CP_GOBO_SIZE) Slot.GoboPixels = Slot.Pixels;
+		else FImageUtils::ImageResize(Slot.SizeX, Slot.SizeY, Slot.Pixels, CP_GOBO_SIZE, CP_GOBO_SIZE, Slot.GoboPixels, false);
+		Slot.bDecoded = true;
+	});
+
+	// Assets creation must stay on the game thread
+	bool bEverythingOK = true; // Flag to not stop the import but alert for an error
+	for (FSlotImage& Slot : Slots) {
+
+		if (!Slot.bDecoded) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Unable to read '%s' from GDTF archive."), *Slot.FileName);
+			bEverythingOK = false;
+			continue;
+		}
+		UTexture2D* texture = FCPGDTFImporterUtils::CreateTextureFromPixels(Slot.SlotName, this->Package->GetName() + TEXT("/") + Slot.WheelName, (const uint8*)Slot.Pixels.GetData(), Slot.SizeX, Slot.SizeY);
+		if (texture == nullptr) {
+			bEverythingOK = false;
+			continue;
+		}
+		texture->CompressionSettings = TextureCompressionSettings::TC_VectorDisplacementmap;
+		texture->MipGenSettings = TextureMipGenSettings::TMGS_NoMipmaps;
+		texture->SRGB = false;
+		texture->MaxTextureSize = CP_GOBO_SIZE;
+		texture->UpdateResource();
+		texture->GetPackage()->SetDirtyFlag(true);
+
+		this->DecodedSlots.Add(texture, MoveTemp(Slot.GoboPixels));
 	}
 
 	return bEverythingOK;
@@ -120,46 +182,6 @@ void FCPGDTFWheelImporter::LinkTexturesToGDTFDescription(UCPGDTFDescription* Fix
 	Cast<UDMXImportGDTFWheels>(FixtureAsset->Wheels)->Wheels = wheels;
 }
 
-/**
- * Import the GDTF textures related to a specific wheel if applicable
- * @author Dorian Gardes - Clay Paky S.R.L.
- * @date 06 may 2022
- *
- * @param WheelXML XML Node representing the wheel
- */
-bool FCPGDTFWheelImporter::ImportWheel(const FXmlNode* WheelXML) {
-
-	FString WheelName = WheelXML->GetAttribute("Name");
-	bool bEverythingOK = true; // Flag to not stop the import but alert for an error
-
-	const FXmlNode* WheelSlot = WheelXML->GetFirstChildNode();
-	while (WheelSlot != nullptr) {
-
-		// If the slot doesn't have a texture associated we continue
-		if (WheelSlot->GetAttribute("MediaFileName").Equals("")) {
-			
-			WheelSlot = WheelSlot->GetNextNode();
-			continue;
-		}
-		
-		UTexture2D* texture = FCPGDTFImporterUtils::ImportPNG(this->GDTFPath, WheelSlot->GetAttribute("Name"), TEXT("wheels/") + WheelSlot->GetAttribute("MediaFileName"), this->Package->GetName() + TEXT("/") + WheelName);
-		if (texture == nullptr) {
-			bEverythingOK = false;
-		} else {
-			texture->CompressionSettings = TextureCompressionSettings::TC_VectorDisplacementmap;
-			texture->MipGenSettings = TextureMipGenSettings::TMGS_NoMipmaps;
-			texture->SRGB = false;
-			texture->MaxTextureSize = CP_GOBO_SIZE;
-			texture->UpdateResource();
-			texture->GetPackage()->SetDirtyFlag(true);
-		}
-
-		WheelSlot = WheelSlot->GetNextNode();
-	}
-
-	return bEverythingOK;
-}
-
 /**
  * Automaticaly generate the Wheels disks textures
  * @author Dorian Gardes - Clay Paky S.R.L.
@@ -167,29 +189,55 @@ bool FCPGDTFWheelImporter::ImportWheel(const FXmlNode* WheelXML) {
  *
  * @param FixtureDescription GDTFDescription of the Fixture
  * @param FixturePackagePath Path of the fixture folder on Content Browser
+ * @param DecodedSlots Pixels of the slots already decoded by the Import. Slots not in this map are read back from their texture.
+ * @param bCreateTextureArrays If true each disk is also saved as a texture array, one slice per slot
+ * @param FrostLevels If greater than 0 each gobo wheel gets a frost chain texture instead of its frosted texture, its mips being stronger and stronger frosts of the disk
 */
-void FCPGDTFWheelImporter::CreateGDTFWheelsTextures(UCPGDTFDescription* FixtureDescription, FString FixturePackagePath) {
+void FCPGDTFWheelImporter::CreateGDTFWheelsTextures(UCPGDTFDescription* FixtureDescription, FString FixturePackagePath, const TMap<const UTexture2D*, TArray<FColor>>& DecodedSlots, bool bCreateTextureArrays, int32 FrostLevels) {
 
 	if (FixturePackagePath[FixturePackagePath.Len()-1] == '/') FixturePackagePath.RemoveAt(FixturePackagePath.Len()-1);
 	FixturePackagePath.Append("/textures/");
+
+	// We gather the inputs of each disk on the game thread
+	TArray<FWheelDisk> Disks;
 	for (FDMXImportGDTFWheel Wheel : Cast<UDMXImportGDTFWheels>(FixtureDescription->Wheels)->Wheels) {
 
 		WheelType Type = FCPGDTFWheelImporter::GetWheelType(FixtureDescription, Wheel.Name);
-		FString SavePath = FixturePackagePath + ObjectTools::SanitizeObjectName(Wheel.Name.ToString());
+		if (Type != WheelType::Gobo && Type != WheelType::Color) continue;
+
+		FWheelDisk& Disk = Disks.AddDefaulted_GetRef();
+		Disk.SavePath = FixturePackagePath + ObjectTools::SanitizeObjectName(Wheel.Name.ToString());
+		Disk.Type = Type;
+		Disk.FrostLevels = Type == WheelType::Gobo ? FrostLevels : 0; // Only the gobos are frosted by the beam
 		if (Type == WheelType::Gobo) {
-			
-			TArray<UTexture2D*> Textures;
 			for (FDMXImportGDTFWheelSlot Slot : Wheel.Slots) {
-				if (Slot.MediaFileName != nullptr) Textures.Add(Slot.MediaFileName);
+				if (Slot.MediaFileName == nullptr) continue;
+				const TArray<FColor>* Decoded = DecodedSlots.Find(Slot.MediaFileName);
+				Disk.Gobos.Add(Decoded != nullptr ? *Decoded : FCPGDTFWheelImporter::ReadSlotPixels_Internal(Slot.MediaFileName));
 			}
-			FCPGDTFWheelImporter::CreateGoboWheelTexture_Internal(SavePath, Textures);
-		} else if (Type == WheelType::Color) {
-			
-			TArray<FLinearColor> Colors = FCPGDTFWheelImporter::GenerateColorArray(Wheel);
-			FCPGDTFWheelImporter::CreateColorWheelTexture_Internal(SavePath, Colors);
-		}
+		} else Disk.Colors = FCPGDTFWheelImporter::GenerateColorArray(Wheel);
 	}
 
+	// Stitching and frosting are pure pixel work: one task per disk
+	ParallelFor(Disks.Num(), [&Disks](int32 DiskIndex) {
+		FCPGDTFWheelImporter::BuildWheelDisk_Internal(Disks[DiskIndex]);
+	});
+
+	for (FWheelDisk& Disk : Disks) {
+		if (Disk.SizeX == 0) continue; // Nothing to show on this wheel
+		if (Disk.FrostMips.Num() == 0) {
+			FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Disk.Pixels.GetData(), Disk.SavePath, Disk.SizeX, Disk.SizeY);
+			if (bCreateTextureArrays) FCPGDTFWheelImporter::SaveWheelToTextureArray_Internal(Disk.Pixels.GetData(), Disk.SavePath, Disk.SizeX, Disk.SizeY, CP_GOBO_SIZE);
+			FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Disk.FrostedPixels.GetData(), Disk.SavePath, Disk.SizeX, Disk.SizeY, true);
+			if (bCreateTextureArrays) FCPGDTFWheelImporter::SaveWheelToTextureArray_Internal(Disk.FrostedPixels.GetData(), Disk.SavePath, Disk.SizeX, Disk.SizeY, CP_GOBO_SIZE, true);
+			continue;
+		}
+
+		// The frost chain replaces both the plain and the frosted disks: its mip 0 is the plain disk, the mips 1+ the frosts.
+		// The beam, the lens and the light only sample this texture
+		FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Disk.Pixels.GetData(), Disk.SavePath, Disk.SizeX, Disk.SizeY, false, Disk.FrostMips);
+		if (bCreateTextureArrays) FCPGDTFWheelImporter::SaveWheelToTextureArray_Internal(Disk.Pixels.GetData(), Disk.SavePath, Disk.SizeX, Disk.SizeY, CP_GOBO_SIZE, false, Disk.FrostMips);
+	}
 }
 
 /**
@@ -264,69 +312,124 @@ TArray<FLinearColor> FCPGDTFWheelImporter::GenerateColorArray(FDMXImportGDTFWhee
 }
 
 /**
- * Create a texture for a given array of SubTextures
+ * Decode a PNG image to BGRA8 pixels. Thread safe.
+ *
+ * @param ImageWrapperModule Image wrapper module, resolved on the game thread
+ * @param Compressed PNG file content
+ * @param OutPixels Decoded pixels
+ * @param OutSizeX Width of the image
+ * @param OutSizeY Height of the image
+ * @return True if the image was decoded
+ */
+bool FCPGDTFWheelImporter::DecodeSlotImage_Internal(IImageWrapperModule& ImageWrapperModule, const TArray<uint8>& Compressed, TArray<FColor>& OutPixels, int32& OutSizeX, int32& OutSizeY) {
+
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(Compressed.GetData(), Compressed.Num())) return false;
+
+	TArray64<uint8> RawData;
+	if (!ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, RawData)) return false;
+
+	OutSizeX = ImageWrapper->GetWidth();
+	OutSizeY = ImageWrapper->GetHeight();
+	if (RawData.Num() != (int64)OutSizeX * OutSizeY * 4) return false;
+	// FColor memory layout is BGRA
+	OutPixels.SetNumUninitialized(OutSizeX * OutSizeY);
+	FMemory::Memcpy(OutPixels.GetData(), RawData.GetData(), RawData.Num());
+	return true;
+}
+
+/**
+ * Read the pixels of a slot texture already on the Content Browser, from its source so the platform data doesn't need to be built. Must be called on the game thread.
+ *
+ * @param Texture Texture of the slot
+ * @return Pixels of the gobo, resized to CP_GOBO_SIZE x CP_GOBO_SIZE, or an empty array if they can't be used
+ */
+TArray<FColor> FCPGDTFWheelImporter::ReadSlotPixels_Internal(UTexture2D* Texture) {
+
+	TArray<FColor> GoboPixels;
+	if (Texture->Source.GetFormat() != ETextureSourceFormat::TSF_BGRA8) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Only BGRA8 gobos textures are supported, %s is skipped."), *Texture->GetName());
+		return GoboPixels;
+	}
+
+	TArray64<uint8> SourceData;
+	const int32 SizeX = Texture->Source.GetSizeX();
+	const int32 SizeY = Texture->Source.GetSizeY();
+	if (!Texture->Source.GetMipData(SourceData, 0) || SourceData.Num() != (int64)SizeX * SizeY * 4) {
+		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Unable to read %s Gobo pixels."), *Texture->GetName());
+		return GoboPixels;
+	}
+
+	// FColor memory layout is BGRA
+	TArray<FColor> SourcePixels;
+	SourcePixels.SetNumUninitialized(SizeX * SizeY);
+	FMemory::Memcpy(SourcePixels.GetData(), SourceData.GetData(), SourceData.Num());
+	if (SizeX == CP_GOBO_SIZE && SizeY == CP_GOBO_SIZE) return SourcePixels;
+	FImageUtils::ImageResize(SizeX, SizeY, SourcePixels, CP_GOBO_SIZE, CP_GOBO_SIZE, GoboPixels, false);
+	return GoboPixels;
+}
+
+/**
+ * Build the pixels of a wheel disk and either its frosted version or its frost mips. Thread safe.
+ *
+ * @param Disk Wheel disk to build
+ */
+void FCPGDTFWheelImporter::BuildWheelDisk_Internal(FWheelDisk& Disk) {
+
+	if (Disk.Type == WheelType::Gobo) Disk.SizeX = FCPGDTFWheelImporter::CreateGoboWheelPixels_Internal(Disk.Gobos, Disk.Pixels);
+	else Disk.SizeX = FCPGDTFWheelImporter::CreateColorWheelPixels_Internal(Disk.Colors, Disk.Pixels);
+	Disk.SizeY = CP_GOBO_SIZE;
+
+	if (Disk.SizeX == 0) return;
+
+	// Each mip is a stronger frost of the previous one, the shader picks the level from the frost value
+	if (Disk.FrostLevels > 0) {
+		FCPGDTFFrostBlur::BuildFrostMips(Disk.Pixels.GetData(), Disk.SizeX, Disk.SizeY, CP_GOBO_SIZE, Disk.FrostLevels, 4, Disk.FrostMips);
+		return;
+	}
+
+	// Creation of the frosted version because frost operation is very consuming
+	Disk.FrostedPixels = Disk.Pixels;
+	FCPGDTFWheelImporter::FrostWheelTexture_Internal(Disk.FrostedPixels.GetData(), Disk.SizeX, Disk.SizeY, CP_GOBO_SIZE, 4); /// TODO \todo Is a frost strenght value available in GDTF ??
+}
+
+/**
+ * Create the pixels of a wheel disk for a given array of gobos
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 12 july 2022
  *
- * @param SavePath		Path of the texture on the content browser
- * @param TexturesArray Array of textures used to build the wheel disk
+ * @param Gobos Pixels of the gobos used to build the wheel disk
+ * @param OutPixels Pixels of the wheel disk
+ * @return Width of the wheel disk
 */
-void FCPGDTFWheelImporter::CreateGoboWheelTexture_Internal(FString SavePath, TArray<UTexture2D*> TexturesArray) {
+int32 FCPGDTFWheelImporter::CreateGoboWheelPixels_Internal(const TArray<TArray<FColor>>& Gobos, TArray<uint8>& OutPixels) {
 
-	int16 TextureSizeX = CP_GOBO_SIZE * TexturesArray.Num();
+	int32 TextureSizeX = CP_GOBO_SIZE * Gobos.Num();
 	
 	// Generation of the Texture pixels
-	uint8* Pixels = new uint8[TextureSizeX * CP_GOBO_SIZE * 4];
-
-	// Creation of a full black texture
-	for (int i = 0; i < TextureSizeX * CP_GOBO_SIZE * 4; i += 4) {
-		Pixels[i  ] = 0;
-		Pixels[i+1] = 0;
-		Pixels[i+2] = 0;
-		Pixels[i+3] = 255; // Alpha
-	}
-	// Loop on gobos
-	for (int GoboIndex = 0; GoboIndex < TexturesArray.Num(); GoboIndex++) {
+	OutPixels.SetNumUninitialized(TextureSizeX * CP_GOBO_SIZE * 4);
+	uint8* Pixels = OutPixels.GetData();
 
-		FTexture2DMipMap GoboMip = TexturesArray[GoboIndex]->GetPlatformData()->Mips[0];
-		if (GoboMip.SizeX != CP_GOBO_SIZE) {
-			UE_LOG_CPGDTFIMPORTER(Warning, TEXT("We do not support gobos textures other than CP_GOBO_SIZE x CP_GOBO_SIZE px. Please provide CP_GOBO_SIZE x CP_GOBO_SIZE px or more for %s texture on GDTF."), *TexturesArray[GoboIndex]->GetName());
-			continue;
-		}
+	// Loop on gobos, row by row: each row of a gobo is a contiguous span of the strip row
+	for (int GoboIndex = 0; GoboIndex < Gobos.Num(); GoboIndex++) {
 
-		int GoboX = 0, GoboY = 0;
-		uint8* GoboPixels = (uint8*)GoboMip.BulkData.Lock(LOCK_READ_ONLY);
-
-		if (GoboPixels == nullptr) {
-			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Unable to read %s Gobo pixels."), *TexturesArray[GoboIndex]->GetName());
-			GoboMip.BulkData.Unlock();
+		uint8* SlotPixels = Pixels + CP_GOBO_SIZE * GoboIndex * 4;
+		// Unreadable gobos stay black
+		if (Gobos[GoboIndex].Num() != CP_GOBO_SIZE * CP_GOBO_SIZE) {
+			for (int32 PixelsY = 0; PixelsY < CP_GOBO_SIZE; PixelsY++) {
+				FColor* Row = (FColor*)(SlotPixels + PixelsY * TextureSizeX * 4);
+				for (int32 GoboX = 0; GoboX < CP_GOBO_SIZE; GoboX++) Row[GoboX] = FColor::Black;
+			}
 			continue;
 		}
 
-		// Loop on columns
-		for (int32 PixelsX = CP_GOBO_SIZE * GoboIndex; PixelsX < (CP_GOBO_SIZE * (GoboIndex + 1)); PixelsX++) {
-			GoboY = 0;
-			// Loop on rows
-			for (int32 PixelsY = 0; PixelsY < CP_GOBO_SIZE; PixelsY++) {
-				int32 curPixelIndex = ((PixelsY * TextureSizeX) + PixelsX);
-				int32 curGoboPixelIndex = ((GoboY * CP_GOBO_SIZE) + GoboX);
-				Pixels[4 * curPixelIndex + 2] = GoboPixels[4 * curGoboPixelIndex + 2]; // Red;
-				Pixels[4 * curPixelIndex + 1] = GoboPixels[4 * curGoboPixelIndex + 1];// Green;
-				Pixels[4 * curPixelIndex    ] = GoboPixels[4 * curGoboPixelIndex];   // Blue;
-				Pixels[4 * curPixelIndex + 3] = 255; // Alpha;
-				GoboY++;
-			}
-			GoboX++;
+		// The alpha is copied as is, the wheel textures are compressed without it
+		const uint8* GoboPixels = (const uint8*)Gobos[GoboIndex].GetData();
+		for (int32 PixelsY = 0; PixelsY < CP_GOBO_SIZE; PixelsY++) {
+			FMemory::Memcpy(SlotPixels + PixelsY * TextureSizeX * 4, GoboPixels + PixelsY * CP_GOBO_SIZE * 4, CP_GOBO_SIZE * 4);
 		}
-		GoboMip.BulkData.Unlock();
 	}
-
-	FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Pixels, SavePath, TextureSizeX, CP_GOBO_SIZE, false);
-
-	// Creation of the frosted version because frost operation is very consuming
-	FCPGDTFWheelImporter::FrostWheelTexture_Internal(Pixels, TextureSizeX, CP_GOBO_SIZE, 4); /// TODO \todo Is a frost strenght value available in GDTF ??
-	FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Pixels, SavePath, TextureSizeX, CP_GOBO_SIZE, true);
-	delete[] Pixels;
+	return TextureSizeX;
 }
 
 /**
@@ -337,78 +440,47 @@ void FCPGDTFWheelImporter::CreateGoboWheelTexture_Internal(FString SavePath, TAr
  * @param PixelsArray Pixels to frost
  * @param SizeX Size of the Texture
  * @param SizeY Size of the Texture
+ * @param SlotSizeX Size of each slot of the wheel. Slots are frosted independently
  * @param Strenght Strenght of the frost
 */
-void FCPGDTFWheelImporter::FrostWheelTexture_Internal(uint8* PixelsArray, int SizeX, int SizeY, float Strenght) {
-
-	// We need to copy the input pixels to a smaller one because the Gaussian Blur algorithm only support RGB and we have RGBA
-	int* InPixelsBlur  = new int[SizeX * SizeY * 3];
-	int* OutPixelsBlur = new int[SizeX * SizeY * 3];
-
-	// Copy into In array
-	for (int PixelX = 0; PixelX < SizeX; PixelX++) {
-		for (int PixelY = 0; PixelY < SizeY; PixelY++) {
-			int PixelArrayAddr = ((PixelY * SizeX) + PixelX);
-			InPixelsBlur[PixelArrayAddr * 3    ] = PixelsArray[PixelArrayAddr * 4];
-			InPixelsBlur[PixelArrayAddr * 3 + 1] = PixelsArray[PixelArrayAddr * 4 + 1];
-			InPixelsBlur[PixelArrayAddr * 3 + 2] = PixelsArray[PixelArrayAddr * 4 + 2];
-		}
-	}
-
-	fast_gaussian_blur_rgb(InPixelsBlur, OutPixelsBlur, SizeX, SizeY, 3, Strenght);
-	delete[] InPixelsBlur;
+void FCPGDTFWheelImporter::FrostWheelTexture_Internal(uint8* PixelsArray, int SizeX, int SizeY, int SlotSizeX, float Strenght) {
 
-	//Copy the out array into PixelsArray
-	for (int PixelX = 0; PixelX < SizeX; PixelX++) {
-		for (int PixelY = 0; PixelY < SizeY; PixelY++) {
-			int PixelArrayAddr = ((PixelY * SizeX) + PixelX);
-			PixelsArray[PixelArrayAddr * 4] = OutPixelsBlur[PixelArrayAddr * 3];
-			PixelsArray[PixelArrayAddr * 4 + 1] = OutPixelsBlur[PixelArrayAddr * 3 + 1];
-			PixelsArray[PixelArrayAddr * 4 + 2] = OutPixelsBlur[PixelArrayAddr * 3 + 2];
-		}
-	}
-	delete[] OutPixelsBlur;
+	FCPGDTFFrostBlur::BlurSlots(PixelsArray, SizeX, SizeY, SlotSizeX, Strenght);
 }
 
 /**
- * Create a texture for a given array of Colors
+ * Create the pixels of a wheel disk for a given array of Colors
  * @author Dorian Gardes - Clay Paky S.R.L.
  * @date 06 july 2022
  *
- * @param SavePath		Path of the texture on the content browser
  * @param ColorsArray Array of colors used to build the wheel disk
+ * @param OutPixels Pixels of the wheel disk
+ * @return Width of the wheel disk
  */
-void FCPGDTFWheelImporter::CreateColorWheelTexture_Internal(FString SavePath, TArray<FLinearColor> ColorsArray) {
+int32 FCPGDTFWheelImporter::CreateColorWheelPixels_Internal(const TArray<FLinearColor>& ColorsArray, TArray<uint8>& OutPixels) {
 
-	#define CP_COLOR_SIZE 256
+	#define CP_COLOR_SIZE CP_GOBO_SIZE
 
 	int X = ColorsArray.Num() * CP_COLOR_SIZE;
 	
 	// Generation of the Texture pixels
-	uint8* Pixels = new uint8[X * CP_COLOR_SIZE * 4];
+	OutPixels.SetNumUninitialized(X * CP_COLOR_SIZE * 4);
+	uint8* Pixels = OutPixels.GetData();
 
-	// Loop on colors
+	// First row: loop on colors
 	for (int ColorIndex = 0; ColorIndex < ColorsArray.Num(); ColorIndex++) {
-		// Loop on columns
 		for (int32 x = CP_COLOR_SIZE * ColorIndex; x < CP_COLOR_SIZE * (ColorIndex + 1); x++) {
-			// Loop on rows
-			for (int y = 0; y < CP_COLOR_SIZE; y++) {
-				int32 curPixelIndex = ((y * X) + x);
-				Pixels[4 * curPixelIndex + 2] = ColorsArray[ColorIndex].R * 255;   // Red;
-				Pixels[4 * curPixelIndex + 1] = ColorsArray[ColorIndex].G * 255;  // Green;
-				Pixels[4 * curPixelIndex    ] = ColorsArray[ColorIndex].B * 255; // Blue;
-				Pixels[4 * curPixelIndex + 3] = 255; // Alpha;
-			}
+			Pixels[4 * x + 2] = ColorsArray[ColorIndex].R * 255;   // Red;
+			Pixels[4 * x + 1] = ColorsArray[ColorIndex].G * 255;  // Green;
+			Pixels[4 * x    ] = ColorsArray[ColorIndex].B * 255; // Blue;
+			Pixels[4 * x + 3] = 255; // Alpha;
 		}
 	}
+	// All the rows are the same
+	for (int y = 1; y < CP_COLOR_SIZE; y++) FMemory::Memcpy(Pixels + y * X * 4, Pixels, X * 4);
 
-	FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Pixels, SavePath, X, CP_COLOR_SIZE);
-
-	FCPGDTFWheelImporter::FrostWheelTexture_Internal(Pixels, X, CP_COLOR_SIZE, 4); /// TODO \todo Is a frost strenght value available in GDTF ??
-	FCPGDTFWheelImporter::SaveWheelToTexture_Internal(Pixels, SavePath, X, CP_COLOR_SIZE, true);
-
-	delete[] Pixels;
 	#undef CP_COLOR_SIZE
+	return X;
 }
 
 /**
@@ -421,15 +493,12 @@ void FCPGDTFWheelImporter::CreateColorWheelTexture_Internal(FString SavePath, TA
  * @param SizeX Size of the texture
  * @param SizeY Size of the texture
  * @param bIsFrosted 
+ * @param FrostMips Pixels of the following mips. If empty mips are generated by the engine, otherwise the texture is the frost chain of the disk
 */
-void FCPGDTFWheelImporter::SaveWheelToTexture_Internal(uint8* PixelsArray, FString SavePath, int SizeX, int SizeY, bool bIsFrosted) {
+void FCPGDTFWheelImporter::SaveWheelToTexture_Internal(uint8* PixelsArray, FString SavePath, int SizeX, int SizeY, bool bIsFrosted, const TArray<TArray<uint8>>& FrostMips) {
 
 	// Generate the save package
-	if (SavePath[SavePath.Len()-1] == '/') SavePath.RemoveAt(SavePath.Len()-1);
-	int Index;
-	SavePath.FindLastChar('/', Index);
-	FString AssetName = FString("Wheel_").Append(SavePath.Mid(Index + 1));
-	if (bIsFrosted) AssetName.Append("_Frosted");
+	FString AssetName = FCPGDTFWheelImporter::GetWheelAssetName_Internal(SavePath, bIsFrosted, false, FrostMips.Num() > 0);
 	SavePath = SavePath.Append("/" + AssetName);
 	UE_LOG_CPGDTFIMPORTER(Error, TEXT("Saving wheel texture to: '%s'"), *SavePath);
 	UPackage* Package = CreatePackage(*SavePath);
@@ -443,7 +512,18 @@ void FCPGDTFWheelImporter::SaveWheelToTexture_Internal(uint8* PixelsArray, FStri
 	Texture->GetPlatformData()->PixelFormat = EPixelFormat::PF_B8G8R8A8;
 
 	
-	Texture->Source.Init(SizeX, SizeY, 1, 1, ETextureSourceFormat::TSF_BGRA8, PixelsArray);
+	if (FrostMips.Num() == 0) Texture->Source.Init(SizeX, SizeY, 1, 1, ETextureSourceFormat::TSF_BGRA8, PixelsArray);
+	else {
+		// The frost levels are the mips: the engine must keep them instead of generating its own
+		Texture->Source.Init(SizeX, SizeY, 1, FrostMips.Num() + 1, ETextureSourceFormat::TSF_BGRA8);
+		FMemory::Memcpy(Texture->Source.LockMip(0), PixelsArray, SizeX * SizeY * 4);
+		Texture->Source.UnlockMip(0);
+		for (int32 Mip = 0; Mip < FrostMips.Num(); Mip++) {
+			FMemory::Memcpy(Texture->Source.LockMip(Mip + 1), FrostMips[Mip].GetData(), FrostMips[Mip].Num());
+			Texture->Source.UnlockMip(Mip + 1);
+		}
+		Texture->MipGenSettings = TextureMipGenSettings::TMGS_LeaveExistingMips;
+	}
 
 	Texture->LODBias = 0;
 	Texture->AdjustMinAlpha = 1.0;
@@ -456,4 +536,95 @@ void FCPGDTFWheelImporter::SaveWheelToTexture_Internal(uint8* PixelsArray, FStri
 	FAssetRegistryModule::AssetCreated(Texture);
 }
 
+/**
+ * Create a texture array for a given wheel strip, one slice per slot
+ *
+ * @param PixelsArray Pixels of the wheel strip
+ * @param SavePath Path in the ContentBrowser
+ * @param SizeX Size of the strip
+ * @param SizeY Size of the strip
+ * @param SlotSizeX Size of each slot of the strip
+ * @param bIsFrosted
+ * @param FrostMips Pixels of the following mips of the strip. If empty mips are generated by the engine, otherwise the texture is the frost chain of the disk
+ */
+void FCPGDTFWheelImporter::SaveWheelToTextureArray_Internal(const uint8* PixelsArray, FString SavePath, int SizeX, int SizeY, int SlotSizeX, bool bIsFrosted, const TArray<TArray<uint8>>& FrostMips) {
+
+	const int32 SlotsNo = SizeX / SlotSizeX;
+	if (SlotsNo <= 0) return;
+
+	// Generate the save package
+	FString AssetName = FCPGDTFWheelImporter::GetWheelAssetName_Internal(SavePath, bIsFrosted, true, FrostMips.Num() > 0);
+	SavePath = SavePath.Append("/" + AssetName);
+	UPackage* Package = CreatePackage(*SavePath);
+
+	UTexture2DArray* Texture = NewObject<UTexture2DArray>(Package, *AssetName, RF_Public | RF_Standalone);
+	Texture->Source.Init(SlotSizeX, SizeY, SlotsNo, FrostMips.Num() + 1, ETextureSourceFormat::TSF_BGRA8);
+
+	// Slices are stored one after the other: each row of a slot is a straight copy of a span of the strip row
+	for (int32 Mip = 0; Mip <= FrostMips.Num(); Mip++) {
+		const uint8* StripPixels = Mip == 0 ? PixelsArray : FrostMips[Mip - 1].GetData();
+		const int32 MipSizeX = SizeX >> Mip;
+		const int32 MipSizeY = SizeY >> Mip;
+		const int32 MipSlotSizeX = SlotSizeX >> Mip;
+		uint8* SlicesPixels = Texture->Source.LockMip(Mip);
+		for (int32 Slot = 0; Slot < SlotsNo; Slot++) {
+			for (int32 y = 0; y < MipSizeY; y++) {
+				FMemory::Memcpy(SlicesPixels + ((Slot * MipSizeY + y) * MipSlotSizeX) * 4, StripPixels + (y * MipSizeX + Slot * MipSlotSizeX) * 4, MipSlotSizeX * 4);
+			}
+		}
+		Texture->Source.UnlockMip(Mip);
+	}
+	if (FrostMips.Num() > 0) Texture->MipGenSettings = TextureMipGenSettings::TMGS_LeaveExistingMips;
+
+	// Otherwise mips are generated slice by slice, so they don't bleed between slots like the strip ones
+	Texture->AdjustMinAlpha = 1.0;
+	Texture->CompressionNoAlpha = true;
+	Texture->SRGB = true;
+	Texture->AddressX = TextureAddress::TA_Clamp;
+	Texture->AddressY = TextureAddress::TA_Clamp;
+	Texture->UpdateResource();
+
+	Package->MarkPackageDirty();
+	FAssetRegistryModule::AssetCreated(Texture);
+}
+
+/**
+ * Generates the asset name of a wheel texture
+ *
+ * @param SavePath Path of the wheel in the ContentBrowser. Its trailing '/' is removed
+ * @param bIsFrosted True for the frosted version
+ * @param bIsArray True for the texture array version
+ * @param bIsFrostChain True for the frost chain version
+ * @return Name of the asset: Wheel_{WheelName}[_Frosted|_FrostChain][_Array]
+ */
+FString FCPGDTFWheelImporter::GetWheelAssetName_Internal(FString& SavePath, bool bIsFrosted, bool bIsArray, bool bIsFrostChain) {
+
+	if (SavePath[SavePath.Len()-1] == '/') SavePath.RemoveAt(SavePath.Len()-1);
+	int Index;
+	SavePath.FindLastChar('/', Index);
+	FString AssetName = FString("Wheel_").Append(SavePath.Mid(Index + 1));
+	if (bIsFrosted) AssetName.Append("_Frosted");
+	else if (bIsFrostChain) AssetName.Append("_FrostChain");
+	if (bIsArray) AssetName.Append("_Array");
+	return AssetName;
+}
+
+/**
+ * Generates the object path of a wheel texture created by CreateGDTFWheelsTextures
+ *
+ * @param FixturePackagePath Path of the fixture folder on Content Browser
+ * @param WheelName Name of the wheel
+ * @param bIsFrosted True for the frosted version
+ * @param bIsArray True for the texture array version
+ * @param bIsFrostChain True for the frost chain version
+ * @return Object path of the texture (EG: /Game/MyFixture/textures/Gobo1/Wheel_Gobo1_Frosted.Wheel_Gobo1_Frosted)
+ */
+FString FCPGDTFWheelImporter::GetWheelTexturePath(FString FixturePackagePath, FName WheelName, bool bIsFrosted, bool bIsArray, bool bIsFrostChain) {
+
+	if (FixturePackagePath.EndsWith("/")) FixturePackagePath.RemoveAt(FixturePackagePath.Len() - 1);
+	FString SavePath = FixturePackagePath + "/textures/" + ObjectTools::SanitizeObjectName(WheelName.ToString());
+	const FString AssetName = FCPGDTFWheelImporter::GetWheelAssetName_Internal(SavePath, bIsFrosted, bIsArray, bIsFrostChain);
+	return SavePath + "/" + AssetName + "." + AssetName;
+}
+
 #undef CP_GOBO_SIZE
@@ -128,7 +128,7 @@ void FCPFActorComponentsLoader::LoadSimpleAttributeComponents_INTERNAL(ACPGDTFFi
 	for (FDMXImportGDTFDMXChannel DMXChannel : *DMXChannels) {
 
 		TSubclassOf<UCPGDTFSimpleAttributeFixtureComponent> ComponentClass = nullptr;
-		ECPGDTFAttributeType DMXChannelAttributeType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(DMXChannel.LogicalChannels[0].Attribute.Name.ToString());
+		ECPGDTFAttributeType DMXChannelAttributeType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(DMXChannel.LogicalChannels[0].Attribute.Name);
 
 		switch (DMXChannelAttributeType) {
 
@@ -59,16 +59,14 @@ void FActorGeometryTree::CreateGeometryTree(ACPGDTFFixtureActor* Actor, FString
 	this->ParentActor = Actor;
 	this->NamePrefix = "";
 	FName RootGeometryName = this->ParentActor->GDTFDescription->GetDMXModes()->DMXModes[DMXModeIndex].Geometry;
-	UCPGDTFDescriptionGeometryBase* RootGeometry = nullptr;
 	TArray<UCPGDTFDescriptionGeometryBase*> TopLevelGeometries = this->GetGDTFTopLevelGeometries();
 
+	// Geometry references are resolved by name for each instance, the map avoids scanning the top level geometries every time
+	this->TopLevelGeometriesByName.Empty(TopLevelGeometries.Num());
 	for (UCPGDTFDescriptionGeometryBase* Geometry : TopLevelGeometries) {
-
-		if (Geometry->Name.ToString().Equals(RootGeometryName.ToString())) {
-			RootGeometry = Geometry;
-			break;
-		}
+		if (Geometry != nullptr && !this->TopLevelGeometriesByName.Contains(Geometry->Name)) this->TopLevelGeometriesByName.Add(Geometry->Name, Geometry);
 	}
+	UCPGDTFDescriptionGeometryBase* RootGeometry = this->FindTopLevelGeometry(RootGeometryName);
 
 	if (RootGeometry == nullptr) {
 		RootGeometry = TopLevelGeometries[0];
@@ -78,6 +76,7 @@ void FActorGeometryTree::CreateGeometryTree(ACPGDTFFixtureActor* Actor, FString
 
 	USceneComponent* TreeBranch = this->CreateTreeBranch(this->ParentActor->GetRootComponent(), RootGeometry, Cast<UCPGDTFDescriptionModels>(Actor->GDTFDescription->Models), FixturePackagePath);
 	TreeBranch->AttachToComponent(this->ParentActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	this->TopLevelGeometriesByName.Empty();
 }
 
 /**
@@ -176,6 +175,18 @@ TArray<UCPGDTFDescriptionGeometryBase*> FActorGeometryTree::GetGDTFTopLevelGeome
 	return Cast<UCPGDTFDescriptionGeometries>(this->ParentActor->GDTFDescription->Geometries)->Geometries;
 }
 
+/**
+ * Find a top level geometry by name in TopLevelGeometriesByName
+ *
+ * @param Name
+ * @return May be null if no top level geometry has this name
+ */
+UCPGDTFDescriptionGeometryBase* FActorGeometryTree::FindTopLevelGeometry(FName Name) const {
+
+	UCPGDTFDescriptionGeometryBase* const* Geometry = this->TopLevelGeometriesByName.Find(Name);
+	return Geometry != nullptr ? *Geometry : nullptr;
+}
+
 /**
  * Creates a branch of the tree (the given geometry and all his childrens)
  * @author Dorian Gardes - Clay Paky S.R.L.
@@ -228,16 +239,10 @@ USceneComponent* FActorGeometryTree::CreateTreeBranch(USceneComponent* Parent, U
 	if (Geometry->Type == ECPGDTFDescriptionGeometryType::GeometryReference) {
 		UCPGDTFDescriptionGeometryReference* GeometryReference = Cast<UCPGDTFDescriptionGeometryReference>(Geometry);
 		
-		UCPGDTFDescriptionGeometryBase* ReferencedGeometry = nullptr;
-		for (UCPGDTFDescriptionGeometryBase* TopLevelGeometry : this->GetGDTFTopLevelGeometries()) {
-
-			if (GeometryReference->Geometry.ToString().Equals(TopLevelGeometry->Name.ToString())) {
-				ReferencedGeometry = TopLevelGeometry;
-				break;
-			}
-		}
-		
-		if (ReferencedGeometry != nullptr) {
+		UCPGDTFDescriptionGeometryBase* ReferencedGeometry = this->FindTopLevelGeometry(GeometryReference->Geometry);
+		if (ReferencedGeometry == nullptr) {
+			UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Geometry reference '%s' points to the missing geometry '%s'"), *GeometryReference->Name.ToString(), *GeometryReference->Geometry.ToString());
+		} else {
 			for (FDMXImportGDTFBreak Break : GeometryReference->Breaks) {
 
 				this->NamePrefix = FString::FromInt(Break.DMXBreak).AppendChar('-').Append(FString::FromInt(Break.DMXOffset));
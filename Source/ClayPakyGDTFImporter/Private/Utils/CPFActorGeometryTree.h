@@ -42,6 +42,9 @@ private:
 	/// Prefix to make subgeometries unique using geometry references
 	FString NamePrefix = "";
 
+	/// Top level geometries of the description by name, built once per tree creation for the geometry references
+	TMap<FName, UCPGDTFDescriptionGeometryBase*> TopLevelGeometriesByName;
+
 public:
 
 	/// Equals to "CPSM_"
@@ -122,6 +125,14 @@ private:
 	*/
 	TArray<UCPGDTFDescriptionGeometryBase*> GetGDTFTopLevelGeometries();
 
+	/**
+	 * Find a top level geometry by name in TopLevelGeometriesByName
+	 *
+	 * @param Name
+	 * @return May be null if no top level geometry has this name
+	*/
+	UCPGDTFDescriptionGeometryBase* FindTopLevelGeometry(FName Name) const;
+
 	/**
 	 * Creates a branch of the tree (the given geometry and all his childrens)
 	 * @author Dorian Gardes - Clay Paky S.R.L.
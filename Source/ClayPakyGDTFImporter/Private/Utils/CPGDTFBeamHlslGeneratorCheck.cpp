@@ -0,0 +1,361 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFBeamHlslGeneratorCheck.h"
+#include "Factories/CPGDTFBeamHlslGenerator.h"
+#include "CPGDTFImporterUtils.h"
+#include "ClayPakyGDTFImporterLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Misc/App.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionConstant.h"
+#include "Materials/MaterialExpressionCustom.h"
+#include "Materials/MaterialExpressionTextureObject.h"
+#include "Engine/Texture2D.h"
+#include "Engine/Texture2DArray.h"
+#include "MaterialShared.h"
+#include "RHI.h"
+
+#define HLSL_CHECK_MAX_COLOR_WHEELS 3
+#define HLSL_CHECK_MAX_GOBO_WHEELS 3
+#define HLSL_CHECK_MAX_OTHER_WHEELS 1 // Animation, Prism and Effects
+#define HLSL_CHECK_BLADES 4 // Orientations 1..4, each one absent, in a+b mode or in a+rot mode
+#define HLSL_CHECK_PLACEHOLDER TEXT("/*__HLSL_")
+#define HLSL_CHECK_KERNEL_STRIDE 64 // Every kernel flags combination is checked on one descriptor every HLSL_CHECK_KERNEL_STRIDE
+#define HLSL_CHECK_KERNEL_COMBINATIONS (ECPGDTFBeamKernelFlags::FrostMipChain << 1)
+#define HLSL_CHECK_GOLDEN_STRIDE 61 // The hash of every descriptor is summed up in a single one, one descriptor every HLSL_CHECK_GOLDEN_STRIDE also has its own to locate the changes
+#define HLSL_CHECK_GOLDEN_ALL TEXT("All")
+#define HLSL_CHECK_CUSTOM_DESCR TEXT("__CUSTOM__RENDER_PIPELINE_BUILDER") // FIND_DESCR_CUSTOM of CPGDTFRenderPipelineBuilder
+
+namespace CPGDTFBeamHlslGeneratorCheck {
+
+	/// Every combination of wheels, iris and blades inside the HLSL_CHECK_* limits, in a stable order
+	static TArray<FCPGDTFBeamHlslDescriptor> EnumerateDescriptors() {
+		int32 BladesCombinations = 1;
+		for (int32 i = 0; i < HLSL_CHECK_BLADES; i++) BladesCombinations *= 3;
+
+		TArray<FCPGDTFBeamHlslDescriptor> Descriptors;
+		for (int32 Color = 0; Color <= HLSL_CHECK_MAX_COLOR_WHEELS; Color++)
+		for (int32 Gobo = 0; Gobo <= HLSL_CHECK_MAX_GOBO_WHEELS; Gobo++)
+		for (int32 Animation = 0; Animation <= HLSL_CHECK_MAX_OTHER_WHEELS; Animation++)
+		for (int32 Prism = 0; Prism <= HLSL_CHECK_MAX_OTHER_WHEELS; Prism++)
+		for (int32 Effects = 0; Effects <= HLSL_CHECK_MAX_OTHER_WHEELS; Effects++)
+		for (int32 Iris = 0; Iris <= 1; Iris++)
+		for (int32 Blades = 0; Blades < BladesCombinations; Blades++) {
+			FCPGDTFBeamHlslDescriptor Descriptor;
+			Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Color] = Color;
+			Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Gobo] = Gobo;
+			Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Animation] = Animation;
+			Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Prism] = Prism;
+			Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Effects] = Effects;
+			Descriptor.bIris = Iris == 1;
+			for (int32 Orientation = 1, Rest = Blades; Orientation <= HLSL_CHECK_BLADES; Orientation++, Rest /= 3) {
+				if (Rest % 3 == 1) Descriptor.Blades.Add(TPair<int, bool>(Orientation, true));
+				else if (Rest % 3 == 2) Descriptor.Blades.Add(TPair<int, bool>(Orientation, false));
+			}
+			Descriptors.Add(Descriptor);
+		}
+		return Descriptors;
+	}
+
+	/// The descriptors of EnumerateDescriptors (without kernel flags) followed by a subset of them with every kernel flags combination
+	static TArray<FCPGDTFBeamHlslDescriptor> EnumerateKernelDescriptors(const TArray<FCPGDTFBeamHlslDescriptor>& BaseDescriptors) {
+		TArray<FCPGDTFBeamHlslDescriptor> Descriptors;
+		for (int32 i = 0; i < BaseDescriptors.Num(); i += HLSL_CHECK_KERNEL_STRIDE) {
+			for (int32 Flags = 1; Flags < HLSL_CHECK_KERNEL_COMBINATIONS; Flags++) {
+				FCPGDTFBeamHlslDescriptor Descriptor = BaseDescriptors[i];
+				Descriptor.KernelFlags = (uint8)Flags;
+				Descriptors.Add(Descriptor);
+			}
+		}
+		return Descriptors;
+	}
+
+	/// One color wheel, one gobo wheel, the iris and a blade per mode: every function of the generated code is used
+	static FCPGDTFBeamHlslDescriptor GetCompileDescriptor(uint8 KernelFlags) {
+		FCPGDTFBeamHlslDescriptor Descriptor;
+		Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Color] = 1;
+		Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Gobo] = 1;
+		Descriptor.bIris = true;
+		Descriptor.Blades.Add(TPair<int, bool>(1, true));
+		Descriptor.Blades.Add(TPair<int, bool>(2, false));
+		Descriptor.KernelFlags = KernelFlags;
+		return Descriptor;
+	}
+
+	static void AddCustomInput(UMaterial* Material, UMaterialExpressionCustom* Custom, const FString& InputName, UMaterialExpression* Expression) {
+		Material->GetEditorOnlyData()->ExpressionCollection.AddExpression(Expression);
+		FCustomInput Input;
+		Input.InputName = FName(*InputName);
+		Input.Input.Connect(0, Expression);
+		Custom->Inputs.Add(Input);
+	}
+
+	static void AddScalarInput(UMaterial* Material, UMaterialExpressionCustom* Custom, const FString& InputName) {
+		AddCustomInput(Material, Custom, InputName, NewObject<UMaterialExpressionConstant>(Material));
+	}
+
+	static void AddTextureInput(UMaterial* Material, UMaterialExpressionCustom* Custom, const FString& InputName, UTexture* Texture) {
+		UMaterialExpressionTextureObject* TextureObject = NewObject<UMaterialExpressionTextureObject>(Material);
+		TextureObject->Texture = Texture;
+		TextureObject->AutoSetSampleType();
+		AddCustomInput(Material, Custom, InputName, TextureObject);
+	}
+
+	/**
+	 * Compiles the generated code of a descriptor inside a copy of M_Beam_Master, with the same inputs CPGDTFRenderPipelineBuilder::buildBeamPipeline adds
+	 *
+	 * @param Descriptor Features of the pipeline
+	 * @param Master Beam master material
+	 * @param Texture Disk texture used for the wheels
+	 * @param TextureArray Disk texture array used for the wheels with ECPGDTFBeamKernelFlags::WheelTextureArrays
+	 * @return True if the material compiled without errors
+	 */
+	static bool CompileDescriptor(const FCPGDTFBeamHlslDescriptor& Descriptor, UMaterial* Master, UTexture* Texture, UTexture* TextureArray) {
+		UMaterial* Material = DuplicateObject<UMaterial>(Master, GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UMaterial::StaticClass(), TEXT("M_HlslCheck")));
+		UMaterialExpressionCustom* Custom = nullptr;
+		for (UMaterialExpression* Expression : Material->GetEditorOnlyData()->ExpressionCollection.Expressions) {
+			Custom = Cast<UMaterialExpressionCustom>(Expression);
+			if (Custom && Custom->Desc.Contains(HLSL_CHECK_CUSTOM_DESCR)) break;
+			Custom = nullptr;
+		}
+		if (Custom == nullptr) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl compile check: custom expression not found in '%s'"), *Master->GetPathName());
+			return false;
+		}
+
+		Material->PreEditChange(nullptr);
+		Custom->Code = CPGDTFBeamHlslGenerator::generateCodeUncached(Descriptor);
+		AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputFrostName());
+		if (Descriptor.bIris) AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputIrisName());
+		const bool bWheelTextureArrays = (Descriptor.KernelFlags & ECPGDTFBeamKernelFlags::WheelTextureArrays) != 0;
+		const bool bFrostMipChain = (Descriptor.KernelFlags & ECPGDTFBeamKernelFlags::FrostMipChain) != 0;
+		for (FCPGDTFWheelImporter::WheelType WheelType : { FCPGDTFWheelImporter::WheelType::Color, FCPGDTFWheelImporter::WheelType::Gobo }) {
+			for (int32 i = 0; i < Descriptor.WheelsNo[WheelType]; i++) {
+				AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputNumSlotsName(WheelType, i));
+				AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputIndexName(WheelType, i));
+				const bool bFrosted = WheelType == FCPGDTFWheelImporter::WheelType::Gobo && !bFrostMipChain;
+				AddTextureInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputTextureName(WheelType, bFrosted, i), bWheelTextureArrays ? TextureArray : Texture);
+			}
+		}
+		for (const TPair<int, bool>& Blade : Descriptor.Blades) {
+			AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputBladeABRotName(true, Blade.Key));
+			AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputBladeABRotName(false, Blade.Key));
+			AddScalarInput(Material, Custom, CPGDTFRenderPipelineBuilder::getInputBladeOrientationName(Blade.Key));
+		}
+		Material->PostEditChange();
+
+		FMaterialResource* Resource = Material->GetMaterialResource(GMaxRHIFeatureLevel);
+		if (Resource == nullptr) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl compile check: %s has no material resource"), *Descriptor.ToString());
+			return false;
+		}
+		Resource->FinishCompilation();
+		for (const FString& Error : Resource->GetCompileErrors()) UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl compile check: %s: %s"), *Descriptor.ToString(), *Error);
+		return Resource->GetCompileErrors().Num() == 0;
+	}
+
+	/// Permutations we expect at most: only color/gobo wheels, iris and blades change the code. Animation, Prism and Effects are not implemented yet
+	static int32 GetMaxPermutations() {
+		int32 BladesCombinations = 1;
+		for (int32 i = 0; i < HLSL_CHECK_BLADES; i++) BladesCombinations *= 3;
+		return (HLSL_CHECK_MAX_COLOR_WHEELS + 1) * (HLSL_CHECK_MAX_GOBO_WHEELS + 1) * 2 * BladesCombinations;
+	}
+
+	/// Permutations we expect at most from the kernel descriptors: each base permutation they sample (same features as GetMaxPermutations()) times each non empty kernel flags combination
+	static int32 GetMaxKernelPermutations(const TArray<FCPGDTFBeamHlslDescriptor>& KernelDescriptors) {
+		TSet<FString> BasePermutations;
+		for (const FCPGDTFBeamHlslDescriptor& Descriptor : KernelDescriptors) {
+			FString Key = FString::Printf(TEXT("%d|%d|%d"), Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Color], Descriptor.WheelsNo[FCPGDTFWheelImporter::WheelType::Gobo], Descriptor.bIris ? 1 : 0);
+			for (const TPair<int, bool>& Blade : Descriptor.Blades) Key += FString::Printf(TEXT("|%d%c"), Blade.Key, Blade.Value ? TEXT('a') : TEXT('r'));
+			BasePermutations.Add(Key);
+		}
+		return BasePermutations.Num() * (HLSL_CHECK_KERNEL_COMBINATIONS - 1);
+	}
+}
+
+FString FCPGDTFBeamHlslGeneratorCheck::GetGoldenFile() {
+	return FPaths::Combine(FCPGDTFImporterUtils::GetTestsDirectory(), TEXT("HlslGolden.csv"));
+}
+
+bool FCPGDTFBeamHlslGeneratorCheck::RunCompileCheck() {
+	using namespace CPGDTFBeamHlslGeneratorCheck;
+
+	const FString ContentPath = FCPGDTFImporterUtils::CLAYPAKY_PLUGIN_CONTENT_BASEPATH;
+	UMaterial* Master = Cast<UMaterial>(FCPGDTFImporterUtils::LoadObjectByPath(ContentPath + TEXT("MaterialInstances/Master/M_Beam_Master.M_Beam_Master")));
+	UTexture2D* Texture = Cast<UTexture2D>(FCPGDTFImporterUtils::LoadObjectByPath(ContentPath + TEXT("MaterialInstances/Textures/T_Circle_01.T_Circle_01")));
+	if (Master == nullptr || Texture == nullptr) {
+		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl compile check: unable to load M_Beam_Master or T_Circle_01"));
+		return false;
+	}
+	UTexture2DArray* TextureArray = NewObject<UTexture2DArray>(GetTransientPackage());
+	TextureArray->SourceTextures.Add(Texture);
+	TextureArray->SRGB = Texture->SRGB;
+	TextureArray->UpdateSourceFromSourceTextures(true);
+	TextureArray->UpdateResource();
+
+	// No option, every option alone and all of them together
+	TArray<uint8> KernelFlags = { ECPGDTFBeamKernelFlags::None };
+	for (int32 Flag = 1; Flag < HLSL_CHECK_KERNEL_COMBINATIONS; Flag <<= 1) KernelFlags.Add((uint8)Flag);
+	KernelFlags.Add((uint8)(HLSL_CHECK_KERNEL_COMBINATIONS - 1));
+
+	bool bSuccess = true;
+	for (uint8 Flags : KernelFlags) bSuccess &= CompileDescriptor(GetCompileDescriptor(Flags), Master, Texture, TextureArray);
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("Hlsl compile check: %d materials compiled"), KernelFlags.Num());
+	return bSuccess;
+}
+
+bool FCPGDTFBeamHlslGeneratorCheck::RunCheck(bool bRecord) {
+	using namespace CPGDTFBeamHlslGeneratorCheck;
+
+	TArray<FCPGDTFBeamHlslDescriptor> Descriptors = EnumerateDescriptors();
+	const TArray<FCPGDTFBeamHlslDescriptor> KernelDescriptors = EnumerateKernelDescriptors(Descriptors);
+	Descriptors.Append(KernelDescriptors);
+	bool bSuccess = true;
+
+	TMap<FString, FString> Golden; // Descriptor -> MD5 of its code
+	if (!bRecord) {
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *GetGoldenFile())) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: unable to read the golden hashes '%s'"), *GetGoldenFile());
+			bSuccess = false;
+		}
+		for (const FString& Line : Lines) {
+			FString Key, Hash;
+			if (Line.Split(TEXT(";"), &Key, &Hash)) Golden.Add(Key, Hash);
+		}
+	}
+
+	FString Content;
+	FString AllHashes;
+	TSet<FString> UniqueCodes;
+	int32 GoldenChecked = 0, GoldenMismatches = 0;
+	for (int32 i = 0; i < Descriptors.Num(); i++) {
+		const FString Key = Descriptors[i].ToString();
+		const FString Code = CPGDTFBeamHlslGenerator::generateCodeUncached(Descriptors[i]);
+		if (Code.Contains(HLSL_CHECK_PLACEHOLDER)) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: %s still contains a placeholder"), *Key);
+			bSuccess = false;
+		}
+
+		const FString Hash = FMD5::HashAnsiString(*Code);
+		UniqueCodes.Add(Hash);
+		AllHashes += Hash;
+		if (i % HLSL_CHECK_GOLDEN_STRIDE != 0) continue;
+		if (bRecord) Content += Key + TEXT(";") + Hash + TEXT("\n");
+		else if (const FString* Expected = Golden.Find(Key)) {
+			GoldenChecked++;
+			if (!Expected->Equals(Hash) && GoldenMismatches++ < 10) UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: %s changed (got %s, expected %s)"), *Key, *Hash, **Expected);
+		}
+	}
+
+	const FString AllHash = FMD5::HashAnsiString(*AllHashes);
+	if (bRecord) Content = FString(HLSL_CHECK_GOLDEN_ALL) + TEXT(";") + AllHash + TEXT("\n") + Content;
+	else if (Golden.Num() > 0) {
+		const FString* ExpectedAll = Golden.Find(HLSL_CHECK_GOLDEN_ALL);
+		if (ExpectedAll == nullptr || !ExpectedAll->Equals(AllHash)) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: the generated code changed (got %s, expected %s)"), *AllHash, ExpectedAll ? **ExpectedAll : TEXT("nothing"));
+			bSuccess = false;
+		}
+		if (GoldenChecked != Golden.Num() - 1) { // The descriptors enumerated by the check changed, the golden file is out of date
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: %d of the %d golden descriptors have been generated"), GoldenChecked, Golden.Num() - 1);
+			bSuccess = false;
+		}
+	}
+	if (GoldenMismatches > 0) {
+		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: %d descriptors don't match their golden hash"), GoldenMismatches);
+		bSuccess = false;
+	}
+
+	// The memoized path has to return the same bytes and add just one variant
+	const FCPGDTFBeamHlslDescriptor& Last = Descriptors.Last();
+	const int32 CachedBefore = CPGDTFBeamHlslGenerator::getCachedVariantsNum();
+	const FString Cached = CPGDTFBeamHlslGenerator::generateCode(Last);
+	if (!Cached.Equals(CPGDTFBeamHlslGenerator::generateCode(Last), ESearchCase::CaseSensitive) || !Cached.Equals(CPGDTFBeamHlslGenerator::generateCodeUncached(Last), ESearchCase::CaseSensitive)
+		|| CPGDTFBeamHlslGenerator::getCachedVariantsNum() > CachedBefore + 1) {
+		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: the cached code of %s differs from the generated one"), *Last.ToString());
+		bSuccess = false;
+	}
+
+	const int32 MaxPermutations = GetMaxPermutations() + GetMaxKernelPermutations(KernelDescriptors);
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("Hlsl check: %d descriptors, %d unique codes (bound %d), %d variants generated by the imports so far"), Descriptors.Num(), UniqueCodes.Num(), MaxPermutations, CPGDTFBeamHlslGenerator::getCachedVariantsNum());
+	if (UniqueCodes.Num() > MaxPermutations) {
+		UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: %d unique codes exceed the bound of %d permutations"), UniqueCodes.Num(), MaxPermutations);
+		bSuccess = false;
+	}
+
+	if (bRecord) {
+		if (!FFileHelper::SaveStringToFile(Content, *GetGoldenFile())) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Hlsl check: unable to write '%s'"), *GetGoldenFile());
+			bSuccess = false;
+		} else UE_LOG_CPGDTFIMPORTER(Display, TEXT("Hlsl check: recorded %d golden hashes"), Descriptors.Num());
+	}
+	return bSuccess;
+}
+
+static FAutoConsoleCommand CPGDTFHlslCheckCommand(
+	TEXT("CPGDTF.Hlsl.Check"),
+	TEXT("Checks that the beam HLSL generator matches the golden hashes committed with the plugin and keeps its permutations bounded. Pass 'record' to (re)write the golden hashes, 'compile' to compile the generated code in the beam material"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		const bool bRecord = Args.Num() > 0 && Args[0].Equals(TEXT("record"), ESearchCase::IgnoreCase);
+		const bool bCompile = Args.Num() > 0 && Args[0].Equals(TEXT("compile"), ESearchCase::IgnoreCase);
+		const bool bSuccess = bCompile ? FCPGDTFBeamHlslGeneratorCheck::RunCompileCheck() : FCPGDTFBeamHlslGeneratorCheck::RunCheck(bRecord);
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Hlsl check: %s"), bSuccess ? TEXT("OK") : TEXT("FAILED"));
+	})
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCPGDTFBeamHlslGeneratorTest, "ClayPaky.GDTF.Beam.HlslGenerator", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCPGDTFBeamHlslGeneratorTest::RunTest(const FString& Parameters) {
+	return FCPGDTFBeamHlslGeneratorCheck::RunCheck(false);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCPGDTFBeamHlslCompileTest, "ClayPaky.GDTF.Beam.HlslCompile", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCPGDTFBeamHlslCompileTest::RunTest(const FString& Parameters) {
+	if (!FApp::CanEverRender()) {
+		AddInfo(TEXT("Shaders can't be compiled without a RHI, skipped"));
+		return true;
+	}
+	return FCPGDTFBeamHlslGeneratorCheck::RunCompileCheck();
+}
+
+#endif
+
+#undef HLSL_CHECK_MAX_COLOR_WHEELS
+#undef HLSL_CHECK_MAX_GOBO_WHEELS
+#undef HLSL_CHECK_MAX_OTHER_WHEELS
+#undef HLSL_CHECK_BLADES
+#undef HLSL_CHECK_PLACEHOLDER
+#undef HLSL_CHECK_KERNEL_STRIDE
+#undef HLSL_CHECK_KERNEL_COMBINATIONS
+#undef HLSL_CHECK_GOLDEN_STRIDE
+#undef HLSL_CHECK_GOLDEN_ALL
+#undef HLSL_CHECK_CUSTOM_DESCR
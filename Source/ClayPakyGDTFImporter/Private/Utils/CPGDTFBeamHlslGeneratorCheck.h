@@ -0,0 +1,57 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Deterministic checks of CPGDTFBeamHlslGenerator. <br>
+ * The generator is a pure function of FCPGDTFBeamHlslDescriptor, so everything runs without a world or a material and can be launched
+ * from a headless editor (-nullrhi) with the CPGDTF.Hlsl.Check console command or as the ClayPaky.GDTF.Beam.HlslGenerator automation test
+ */
+class FCPGDTFBeamHlslGeneratorCheck {
+
+public:
+
+	/**
+	 * Enumerates every descriptor combination (and every kernel option on a subset of them), checks that the generated code matches the golden hashes committed with the plugin
+	 * and that the number of different generated codes (so of shader permutations) stays under the expected bound
+	 *
+	 * @param bRecord If true the golden hashes are (re)written instead of being checked
+	 * @return True if every check passed (or the golden hashes have been recorded)
+	 */
+	static bool RunCheck(bool bRecord);
+
+	/**
+	 * Compiles the generated code of one descriptor per kernel option (none, each one alone, all together) inside a copy of M_Beam_Master. <br>
+	 * Unlike RunCheck it needs the shader compiler, so it's run by the CPGDTF.Hlsl.Check compile console command or the ClayPaky.GDTF.Beam.HlslCompile automation test (skipped with -nullrhi)
+	 *
+	 * @return True if every material compiled without errors
+	 */
+	static bool RunCompileCheck();
+
+	/// File where the golden hashes of the generated code are stored (Resources/Tests/HlslGolden.csv inside the plugin)
+	static FString GetGoldenFile();
+};
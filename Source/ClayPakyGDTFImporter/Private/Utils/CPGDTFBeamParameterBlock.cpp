@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utils/CPGDTFBeamParameterBlock.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+uint64 FCPGDTFBeamParameterBlock::TotalMaterialWrites = 0;
+
+void FCPGDTFBeamParameterBlock::Bind(UMaterialInstanceDynamic* const (&NewSlots)[SLOTS_NUM]) {
+	if (FMemory::Memcmp(this->Slots, NewSlots, sizeof(this->Slots)) == 0) return;
+	FMemory::Memcpy(this->Slots, NewSlots, sizeof(this->Slots));
+
+	// The same material instance may be used by more slots, we write it only once
+	this->Materials.Reset();
+	this->MaterialsSlotsMask.Reset();
+	for (int32 Slot = 0; Slot < SLOTS_NUM; Slot++) {
+		if (this->Slots[Slot] == nullptr) continue;
+		const int32 Index = this->Materials.AddUnique(this->Slots[Slot]);
+		if (Index == this->MaterialsSlotsMask.Num()) this->MaterialsSlotsMask.Add(0);
+		this->MaterialsSlotsMask[Index] |= 1 << Slot;
+	}
+
+	// New materials, the cached indices aren't valid anymore
+	for (int32 i = 0; i < this->Parameters.Num(); i++) {
+		FParameter& Parameter = this->Parameters[i];
+		for (int32& MaterialIndex : Parameter.MaterialIndices) MaterialIndex = INDEX_NONE;
+		if (Parameter.bHasValue) this->MarkDirty(i);
+	}
+}
+
+FCPGDTFBeamParameterBlock::FParameter& FCPGDTFBeamParameterBlock::FindOrAddParameter(const FName& Name, EParameterType Type, uint32 SlotsMask) {
+	const TPair<FName, EParameterType> Key(Name, Type);
+	if (int32* Index = this->ParametersLookup.Find(Key)) {
+		FParameter& Parameter = this->Parameters[*Index];
+		if ((Parameter.SlotsMask & SlotsMask) != SlotsMask) { // Written to new slots, we have to write it there too
+			Parameter.SlotsMask |= SlotsMask;
+			if (Parameter.bHasValue) this->MarkDirty(*Index);
+		}
+		return Parameter;
+	}
+
+	const int32 Index = this->Parameters.AddDefaulted();
+	FParameter& Parameter = this->Parameters[Index];
+	Parameter.Name = Name;
+	Parameter.Type = Type;
+	Parameter.SlotsMask = SlotsMask;
+	for (int32& MaterialIndex : Parameter.MaterialIndices) MaterialIndex = INDEX_NONE;
+	this->ParametersLookup.Add(Key, Index);
+	return Parameter;
+}
+
+void FCPGDTFBeamParameterBlock::MarkDirty(int32 ParameterIndex) {
+	FParameter& Parameter = this->Parameters[ParameterIndex];
+	if (Parameter.bDirty) return;
+	Parameter.bDirty = true;
+	this->DirtyParameters.Add(ParameterIndex);
+}
+
+void FCPGDTFBeamParameterBlock::SetScalar(const FName& Name, float Value, uint32 SlotsMask) {
+	FParameter& Parameter = this->FindOrAddParameter(Name, EParameterType::Scalar, SlotsMask);
+	if (Parameter.bHasValue && Parameter.Scalar == Value) return;
+	Parameter.Scalar = Value;
+	Parameter.bHasValue = true;
+	this->MarkDirty(&Parameter - this->Parameters.GetData());
+}
+
+void FCPGDTFBeamParameterBlock::SetVector(const FName& Name, const FLinearColor& Value, uint32 SlotsMask) {
+	FParameter& Parameter = this->FindOrAddParameter(Name, EParameterType::Vector, SlotsMask);
+	if (Parameter.bHasValue && Parameter.Vector == Value) return;
+	Parameter.Vector = Value;
+	Parameter.bHasValue = true;
+	this->MarkDirty(&Parameter - this->Parameters.GetData());
+}
+
+void FCPGDTFBeamParameterBlock::SetTexture(const FName& Name, UTexture* Value, uint32 SlotsMask) {
+	FParameter& Parameter = this->FindOrAddParameter(Name, EParameterType::Texture, SlotsMask);
+	if (Parameter.bHasValue && Parameter.Texture == Value) return;
+	Parameter.Texture = Value;
+	Parameter.bHasValue = true;
+	this->MarkDirty(&Parameter - this->Parameters.GetData());
+}
+
+void FCPGDTFBeamParameterBlock::AddReferencedObjects(FReferenceCollector& Collector) {
+	for (FParameter& Parameter : this->Parameters) {
+		if (Parameter.Type == EParameterType::Texture) Collector.AddReferencedObject(Parameter.Texture);
+	}
+}
+
+bool FCPGDTFBeamParameterBlock::GetScalar(const FName& Name, float& OutValue) const {
+	const int32* Index = this->ParametersLookup.Find(TPair<FName, EParameterType>(Name, EParameterType::Scalar));
+	if (Index == nullptr || !this->Parameters[*Index].bHasValue) return false;
+	OutValue = this->Parameters[*Index].Scalar;
+	return true;
+}
+
+void FCPGDTFBeamParameterBlock::Flush() {
+	for (int32 ParameterIndex : this->DirtyParameters) {
+		FParameter& Parameter = this->Parameters[ParameterIndex];
+		Parameter.bDirty = false;
+
+		for (int32 m = 0; m < this->Materials.Num(); m++) {
+			if ((this->MaterialsSlotsMask[m] & Parameter.SlotsMask) == 0) continue;
+			UMaterialInstanceDynamic* Material = this->Materials[m];
+			int32& MaterialIndex = Parameter.MaterialIndices[m];
+			TotalMaterialWrites++;
+
+			switch (Parameter.Type) {
+			case EParameterType::Scalar:
+				// The first write resolves the index, the next ones skip the search by name
+				if (MaterialIndex == INDEX_NONE || !Material->SetScalarParameterByIndex(MaterialIndex, Parameter.Scalar))
+					Material->InitializeScalarParameterAndGetIndex(Parameter.Name, Parameter.Scalar, MaterialIndex);
+				break;
+			case EParameterType::Vector:
+				if (MaterialIndex == INDEX_NONE || !Material->SetVectorParameterByIndex(MaterialIndex, Parameter.Vector))
+					Material->InitializeVectorParameterAndGetIndex(Parameter.Name, Parameter.Vector, MaterialIndex);
+				break;
+			case EParameterType::Texture:
+				// There are no indexed setters for textures, but they're usually set only once
+				Material->SetTextureParameterValue(Parameter.Name, Parameter.Texture);
+				break;
+			}
+		}
+	}
+	this->DirtyParameters.Reset();
+}
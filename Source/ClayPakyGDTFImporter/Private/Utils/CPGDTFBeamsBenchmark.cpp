@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFBeamsBenchmark.h"
+#include "CPGDTFFixtureActor.h"
+#include "Utils/CPGDTFBeamParameterBlock.h"
+#include "ClayPakyGDTFImporterLog.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+
+#define BEAMS_BENCHMARK_DEFAULT_FRAMES 300
+
+namespace CPGDTFBeamsBenchmark {
+	static TWeakObjectPtr<UWorld> World;
+	static FDelegateHandle EndFrameHandle;
+	static int32 Frames = 0;
+	/// Frames still to be measured
+	static int32 FramesLeft = 0;
+	static uint64 StartMaterialWrites = 0;
+	static double StartSeconds = 0;
+}
+
+void FCPGDTFBeamsBenchmark::Start(UWorld* World, int32 Frames) {
+	using namespace CPGDTFBeamsBenchmark;
+
+	if (!EndFrameHandle.IsValid()) EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FCPGDTFBeamsBenchmark::OnEndFrame);
+	CPGDTFBeamsBenchmark::World = World;
+	CPGDTFBeamsBenchmark::Frames = FMath::Max(Frames, 1);
+	FramesLeft = CPGDTFBeamsBenchmark::Frames;
+	StartMaterialWrites = FCPGDTFBeamParameterBlock::GetTotalMaterialWrites();
+	StartSeconds = FPlatformTime::Seconds();
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("Beams benchmark: measuring %d frames"), CPGDTFBeamsBenchmark::Frames);
+}
+
+void FCPGDTFBeamsBenchmark::OnEndFrame() {
+	using namespace CPGDTFBeamsBenchmark;
+
+	if (--FramesLeft > 0) return;
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+
+	UWorld* BenchmarkWorld = World.Get();
+	if (BenchmarkWorld == nullptr) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Beams benchmark: the world has been destroyed during the measure"));
+		return;
+	}
+
+	int32 FixturesNum = 0, LightsNum = 0;
+	for (TActorIterator<ACPGDTFFixtureActor> It(BenchmarkWorld); It; ++It) {
+		FixturesNum++;
+		LightsNum += It->GetActiveLightsNum();
+	}
+	const uint64 MaterialWrites = FCPGDTFBeamParameterBlock::GetTotalMaterialWrites() - StartMaterialWrites;
+	const double Seconds = FPlatformTime::Seconds() - StartSeconds;
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("Beams benchmark: %d fixtures, %d lights in the scene, %.1f material parameter writes/frame, %.3f ms/frame"),
+		FixturesNum, LightsNum, (double)MaterialWrites / Frames, Seconds * 1000.0 / Frames);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CPGDTFBeamsBenchmarkCommand(
+	TEXT("CPGDTF.Beams.Benchmark"),
+	TEXT("Counts the lights in the scene, the material parameter writes and the frame time of the fixtures of the world. Optional argument: number of frames (default 300)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World) {
+		if (World == nullptr) {
+			UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Beams benchmark: no world"));
+			return;
+		}
+		FCPGDTFBeamsBenchmark::Start(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : BEAMS_BENCHMARK_DEFAULT_FRAMES);
+	})
+);
+
+#undef BEAMS_BENCHMARK_DEFAULT_FRAMES
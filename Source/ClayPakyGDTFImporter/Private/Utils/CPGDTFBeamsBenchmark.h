@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Measures the cost of the beams of a running world, to compare the ECPGDTFBeamLightMode of the fixtures. <br>
+ * Launched with the CPGDTF.Beams.Benchmark console command: it samples the next frames and then logs the lights added to the scene by the fixtures,
+ * the material parameter writes per frame and the game thread frame time
+ */
+class FCPGDTFBeamsBenchmark {
+
+public:
+
+	/**
+	 * Starts measuring the next frames of a world. A benchmark already running is restarted
+	 *
+	 * @param World World whose fixtures are counted
+	 * @param Frames Number of frames to measure
+	 */
+	static void Start(UWorld* World, int32 Frames);
+
+private:
+
+	/// Called at the end of each frame while a benchmark is running
+	static void OnEndFrame();
+};
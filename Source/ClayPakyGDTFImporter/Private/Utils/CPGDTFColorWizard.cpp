@@ -25,6 +25,28 @@ SOFTWARE.
 #include "Utils/CPGDTFColorWizard.h"
 #include "Kismet/KismetMathLibrary.h"
 
+namespace CPGDTFColorWizard {
+
+	/// Piecewise gaussian, different widths on each side of the center
+	FORCEINLINE float PiecewiseGaussian(float X, float Center, float WidthBelow, float WidthAbove) {
+		const float T = (X - Center) / (X < Center ? WidthBelow : WidthAbove);
+		return FMath::Exp(-0.5f * T * T);
+	}
+
+	/**
+	 * CIE 1931 2° color matching functions at a wavelength. <br>
+	 * Multi-lobe fit of Wyman, Sloan and Shirley (Simple Analytic Approximations to the CIE XYZ Color Matching Functions, 2013):
+	 * within the accuracy of the measurements and no table to ship
+	 */
+	FORCEINLINE FVector3f ColorMatchingFunctions(float WaveLength) {
+		return FVector3f(
+			1.056f * PiecewiseGaussian(WaveLength, 599.8f, 37.9f, 31.0f) + 0.362f * PiecewiseGaussian(WaveLength, 442.0f, 16.0f, 26.7f) - 0.065f * PiecewiseGaussian(WaveLength, 501.1f, 20.4f, 26.2f),
+			0.821f * PiecewiseGaussian(WaveLength, 568.8f, 46.9f, 40.5f) + 0.286f * PiecewiseGaussian(WaveLength, 530.9f, 16.3f, 31.1f),
+			1.217f * PiecewiseGaussian(WaveLength, 437.0f, 11.8f, 36.0f) + 0.681f * PiecewiseGaussian(WaveLength, 459.0f, 26.0f, 13.8f)
+		);
+	}
+}
+
 /**
  * Blend the internal color with the given one
  * @author Dorian Gardes - Clay Paky S.R.L.
@@ -57,6 +79,29 @@ void FCPColorWizard::BlendColor(FLinearColor BlendingColor, float Intensity) {
 	*/
 }
 
+/**
+ * Add the light of an emitter. Unlike the Blend methods the emitters are mixed linearly in the CIE XYZ space, like real LEDs
+ *
+ * @param XYZ CIE XYZ of the emitter at full power, see FCPGDTFEmitterSpectrum
+ * @param Intensity Must be in range [0;1]
+ */
+void FCPColorWizard::AddEmitter(const FVector3f& XYZ, float Intensity) {
+	this->EmittersXYZ += XYZ * FMath::Clamp(Intensity, 0.0f, 1.0f);
+}
+
+/**
+ * Linear RGB color of the emitters added with AddEmitter()
+ *
+ * @param Normalization Divides the color, usually the maximum component of the color of all the emitters at full power
+ * @return Color clamped in range [0;1]
+ */
+FLinearColor FCPColorWizard::GetEmittersColor(float Normalization) const {
+
+	if (Normalization <= 0) return FLinearColor(0, 0, 0, 1);
+	const FLinearColor RGB = ColorXYZToLinearRGB(this->EmittersXYZ / Normalization);
+	return FLinearColor(FMath::Clamp(RGB.R, 0.0f, 1.0f), FMath::Clamp(RGB.G, 0.0f, 1.0f), FMath::Clamp(RGB.B, 0.0f, 1.0f), 1.0f);
+}
+
 void FCPColorWizard::BlendRed(float Intensity) {
 	this->BlendColor(FLinearColor(1, 0, 0), Intensity);
 }
@@ -225,4 +270,46 @@ FDMXColorCIE FCPColorWizard::ColorRGBToCIE(FLinearColor RGB) {
 	CIE.YY = Y;
 
 	return CIE;
-}
\ No newline at end of file
+}
+
+/**
+ * Convert a CIE XYZ color to linear sRGB, without gamma nor clamping
+ *
+ * @param XYZ Color to convert
+ * @return Conversion result, components may be negative or above 1 out of the sRGB gamut
+ */
+FLinearColor FCPColorWizard::ColorXYZToLinearRGB(const FVector3f& XYZ) {
+
+	// Same matrix as ColorCIEToRGB, without the gamma: the lights want linear colors
+	return FLinearColor(
+		(XYZ.X *  3.2406f) + (XYZ.Y * -1.5372f) + (XYZ.Z * -0.4986f),
+		(XYZ.X * -0.9689f) + (XYZ.Y *  1.8758f) + (XYZ.Z *  0.0415f),
+		(XYZ.X *  0.0557f) + (XYZ.Y * -0.2040f) + (XYZ.Z *  1.0570f),
+		1.0f
+	);
+}
+
+/**
+ * Integrate a spectrum with the CIE 1931 2° color matching functions
+ *
+ * @param WaveLengths In nanometers, in increasing order
+ * @param Energies Spectral energy at each wavelength
+ * @return CIE XYZ of the spectrum
+ */
+FVector3f FCPColorWizard::SpectrumToXYZ(TArrayView<const float> WaveLengths, TArrayView<const float> Energies) {
+	using namespace CPGDTFColorWizard;
+
+	const int32 PointsNo = FMath::Min(WaveLengths.Num(), Energies.Num());
+	if (PointsNo == 0) return FVector3f::ZeroVector;
+	if (PointsNo == 1) return ColorMatchingFunctions(WaveLengths[0]) * Energies[0]; // Monochromatic emitter
+
+	// Trapezoidal integration on the measured points
+	FVector3f XYZ = FVector3f::ZeroVector;
+	FVector3f Previous = ColorMatchingFunctions(WaveLengths[0]) * Energies[0];
+	for (int32 i = 1; i < PointsNo; i++) {
+		const FVector3f Current = ColorMatchingFunctions(WaveLengths[i]) * Energies[i];
+		XYZ += (Previous + Current) * (0.5f * FMath::Abs(WaveLengths[i] - WaveLengths[i - 1]));
+		Previous = Current;
+	}
+	return XYZ;
+}
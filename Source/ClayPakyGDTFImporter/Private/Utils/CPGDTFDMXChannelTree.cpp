@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "CPGDTFDMXChannelTree.h"
+#include "Algo/BinarySearch.h"
 /*************************************************************/
 
 bool FDMXChannelSetTreeNode::IsValueInRange(int32 DMXValue) {
@@ -94,15 +95,18 @@ void FDMXLogicalChannelTree::Insert(FCPGDTFDescriptionChannelSet& Item) {
 }
 
 FCPGDTFDescriptionChannelSet* FDMXLogicalChannelTree::GetChannelSetByDMXValue(int32 DMXValue) {
-    if (this->IsEmpty()) return nullptr;
-    FDMXChannelSetTreeNode* CurrentNode = &elements[this->Root];
+    return this->GetChannelSetByIndex(this->GetChannelSetIndexByDMXValue(DMXValue));
+}
+
+int32 FDMXLogicalChannelTree::GetChannelSetIndexByDMXValue(int32 DMXValue) {
+    if (this->IsEmpty()) return INDEX_NONE;
+    int32 CurrentIndex = this->Root;
 
-    while (!CurrentNode->IsValueInRange(DMXValue)) {
-        int32 index = *CurrentNode < DMXValue ? CurrentNode->Right : CurrentNode->Left;
-        if (index < 0) return nullptr;
-        CurrentNode = &elements[index];
+    while (!elements[CurrentIndex].IsValueInRange(DMXValue)) {
+        CurrentIndex = elements[CurrentIndex] < DMXValue ? elements[CurrentIndex].Right : elements[CurrentIndex].Left;
+        if (CurrentIndex < 0) return INDEX_NONE;
     }
-    return &CurrentNode->ChannelSet;
+    return CurrentIndex;
 }
 
 /*************************************************************/
@@ -167,6 +171,8 @@ void FDMXChannelTree::Insert(FCPGDTFDescriptionChannelFunction& Item) {
     NewElement.ChannelSetsTree.Insert(Item);
 
 
+    this->bIsCompiled = false; // The lookup table is no longer valid
+
     if (this->IsEmpty()) Root = elements.Add(NewElement);
     else {
         int32 elementId = elements.Add(NewElement);
@@ -182,19 +188,131 @@ void FDMXChannelTree::Insert(FCPGDTFDescriptionChannelFunction& Item) {
     }
 }
 
-TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> FDMXChannelTree::GetBehaviourByDMXValue(int32 DMXValue) {
-    if (this->IsEmpty()) return {nullptr, nullptr};
-    FDMXChannelTreeNode* ChannelFunctionNode = &elements[this->Root];
+int32 FDMXChannelTree::GetChannelFunctionIndexByDMXValue(int32 DMXValue) {
+    if (this->IsEmpty()) return INDEX_NONE;
+    int32 CurrentIndex = this->Root;
 
-    while (!ChannelFunctionNode->IsValueInRange(DMXValue)) {
-        int32 index = *ChannelFunctionNode < DMXValue ? ChannelFunctionNode->Right : ChannelFunctionNode->Left;
-        if (index < 0) return {nullptr, nullptr};
-        ChannelFunctionNode = &elements[index];
+    while (!elements[CurrentIndex].IsValueInRange(DMXValue)) {
+        CurrentIndex = elements[CurrentIndex] < DMXValue ? elements[CurrentIndex].Right : elements[CurrentIndex].Left;
+        if (CurrentIndex < 0) return INDEX_NONE;
     }
+    return CurrentIndex;
+}
+
+TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> FDMXChannelTree::GetBehaviourByDMXValue(int32 DMXValue) {
+    int32 ChannelFunctionIndex = this->GetChannelFunctionIndexByDMXValue(DMXValue);
+    if (ChannelFunctionIndex == INDEX_NONE) return {nullptr, nullptr};
+    FDMXChannelTreeNode* ChannelFunctionNode = &elements[ChannelFunctionIndex];
 
     TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> ReturnTuple;
     ReturnTuple.Key = &ChannelFunctionNode->ChannelFunction;
     ReturnTuple.Value = ChannelFunctionNode->ChannelSetsTree.GetChannelSetByDMXValue(DMXValue);
 
     return ReturnTuple;
+}
+
+/*************************************************************/
+
+void FDMXChannelTree::Compile() {
+
+    this->Behaviours.Empty();
+    this->ValueToBehaviour.Empty();
+    this->RunStarts.Empty();
+    this->RunBehaviours.Empty();
+    this->bIsCompiled = true;
+    if (this->IsEmpty()) return;
+
+    // 1. We collect every DMX value where the behaviour can change: the start of each ChannelFunction/ChannelSet
+    // and the values around 255/65535/etc since IsValueInRange() handles them differently
+    int32 MaxValue = 0;
+    TArray<int32> Boundaries;
+    Boundaries.Add(0);
+    for (FDMXChannelTreeNode& Node : this->elements) {
+        // Trees saved before the attribute was cached on the ChannelFunction have to be refreshed
+        Node.ChannelFunction.AttributeType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(Node.ChannelFunction.Attribute.Name);
+        Node.ChannelFunction.AttributeIndex = CPGDTFDescription::GetGDTFAttributeIndexFromName(Node.ChannelFunction.Attribute.Name);
+        MaxValue = FMath::Max(MaxValue, Node.ChannelFunction.DMXTo.Value);
+        Boundaries.Add(Node.ChannelFunction.DMXFrom.Value);
+        Boundaries.Add(Node.ChannelFunction.DMXTo.Value);
+        for (FDMXImportGDTFChannelSet& ChannelSet : Node.ChannelFunction.ChannelSets) Boundaries.Add(ChannelSet.DMXFrom.Value);
+    }
+    for (int32 SpecialValue : { 0xff, 0xffff, 0xffffff }) {
+        Boundaries.Add(SpecialValue);
+        Boundaries.Add(SpecialValue + 1);
+    }
+    Boundaries.Sort();
+
+    // 2. Each run goes from a boundary to the next one and has a constant behaviour, so we evaluate the trees only once per run
+    TMap<TPair<int32, int32>, int32> BehavioursIndexes;
+    for (int i = 0; i < Boundaries.Num(); i++) {
+        const int32 RunStart = Boundaries[i];
+        if (RunStart < 0 || RunStart > MaxValue) continue;
+        if (this->RunStarts.Num() > 0 && this->RunStarts.Last() == RunStart) continue; // Duplicated boundary
+
+        int32 BehaviourIndex = INDEX_NONE;
+        const int32 ChannelFunctionIndex = this->GetChannelFunctionIndexByDMXValue(RunStart);
+        if (ChannelFunctionIndex != INDEX_NONE) {
+            FDMXChannelTreeNode& Node = this->elements[ChannelFunctionIndex];
+            const int32 ChannelSetIndex = Node.ChannelSetsTree.GetChannelSetIndexByDMXValue(RunStart);
+            if (ChannelSetIndex != INDEX_NONE) {
+                const TPair<int32, int32> Key = TPair<int32, int32>(ChannelFunctionIndex, ChannelSetIndex);
+                const int32* ExistingIndex = BehavioursIndexes.Find(Key);
+                if (ExistingIndex) BehaviourIndex = *ExistingIndex;
+                else {
+                    FCPGDTFDescriptionChannelSet* ChannelSet = Node.ChannelSetsTree.GetChannelSetByIndex(ChannelSetIndex);
+                    FDMXChannelBehaviour Behaviour;
+                    Behaviour.ChannelFunctionIndex = ChannelFunctionIndex;
+                    Behaviour.ChannelSetIndex = ChannelSetIndex;
+                    Behaviour.AttributeType = Node.ChannelFunction.AttributeType;
+                    Behaviour.AttributeIndex = Node.ChannelFunction.AttributeIndex;
+                    Behaviour.DMXFrom = ChannelSet->DMXFrom.Value;
+                    Behaviour.DMXTo = ChannelSet->DMXTo.Value;
+                    Behaviour.PhysicalFrom = ChannelSet->PhysicalFrom;
+                    Behaviour.PhysicalTo = ChannelSet->PhysicalTo;
+                    BehaviourIndex = this->Behaviours.Add(Behaviour);
+                    BehavioursIndexes.Add(Key, BehaviourIndex);
+                }
+            }
+        }
+
+        // Merge with the previous run if the behaviour is the same
+        if (this->RunBehaviours.Num() > 0 && this->RunBehaviours.Last() == BehaviourIndex) continue;
+        this->RunStarts.Add(RunStart);
+        this->RunBehaviours.Add(BehaviourIndex);
+    }
+
+    // 3. Small channels are expanded into a flat table to have a single load per lookup
+    const bool bUseFlatTable = MaxValue < CP_DMX_LUT_8BIT_SIZE || (MaxValue <= 0xffff && this->RunStarts.Num() > CP_DMX_LUT_MAX_RUNS);
+    if (bUseFlatTable && this->Behaviours.Num() < MAX_uint16) {
+        this->ValueToBehaviour.SetNumUninitialized(MaxValue + 1);
+        for (int i = 0; i < this->RunStarts.Num(); i++) {
+            const int32 RunEnd = i + 1 < this->RunStarts.Num() ? this->RunStarts[i + 1] : MaxValue + 1;
+            const uint16 Value = this->RunBehaviours[i] == INDEX_NONE ? MAX_uint16 : (uint16)this->RunBehaviours[i];
+            for (int32 DMXValue = this->RunStarts[i]; DMXValue < RunEnd; DMXValue++) this->ValueToBehaviour[DMXValue] = Value;
+        }
+        this->RunStarts.Empty();
+        this->RunBehaviours.Empty();
+    }
+}
+
+const FDMXChannelBehaviour* FDMXChannelTree::FindBehaviour(int32 DMXValue) {
+    if (!this->bIsCompiled) this->Compile();
+
+    if (this->ValueToBehaviour.Num() > 0) {
+        if (DMXValue < 0 || DMXValue >= this->ValueToBehaviour.Num()) return nullptr;
+        const uint16 BehaviourIndex = this->ValueToBehaviour[DMXValue];
+        return BehaviourIndex == MAX_uint16 ? nullptr : &this->Behaviours[BehaviourIndex];
+    }
+
+    // Run-length table: find the last run starting before DMXValue
+    if (this->RunStarts.Num() == 0 || DMXValue < this->RunStarts[0]) return nullptr;
+    const int32 RunIndex = Algo::UpperBound(this->RunStarts, DMXValue) - 1;
+    const int32 BehaviourIndex = this->RunBehaviours[RunIndex];
+    return BehaviourIndex == INDEX_NONE ? nullptr : &this->Behaviours[BehaviourIndex];
+}
+
+TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> FDMXChannelTree::GetBehaviourPointers(const FDMXChannelBehaviour& Behaviour) {
+    if (!this->elements.IsValidIndex(Behaviour.ChannelFunctionIndex)) return {nullptr, nullptr};
+    FDMXChannelTreeNode& Node = this->elements[Behaviour.ChannelFunctionIndex];
+    return {&Node.ChannelFunction, Node.ChannelSetsTree.GetChannelSetByIndex(Behaviour.ChannelSetIndex)};
 }
\ No newline at end of file
@@ -32,6 +32,11 @@ SOFTWARE.
  * Trees to optimize the DMXChannel definition during runtime
  */
 
+/// Number of DMX values a 8bit channel can assume. These channels are always compiled into a flat lookup table
+#define CP_DMX_LUT_8BIT_SIZE 256
+/// Max number of runs a channel can have before we compile it into a flat lookup table instead of a run-length one. Only used for 16bit channels
+#define CP_DMX_LUT_MAX_RUNS 64
+
 /**
  * Node containing FDMXImportGDTFChannelSet
  */
@@ -79,6 +84,11 @@ public:
 	
 	FCPGDTFDescriptionChannelSet* GetChannelSetByDMXValue(int32 DMXValue);
 
+	/// Returns the index of the node holding the ChannelSet of the DMXValue, or INDEX_NONE if not found
+	int32 GetChannelSetIndexByDMXValue(int32 DMXValue);
+
+	FCPGDTFDescriptionChannelSet* GetChannelSetByIndex(int32 Index) { return elements.IsValidIndex(Index) ? &elements[Index].ChannelSet : nullptr; }
+
 protected:
 	
 	void Insert(FCPGDTFDescriptionChannelSet& Item);
@@ -113,6 +123,35 @@ public:
 	bool operator>=(const FDMXChannelTreeNode& Other) const;
 };
 
+/**
+ * Compact DMX behaviour stored in the lookup table of a FDMXChannelTree.
+ * It holds everything ApplyEffectToBeam needs, so we don't have to walk the trees at runtime.
+ */
+struct FDMXChannelBehaviour {
+
+	/// Index of the ChannelFunction node inside the FDMXChannelTree
+	int32 ChannelFunctionIndex = INDEX_NONE;
+	/// Index of the ChannelSet node inside the ChannelSetsTree of the ChannelFunction node
+	int32 ChannelSetIndex = INDEX_NONE;
+
+	/// Cached attribute of the ChannelFunction
+	ECPGDTFAttributeType AttributeType = ECPGDTFAttributeType::DefaultValue;
+	/// Index number contained in the attribute name of the ChannelFunction (eg. 1 for Blade1A)
+	int32 AttributeIndex = 0;
+
+	int32 DMXFrom = 0;
+	int32 DMXTo = 0;
+	float PhysicalFrom = 0.0f;
+	float PhysicalTo = 0.0f;
+
+	/// Translates the DMXValue to the physical value of the ChannelSet
+	FORCEINLINE float GetPhysicalValue(int32 DMXValue) const {
+		if (DMXFrom == DMXTo) return DMXValue >= DMXTo ? PhysicalTo : PhysicalFrom; // Same behaviour of UKismetMathLibrary::MapRangeClamped
+		const float Alpha = FMath::Clamp((float)(DMXValue - DMXFrom) / (float)(DMXTo - DMXFrom), 0.0f, 1.0f);
+		return FMath::Lerp(PhysicalFrom, PhysicalTo, Alpha);
+	}
+};
+
 /**
  * Tree of FCPGDTFChannelFunction
  */
@@ -142,7 +181,42 @@ public:
 	
 	TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> GetBehaviourByDMXValue(int32 DMXValue);
 
+	/**
+	 * Flattens the trees into a lookup table indexed by DMX value.
+	 * 8bit channels (and 16bit channels with a lot of ChannelSets) are compiled into a flat array with one entry per DMX value,
+	 * the others are compiled into a sorted list of runs of DMX values sharing the same behaviour.
+	 * The lookup table is not serialized, so it's lazily rebuilt by FindBehaviour() if needed.
+	 */
+	void Compile();
+
+	bool IsCompiled() { return bIsCompiled; }
+
+	/**
+	 * Gets the compiled behaviour of a DMX value. Compiles the tree if it's not already done
+	 *
+	 * @param DMXValue
+	 * @return The behaviour or nullptr if no ChannelFunction/ChannelSet is defined for this value
+	 */
+	const FDMXChannelBehaviour* FindBehaviour(int32 DMXValue);
+
+	/// Converts a compiled behaviour to the ChannelFunction/ChannelSet pair it was built from
+	TTuple<FCPGDTFDescriptionChannelFunction*, FCPGDTFDescriptionChannelSet*> GetBehaviourPointers(const FDMXChannelBehaviour& Behaviour);
+
 protected:
 
 	void Insert(FCPGDTFDescriptionChannelFunction& Item);
+
+	/// Returns the index of the node holding the ChannelFunction of the DMXValue, or INDEX_NONE if not found
+	int32 GetChannelFunctionIndexByDMXValue(int32 DMXValue);
+
+	/// Distinct behaviours of the channel. Both lookup tables point here
+	TArray<FDMXChannelBehaviour> Behaviours;
+	/// Flat lookup table: DMX value -> index in Behaviours (MAX_uint16 if undefined)
+	TArray<uint16> ValueToBehaviour;
+	/// Run-length lookup table: sorted first DMX values of each run
+	TArray<int32> RunStarts;
+	/// Run-length lookup table: index in Behaviours of each run (INDEX_NONE if undefined)
+	TArray<int32> RunBehaviours;
+
+	bool bIsCompiled = false;
 };
\ No newline at end of file
@@ -0,0 +1,72 @@
+﻿/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utils/CPGDTFDMXUniverseView.h"
+#include "Library/DMXEntityFixturePatch.h"
+#include "Library/DMXLibrary.h"
+#include "IO/DMXInputPort.h"
+#include "DMXProtocolConstants.h"
+#include "Library/DMXImportGDTF.h"
+
+FCPDMXUniverseView::FCPDMXUniverseView(UDMXEntityFixturePatch* FixturePatch, TArrayView<const FDMXImportGDTFDMXChannel> DMXChannels) {
+	if (FixturePatch == nullptr) return;
+
+	// Fast path: we directly look at the last signal received on the universe
+	if (UDMXLibrary* Library = FixturePatch->GetParentLibrary()) {
+		const int32 UniverseID = FixturePatch->GetUniverseID();
+		for (const FDMXInputPortSharedRef& InputPort : Library->GetInputPorts()) {
+			if (!InputPort->IsLocalUniverseInPortRange(UniverseID)) continue;
+			if (InputPort->GameThreadGetDMXSignal(UniverseID, this->Signal) && this->Signal.IsValid()) {
+				this->Data = TArrayView<const uint8>(this->Signal->ChannelData);
+				this->PatchOffset = FixturePatch->GetStartingChannel() - 1;
+				return;
+			}
+		}
+	}
+
+	// Slow path: we ask the patch for its values, once for all the components of the fixture
+	TMap<int32, int32> RawChannelsValues;
+	FixturePatch->GetRawChannelsValues(RawChannelsValues);
+	this->FallbackBuffer.SetNumZeroed(DMX_UNIVERSE_SIZE);
+	if (DMXChannels.Num() == 0) {
+		// Without the channels we don't know the size of the values, so we can only keep the single byte ones
+		for (const TPair<int32, int32>& Pair : RawChannelsValues) {
+			if (Pair.Key >= 1 && Pair.Key <= DMX_UNIVERSE_SIZE) this->FallbackBuffer[Pair.Key - 1] = (uint8)FMath::Min(Pair.Value, 255);
+		}
+	}
+	for (const FDMXImportGDTFDMXChannel& Channel : DMXChannels) {
+		if (Channel.Offset.Num() == 0) continue;
+		const int32* Value = RawChannelsValues.Find(Channel.Offset[0]);
+		if (Value == nullptr) continue;
+		// The value is spread over all the bytes of the channel, most significant byte first
+		for (int32 i = 0; i < Channel.Offset.Num(); i++) {
+			const int32 Address = Channel.Offset[i];
+			const int32 Shift = 8 * (Channel.Offset.Num() - 1 - i);
+			if (Address < 1 || Address > DMX_UNIVERSE_SIZE) continue;
+			this->FallbackBuffer[Address - 1] = Shift < 32 ? (uint8)((uint32)*Value >> Shift) : 0;
+		}
+	}
+	this->Data = TArrayView<const uint8>(this->FallbackBuffer);
+	this->PatchOffset = 0; // Values returned by GetRawChannelsValues are indexed by the address of the channel inside the patch
+}
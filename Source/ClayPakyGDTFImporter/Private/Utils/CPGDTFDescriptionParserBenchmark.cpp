@@ -0,0 +1,264 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFDescriptionParserBenchmark.h"
+#include "Factories/Importers/Description/CPGDTFDescriptionImporter.h"
+#include "CPGDTFDescription.h"
+#include "ClayPakyGDTFImporterLog.h"
+#include "CPGDTFImporterUtils.h"
+#include "Factories/CPGDTFUnzip.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#define XML_BENCHMARK_ITERATIONS 5
+// Below this total size of the descriptions the timings are mostly noise (real multi-mode fixtures have descriptions of some MB)
+#define XML_BENCHMARK_MIN_CORPUS_KB 1024
+// Differences logged per file before giving up
+#define XML_CHECK_MAX_DIFFERENCES 10
+
+namespace CPGDTFDescriptionParserBenchmark {
+
+	struct FImportResult {
+		UCPGDTFDescription* Description = nullptr;
+		double Seconds = 0;
+		/// Growth of the process memory between the start of the import and the end of the parse, with the parser data (DOM or bytes) still alive
+		int64 UsedBytes = 0;
+	};
+
+	static FString GetCorpusDirectory(const FString& Folder) {
+		return Folder.IsEmpty() ? FPaths::Combine(FCPGDTFImporterUtils::GetTestsDirectory(), TEXT("GDTFCorpus")) : Folder;
+	}
+
+	static TArray<FString> GetCorpus(const FString& Folder) {
+		const FString Directory = GetCorpusDirectory(Folder);
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *FPaths::Combine(Directory, TEXT("*.gdtf")), true, false);
+		Files.Sort();
+		for (FString& File : Files) File = FPaths::Combine(Directory, File);
+		if (Files.Num() == 0) UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Xml parser: no .gdtf file in '%s'"), *Directory);
+		return Files;
+	}
+
+	/**
+	 * Imports the description of a GDTF into a transient package. <br>
+	 * The memory is sampled from the platform stats, so it includes the allocations of the other threads: the benchmark keeps the smallest sample of each file
+	 */
+	static FImportResult Import(const FString& GDTFPath, bool bStreaming) {
+		static int32 ImportsNo = 0;
+		const FName AssetName(*FString::Printf(TEXT("CPGDTFXmlBenchmark_%d"), ImportsNo++));
+		FImportResult Result;
+
+		// Gives the cached free blocks back to the OS, otherwise the import may reuse them without changing the process memory
+		GMalloc->Trim(false);
+		const int64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+		const double Start = FPlatformTime::Seconds();
+		{
+			FCPGDTFDescriptionImporter Importer(GetTransientPackage(), AssetName, RF_Transient, GDTFPath);
+			Result.Description = Importer.Import(bStreaming);
+			Result.Seconds = FPlatformTime::Seconds() - Start;
+			Result.UsedBytes = FMath::Max<int64>(0, FPlatformMemory::GetStats().UsedPhysical - UsedBefore);
+		}
+		return Result;
+	}
+
+	static void Discard(UCPGDTFDescription* Description) {
+		if (Description == nullptr) return;
+		UPackage* Package = Description->GetPackage();
+		Description->MarkAsGarbage();
+		if (Package != GetTransientPackage()) Package->MarkAsGarbage();
+	}
+
+	/// Compares two descriptions property by property, following the objects owned by the descriptions
+	class FDescriptionComparer {
+
+	public:
+
+		FDescriptionComparer(const UObject* InRootA, const UObject* InRootB) : RootA(InRootA), RootB(InRootB) {}
+
+		TArray<FString> Differences;
+
+		void CompareObjects(const UObject* A, const UObject* B, const FString& Path) {
+			if (A->GetClass() != B->GetClass()) {
+				this->AddDifference(Path, A->GetClass()->GetName(), B->GetClass()->GetName());
+				return;
+			}
+			bool bAlreadyCompared = false;
+			this->Compared.Add(A, &bAlreadyCompared);
+			if (!bAlreadyCompared) this->CompareStructs(A->GetClass(), A, B, Path);
+		}
+
+	private:
+
+		const UObject* RootA;
+		const UObject* RootB;
+		TSet<const UObject*> Compared;
+
+		void AddDifference(const FString& Path, const FString& ValueA, const FString& ValueB) {
+			if (this->Differences.Num() < XML_CHECK_MAX_DIFFERENCES) this->Differences.Add(FString::Printf(TEXT("%s: DOM '%s', streaming '%s'"), *Path, *ValueA, *ValueB));
+			else if (this->Differences.Num() == XML_CHECK_MAX_DIFFERENCES) this->Differences.Add(TEXT("..."));
+		}
+
+		void CompareStructs(const UStruct* Struct, const void* A, const void* B, const FString& Path) {
+			for (TFieldIterator<FProperty> It(Struct); It; ++It) {
+				for (int32 Index = 0; Index < It->ArrayDim; Index++) {
+					const FString PropertyPath = It->ArrayDim > 1 ? FString::Printf(TEXT("%s.%s[%d]"), *Path, *It->GetName(), Index) : Path + TEXT(".") + It->GetName();
+					this->CompareValues(*It, It->ContainerPtrToValuePtr<void>(A, Index), It->ContainerPtrToValuePtr<void>(B, Index), PropertyPath);
+				}
+			}
+		}
+
+		void CompareValues(const FProperty* Property, const void* A, const void* B, const FString& Path) {
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property)) {
+				this->CompareStructs(StructProperty->Struct, A, B, Path);
+
+			} else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property)) {
+				FScriptArrayHelper ArrayA(ArrayProperty, A), ArrayB(ArrayProperty, B);
+				if (ArrayA.Num() != ArrayB.Num()) {
+					this->AddDifference(Path + TEXT(".Num"), FString::FromInt(ArrayA.Num()), FString::FromInt(ArrayB.Num()));
+					return;
+				}
+				for (int32 i = 0; i < ArrayA.Num(); i++)
+					this->CompareValues(ArrayProperty->Inner, ArrayA.GetRawPtr(i), ArrayB.GetRawPtr(i), FString::Printf(TEXT("%s[%d]"), *Path, i));
+
+			} else if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property)) {
+				const UObject* ObjectA = ObjectProperty->GetObjectPropertyValue(A);
+				const UObject* ObjectB = ObjectProperty->GetObjectPropertyValue(B);
+				if (ObjectA == nullptr || ObjectB == nullptr) {
+					if (ObjectA != ObjectB) this->AddDifference(Path, GetNameSafe(ObjectA), GetNameSafe(ObjectB));
+				} else if (ObjectA->IsIn(this->RootA) && ObjectB->IsIn(this->RootB)) {
+					this->CompareObjects(ObjectA, ObjectB, Path);
+				} else if (ObjectA != ObjectB) this->AddDifference(Path, ObjectA->GetPathName(), ObjectB->GetPathName());
+
+			} else if (!Property->Identical(A, B, PPF_None)) {
+				FString ValueA, ValueB;
+				Property->ExportTextItem_Direct(ValueA, A, nullptr, nullptr, PPF_None);
+				Property->ExportTextItem_Direct(ValueB, B, nullptr, nullptr, PPF_None);
+				this->AddDifference(Path, ValueA, ValueB);
+			}
+		}
+	};
+}
+
+bool FCPGDTFDescriptionParserBenchmark::RunCheck(const FString& Folder) {
+	using namespace CPGDTFDescriptionParserBenchmark;
+
+	bool bSuccess = true;
+	const TArray<FString> Files = GetCorpus(Folder);
+	for (const FString& File : Files) {
+		const FString FileName = FPaths::GetCleanFilename(File);
+		const FImportResult Dom = Import(File, false);
+		const FImportResult Streaming = Import(File, true);
+
+		if (Dom.Description == nullptr || Streaming.Description == nullptr) {
+			// A broken file must be rejected by both parsers
+			const bool bPassed = Dom.Description == Streaming.Description;
+			UE_LOG_CPGDTFIMPORTER(Display, TEXT("Xml check: %s: DOM %s, streaming %s: %s"), *FileName, Dom.Description ? TEXT("imported") : TEXT("failed"),
+				Streaming.Description ? TEXT("imported") : TEXT("failed"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+			bSuccess &= bPassed;
+		} else {
+			FDescriptionComparer Comparer(Dom.Description, Streaming.Description);
+			Comparer.CompareObjects(Dom.Description, Streaming.Description, TEXT("Description"));
+			for (const FString& Difference : Comparer.Differences) UE_LOG_CPGDTFIMPORTER(Error, TEXT("Xml check: %s: %s"), *FileName, *Difference);
+			UE_LOG_CPGDTFIMPORTER(Display, TEXT("Xml check: %s: %s"), *FileName, Comparer.Differences.Num() == 0 ? TEXT("passed") : TEXT("FAILED"));
+			bSuccess &= Comparer.Differences.Num() == 0;
+		}
+		Discard(Dom.Description);
+		Discard(Streaming.Description);
+	}
+	return bSuccess && Files.Num() > 0;
+}
+
+void FCPGDTFDescriptionParserBenchmark::RunBenchmark(const FString& Folder) {
+	using namespace CPGDTFDescriptionParserBenchmark;
+
+	double TotalSeconds[2] = { 0, 0 };
+	int64 MaxUsedBytes[2] = { 0, 0 };
+	int64 DescriptionsBytes = 0;
+	for (const FString& File : GetCorpus(Folder)) {
+		const int64 FileSize = IFileManager::Get().FileSize(*File);
+		TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(File);
+		if (Archive.IsValid()) DescriptionsBytes += FMath::Max<int64>(0, Archive->GetFileSize(TEXT("description.xml")));
+		for (int32 Mode = 0; Mode < 2; Mode++) {
+			const bool bStreaming = Mode == 1;
+
+			double Seconds = 0;
+			int64 UsedBytes = MAX_int64;
+			for (int32 Iteration = 0; Iteration < XML_BENCHMARK_ITERATIONS; Iteration++) {
+				const FImportResult Timed = Import(File, bStreaming);
+				Seconds += Timed.Seconds;
+				UsedBytes = FMath::Min(UsedBytes, Timed.UsedBytes);
+				Discard(Timed.Description);
+			}
+			Seconds /= XML_BENCHMARK_ITERATIONS;
+			TotalSeconds[Mode] += Seconds;
+			MaxUsedBytes[Mode] = FMath::Max(MaxUsedBytes[Mode], UsedBytes);
+
+			UE_LOG_CPGDTFIMPORTER(Display, TEXT("Xml benchmark: %-40s (%6lld KB) %-9s %8.2fms, memory %8.1f KB"), *FPaths::GetCleanFilename(File), FileSize / 1024,
+				bStreaming ? TEXT("streaming") : TEXT("DOM"), Seconds * 1000.0, UsedBytes / 1024.0);
+		}
+	}
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("Xml benchmark: total DOM %.2fms, streaming %.2fms (x%.1f), max memory DOM %.1f KB, streaming %.1f KB"), TotalSeconds[0] * 1000.0, TotalSeconds[1] * 1000.0,
+		TotalSeconds[1] > 0 ? TotalSeconds[0] / TotalSeconds[1] : 0.0, MaxUsedBytes[0] / 1024.0, MaxUsedBytes[1] / 1024.0);
+	if (DescriptionsBytes < XML_BENCHMARK_MIN_CORPUS_KB * 1024) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Xml benchmark: the descriptions of the corpus are only %lld KB (less than %d KB), these numbers are meaningless. Use a folder with real or larger GDTF files"),
+			DescriptionsBytes / 1024, XML_BENCHMARK_MIN_CORPUS_KB);
+	}
+}
+
+static FAutoConsoleCommand CPGDTFXmlCheckCommand(
+	TEXT("CPGDTF.Xml.Check"),
+	TEXT("Imports the descriptions of a GDTF corpus folder (default Resources/Tests/GDTFCorpus of the plugin) with the XML DOM and the pull parser and compares them"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		const bool bSuccess = FCPGDTFDescriptionParserBenchmark::RunCheck(Args.Num() > 0 ? Args[0] : FString());
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Xml check: %s"), bSuccess ? TEXT("OK") : TEXT("FAILED"));
+	})
+);
+
+static FAutoConsoleCommand CPGDTFXmlBenchmarkCommand(
+	TEXT("CPGDTF.Xml.Benchmark"),
+	TEXT("Measures time and peak memory of the XML DOM and of the pull parser on the descriptions of a GDTF corpus folder (default Resources/Tests/GDTFCorpus of the plugin)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		FCPGDTFDescriptionParserBenchmark::RunBenchmark(Args.Num() > 0 ? Args[0] : FString());
+	})
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCPGDTFDescriptionParserTest, "ClayPaky.GDTF.Description.XmlParsers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FCPGDTFDescriptionParserTest::RunTest(const FString& Parameters) {
+	// The corpus has a truncated description, rejected by both parsers
+	AddExpectedError(TEXT("Malformed description.xml"), EAutomationExpectedErrorFlags::Contains, 0);
+	AddExpectedError(TEXT("Error reading description.xml"), EAutomationExpectedErrorFlags::Contains, 0);
+	return FCPGDTFDescriptionParserBenchmark::RunCheck(FString());
+}
+#endif
+
+#undef XML_BENCHMARK_ITERATIONS
+#undef XML_BENCHMARK_MIN_CORPUS_KB
+#undef XML_CHECK_MAX_DIFFERENCES
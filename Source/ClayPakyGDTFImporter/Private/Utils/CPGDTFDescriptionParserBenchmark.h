@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Check and benchmark of the description.xml parsers. <br>
+ * Both import every .gdtf of a corpus folder (by default the synthetic fixtures of Resources/Tests/GDTFCorpus inside the plugin) with the XML DOM and with the pull parser
+ * into transient descriptions, with the CPGDTF.Xml.Check and CPGDTF.Xml.Benchmark console commands. The check also runs as the ClayPaky.GDTF.Description.XmlParsers automation test
+ */
+class FCPGDTFDescriptionParserBenchmark {
+
+public:
+
+	/**
+	 * Imports each GDTF of the corpus with both parsers and compares every property of the two descriptions
+	 *
+	 * @param Folder Corpus folder, default one if empty
+	 * @return True if the descriptions are the same for every file
+	 */
+	static bool RunCheck(const FString& Folder);
+
+	/**
+	 * Measures the import time and the memory used at the end of the parse (from FPlatformMemory::GetStats) of both parsers on each GDTF of the corpus
+	 *
+	 * @param Folder Corpus folder, default one if empty
+	 */
+	static void RunBenchmark(const FString& Folder);
+};
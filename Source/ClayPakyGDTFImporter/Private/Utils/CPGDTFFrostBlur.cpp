@@ -0,0 +1,272 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFFrostBlur.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#include <emmintrin.h>
+	#define FROST_BLUR_SIMD 1
+#else
+	#define FROST_BLUR_SIMD 0
+#endif
+
+// Sums are stored on 16 bits: 255 * (2 * 127 + 1) still fits
+#define FROST_BLUR_MAX_RADIUS 127
+// Widest box for which the 16 bits fixed point division of the SIMD path is exact
+#define FROST_BLUR_MAX_SIMD_RADIUS 7
+
+namespace CPGDTFFrostBlur {
+
+	/// One box blur pass: each output is round(Sum / Width), computed as ((Sum + Radius) * Reciprocal) >> Shift
+	struct FBox {
+		int32 Radius;
+		int32 Width;
+		uint16 Reciprocal16;
+		uint64 Reciprocal32;
+		bool bSimd;
+
+		FBox(int32 InRadius, bool bAllowSimd) {
+			this->Radius = InRadius;
+			this->Width = 2 * InRadius + 1;
+			this->Reciprocal16 = (uint16)FMath::Min((65536 + this->Width - 1) / this->Width, 65535);
+			this->Reciprocal32 = (4294967296ull + this->Width - 1) / this->Width;
+			this->bSimd = FROST_BLUR_SIMD && bAllowSimd && InRadius >= 1 && InRadius <= FROST_BLUR_MAX_SIMD_RADIUS;
+		}
+
+		FORCEINLINE uint8 Divide(uint32 Sum) const {
+			return (uint8)(((Sum + this->Radius) * this->Reciprocal32) >> 32);
+		}
+	};
+
+#if FROST_BLUR_SIMD
+	/// Loads the 4 channels of a pixel in the 4 low 16 bits lanes
+	FORCEINLINE __m128i LoadPixel(const uint8* Pixel) {
+		return _mm_unpacklo_epi8(_mm_cvtsi32_si128(*reinterpret_cast<const int32*>(Pixel)), _mm_setzero_si128());
+	}
+#endif
+
+	/// Horizontal pass of a box blur on a W x H tile, the borders are clamped
+	static void HorizontalPass(const uint8* In, uint8* Out, int32 W, int32 H, const FBox& Box) {
+
+		const int32 R = Box.Radius;
+		for (int32 y = 0; y < H; y++) {
+
+			const uint8* Row = In + y * W * 4;
+			uint8* OutRow = Out + y * W * 4;
+#if FROST_BLUR_SIMD
+			if (Box.bSimd) {
+				const __m128i Bias = _mm_set1_epi16((int16)R);
+				const __m128i Reciprocal = _mm_set1_epi16((int16)Box.Reciprocal16);
+				__m128i Sum = _mm_setzero_si128();
+				for (int32 k = -R; k <= R; k++) Sum = _mm_add_epi16(Sum, LoadPixel(Row + FMath::Clamp(k, 0, W - 1) * 4));
+
+				for (int32 x = 0; x < W; x++) {
+					const __m128i Result = _mm_mulhi_epu16(_mm_add_epi16(Sum, Bias), Reciprocal);
+					*reinterpret_cast<int32*>(OutRow + x * 4) = _mm_cvtsi128_si32(_mm_packus_epi16(Result, Result));
+					Sum = _mm_add_epi16(Sum, LoadPixel(Row + FMath::Min(x + R + 1, W - 1) * 4));
+					Sum = _mm_sub_epi16(Sum, LoadPixel(Row + FMath::Max(x - R, 0) * 4));
+				}
+				continue;
+			}
+#endif
+			uint32 Sum[4] = { 0, 0, 0, 0 };
+			for (int32 k = -R; k <= R; k++) {
+				const uint8* Pixel = Row + FMath::Clamp(k, 0, W - 1) * 4;
+				for (int32 c = 0; c < 4; c++) Sum[c] += Pixel[c];
+			}
+			for (int32 x = 0; x < W; x++) {
+				const uint8* Add = Row + FMath::Min(x + R + 1, W - 1) * 4;
+				const uint8* Sub = Row + FMath::Max(x - R, 0) * 4;
+				for (int32 c = 0; c < 4; c++) {
+					OutRow[x * 4 + c] = Box.Divide(Sum[c]);
+					Sum[c] = Sum[c] + Add[c] - Sub[c];
+				}
+			}
+		}
+	}
+
+	/// Vertical pass of a box blur on a W x H tile, the borders are clamped. The tile is swept row by row with one sum per byte of the row
+	static void VerticalPass(const uint8* In, uint8* Out, int32 W, int32 H, const FBox& Box, TArray<uint16>& Sums) {
+
+		const int32 R = Box.Radius;
+		const int32 RowBytes = W * 4;
+		Sums.SetNumUninitialized(RowBytes, false);
+		uint16* Sum = Sums.GetData();
+		FMemory::Memzero(Sum, RowBytes * sizeof(uint16));
+		for (int32 k = -R; k <= R; k++) {
+			const uint8* Row = In + FMath::Clamp(k, 0, H - 1) * RowBytes;
+			for (int32 i = 0; i < RowBytes; i++) Sum[i] += Row[i];
+		}
+
+		for (int32 y = 0; y < H; y++) {
+
+			const uint8* Add = In + FMath::Min(y + R + 1, H - 1) * RowBytes;
+			const uint8* Sub = In + FMath::Max(y - R, 0) * RowBytes;
+			uint8* OutRow = Out + y * RowBytes;
+			int32 i = 0;
+#if FROST_BLUR_SIMD
+			if (Box.bSimd) {
+				const __m128i Zero = _mm_setzero_si128();
+				const __m128i Bias = _mm_set1_epi16((int16)R);
+				const __m128i Reciprocal = _mm_set1_epi16((int16)Box.Reciprocal16);
+				for (; i + 16 <= RowBytes; i += 16) {
+					__m128i SumLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Sum + i));
+					__m128i SumHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Sum + i + 8));
+					const __m128i ResultLo = _mm_mulhi_epu16(_mm_add_epi16(SumLo, Bias), Reciprocal);
+					const __m128i ResultHi = _mm_mulhi_epu16(_mm_add_epi16(SumHi, Bias), Reciprocal);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(OutRow + i), _mm_packus_epi16(ResultLo, ResultHi));
+
+					const __m128i AddBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Add + i));
+					const __m128i SubBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Sub + i));
+					SumLo = _mm_sub_epi16(_mm_add_epi16(SumLo, _mm_unpacklo_epi8(AddBytes, Zero)), _mm_unpacklo_epi8(SubBytes, Zero));
+					SumHi = _mm_sub_epi16(_mm_add_epi16(SumHi, _mm_unpackhi_epi8(AddBytes, Zero)), _mm_unpackhi_epi8(SubBytes, Zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Sum + i), SumLo);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Sum + i + 8), SumHi);
+				}
+			}
+#endif
+			for (; i < RowBytes; i++) {
+				OutRow[i] = Box.Divide(Sum[i]);
+				Sum[i] = Sum[i] + Add[i] - Sub[i];
+			}
+		}
+	}
+
+	/// Blurs a W x H tile of an image whose rows are Stride bytes long
+	static void BlurTile(uint8* Pixels, int32 Stride, int32 W, int32 H, const int32 Radii[3], bool bAllowSimd) {
+
+		// The tile is copied to a contiguous buffer to keep the passes on the cache
+		TArray<uint8> Tile, Scratch;
+		TArray<uint16> Sums;
+		Tile.SetNumUninitialized(W * H * 4);
+		Scratch.SetNumUninitialized(W * H * 4);
+		for (int32 y = 0; y < H; y++) FMemory::Memcpy(Tile.GetData() + y * W * 4, Pixels + y * Stride, W * 4);
+
+		for (int32 Pass = 0; Pass < 3; Pass++) {
+			const FBox Box(Radii[Pass], bAllowSimd);
+			HorizontalPass(Tile.GetData(), Scratch.GetData(), W, H, Box);
+			VerticalPass(Scratch.GetData(), Tile.GetData(), W, H, Box, Sums);
+		}
+
+		for (int32 y = 0; y < H; y++) FMemory::Memcpy(Pixels + y * Stride, Tile.GetData() + y * W * 4, W * 4);
+	}
+}
+
+/**
+ * Blur each slot of a wheel strip in place
+ *
+ * @param Pixels BGRA8 pixels of the strip, row by row
+ * @param SizeX Width of the strip
+ * @param SizeY Height of the strip
+ * @param SlotSizeX Width of a slot. The strip is made of SizeX / SlotSizeX slots side by side
+ * @param Sigma Standard deviation of the gaussian blur
+ * @param bAllowSimd If false the scalar path is used everywhere (used by the checks)
+ */
+void FCPGDTFFrostBlur::BlurSlots(uint8* Pixels, int32 SizeX, int32 SizeY, int32 SlotSizeX, float Sigma, bool bAllowSimd) {
+
+	if (Pixels == nullptr || SizeX <= 0 || SizeY <= 0 || SlotSizeX <= 0 || Sigma <= 0) return;
+
+	int32 Radii[3];
+	FCPGDTFFrostBlur::ComputeBoxRadii(Sigma, Radii);
+
+	const int32 SlotsNo = FMath::DivideAndRoundUp(SizeX, SlotSizeX);
+	ParallelFor(SlotsNo, [&](int32 SlotIndex) {
+		const int32 SlotX = SlotIndex * SlotSizeX;
+		CPGDTFFrostBlur::BlurTile(Pixels + SlotX * 4, SizeX * 4, FMath::Min(SlotSizeX, SizeX - SlotX), SizeY, Radii, bAllowSimd);
+	});
+}
+
+/**
+ * Converts the standard deviation of the gaussian blur into the radii of the three box blurs
+ *
+ * @param Sigma Standard deviation of the gaussian blur
+ * @param OutRadii Radii of the box blurs
+ */
+void FCPGDTFFrostBlur::ComputeBoxRadii(float Sigma, int32 OutRadii[3]) {
+
+	// Same conversion as FastGaussianBlur std_to_box, see https://www.peterkovesi.com/papers/FastGaussianSmoothing.pdf
+	const int32 BoxesNo = 3;
+	const float IdealWidth = FMath::Sqrt((12 * Sigma * Sigma / BoxesNo) + 1);
+	int32 LowerWidth = FMath::FloorToInt(IdealWidth);
+	if (LowerWidth % 2 == 0) LowerWidth--;
+	const int32 UpperWidth = LowerWidth + 2;
+
+	const float IdealLowerBoxes = (12 * Sigma * Sigma - BoxesNo * LowerWidth * LowerWidth - 4 * BoxesNo * LowerWidth - 3 * BoxesNo) / (-4 * LowerWidth - 4);
+	const int32 LowerBoxes = FMath::RoundToInt(IdealLowerBoxes);
+
+	for (int32 i = 0; i < BoxesNo; i++) OutRadii[i] = FMath::Clamp(((i < LowerBoxes ? LowerWidth : UpperWidth) - 1) / 2, 0, FROST_BLUR_MAX_RADIUS);
+}
+
+/**
+ * Builds a chain of successively stronger frosts of a wheel strip, to be used as its mips: each level is the previous one blurred slot by slot and halved,
+ * so the blur measured in pixels of the strip roughly doubles at each level
+ *
+ * @param Pixels BGRA8 pixels of the strip, row by row
+ * @param SizeX Width of the strip
+ * @param SizeY Height of the strip
+ * @param SlotSizeX Width of a slot
+ * @param Levels Number of frost levels. Stops earlier if a slot can't be halved anymore
+ * @param Sigma Standard deviation of the blur applied before halving each level
+ * @param OutMips BGRA8 pixels of the levels, level 1 (half size) first
+ */
+void FCPGDTFFrostBlur::BuildFrostMips(const uint8* Pixels, int32 SizeX, int32 SizeY, int32 SlotSizeX, int32 Levels, float Sigma, TArray<TArray<uint8>>& OutMips) {
+
+	OutMips.Empty(Levels);
+	TArray<uint8> Blurred;
+	for (int32 Level = 1; Level <= Levels; Level++) {
+
+		// The slots must stay aligned on the texels of every level
+		if (SizeY % 2 != 0 || SlotSizeX % 2 != 0 || SizeX % SlotSizeX != 0) break;
+
+		const uint8* Previous = Level == 1 ? Pixels : OutMips.Last().GetData();
+		Blurred = TArray<uint8>(Previous, SizeX * SizeY * 4);
+		FCPGDTFFrostBlur::BlurSlots(Blurred.GetData(), SizeX, SizeY, SlotSizeX, Sigma);
+
+		// 2x2 box to halve the level
+		SizeX /= 2;
+		SizeY /= 2;
+		SlotSizeX /= 2;
+		TArray<uint8>& Mip = OutMips.AddDefaulted_GetRef();
+		Mip.SetNumUninitialized(SizeX * SizeY * 4);
+		const int32 InRowBytes = SizeX * 2 * 4;
+		for (int32 y = 0; y < SizeY; y++) {
+			const uint8* Row0 = Blurred.GetData() + (y * 2) * InRowBytes;
+			const uint8* Row1 = Row0 + InRowBytes;
+			uint8* OutRow = Mip.GetData() + y * SizeX * 4;
+			for (int32 x = 0; x < SizeX * 4; x++) {
+				const int32 In = (x / 4) * 8 + (x % 4);
+				OutRow[x] = (uint8)((Row0[In] + Row0[In + 4] + Row1[In] + Row1[In + 4] + 2) / 4);
+			}
+		}
+	}
+}
+
+bool FCPGDTFFrostBlur::HasSimd() {
+	return FROST_BLUR_SIMD != 0;
+}
+
+#undef FROST_BLUR_SIMD
+#undef FROST_BLUR_MAX_RADIUS
+#undef FROST_BLUR_MAX_SIMD_RADIUS
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Frost effect of the wheels disks. <br>
+ * Approximates a gaussian blur with three box blurs (as FastGaussianBlur does) directly on BGRA8 pixels, with integer accumulators and a fixed point division.
+ * Each slot of a wheel strip is blurred on its own (clamped to its edges) so the slots never bleed into each other, and the slots are blurred in parallel.
+ */
+class FCPGDTFFrostBlur {
+
+public:
+
+	/**
+	 * Blur each slot of a wheel strip in place
+	 *
+	 * @param Pixels BGRA8 pixels of the strip, row by row
+	 * @param SizeX Width of the strip
+	 * @param SizeY Height of the strip
+	 * @param SlotSizeX Width of a slot. The strip is made of SizeX / SlotSizeX slots side by side
+	 * @param Sigma Standard deviation of the gaussian blur
+	 * @param bAllowSimd If false the scalar path is used everywhere (used by the checks)
+	 */
+	static void BlurSlots(uint8* Pixels, int32 SizeX, int32 SizeY, int32 SlotSizeX, float Sigma, bool bAllowSimd = true);
+
+	/**
+	 * Converts the standard deviation of the gaussian blur into the radii of the three box blurs
+	 *
+	 * @param Sigma Standard deviation of the gaussian blur
+	 * @param OutRadii Radii of the box blurs
+	 */
+	static void ComputeBoxRadii(float Sigma, int32 OutRadii[3]);
+
+	/**
+	 * Builds a chain of successively stronger frosts of a wheel strip, to be used as its mips: each level is the previous one blurred slot by slot and halved,
+	 * so the blur measured in pixels of the strip roughly doubles at each level
+	 *
+	 * @param Pixels BGRA8 pixels of the strip, row by row
+	 * @param SizeX Width of the strip
+	 * @param SizeY Height of the strip
+	 * @param SlotSizeX Width of a slot
+	 * @param Levels Number of frost levels. Stops earlier if a slot can't be halved anymore
+	 * @param Sigma Standard deviation of the blur applied before halving each level
+	 * @param OutMips BGRA8 pixels of the levels, level 1 (half size) first
+	 */
+	static void BuildFrostMips(const uint8* Pixels, int32 SizeX, int32 SizeY, int32 SlotSizeX, int32 Levels, float Sigma, TArray<TArray<uint8>>& OutMips);
+
+	/// True if this build has a SIMD path
+	static bool HasSimd();
+};
@@ -0,0 +1,190 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFFrostBlurBenchmark.h"
+#include "CPGDTFFrostBlur.h"
+#include "ClayPakyGDTFImporterLog.h"
+#include "Libs/FastGaussianBlur/FastGaussianBlur.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#define FROST_BENCHMARK_SEED 0xF057
+#define FROST_BENCHMARK_ITERATIONS 10
+#define FROST_BENCHMARK_SLOT_SIZE 256
+#define FROST_BENCHMARK_SLOTS_NO 12
+// Maximum difference allowed with FastGaussianBlur on each channel
+#define FROST_CHECK_TOLERANCE 1
+
+namespace CPGDTFFrostBlurBenchmark {
+
+	/// Strip of SlotsNo opaque slots mixing hard edged shapes (like gobos) and noise
+	static TArray<uint8> MakeStrip(int32 SlotSizeX, int32 SizeY, int32 SlotsNo, FRandomStream& Random) {
+		const int32 SizeX = SlotSizeX * SlotsNo;
+		TArray<uint8> Pixels;
+		Pixels.SetNumUninitialized(SizeX * SizeY * 4);
+		for (int32 y = 0; y < SizeY; y++) {
+			for (int32 x = 0; x < SizeX; x++) {
+				uint8* Pixel = &Pixels[(y * SizeX + x) * 4];
+				const bool bShape = ((x / 7) + (y / 5)) % 3 == 0;
+				for (int32 c = 0; c < 3; c++) Pixel[c] = bShape ? 255 : (uint8)Random.RandRange(0, 255);
+				Pixel[3] = 255;
+			}
+		}
+		return Pixels;
+	}
+
+	/// Frost of the whole strip as FCPGDTFWheelImporter did before: RGB copied to an int buffer and blurred with FastGaussianBlur
+	static void LegacyFrost(uint8* Pixels, int32 SizeX, int32 SizeY, float Sigma) {
+		int* InPixelsBlur = new int[SizeX * SizeY * 3];
+		int* OutPixelsBlur = new int[SizeX * SizeY * 3];
+		for (int32 i = 0; i < SizeX * SizeY; i++)
+			for (int32 c = 0; c < 3; c++) InPixelsBlur[i * 3 + c] = Pixels[i * 4 + c];
+		fast_gaussian_blur_rgb(InPixelsBlur, OutPixelsBlur, SizeX, SizeY, 3, Sigma);
+		for (int32 i = 0; i < SizeX * SizeY; i++)
+			for (int32 c = 0; c < 3; c++) Pixels[i * 4 + c] = OutPixelsBlur[i * 3 + c];
+		delete[] InPixelsBlur;
+		delete[] OutPixelsBlur;
+	}
+
+	/// Reference frost: FastGaussianBlur applied on each slot copied on its own
+	static TArray<uint8> LegacyFrostSlots(const TArray<uint8>& Pixels, int32 SlotSizeX, int32 SizeY, int32 SlotsNo, float Sigma) {
+		const int32 SizeX = SlotSizeX * SlotsNo;
+		TArray<uint8> Result = Pixels;
+		TArray<uint8> Slot;
+		Slot.SetNumUninitialized(SlotSizeX * SizeY * 4);
+		for (int32 SlotIndex = 0; SlotIndex < SlotsNo; SlotIndex++) {
+			for (int32 y = 0; y < SizeY; y++) FMemory::Memcpy(&Slot[y * SlotSizeX * 4], &Pixels[(y * SizeX + SlotIndex * SlotSizeX) * 4], SlotSizeX * 4);
+			LegacyFrost(Slot.GetData(), SlotSizeX, SizeY, Sigma);
+			for (int32 y = 0; y < SizeY; y++) FMemory::Memcpy(&Result[(y * SizeX + SlotIndex * SlotSizeX) * 4], &Slot[y * SlotSizeX * 4], SlotSizeX * 4);
+		}
+		return Result;
+	}
+}
+
+bool FCPGDTFFrostBlurBenchmark::RunCheck() {
+	using namespace CPGDTFFrostBlurBenchmark;
+
+	struct FCase { int32 SlotSizeX; int32 SizeY; int32 SlotsNo; float Sigma; };
+	const FCase Cases[] = {
+		{ 256, 256, 3, 4 },  // Import settings
+		{ 256, 256, 1, 1 },
+		{ 100, 64, 4, 2.5f },
+		{ 37, 20, 2, 4 },    // Slot width not multiple of the SIMD width
+		{ 64, 64, 2, 8 },    // Boxes too wide for the SIMD path
+	};
+
+	bool bSuccess = true;
+	FRandomStream Random(FROST_BENCHMARK_SEED);
+	for (const FCase& Case : Cases) {
+		const int32 SizeX = Case.SlotSizeX * Case.SlotsNo;
+		const TArray<uint8> Pixels = MakeStrip(Case.SlotSizeX, Case.SizeY, Case.SlotsNo, Random);
+		const TArray<uint8> Reference = LegacyFrostSlots(Pixels, Case.SlotSizeX, Case.SizeY, Case.SlotsNo, Case.Sigma);
+		TArray<uint8> Simd = Pixels, Scalar = Pixels;
+		FCPGDTFFrostBlur::BlurSlots(Simd.GetData(), SizeX, Case.SizeY, Case.SlotSizeX, Case.Sigma, true);
+		FCPGDTFFrostBlur::BlurSlots(Scalar.GetData(), SizeX, Case.SizeY, Case.SlotSizeX, Case.Sigma, false);
+
+		int32 MaxDifference = 0;
+		for (int32 i = 0; i < Reference.Num(); i++)
+			if (i % 4 != 3) MaxDifference = FMath::Max(MaxDifference, FMath::Abs((int32)Reference[i] - (int32)Simd[i]));
+		const bool bSameAsScalar = FMemory::Memcmp(Simd.GetData(), Scalar.GetData(), Simd.Num()) == 0;
+
+		const bool bPassed = MaxDifference <= FROST_CHECK_TOLERANCE && bSameAsScalar;
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Frost check: %3dx%3d x%d sigma %.1f: max difference %d, SIMD %s scalar: %s"), Case.SlotSizeX, Case.SizeY, Case.SlotsNo, Case.Sigma,
+			MaxDifference, bSameAsScalar ? TEXT("==") : TEXT("!="), bPassed ? TEXT("passed") : TEXT("FAILED"));
+		bSuccess &= bPassed;
+	}
+
+	// A white slot between two black ones must not bleed on them
+	const int32 SizeX = FROST_BENCHMARK_SLOT_SIZE * 3;
+	TArray<uint8> Pixels;
+	Pixels.SetNumZeroed(SizeX * FROST_BENCHMARK_SLOT_SIZE * 4);
+	for (int32 y = 0; y < FROST_BENCHMARK_SLOT_SIZE; y++)
+		FMemory::Memset(&Pixels[(y * SizeX + FROST_BENCHMARK_SLOT_SIZE) * 4], 255, FROST_BENCHMARK_SLOT_SIZE * 4);
+	FCPGDTFFrostBlur::BlurSlots(Pixels.GetData(), SizeX, FROST_BENCHMARK_SLOT_SIZE, FROST_BENCHMARK_SLOT_SIZE, 4);
+	bool bIsolated = true;
+	for (int32 y = 0; y < FROST_BENCHMARK_SLOT_SIZE && bIsolated; y++) {
+		for (int32 x = 0; x < SizeX && bIsolated; x++) {
+			const uint8 Expected = (x >= FROST_BENCHMARK_SLOT_SIZE && x < FROST_BENCHMARK_SLOT_SIZE * 2) ? 255 : 0;
+			if (Pixels[(y * SizeX + x) * 4] != Expected) bIsolated = false;
+		}
+	}
+	UE_LOG_CPGDTFIMPORTER(Display, TEXT("Frost check: slots isolation: %s"), bIsolated ? TEXT("passed") : TEXT("FAILED"));
+	return bSuccess && bIsolated;
+}
+
+void FCPGDTFFrostBlurBenchmark::RunBenchmark() {
+	using namespace CPGDTFFrostBlurBenchmark;
+
+	FRandomStream Random(FROST_BENCHMARK_SEED);
+	const int32 SizeX = FROST_BENCHMARK_SLOT_SIZE * FROST_BENCHMARK_SLOTS_NO;
+	const TArray<uint8> Pixels = MakeStrip(FROST_BENCHMARK_SLOT_SIZE, FROST_BENCHMARK_SLOT_SIZE, FROST_BENCHMARK_SLOTS_NO, Random);
+
+	const TCHAR* Names[] = { TEXT("FastGaussianBlur"), TEXT("Scalar"), FCPGDTFFrostBlur::HasSimd() ? TEXT("SIMD") : TEXT("SIMD (unavailable, scalar)") };
+	double Times[3];
+	for (int32 Mode = 0; Mode < 3; Mode++) {
+		double Elapsed = 0;
+		for (int32 Iteration = 0; Iteration < FROST_BENCHMARK_ITERATIONS; Iteration++) {
+			TArray<uint8> Strip = Pixels; // Outside of the measured time
+			const double Start = FPlatformTime::Seconds();
+			if (Mode == 0) LegacyFrost(Strip.GetData(), SizeX, FROST_BENCHMARK_SLOT_SIZE, 4);
+			else FCPGDTFFrostBlur::BlurSlots(Strip.GetData(), SizeX, FROST_BENCHMARK_SLOT_SIZE, FROST_BENCHMARK_SLOT_SIZE, 4, Mode == 2);
+			Elapsed += FPlatformTime::Seconds() - Start;
+		}
+		Times[Mode] = Elapsed / FROST_BENCHMARK_ITERATIONS;
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Frost benchmark: %-26s %dx%d strip in %7.2fms (x%.1f)"), Names[Mode], SizeX, FROST_BENCHMARK_SLOT_SIZE, Times[Mode] * 1000.0, Times[Mode] > 0 ? Times[0] / Times[Mode] : 0.0);
+	}
+}
+
+static FAutoConsoleCommand CPGDTFFrostCheckCommand(
+	TEXT("CPGDTF.Frost.Check"),
+	TEXT("Compares the wheels frost with FastGaussianBlur applied slot by slot and checks that slots do not bleed on each other"),
+	FConsoleCommandDelegate::CreateLambda([]() {
+		const bool bSuccess = FCPGDTFFrostBlurBenchmark::RunCheck();
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Frost check: %s"), bSuccess ? TEXT("OK") : TEXT("FAILED"));
+	})
+);
+
+static FAutoConsoleCommand CPGDTFFrostBenchmarkCommand(
+	TEXT("CPGDTF.Frost.Benchmark"),
+	TEXT("Measures the frost of a 12 gobos wheel strip with FastGaussianBlur, the scalar path and the SIMD path"),
+	FConsoleCommandDelegate::CreateStatic(&FCPGDTFFrostBlurBenchmark::RunBenchmark)
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCPGDTFFrostBlurTest, "ClayPaky.GDTF.Wheels.Frost", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCPGDTFFrostBlurTest::RunTest(const FString& Parameters) {
+	return FCPGDTFFrostBlurBenchmark::RunCheck();
+}
+
+#endif
+
+#undef FROST_BENCHMARK_SEED
+#undef FROST_BENCHMARK_ITERATIONS
+#undef FROST_BENCHMARK_SLOT_SIZE
+#undef FROST_BENCHMARK_SLOTS_NO
+#undef FROST_CHECK_TOLERANCE
@@ -0,0 +1,50 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Checks and microbenchmark of FCPGDTFFrostBlur. <br>
+ * Everything runs on the CPU on generated strips, so it can be launched from a headless editor (-nullrhi) with the
+ * CPGDTF.Frost.Check and CPGDTF.Frost.Benchmark console commands. The check is also the ClayPaky.GDTF.Wheels.Frost automation test
+ */
+class FCPGDTFFrostBlurBenchmark {
+
+public:
+
+	/**
+	 * Compares the frost of generated strips with the FastGaussianBlur one applied slot by slot, checks that the SIMD and scalar paths give the same pixels
+	 * and that a slot never bleeds on its neighbours
+	 *
+	 * @return True if every check passed
+	 */
+	static bool RunCheck();
+
+	/**
+	 * Measures the frost of a 12 gobos wheel strip with FastGaussianBlur (as the import did before), with the scalar path and with the SIMD path
+	 */
+	static void RunBenchmark();
+};
@@ -36,6 +36,7 @@ SOFTWARE.
 #include "Modules/ModuleManager.h"
 #include "HAL/PlatformFileManager.h"
 #include "Misc/Paths.h"
+#include "Interfaces/IPluginManager.h"
 #include "GLTFImportOptions.h"
 #include "Framework/Notifications/NotificationManager.h"
 
@@ -66,9 +67,10 @@ UTexture2D* FCPGDTFImporterUtils::ImportPNG(FString GDTFPath, FString AssetName,
 	// Creation of the Package to store the Asset
 	else AssetPackage = FCPGDTFImporterUtils::PreparePackageOnSubFolder(AssetName, PathOnContentBrowser);
 	
-	// Load of the file from disk
-	std::tuple<void*, int> bufferTuple = UCPGDTFUnzip::ExtractFileFromGDTFArchive(GDTFPath, FileName + ".png");
-	if (!std::get<0>(bufferTuple)) { // Check if read problems
+	// Load of the file from the (shared) archive
+	TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(GDTFPath);
+	TArray<uint8> Buffer;
+	if (!Archive.IsValid() || !Archive->Extract(FileName + ".png", Buffer)) { // Check if read problems
 		FString LongFileName = FileName + ".png";
 		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Error opening '%s' on '%s'"), *LongFileName, *GDTFPath);
 		return nullptr;
@@ -78,12 +80,11 @@ UTexture2D* FCPGDTFImporterUtils::ImportPNG(FString GDTFPath, FString AssetName,
 	UTextureFactory* Factory = NewObject<UTextureFactory>();
 	Factory->SuppressImportOverwriteDialog(true); // Remove overwrite warning for re-import
 	Factory->AddToRoot(); // Prevent Garbage Collection
-	const uint8* bufferptr = (uint8*)std::get<0>(bufferTuple);
-	const uint8* endbufferptr = (bufferptr + std::get<1>(bufferTuple));
+	const uint8* bufferptr = Buffer.GetData();
+	const uint8* endbufferptr = (bufferptr + Buffer.Num());
 	FString CleanAssetName = ObjectTools::SanitizeObjectName(AssetName);
 	
 	Asset = (UTexture2D*)Factory->FactoryCreateBinary(UTexture2D::StaticClass(), AssetPackage, *CleanAssetName, RF_Standalone | RF_Public, NULL, TEXT("PNG"), bufferptr, endbufferptr, GWarn);
-	free(std::get<0>(bufferTuple)); // Clear of the buffer memory
 
 	// Notify the Asset Registery from the creation of the Asset
 	FAssetRegistryModule::AssetCreated(Asset);
@@ -93,6 +94,40 @@ UTexture2D* FCPGDTFImporterUtils::ImportPNG(FString GDTFPath, FString AssetName,
 }
 
 
+/**
+ * Create (or overwrite on reimport) a Texture2D asset from already decoded pixels
+ *
+ * @param AssetName Name of the Asset
+ * @param PathOnContentBrowser   Path of the Texture2D on the ContentBrowser
+ * @param BGRAPixels Pixels in BGRA8 format, row by row (SizeX * SizeY * 4 bytes)
+ * @param SizeX Width of the image
+ * @param SizeY Height of the image
+ */
+UTexture2D* FCPGDTFImporterUtils::CreateTextureFromPixels(FString AssetName, FString PathOnContentBrowser, const uint8* BGRAPixels, int32 SizeX, int32 SizeY) {
+
+	// Check if alls args are provided
+	if (AssetName.IsEmpty() || PathOnContentBrowser.IsEmpty() || BGRAPixels == nullptr || SizeX <= 0 || SizeY <= 0) return nullptr;
+
+	UPackage* AssetPackage;
+	UTexture2D* Asset = Cast<UTexture2D>(FCPGDTFImporterUtils::IsAssetExisting(AssetName, PathOnContentBrowser));
+
+	// If Asset found in Content Browser (probably a re-import)
+	if (Asset != nullptr) AssetPackage = Asset->GetPackage();
+	// Creation of the Package to store the Asset
+	else AssetPackage = FCPGDTFImporterUtils::PreparePackageOnSubFolder(AssetName, PathOnContentBrowser);
+
+	FString CleanAssetName = ObjectTools::SanitizeObjectName(AssetName);
+	if (Asset == nullptr) Asset = NewObject<UTexture2D>(AssetPackage, *CleanAssetName, RF_Standalone | RF_Public);
+	else Asset->PreEditChange(nullptr);
+	Asset->Source.Init(SizeX, SizeY, 1, 1, ETextureSourceFormat::TSF_BGRA8, BGRAPixels);
+	Asset->PostEditChange();
+
+	// Notify the Asset Registery from the creation of the Asset
+	FAssetRegistryModule::AssetCreated(Asset);
+	AssetPackage->SetDirtyFlag(true);
+	return Asset;
+}
+
 /**
  * Import a 3D model from a GDTF file
  * @author Dorian Gardes - Clay Paky S.R.L.
@@ -123,22 +158,27 @@ UObject* FCPGDTFImporterUtils::Import3DModel(FString GDTFPath, FString AssetName
 	// If the file exist we delete it
 	if (FileManager.FileExists(*TempFilePath)) FileManager.DeleteFile(*TempFilePath);
 
-	// Load of the model from archive
+	// Stream the model from the (shared) archive to a temp file, without holding it all in memory
 	FString InternalArchivePath = TEXT("models/gltf/") + FileName + TEXT(".glb");
-	std::tuple<void*, int> bufferTuple = UCPGDTFUnzip::ExtractFileFromGDTFArchive(GDTFPath, InternalArchivePath);
-	if (!std::get<0>(bufferTuple)) { // Check if read problems
+	TSharedPtr<FCPGDTFArchive> Archive = FCPGDTFArchive::Open(GDTFPath);
+	if (!Archive.IsValid() || !Archive->Contains(InternalArchivePath)) { // Check if read problems
 		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Error opening '%s' on '%s'"), *InternalArchivePath, *GDTFPath);
 		return nullptr;
 	}
 
-	// Write the model on temp file
 	std::fstream TempFileStream;
 	TempFileStream.open(*TempFilePath, std::ios::out | std::ios::binary);
 	if (!TempFileStream) UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Unable to write temp '%s' on disk"), *FileName);
-	TempFileStream.write((char*)std::get<0>(bufferTuple), std::get<1>(bufferTuple));
+	const bool bExtracted = Archive->ExtractStreaming(InternalArchivePath, [&TempFileStream](int64 Offset, const void* Data, int64 Size) {
+		TempFileStream.write((const char*)Data, Size);
+		return TempFileStream.good();
+	});
 	TempFileStream.flush();
 	TempFileStream.close();
-	free(std::get<0>(bufferTuple)); // Clear of the buffer memory
+	if (!bExtracted) {
+		UE_LOG_CPGDTFIMPORTER(Warning, TEXT("Error extracting '%s' from '%s'"), *InternalArchivePath, *GDTFPath);
+		return nullptr;
+	}
 
 	// Creation of the settings to automate the import and avoid a popup windows for each model
 	FAssetToolsModule& AssetToolsModule = FModuleManager::GetModuleChecked<FAssetToolsModule>("AssetTools");
@@ -354,4 +394,9 @@ void FCPGDTFImporterUtils::SendNotification(FString Title, FString Message, SNot
 	if (Notification.IsValid()) {
 		Notification->SetCompletionState(State);
 	}
-}
\ No newline at end of file
+}
+
+FString FCPGDTFImporterUtils::GetTestsDirectory() {
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("ClayPakyGDTFImporter"));
+	return FPaths::Combine(Plugin.IsValid() ? Plugin->GetBaseDir() : FPaths::ProjectPluginsDir() / TEXT("ClayPakyGDTFImporter"), TEXT("Resources"), TEXT("Tests"));
+}
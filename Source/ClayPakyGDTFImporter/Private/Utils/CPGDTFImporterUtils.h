@@ -52,6 +52,17 @@ public:
      */
 	static UTexture2D* FCPGDTFImporterUtils::ImportPNG(FString GDTFPath, FString AssetName, FString FileName, FString PathOnContentBrowser);
 
+    /**
+     * Create (or overwrite on reimport) a Texture2D asset from already decoded pixels
+     *
+     * @param AssetName Name of the Asset
+     * @param PathOnContentBrowser   Path of the Texture2D on the ContentBrowser
+     * @param BGRAPixels Pixels in BGRA8 format, row by row (SizeX * SizeY * 4 bytes)
+     * @param SizeX Width of the image
+     * @param SizeY Height of the image
+     */
+	static UTexture2D* CreateTextureFromPixels(FString AssetName, FString PathOnContentBrowser, const uint8* BGRAPixels, int32 SizeX, int32 SizeY);
+
     /**
      * Import a 3D model from a GDTF file
      * @author Dorian Gardes - Clay Paky S.R.L.
@@ -155,6 +166,13 @@ public:
      * @param FadeOutDuration Default value 0.5s
      */
     static void SendNotification(FString Title, FString Message, SNotificationItem::ECompletionState State, float Duration = 5.0f, float FadeInDuration = 0.5f, float FadeOutDuration = 0.5f);
+
+    /**
+     * Folder of the data used by the checks (golden files, sample GDTFs). It's inside the plugin, so it's versioned with the code it checks
+     *
+     * @return Path of Resources/Tests inside the plugin's folder
+     */
+    static FString GetTestsDirectory();
 };
 
 struct FCPDMXImportGDTFChannelFunction : public FDMXImportGDTFChannelFunction {
@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "CPGDTFInterpolationBenchmark.h"
+#include "CPGDTFInterpolation.h"
+#include "CPGDTFImporterUtils.h"
+#include "ClayPakyGDTFImporterLog.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+
+#define INTERPOLATION_BENCHMARK_DELTA_SECONDS (1.0f / 60.0f)
+#define INTERPOLATION_BENCHMARK_STEPS 600
+#define INTERPOLATION_BENCHMARK_SEED 0xC1A7
+#define INTERPOLATION_BENCHMARK_TOLERANCE 0.0001f
+
+namespace CPGDTFInterpolationBenchmark {
+
+	/// Scripted sequence of targets. Called before each Update() to (maybe) set a new target
+	struct FScenario {
+		const TCHAR* Name;
+		TFunction<void(int32 Step, FRandomStream& Random, FChannelInterpolation& Interpolation)> Drive;
+	};
+
+	/// Pan-like interpolation: 540 degrees of range, 0.5 seconds to fully accelerate and 2.5 seconds to cross the whole range
+	static FChannelInterpolation MakeInterpolation() {
+		FChannelInterpolation Interpolation(0);
+		Interpolation.setFadeAndAcceleration(0.5f, 2.5f, 540.0f);
+		Interpolation.setTargetValue(0); // The first target is a snap
+		return Interpolation;
+	}
+
+	static TArray<FScenario> GetScenarios() {
+		TArray<FScenario> Scenarios;
+		Scenarios.Add({ TEXT("Step"), [](int32 Step, FRandomStream& Random, FChannelInterpolation& Interpolation) {
+			if (Step == 0) Interpolation.setTargetValue(540);
+			if (Step == 300) Interpolation.setTargetValue(10);
+		} });
+		Scenarios.Add({ TEXT("SmallStep"), [](int32 Step, FRandomStream& Random, FChannelInterpolation& Interpolation) {
+			if (Step % 120 == 0) Interpolation.setTargetValue((Step / 120) * 5.0f);
+		} });
+		Scenarios.Add({ TEXT("Ramp"), [](int32 Step, FRandomStream& Random, FChannelInterpolation& Interpolation) {
+			if (Step < 400) Interpolation.setTargetValue(Step * 1.2f);
+		} });
+		Scenarios.Add({ TEXT("RandomWalk"), [](int32 Step, FRandomStream& Random, FChannelInterpolation& Interpolation) {
+			if (Step % 15 == 0) Interpolation.setTargetValue(FMath::Clamp(Interpolation.getTargetValue() + Random.FRandRange(-60.0f, 60.0f), 0.0f, 540.0f));
+		} });
+		Scenarios.Add({ TEXT("ReversalMidFlight"), [](int32 Step, FRandomStream& Random, FChannelInterpolation& Interpolation) {
+			if (Step == 0) Interpolation.setTargetValue(540);
+			if (Step == 45) Interpolation.setTargetValue(0); // Still accelerating
+			if (Step == 200) Interpolation.setTargetValue(400);
+			if (Step == 260) Interpolation.setTargetValue(380); // Target moved closer while moving, forces the deceleration override
+		} });
+		return Scenarios;
+	}
+
+	static TArray<float> RunScenario(const FScenario& Scenario) {
+		FRandomStream Random(INTERPOLATION_BENCHMARK_SEED);
+		FChannelInterpolation Interpolation = MakeInterpolation();
+		TArray<float> Trajectory;
+		Trajectory.Reserve(INTERPOLATION_BENCHMARK_STEPS);
+		for (int32 Step = 0; Step < INTERPOLATION_BENCHMARK_STEPS; Step++) {
+			Scenario.Drive(Step, Random, Interpolation);
+			Interpolation.Update(INTERPOLATION_BENCHMARK_DELTA_SECONDS);
+			Trajectory.Add(Interpolation.getCurrentValue());
+		}
+		return Trajectory;
+	}
+}
+
+FString FCPGDTFInterpolationBenchmark::GetGoldenDirectory() {
+	return FPaths::Combine(FCPGDTFImporterUtils::GetTestsDirectory(), TEXT("InterpolationGolden"));
+}
+
+bool FCPGDTFInterpolationBenchmark::RunConformance(bool bRecord) {
+	using namespace CPGDTFInterpolationBenchmark;
+
+	bool bSuccess = true;
+	for (const FScenario& Scenario : GetScenarios()) {
+		const TArray<float> Trajectory = RunScenario(Scenario);
+		const FString GoldenPath = FPaths::Combine(GetGoldenDirectory(), FString(Scenario.Name) + TEXT(".csv"));
+
+		if (bRecord) {
+			FString Content;
+			for (float Value : Trajectory) Content += FString::Printf(TEXT("%.6f\n"), Value);
+			if (!FFileHelper::SaveStringToFile(Content, *GoldenPath)) {
+				UE_LOG_CPGDTFIMPORTER(Error, TEXT("Interpolation conformance: unable to write '%s'"), *GoldenPath);
+				bSuccess = false;
+			} else UE_LOG_CPGDTFIMPORTER(Display, TEXT("Interpolation conformance: recorded %s"), Scenario.Name);
+			continue;
+		}
+
+		TArray<FString> Golden;
+		if (!FFileHelper::LoadFileToStringArray(Golden, *GoldenPath)) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Interpolation conformance: no golden trajectory for %s in '%s'"), Scenario.Name, *GetGoldenDirectory());
+			bSuccess = false;
+			continue;
+		}
+		if (Golden.Num() != Trajectory.Num()) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Interpolation conformance: %s has %d steps, golden has %d"), Scenario.Name, Trajectory.Num(), Golden.Num());
+			bSuccess = false;
+			continue;
+		}
+		int32 Mismatch = INDEX_NONE;
+		for (int32 i = 0; i < Trajectory.Num() && Mismatch == INDEX_NONE; i++)
+			if (!FMath::IsNearlyEqual(Trajectory[i], FCString::Atof(*Golden[i]), INTERPOLATION_BENCHMARK_TOLERANCE)) Mismatch = i;
+		if (Mismatch != INDEX_NONE) {
+			UE_LOG_CPGDTFIMPORTER(Error, TEXT("Interpolation conformance: %s FAILED at step %d (got %f, expected %s)"), Scenario.Name, Mismatch, Trajectory[Mismatch], *Golden[Mismatch]);
+			bSuccess = false;
+		} else UE_LOG_CPGDTFIMPORTER(Display, TEXT("Interpolation conformance: %s passed"), Scenario.Name);
+	}
+	return bSuccess;
+}
+
+void FCPGDTFInterpolationBenchmark::RunBenchmark() {
+	using namespace CPGDTFInterpolationBenchmark;
+
+	const int32 Sizes[] = { 1, 1000, 100000 };
+	for (int32 Size : Sizes) {
+		FCPGDTFInterpolationEngine Engine;
+		TArray<FCPGDTFInterpolationHandle> Handles;
+		Handles.Reserve(Size);
+		for (int32 i = 0; i < Size; i++) Handles.Add(Engine.Allocate(MakeInterpolation()));
+
+		FRandomStream Random(INTERPOLATION_BENCHMARK_SEED);
+		uint64 Updates = 0;
+		double Elapsed = 0;
+		for (int32 Step = 0; Step < INTERPOLATION_BENCHMARK_STEPS; Step++) {
+			if (Step % 60 == 0) // New targets every second, outside of the measured time
+				for (FCPGDTFInterpolationHandle& Handle : Handles) Handle->setTargetValue(Random.FRandRange(0, 540));
+
+			Updates += Engine.NumAwake();
+			const double Start = FPlatformTime::Seconds();
+			Engine.Advance(INTERPOLATION_BENCHMARK_DELTA_SECONDS);
+			Elapsed += FPlatformTime::Seconds() - Start;
+		}
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Interpolation benchmark: %6d interpolations, %10llu updates in %.4fs, %.2f M updates/s"), Size, Updates, Elapsed, Elapsed > 0 ? Updates / Elapsed / 1000000.0 : 0.0);
+	}
+}
+
+static FAutoConsoleCommand CPGDTFInterpolationConformanceCommand(
+	TEXT("CPGDTF.Interpolation.Conformance"),
+	TEXT("Checks FChannelInterpolation against the golden trajectories. Pass 'record' to (re)write them"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		const bool bRecord = Args.Num() > 0 && Args[0].Equals(TEXT("record"), ESearchCase::IgnoreCase);
+		const bool bSuccess = FCPGDTFInterpolationBenchmark::RunConformance(bRecord);
+		UE_LOG_CPGDTFIMPORTER(Display, TEXT("Interpolation conformance: %s"), bSuccess ? TEXT("OK") : TEXT("FAILED"));
+	})
+);
+
+static FAutoConsoleCommand CPGDTFInterpolationBenchmarkCommand(
+	TEXT("CPGDTF.Interpolation.Benchmark"),
+	TEXT("Measures the FChannelInterpolation updates per second with 1, 1k and 100k interpolations"),
+	FConsoleCommandDelegate::CreateStatic(&FCPGDTFInterpolationBenchmark::RunBenchmark)
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCPGDTFInterpolationConformanceTest, "ClayPaky.GDTF.Interpolation.Conformance", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCPGDTFInterpolationConformanceTest::RunTest(const FString& Parameters) {
+	return FCPGDTFInterpolationBenchmark::RunConformance(false);
+}
+
+#endif
+
+#undef INTERPOLATION_BENCHMARK_DELTA_SECONDS
+#undef INTERPOLATION_BENCHMARK_STEPS
+#undef INTERPOLATION_BENCHMARK_SEED
+#undef INTERPOLATION_BENCHMARK_TOLERANCE
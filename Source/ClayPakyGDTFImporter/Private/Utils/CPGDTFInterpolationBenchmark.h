@@ -0,0 +1,54 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Deterministic conformance checks and microbenchmark of FChannelInterpolation. <br>
+ * Everything runs on the CPU with fixed time steps and no world, so it can be launched from a headless editor (-nullrhi) with the
+ * CPGDTF.Interpolation.Conformance and CPGDTF.Interpolation.Benchmark console commands. The conformance is also the ClayPaky.GDTF.Interpolation.Conformance
+ * automation test. See Docs/Interpolation.md
+ */
+class FCPGDTFInterpolationBenchmark {
+
+public:
+
+	/**
+	 * Runs the scripted target sequences (step, ramp, random walk, reversal mid-flight) and compares each trajectory with the golden one committed with the plugin
+	 *
+	 * @param bRecord If true the golden trajectories are (re)written instead of being checked
+	 * @return True if every trajectory matches its golden one (or has been recorded)
+	 */
+	static bool RunConformance(bool bRecord);
+
+	/**
+	 * Measures the interpolation updates per second with 1, 1k and 100k interpolations moving inside a FCPGDTFInterpolationEngine
+	 */
+	static void RunBenchmark();
+
+	/// Folder where the golden trajectories are stored (Resources/Tests/InterpolationGolden inside the plugin)
+	static FString GetGoldenDirectory();
+};
@@ -25,10 +25,12 @@ SOFTWARE.
 
 #include "CPGDTFImportUI.h"
 
-UCPGDTFImportUI::UCPGDTFImportUI() : bImportXML(true) , bImportTextures(true) , bImportModels(true) {}
+UCPGDTFImportUI::UCPGDTFImportUI() : bImportXML(true) , bImportTextures(true) , bImportModels(true) , bCreateWheelTextureArrays(false) , WheelFrostLevels(0) {}
 
 void UCPGDTFImportUI::ResetToDefault() {
     bImportXML = true;
     bImportTextures = true;
     bImportModels = true;
+    bCreateWheelTextureArrays = false;
+    WheelFrostLevels = 0;
 }
@@ -52,6 +52,14 @@ public:
 
     UPROPERTY(EditAnywhere, Category = "GDTF Import")
     bool bImportModels;
+
+    /// Also save each wheel disk as a texture array (one slice per slot), used by the beams with the WheelTextureArrays kernel option
+    UPROPERTY(EditAnywhere, Category = "GDTF Import")
+    bool bCreateWheelTextureArrays;
+
+    /// Number of frost levels stored in the mips of a frost chain texture of each gobo wheel, replacing its frosted texture. The beams of these fixtures always use the FrostMipChain kernel option. 0 creates the frosted textures instead
+    UPROPERTY(EditAnywhere, Category = "GDTF Import", meta = (ClampMin = "0", ClampMax = "5"))
+    int32 WheelFrostLevels;
 };
 
 
@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CPGDTFBeamLODSubsystem.generated.h"
+
+class ACPGDTFFixtureActor;
+class UCPGDTFBeamSceneComponent;
+
+/// Thresholds used to choose the level of detail of the beams of a fixture. Distances are in cm, screen sizes are the beam radius over the half screen width
+USTRUCT(BlueprintType)
+struct CLAYPAKYGDTFIMPORTER_API FCPGDTFBeamLODSettings {
+
+	GENERATED_BODY()
+
+	/// Under this screen size the raymarch step size is doubled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Beam LOD", meta = (ClampMin = "0"))
+		float ReducedScreenSize = 0.25f;
+
+	/// Under this screen size the biggest raymarch step size is used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Beam LOD", meta = (ClampMin = "0"))
+		float FarScreenSize = 0.05f;
+
+	/// Beyond this distance the spotlights are hidden. 0 to never hide them
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Beam LOD", meta = (ClampMin = "0"))
+		float SpotlightsMaxDistance = 10000.0f;
+
+	/// Beyond this distance the pointlight is hidden. 0 to never hide it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Beam LOD", meta = (ClampMin = "0"))
+		float PointLightMaxDistance = 5000.0f;
+
+	/// Beyond this distance the volumetric beam is hidden and only the lens is rendered. 0 to never hide it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Beam LOD", meta = (ClampMin = "0"))
+		float BeamMaxDistance = 30000.0f;
+
+	/// Relative margin around each threshold. A beam changes level only when it crosses the threshold by this margin, to avoid popping
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Beam LOD", meta = (ClampMin = "0", ClampMax = "0.9"))
+		float Hysteresis = 0.1f;
+};
+
+/**
+ * Chooses the level of detail of the beams of all the fixtures of a world, from their distance and screen size as seen by the nearest view. <br>
+ * The views are the cameras of the local players or, when the world has none (Simulate in editor, nDisplay cluster nodes), the locations rendered in the last frame. <br>
+ * Each frame at most BeamsPerFrame beams, picked round-robin, are evaluated. See FCPGDTFBeamLODSettings for the thresholds
+ */
+UCLASS()
+class CLAYPAKYGDTFIMPORTER_API UCPGDTFBeamLODSubsystem : public UTickableWorldSubsystem {
+
+	GENERATED_BODY()
+
+protected:
+
+	/// Fixtures using the beam LOD
+	UPROPERTY()
+	TArray<ACPGDTFFixtureActor*> Fixtures;
+
+	struct FBeamEntry {
+		TWeakObjectPtr<ACPGDTFFixtureActor> Fixture;
+		TWeakObjectPtr<UCPGDTFBeamSceneComponent> Beam;
+	};
+	TArray<FBeamEntry> Beams;
+	/// Next entry to be evaluated by the round-robin
+	int32 Cursor = 0;
+	bool bBeamsDirty = false;
+
+	void RebuildBeams();
+
+	/**
+	 * Collects the locations the world is seen from
+	 *
+	 * @param OutViewLocations Locations of the cameras
+	 * @return 1 / tan(FOV / 2) of the narrowest camera (where the beams look biggest), or of a 90° FOV when only the rendered locations are known
+	 */
+	float GatherViews(TArray<FVector>& OutViewLocations) const;
+
+	/**
+	 * Chooses the level of detail of a beam
+	 *
+	 * @param Beam Beam to update
+	 * @param Settings Thresholds of the fixture
+	 * @param ViewLocations Locations of the cameras, the nearest one is used
+	 * @param ScreenMultiplier 1 / tan(FOV / 2) of the cameras
+	 */
+	static void UpdateBeamLOD(UCPGDTFBeamSceneComponent* Beam, const FCPGDTFBeamLODSettings& Settings, const TArray<FVector>& ViewLocations, float ScreenMultiplier);
+
+public:
+
+	/// Max number of beams evaluated each frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX|Beam LOD")
+	int32 BeamsPerFrame = 256;
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterFixture(ACPGDTFFixtureActor* Fixture);
+	void UnregisterFixture(ACPGDTFFixtureActor* Fixture);
+};
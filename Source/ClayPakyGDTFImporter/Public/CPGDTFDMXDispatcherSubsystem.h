@@ -0,0 +1,139 @@
+﻿/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CPGDTFDMXDispatcherSubsystem.generated.h"
+
+class ACPGDTFFixtureActor;
+class UCPGDTFFixtureComponentBase;
+class UDMXEntityFixturePatch;
+class UDMXLibrary;
+
+/**
+ * Dispatches the incoming DMX packets at the universe level. <br>
+ * Each frame is compared with the previous one of the same universe, and only the components patched on the bytes that changed are woken up.
+ * Fixture actors register themselves on BeginPlay and forward their OnDMXReceivedRaw events here.
+ */
+UCLASS()
+class CLAYPAKYGDTFIMPORTER_API UCPGDTFDMXDispatcherSubsystem : public UWorldSubsystem {
+
+	GENERATED_BODY()
+
+protected:
+
+	/// Bytes of the universe read by a component
+	struct FCPDMXComponentRange {
+		/// First byte in the universe (0 based)
+		int32 First;
+		/// Last byte in the universe (0 based, included)
+		int32 Last;
+		/// Index of the first channel of the fixture patch in the universe
+		int32 PatchOffset;
+		/// Last dispatch that woke the component, to avoid pushing the same frame twice
+		uint32 LastDispatch;
+		TWeakObjectPtr<UCPGDTFFixtureComponentBase> Component;
+		TWeakObjectPtr<ACPGDTFFixtureActor> Fixture;
+	};
+
+	/// Interval index of the components patched on a universe, and last frame received on it
+	struct FCPDMXUniverseState {
+		TArray<uint8> PreviousFrame;
+		/// Sorted by First
+		TArray<FCPDMXComponentRange> Ranges;
+		/// Longest range, used to bound the interval search
+		int32 MaxRangeLength = 0;
+		uint32 DispatchCounter = 0;
+	};
+
+	typedef TPair<const UDMXLibrary*, int32> FCPDMXUniverseKey;
+
+	TMap<FCPDMXUniverseKey, FCPDMXUniverseState> Universes;
+	/// Universe of each registered fixture
+	TMap<const ACPGDTFFixtureActor*, FCPDMXUniverseKey> FixturesUniverse;
+	/// Fixtures registered after the last frame of their universe, they have to receive the whole packet once
+	TSet<const ACPGDTFFixtureActor*> PendingFullPush;
+
+	uint64 FramesReceived = 0;
+	uint64 BytesChanged = 0;
+	uint64 ComponentsWoken = 0;
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Adds the DMX components of a fixture to the interval index of its universe
+	 *
+	 * @param Fixture Fixture to register. Its components must have already begun play
+	 * @param FixturePatch Patch of the fixture
+	 */
+	void RegisterFixture(ACPGDTFFixtureActor* Fixture, UDMXEntityFixturePatch* FixturePatch);
+
+	/**
+	 * Removes a fixture from the interval index
+	 */
+	void UnregisterFixture(ACPGDTFFixtureActor* Fixture);
+
+	/**
+	 * Handles a DMX packet received by a fixture: diffs its universe against the previous frame and pushes the values
+	 * to the components patched on the changed bytes, whatever the fixture they belong to.
+	 *
+	 * @param Fixture Fixture that received the packet
+	 * @param FixturePatch Patch of the fixture
+	 */
+	void DispatchDMXPacket(ACPGDTFFixtureActor* Fixture, UDMXEntityFixturePatch* FixturePatch);
+
+	/// Number of DMX packets handled since the start of the level
+	UFUNCTION(BlueprintCallable, Category = "DMX Dispatcher")
+		int64 GetFramesReceived() const { return (int64)this->FramesReceived; }
+
+	/// Number of DMX bytes that changed between two frames since the start of the level
+	UFUNCTION(BlueprintCallable, Category = "DMX Dispatcher")
+		int64 GetBytesChanged() const { return (int64)this->BytesChanged; }
+
+	/// Number of times a component received new DMX values since the start of the level
+	UFUNCTION(BlueprintCallable, Category = "DMX Dispatcher")
+		int64 GetComponentsWoken() const { return (int64)this->ComponentsWoken; }
+
+	UFUNCTION(BlueprintCallable, Category = "DMX Dispatcher")
+		void ResetCounters();
+
+protected:
+
+	/**
+	 * Compares two frames a word at a time and returns the ranges of bytes that changed
+	 *
+	 * @param Previous Previous frame
+	 * @param Current Current frame, same size of Previous
+	 * @param Num Number of bytes to compare
+	 * @param OutRanges First and last (included) byte of each changed range
+	 */
+	static void FindDirtyRanges(const uint8* Previous, const uint8* Current, int32 Num, TArray<TPair<int32, int32>, TInlineAllocator<16>>& OutRanges);
+
+	/// Pushes the whole universe to all the components of a fixture, used when we can't diff the frames
+	void PushToFixture(ACPGDTFFixtureActor* Fixture, const struct FCPDMXUniverseView& UniverseView);
+};
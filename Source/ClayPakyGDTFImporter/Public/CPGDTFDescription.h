@@ -69,6 +69,23 @@ namespace CPGDTFDescription {
 		return static_cast<ECPGDTFAttributeType>(StaticEnum<ECPGDTFAttributeType>()->GetValueByName(FName(*EditedString)));
 	}
 
+	/**
+	 * Interned version of GetGDTFAttributeTypeValueFromString.
+	 * The first lookup of a name parses it, the following ones are a single hash map lookup without any allocation.
+	 *
+	 * @param AttributeName GDTF name of the attribute (eg. Blade1A)
+	 * @returns The attribute type (eg. Blade_n_A)
+	 */
+	CLAYPAKYGDTFIMPORTER_API ECPGDTFAttributeType GetGDTFAttributeTypeValueFromName(const FName& AttributeName);
+
+	/**
+	 * Returns the index number contained in an attribute name (eg. 1 for Blade1A, 2 for Gobo2WheelIndex). Interned as GetGDTFAttributeTypeValueFromName.
+	 *
+	 * @param AttributeName GDTF name of the attribute
+	 * @returns The first number found in the name, 0 if there is none
+	 */
+	CLAYPAKYGDTFIMPORTER_API int32 GetGDTFAttributeIndexFromName(const FName& AttributeName);
+
 	/**
 	 * Parses a GDTF Matrix
 	 * @author Dorian Gardes - Clay Paky S.R.L.
@@ -391,6 +408,47 @@ public:
 };
 
 
+  /***************************************************/
+ /*        Physical descriptions definitions        */
+/***************************************************/
+
+/**
+ * Spectral measurement of an emitter. <br>
+ * The points are stored as two parallel arrays instead of FDMXImportGDTFEmitter::Measurement: far lighter to store and to show in the editor
+ */
+USTRUCT(BlueprintType)
+struct FCPGDTFEmitterSpectrum {
+
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX");
+		FName Emitter;
+
+	/// Physical value of the DMX channel at which the measurement was done, the highest one if the emitter has several measurements
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX");
+		float Physical = 0;
+
+	/// In candela, 0 if not specified
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX");
+		float LuminousIntensity = 0;
+
+	/// In nanometers, same size than Energies
+	UPROPERTY()
+		TArray<float> WaveLengths;
+
+	/// Spectral energy at each wavelength
+	UPROPERTY()
+		TArray<float> Energies;
+
+	/// CIE 1931 XYZ of the emitter at full power, computed at import. Y is the luminous intensity (candela) if the measurement specifies it, otherwise it's in the unit of the measured energies
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX");
+		FVector3f XYZ = FVector3f::ZeroVector;
+
+	bool IsValid() const { return this->WaveLengths.Num() > 0 && this->XYZ.Y > 0; }
+};
+
   /***************************************************/
  /*             Geometries definitions              */
 /***************************************************/
@@ -746,10 +804,20 @@ struct FCPGDTFDescriptionChannelFunction : public FDMXImportGDTFChannelFunction
 		this->ModeTo = PreviousChannelFunction.ModeTo;
 		this->ChannelSets = PreviousChannelFunction.ChannelSets;
 		this->DMXTo = _DMXTo;
+		this->AttributeType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(this->Attribute.Name);
+		this->AttributeIndex = CPGDTFDescription::GetGDTFAttributeIndexFromName(this->Attribute.Name);
 	}
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX");
 		FDMXImportGDTFDMXValue DMXTo;
+
+	/// Attribute type resolved once from Attribute.Name, so we don't have to parse it on each DMX packet
+	UPROPERTY(VisibleAnywhere, Category = "DMX");
+		ECPGDTFAttributeType AttributeType = ECPGDTFAttributeType::DefaultValue;
+
+	/// Index number contained in the attribute name (eg. 1 for Blade1A), 0 if there is none
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX");
+		int32 AttributeIndex = 0;
 };
 
 /// Implementation of ChannelSet GDTF node
@@ -790,6 +858,18 @@ public:
 	}
 
 	FString GetFixtureSavePath();
+
+	/// Spectra of the emitters used by the DMX channels which have a measurement, by emitter name
+	UPROPERTY(VisibleAnywhere, Category = "DMX")
+		TMap<FName, FCPGDTFEmitterSpectrum> EmitterSpectra;
+
+	/**
+	 * Find the spectrum of an emitter
+	 *
+	 * @param Emitter Name of the emitter
+	 * @return Null if the emitter has no measurement
+	 */
+	const FCPGDTFEmitterSpectrum* FindEmitterSpectrum(FName Emitter) const;
 };
 
 /// @}
\ No newline at end of file
@@ -27,12 +27,18 @@ SOFTWARE.
 #include "CoreMinimal.h"
 #include "CPGDTFDescription.h"
 #include "Components/CPGDTFBeamSceneComponent.h"
+#include "CPGDTFBeamLODSubsystem.h"
 #include "Utils/CPFActorGeometryTree.h"
 #include "Game/DMXComponent.h"
 #include "DMXTypes.h"
 
 #include "CPGDTFFixtureActor.generated.h"
 
+class UCPGDTFFixtureComponentBase;
+class UCPGDTFAdditiveColorFixtureComponent;
+class UCPGDTFSubstractiveColorFixtureComponent;
+class UCPGDTFColorWheelFixtureComponent;
+
 UENUM()
 enum ECPGDTFFixtureQualityLevel
 {
@@ -58,6 +64,31 @@ protected:
 
 	void UpdateProperties();
 
+	/// Components that give the color to a beam, in evaluation order
+	struct FCPBeamTickSchedule {
+		UCPGDTFBeamSceneComponent* Beam;
+		TArray<UCPGDTFAdditiveColorFixtureComponent*> AdditiveSources;
+		TArray<UCPGDTFSubstractiveColorFixtureComponent*> SubstractiveSources;
+		/// Same size of SubstractiveSources. Contains the filter casted to a color wheel, or nullptr if it isn't one
+		TArray<UCPGDTFColorWheelFixtureComponent*> ColorWheels;
+		/// Color computed by ComputeBeamColors() and applied to the beam by TickPostPass()
+		FLinearColor StagedColor = FLinearColor(1, 1, 1, 1);
+	};
+
+	/// Color composition of each beam
+	TArray<FCPBeamTickSchedule> BeamTickSchedules;
+	/// Color sources attached to at least one beam. Each one is interpolated once per tick, before the beam colors are computed
+	TArray<UCPGDTFFixtureComponentBase*> ColorSourcesTickSchedule;
+	/// Color corrections first, then all the other components. Interpolated after the beam colors are computed
+	TArray<UCPGDTFFixtureComponentBase*> OtherComponentsTickSchedule;
+	/// False if the schedule has to be rebuilt. The fixture and beam components invalidate it when they're registered or unregistered
+	bool bTickScheduleValid = false;
+
+	/**
+	 * Builds the per-beam arrays iterated by Tick(), so we don't have to search and filter the components each frame
+	 */
+	void BuildTickSchedule();
+
 public:
 
 	//@param FixturePackagePath Path of the package (folder) containing the fixture assets. For example: "/Game/ClayPaky_MiniB"
@@ -71,7 +102,6 @@ public:
 	void Tick(float DeltaTime); // Called every frame
 	//~ End AActor Interface
 
-	FTimerHandle CheckOcclusionTimer;
 	FActorGeometryTree GeometryTree;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Internal)
@@ -90,6 +120,12 @@ public:
 
 	FString getClassNameFromMode(FString modeName); //Returns the name of the class of this same fixture, but with the specified mode name
 
+	/// Registers again the fixture on the DMX dispatcher, so its components ranges follow the current patch and mode
+	void RefreshDMXDispatcherRegistration();
+
+	/// DMX channels of the current mode of the fixture. Empty if the description or the mode are missing
+	TArrayView<const FDMXImportGDTFDMXChannel> GetCurrentDMXChannels() const;
+
 	/**
 	 * Setup the actor for a specific GDTFDescription.
 	 * Used during the generation of the Asset by the GDTFFactory.
@@ -109,6 +145,23 @@ public:
 	 */
 	void CreateRenderingPipelines(UCPGDTFDescription* FixtureGDTFDescription);
 
+	/// Forces Tick() to rebuild its schedule. Adding or removing components already does it automatically
+	FORCEINLINE void InvalidateTickSchedule() { this->bTickScheduleValid = false; }
+
+	/*
+	 * Tick stages. Tick() runs them in order for this fixture, while UCPGDTFFixtureManagerSubsystem runs each stage for all the fixtures before moving to the next one.
+	 * Between TickPrePass() and TickColorSourcesPostPass() the world's FCPGDTFInterpolationEngine has to be advanced.
+	 */
+
+	/// Game thread. Running effects of the components, which may set new interpolation targets
+	void TickPrePass(float DeltaTime);
+	/// Game thread. Sends the interpolated values of the color sources to the beams and updates their current color
+	void TickColorSourcesPostPass(float DeltaTime);
+	/// Any thread. Blends the color sources of each beam into its staged color. Doesn't write anything outside of the tick schedule
+	void ComputeBeamColors();
+	/// Game thread. Applies the staged colors to the lights, sends the interpolated values of the other components to the beams and flushes them (light visibility included)
+	void TickPostPass(float DeltaTime);
+
 	/*******************************************************
 	 *                   END OF C++ ONLY                   *
 	 *******************************************************
@@ -135,10 +188,29 @@ public:
 
 	// PARAMETERS---------------------------------
 
-	/// Simple solution useful for walls, 1 linetrace from the center
+	/// Simple solution useful for walls, 1 linetrace from the center. The traces of all the fixtures are scheduled by UCPGDTFOcclusionSubsystem
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX Light Fixture")
 		bool UseDynamicOcclusion;
 
+	/// If true the fixture is ticked by the UCPGDTFFixtureManagerSubsystem together with the other fixtures of the world, instead of ticking by itself. Faster on large rigs, but the fixture no longer follows its own tick group and prerequisites
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, AdvancedDisplay, Category = "DMX Light Fixture")
+		bool bTickInFixtureManager = false;
+
+	/// Lights used by each beam. The single spotlight modes cost less on large rigs, but colors are given per beam and not per pixel of the light function. Applied on BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Light Fixture")
+		ECPGDTFBeamLightMode BeamLightMode = ECPGDTFBeamLightMode::RGBSpotlights;
+
+	/// Optimizations of the beams raymarch, to trade quality for GPU cost. They're compiled in the beam material: editing them builds the pipeline of the current mode for this combination and points the beams of this actor to its material instances
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Light Fixture")
+		FCPGDTFBeamKernelOptions BeamKernelOptions;
+
+	/// If true the raymarch quality and the lights of the beams are reduced with the distance from the camera by UCPGDTFBeamLODSubsystem
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Light Fixture")
+		bool bUseBeamLOD = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX Light Fixture", meta = (EditCondition = "bUseBeamLOD"))
+		FCPGDTFBeamLODSettings BeamLODSettings;
+
 	/// DMX COMPONENT
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX Light Fixture")
 		class UDMXComponent* DMX;
@@ -197,7 +269,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DMX Fixture")
 		void SetLightCastShadow(bool bLightShouldCastShadow);
 
-	/// Call to check dynamic occlusion
+	/// Asks the occlusion subsystem to trace the beams again on its next tick, even if they didn't move
 	UFUNCTION(BlueprintCallable, Category = "DMX Fixture")
 		void CheckOcclusion();
+
+	/// Number of light components of the beams that are added to the scene
+	UFUNCTION(BlueprintPure, Category = "DMX Fixture")
+		int32 GetActiveLightsNum() const;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CPGDTFFixtureManagerSubsystem.generated.h"
+
+class ACPGDTFFixtureActor;
+
+/**
+ * Ticks all the fixtures of a world together, stage by stage. <br>
+ * The game thread stages (running effects, sending values to the materials and lights) are run fixture by fixture, while the interpolations
+ * of the whole world and the color blending of each fixture are computed in parallel. See ACPGDTFFixtureActor::Tick() for the stages. <br>
+ * Only these two stages are pure: the effects and the color sources go through the components (UObjects, lights, material parameter blocks
+ * shared by the components of a beam) and stay on the game thread until they're split into a compute and a write part
+ */
+UCLASS()
+class CLAYPAKYGDTFIMPORTER_API UCPGDTFFixtureManagerSubsystem : public UTickableWorldSubsystem {
+
+	GENERATED_BODY()
+
+protected:
+
+	/// Fixtures in registration order
+	UPROPERTY()
+	TArray<ACPGDTFFixtureActor*> Fixtures;
+
+public:
+
+	/// If false every stage is run on the game thread
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX|Fixture Manager")
+	bool bParallelEvaluation = true;
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterFixture(ACPGDTFFixtureActor* Fixture);
+	void UnregisterFixture(ACPGDTFFixtureActor* Fixture);
+
+	/// Number of fixtures ticked by the manager
+	UFUNCTION(BlueprintPure, Category = "DMX|Fixture Manager")
+	int32 GetFixturesNum() const { return this->Fixtures.Num(); }
+};
@@ -24,7 +24,7 @@ SOFTWARE.
 
 #pragma once
 
-#include "HAL/CriticalSection.h"
+#include "CoreGlobals.h"
 #include "Misc/AssertionMacros.h"
 #include "ClayPakyGDTFImporterLog.h"
 #include "CPGDTFInterpolation.generated.h"
@@ -133,6 +133,7 @@ private:
 				setCurrentAcceleration(-acceleration * currentDirection);
 		}
 	};
+
 public:
 	/// Last value assumed from the "physical" parameter controlled by this interpolation
 	float lastValue;
@@ -165,8 +166,6 @@ private:
 
 	//Current acceleration and speed status
 	InterpolationStatus currentStatus;
-	//Lock struct
-	FCriticalSection *criticalSection = nullptr;
 
 	//previous movement status, so if in the previous tick we were acelerating/at max speed or decelerating/stopped
 	bool oldMovementStatus;
@@ -178,13 +177,6 @@ private:
 		return FMath::RoundToInt(n * precision);
 	}
 
-	inline void aquireLock(){
-		criticalSection->Lock();
-	}
-	inline void releaseLock(){
-		criticalSection->Unlock();
-	}
-
 	//starts acelerating the interpolation
 	FORCEINLINE void start() {
 		currentStatus.start(acceleration);
@@ -266,7 +258,7 @@ public:
 		return currentStatus.currentDirection == FORWARD ? cv > targetValueNoPrecision : cv < targetValueNoPrecision;
 	}
 	//Check if the interpolation is still going
-	inline bool IsUpdating() {
+	inline bool IsUpdating() const {
 		return CurrentValue != TargetValue;
 	}
 	//Checks if the interpolation is done by checking if the difference between the current and the target value is less then the space we're gonna move during this tick
@@ -294,18 +286,14 @@ public:
 
 	/// Set current value without any interpolation
 	inline void SetValueNoInterp(float NewValue) {
-		aquireLock();
 		__setTargetValue_noLocks(NewValue, false);
 		__EndInterpolation_noLocks(true);
-		releaseLock();
 	}
 
 	// Moves both CurrentValue and TargetValue by the same offset, without stopping the interpolation
 	inline void offset(float offset) {
-		aquireLock();
 		__setTargetValue_noLocks(TargetValue + offset, false);
 		CurrentValue += offset;
-		releaseLock();
 	}
 
 	/**
@@ -332,11 +320,9 @@ public:
 
 	//Sets the max speed, expressed in value per second
 	FORCEINLINE void setMaxSpeed(float _maxSpeed) {
-		aquireLock();
 		_maxSpeed = FMath::Abs(_maxSpeed);
 		this->maxPhysicalSpeed = _maxSpeed;
 		this->realFade = -1;
-		releaseLock();
 	}
 	//Gets the max speed, expressed in value per second
 	FORCEINLINE float getMaxSpeed() {
@@ -344,12 +330,10 @@ public:
 	}
 	//Sets the acceleration, expressed in normalized speed per second
 	inline void setAcceleration(float _acceleration) {
-		aquireLock();
 		_acceleration = FMath::Abs(_acceleration);
 		this->timeToFullyAccelerate = 1 / _acceleration;
 		this->acceleration = _acceleration;
 		this->realFade = -1;
-		releaseLock();
 	}
 	//Gets the acceleration, expressed in normalized speed per second
 	FORCEINLINE float getAcceleration() {
@@ -358,16 +342,14 @@ public:
 	//Sets the target value. If it hasn't been set yet, we snap directly to it. If we're moving by just a little bit, we slow down our max normalized speed to get a smooth fade
 	void __setTargetValue_noLocks(float value, bool checkSpeedCap = true);
 	inline void setTargetValue(float value) {
-		aquireLock();
 		__setTargetValue_noLocks(value);
-		releaseLock();
 	}
 	//Obtains the target value
-	FORCEINLINE float getTargetValue() {
+	FORCEINLINE float getTargetValue() const {
 		return TargetValue;
 	}
 	//Obtains the current value
-	FORCEINLINE float getCurrentValue() {
+	FORCEINLINE float getCurrentValue() const {
 		return CurrentValue;
 	}
 
@@ -382,15 +364,108 @@ private:
 public:
 	//Ends the interpolation. If snapToTargetValue is true, we jump directly to the target value, otherwise we stop with the current target value
 	inline void EndInterpolation(bool snapToTargetValue = true) {
-		aquireLock();
 		__EndInterpolation_noLocks(snapToTargetValue);
-		releaseLock();
 	}
 
 	//Advance the interpolation of one tick
 	inline void Update(float DeltaSeconds) {
-		aquireLock();
 		__Update_noLocks(DeltaSeconds);
-		releaseLock();
 	}
-};
\ No newline at end of file
+};
+
+class FCPGDTFInterpolationEngine;
+
+/// Handle to an interpolation stored inside a FCPGDTFInterpolationEngine. Obtained from FCPGDTFInterpolationEngine::Allocate()
+struct CLAYPAKYGDTFIMPORTER_API FCPGDTFInterpolationHandle {
+
+	FCPGDTFInterpolationEngine* Engine = nullptr;
+	int32 Index = INDEX_NONE;
+
+	FORCEINLINE bool IsValid() const { return Engine != nullptr && Index != INDEX_NONE; }
+
+	/// Access to the interpolation. The interpolation is woken up, so it will be updated on the next FCPGDTFInterpolationEngine::Advance()
+	FChannelInterpolation* operator->() const;
+	/// Read-only access to the interpolation. It doesn't wake it up
+	const FChannelInterpolation& Peek() const;
+	/// Access to the fields that don't affect the movement (eg. lastValue). It doesn't wake it up
+	FChannelInterpolation& GetNoWake() const;
+};
+
+/**
+ * Batched storage of all the interpolations of a world. <br>
+ * Interpolations are stored contiguously, and only the ones that have been touched since they stopped moving (the "awake" ones) are updated by Advance(),
+ * in a single pass per frame. Each interpolation is updated with FChannelInterpolation::Update(), see Docs/Interpolation.md <br>
+ * The bookkeeping (awake, used, last update frame) is kept in parallel arrays, while the state of each interpolation stays in one FChannelInterpolation,
+ * since Update() reads and writes most of its fields for every step.
+ */
+class CLAYPAKYGDTFIMPORTER_API FCPGDTFInterpolationEngine {
+
+private:
+	/// Interpolation objects, indexed by FCPGDTFInterpolationHandle::Index
+	TArray<FChannelInterpolation> Interpolations;
+	/// 1 if the interpolation at the same index is in AwakeList
+	TArray<uint8> AwakeFlags;
+	/// 1 if the slot at the same index is used
+	TArray<uint8> UsedFlags;
+	/// Indexes of the interpolations to update on the next Advance()
+	TArray<int32> AwakeList;
+	/// Released slots that can be reused
+	TArray<int32> FreeSlots;
+	/// Value of GFrameCounter when the interpolation at the same index was last updated by AdvanceOncePerFrame() or AdvanceHandles()
+	TArray<uint64> UpdatedFrames;
+	/// Value of GFrameCounter during the last Sweep()
+	uint64 LastSweptFrame = MAX_uint64;
+
+	/// Updates the awake interpolations. If bOncePerFrame is true the ones already updated in this frame are skipped
+	void AdvanceAwake(float DeltaSeconds, bool bParallel, bool bOncePerFrame);
+	/// Removes from AwakeList the interpolations that reached their target
+	void Sweep();
+
+public:
+	~FCPGDTFInterpolationEngine() { Empty(); }
+
+	/**
+	 * Stores a new interpolation and returns its handle.
+	 *
+	 * @param Interpolation Initialized interpolation to store
+	 */
+	FCPGDTFInterpolationHandle Allocate(const FChannelInterpolation& Interpolation);
+	/// Releases the slot of an interpolation and invalidates the handle
+	void Release(FCPGDTFInterpolationHandle& Handle);
+	/// Releases all the interpolations
+	void Empty();
+
+	/// Marks an interpolation to be updated on the next Advance(). Game thread only
+	FORCEINLINE void Wake(int32 Index) {
+		if (AwakeFlags[Index]) return;
+		AwakeFlags[Index] = 1;
+		AwakeList.Add(Index);
+	}
+	FORCEINLINE FChannelInterpolation& Get(int32 Index) { Wake(Index); return Interpolations[Index]; }
+	FORCEINLINE FChannelInterpolation& GetNoWake(int32 Index) { return Interpolations[Index]; }
+
+	/**
+	 * Updates all the awake interpolations of one tick. The interpolations that reached their target go back to sleep
+	 *
+	 * @param bParallel If true and there are enough awake interpolations, they're updated in chunks on the task graph. Interpolations are independent, so the result doesn't change
+	 */
+	void Advance(float DeltaSeconds, bool bParallel = false);
+	/// Same as Advance(), but each interpolation is updated at most once per frame: the ones already updated in this frame (eg. by AdvanceHandles()) are skipped
+	void AdvanceOncePerFrame(float DeltaSeconds, bool bParallel = false);
+	/**
+	 * Updates only some interpolations, if they're awake and haven't been updated yet in this frame.
+	 * Used by the fixtures ticking by themselves, so the targets set by their running effects are consumed in the same frame without advancing the other fixtures too early
+	 *
+	 * @param Handles Interpolations to update
+	 */
+	void AdvanceHandles(TArrayView<const FCPGDTFInterpolationHandle> Handles, float DeltaSeconds);
+
+	/// Number of interpolations currently stored
+	FORCEINLINE int32 Num() const { return Interpolations.Num() - FreeSlots.Num(); }
+	/// Number of interpolations that will be updated on the next Advance()
+	FORCEINLINE int32 NumAwake() const { return AwakeList.Num(); }
+};
+
+FORCEINLINE FChannelInterpolation* FCPGDTFInterpolationHandle::operator->() const { return &Engine->Get(Index); }
+FORCEINLINE const FChannelInterpolation& FCPGDTFInterpolationHandle::Peek() const { return Engine->GetNoWake(Index); }
+FORCEINLINE FChannelInterpolation& FCPGDTFInterpolationHandle::GetNoWake() const { return Engine->GetNoWake(Index); }
@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CPGDTFInterpolation.h"
+#include "CPGDTFInterpolationSubsystem.generated.h"
+
+/**
+ * Owns the FCPGDTFInterpolationEngine of a world. <br>
+ * Fixture components allocate their interpolations here on BeginPlay and release them on EndPlay.
+ */
+UCLASS()
+class CLAYPAKYGDTFIMPORTER_API UCPGDTFInterpolationSubsystem : public UWorldSubsystem {
+
+	GENERATED_BODY()
+
+protected:
+
+	FCPGDTFInterpolationEngine Engine;
+
+public:
+
+	virtual void Deinitialize() override;
+
+	FORCEINLINE FCPGDTFInterpolationEngine* GetEngine() { return &this->Engine; }
+
+	/// Number of interpolations allocated in the world
+	UFUNCTION(BlueprintPure, Category = "DMX|Interpolation")
+	int32 GetInterpolationsNum() const { return this->Engine.Num(); }
+
+	/// Number of interpolations that are still moving and will be updated on the next frame
+	UFUNCTION(BlueprintPure, Category = "DMX|Interpolation")
+	int32 GetAwakeInterpolationsNum() const { return this->Engine.NumAwake(); }
+};
@@ -0,0 +1,107 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "CPGDTFOcclusionSubsystem.generated.h"
+
+class ACPGDTFFixtureActor;
+class UCPGDTFBeamSceneComponent;
+
+/**
+ * Computes the dynamic occlusion of the beams of all the fixtures of a world. <br>
+ * Each frame at most MaxTracesPerFrame beams, picked round-robin, are traced asynchronously along their Occlusion arrow. When a trace completes
+ * the length of the beam is sent to its material. Beams that are blacked out, or didn't move since their last trace, are skipped
+ */
+UCLASS()
+class CLAYPAKYGDTFIMPORTER_API UCPGDTFOcclusionSubsystem : public UTickableWorldSubsystem {
+
+	GENERATED_BODY()
+
+protected:
+
+	struct FBeamEntry {
+		/// Not owned: the fixtures are kept by the Fixtures array, the beams may be destroyed at any time with their fixture's components
+		TWeakObjectPtr<ACPGDTFFixtureActor> Fixture;
+		TWeakObjectPtr<UCPGDTFBeamSceneComponent> Beam;
+		/// Identifies the entry in the traces user data, since the entries are rebuilt when the fixtures change
+		uint32 Id;
+		/// Trace in flight, if any
+		FTraceHandle PendingTrace;
+		/// Origin and direction of the last trace. A beam is traced again only if they changed
+		FVector LastStart = FVector::ZeroVector;
+		FVector LastDirection = FVector::ZeroVector;
+		bool bHasResult = false;
+	};
+
+	/// Fixtures using the dynamic occlusion
+	UPROPERTY()
+	TArray<ACPGDTFFixtureActor*> Fixtures;
+
+	/// Beams of the fixtures, in scheduling order
+	TArray<FBeamEntry> Beams;
+	/// Index in Beams of each entry Id
+	TMap<uint32, int32> BeamsById;
+	uint32 NextBeamId = 0;
+	/// Next entry to be considered by the round-robin
+	int32 Cursor = 0;
+	bool bBeamsDirty = false;
+
+	FTraceDelegate TraceDelegate;
+
+	/// Rebuilds the Beams array from the registered fixtures, keeping the state of the beams already known
+	void RebuildBeams();
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+public:
+
+	/// Max number of traces started each frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX|Occlusion")
+	int32 MaxTracesPerFrame = 32;
+
+	/// If true the beams are scheduled in an order given by FixedSeed, so runs with the same fixtures are reproducible. Otherwise the order is randomized at each rebuild
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX|Occlusion")
+	bool bUseFixedSeed = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX|Occlusion")
+	int32 FixedSeed = 0;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterFixture(ACPGDTFFixtureActor* Fixture);
+	void UnregisterFixture(ACPGDTFFixtureActor* Fixture);
+
+	/// Forgets the last traces of the beams of a fixture, so they're traced again even if they didn't move
+	void InvalidateFixture(ACPGDTFFixtureActor* Fixture);
+
+	/// Number of beams using the dynamic occlusion
+	UFUNCTION(BlueprintPure, Category = "DMX|Occlusion")
+	int32 GetBeamsNum() const { return this->Beams.Num(); }
+};
@@ -31,9 +31,93 @@ SOFTWARE.
 #include "Materials/MaterialInstanceDynamic.h"
 
 #include "CPGDTFDescription.h"
+#include "Utils/CPGDTFBeamParameterBlock.h"
 
 #include "CPGDTFBeamSceneComponent.generated.h"
 
+class CPGDTFRenderPipelineBuilder;
+
+/// Lights used by each beam to light the scene
+UENUM(BlueprintType)
+enum class ECPGDTFBeamLightMode : uint8 {
+	/// One spotlight per color channel (each one masking its channel of the light function) and a pointlight. Colored gobos are rendered correctly
+	RGBSpotlights			UMETA(DisplayName = "RGB Spotlights"),
+	/// A single white-masked spotlight colored by the DMX Color, and a pointlight
+	SingleSpotlight			UMETA(DisplayName = "Single Spotlight"),
+	/// A single white-masked spotlight colored by the DMX Color, without pointlight
+	SingleSpotlightOnly		UMETA(DisplayName = "Single Spotlight (no Pointlight)")
+};
+
+/// Level of detail of a beam, chosen by UCPGDTFBeamLODSubsystem from its distance and screen size
+UENUM(BlueprintType)
+enum class ECPGDTFBeamLOD : uint8 {
+	/// Raymarch quality set by the fixture
+	Full		UMETA(DisplayName = "Full"),
+	/// Doubled raymarch step size
+	Reduced		UMETA(DisplayName = "Reduced"),
+	/// Biggest raymarch step size
+	Far			UMETA(DisplayName = "Far")
+};
+
+/// Bits of FCPGDTFBeamKernelOptions, as used by the beam HLSL generator
+namespace ECPGDTFBeamKernelFlags {
+	enum Type : uint8 {
+		None				= 0,
+		AdaptiveSteps		= 1 << 0,
+		EarlyTermination	= 1 << 1,
+		HoistInvariants		= 1 << 2,
+		FastPow				= 1 << 3,
+		JitteredLowSteps	= 1 << 4,
+		WheelTextureArrays	= 1 << 5,
+		FrostMipChain		= 1 << 6
+	};
+}
+
+/// Optional optimizations of the beam raymarch kernel. They change the generated beam material: each combination has its own material instances (see CPGDTFRenderPipelineBuilder), so actors of the same fixture can use different options
+USTRUCT(BlueprintType)
+struct CLAYPAKYGDTFIMPORTER_API FCPGDTFBeamKernelOptions {
+
+	GENERATED_BODY()
+
+	/// Steps distributed quadratically along the ray, denser near the lens where the beam is brighter
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bAdaptiveSteps = false;
+
+	/// Stops the raymarch when the scene depth clips it or when the remaining steps can't add more than 1% of the accumulated light
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bEarlyTermination = false;
+
+	/// Computes the wheels UV scale/offset and the blades rotation once, outside the raymarch loop
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bHoistInvariants = false;
+
+	/// Replaces the pow(x, 0.66) remap of every wheel, blade and iris sample with sqrt(x) * (0.717 + 0.283 * x) (max error 0.027) and computes the sCurve of the blade/iris edges without pow (same result)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bFastPow = false;
+
+	/// Half the steps, jittered per pixel and per frame with an interleaved gradient noise. Needs temporal AA/TSR to accumulate the frames
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bJitteredLowSteps = false;
+
+	/// Samples the color and gobo wheels from their texture arrays (one slice per slot, created with the 'Create Wheel Texture Arrays' import option): no filtering bleed between slots. Ignored, with a warning, if the fixture has been imported without that option
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bWheelTextureArrays = false;
+
+	/// Frosts the gobo wheels by sampling a mip level, chosen from the frost value, of their frost chain texture instead of the frosted one. Ignored, with a warning, if the fixture has been imported with 'Wheel Frost Levels' = 0, always on if it has been imported with 'Wheel Frost Levels' > 0 (there are no frosted textures)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Beam Kernel")
+		bool bFrostMipChain = false;
+
+	uint8 GetFlags() const {
+		return (this->bAdaptiveSteps ? ECPGDTFBeamKernelFlags::AdaptiveSteps : 0)
+			| (this->bEarlyTermination ? ECPGDTFBeamKernelFlags::EarlyTermination : 0)
+			| (this->bHoistInvariants ? ECPGDTFBeamKernelFlags::HoistInvariants : 0)
+			| (this->bFastPow ? ECPGDTFBeamKernelFlags::FastPow : 0)
+			| (this->bJitteredLowSteps ? ECPGDTFBeamKernelFlags::JitteredLowSteps : 0)
+			| (this->bWheelTextureArrays ? ECPGDTFBeamKernelFlags::WheelTextureArrays : 0)
+			| (this->bFrostMipChain ? ECPGDTFBeamKernelFlags::FrostMipChain : 0);
+	}
+};
+
 /** Helper Object who contains a complete light output tree */
 
 /// \cond NOT_DOXYGEN
@@ -50,6 +134,9 @@ class CLAYPAKYGDTFIMPORTER_API UCPGDTFBeamSceneComponent : public USceneComponen
 protected:
 
 	//~ Begin UActorComponent Interface
+	/// Both invalidate the tick schedule of the parent fixture actor, which keeps a pointer to this beam
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 	#if WITH_EDITOR
 		virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 	#endif
@@ -57,11 +144,54 @@ protected:
 
 	void UpdateProperties();
 
+	/// Staged parameters of the dynamic materials
+	FCPGDTFBeamParameterBlock MaterialParameters;
+
+	/// Lights mode applied in BeginPlay, taken from the owning fixture actor
+	ECPGDTFBeamLightMode LightMode = ECPGDTFBeamLightMode::RGBSpotlights;
+
+	/// Hides and unregisters the lights not used by the current LightMode
+	void ApplyLightMode();
+
+	/// Inputs of the light visibility, as staged by the DMX components
+	float VisibilityDimmer = 1.0f;
+	float VisibilityShutterOpen = 1.0f;
+	FLinearColor VisibilityColor = FLinearColor(1, 1, 1, 1);
+	/// True if one of the visibility inputs changed since the last UpdateLightVisibility()
+	bool bLightVisibilityDirty = true;
+	/// True if the beam is lit by dimmer, shutter and color
+	bool bLightVisible = true;
+
+	/// Level of detail and lights allowed by UCPGDTFBeamLODSubsystem
+	ECPGDTFBeamLOD LOD = ECPGDTFBeamLOD::Full;
+	bool bLODSpotlights = true;
+	bool bLODPointLight = true;
+	bool bLODBeamMesh = true;
+	/// Visibility currently applied to the spotlights, the pointlight and the beam mesh
+	bool bAppliedSpotlightsVisible = true;
+	bool bAppliedPointLightVisible = true;
+	bool bAppliedBeamMeshVisible = true;
+
+	/// Quality set by SetBeamQuality(), before the LOD scaling
+	float BaseBeamQuality = 1.0f;
+	/// Writes the "DMX Quality Level" given by BaseBeamQuality and LOD
+	void ApplyBeamQuality();
+
+	/**
+	 * Shows or hides the lights and the beam mesh from the visibility inputs and the LOD. SetVisibility() is called only on transitions
+	 *
+	 * @param bForce If true the visibility is applied even if it didn't change
+	 */
+	void UpdateLightVisibility(bool bForce = false);
+
 public:	
 
 	/// Sets default values for this component's properties
 	UCPGDTFBeamSceneComponent();
 
+	/// Keeps alive the textures staged in MaterialParameters, which isn't reflected
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 	/// Called when the game starts or when spawned
 	void BeginPlay();
 	/// Called during Actor spawn to a specific world
@@ -80,6 +210,14 @@ public:
 	*/
 	bool PreConstruct(UCPGDTFDescriptionGeometryBeam* BeamDescription, FCPGDTFDescriptionModel* Model, FString FixturePathOnContentBrowser, UCPGDTFDescription* gdtfDescription, TArray<UActorComponent*> components, int selectedMode);
 
+	/**
+	 * Points the beam, lens and spotlights to the material instances of an already built pipeline. Used when the kernel options of the actor change. <br>
+	 * The dynamic materials are created again from the new instances on BeginPlay
+	 *
+	 * @param PipelineBuilder Builder of the pipeline
+	 */
+	void SetPipelineMaterialInstances(CPGDTFRenderPipelineBuilder& PipelineBuilder);
+
 	/*********************************
 	 *        BP Accessible          *
 	 *********************************/
@@ -130,17 +268,30 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DMX Light Fixture Beam Components")
 		void ResetLightColorTemp() { this->SetLightColorTemp(this->DefaultLightColorTemp); };
 
+	/// Applies again the visibility computed from the last dimmer, shutter and color values. Not needed during the simulation, visibility follows these values by itself
 	UFUNCTION(BlueprintCallable, Category = "DMX Light Fixture Beam Components")
 		void ToggleLightVisibility();
 
+	/// Dimmer value used to compute the light visibility. Set by the dimmer component
+	void SetVisibilityDimmer(float Dimmer);
+	/// Shutter opening used to compute the light visibility. Set by the shutter component
+	void SetVisibilityShutterOpen(float ShutterOpen);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "DMX Light Fixture Beam Components")
 		FTransform PreviousHeadTransform;
 
 	UFUNCTION(BlueprintCallable, Category = "DMX Light Fixture Beam Components")
 		bool IsMoving();
 
-	UFUNCTION(BlueprintCallable, Category = "DMX Light Fixture Beam Components")
-		void CheckOcclusion();
+	/**
+	 * Sets the length of the beam from the result of an occlusion trace
+	 *
+	 * @param HitDistance Distance of the obstacle from the beam origin, negative if the beam isn't occluded
+	 */
+	void SetOcclusionDistance(float HitDistance);
+
+	/// True if the lights are visible, i.e. the beam isn't blacked out by dimmer, shutter or color
+	FORCEINLINE bool IsLightVisible() const { return this->bLightVisible; }
 
 	/*********************************
 	 *             Beam              *
@@ -155,9 +306,26 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "DMX Light Fixture Beam Components")
 		class UMaterialInstanceDynamic* DynamicMaterialBeam;
 
+	/// Sets the raymarch quality of the beam. Smaller is better. The LOD may increase it
 	UFUNCTION(BlueprintCallable, Category = "DMX Light Fixture Beam Components")
 		void SetBeamQuality(float Quality);
 
+	/**
+	 * Sets the level of detail of the beam. Called by UCPGDTFBeamLODSubsystem
+	 *
+	 * @param NewLOD Raymarch level of detail
+	 * @param bSpotlights If false the spotlights are hidden
+	 * @param bPointLight If false the pointlight is hidden
+	 * @param bBeamMesh If false the volumetric beam is hidden, leaving only the lens
+	 */
+	void SetLOD(ECPGDTFBeamLOD NewLOD, bool bSpotlights, bool bPointLight, bool bBeamMesh);
+
+	UFUNCTION(BlueprintPure, Category = "DMX Light Fixture Beam Components")
+		ECPGDTFBeamLOD GetLOD() const { return this->LOD; }
+	FORCEINLINE bool GetLODSpotlights() const { return this->bLODSpotlights; }
+	FORCEINLINE bool GetLODPointLight() const { return this->bLODPointLight; }
+	FORCEINLINE bool GetLODBeamMesh() const { return this->bLODBeamMesh; }
+
 	/*********************************
 	 *           SpotLight           *
 	 *********************************/
@@ -179,6 +347,9 @@ public:
 		class UMaterialInstance* SpotLightMaterialInstanceG;
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "DMX Light Fixture Beam Components")
 		class UMaterialInstance* SpotLightMaterialInstanceB;
+	/// Light function used by ECPGDTFBeamLightMode::SingleSpotlight(Only). If not set SpotLightMaterialInstanceR is used with a white mask
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "DMX Light Fixture Beam Components")
+		class UMaterialInstance* SpotLightMaterialInstanceSingle;
 
 	UPROPERTY(BlueprintReadOnly, Category = "DMX Light Fixture Beam Components")
 		class UMaterialInstanceDynamic* DynamicMaterialSpotLight;; //Added for compatibility reasons
@@ -246,4 +417,20 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, Category = "DMX Light Fixture Beam Components")
 		class UMaterialInstanceDynamic* DynamicMaterialLens;
+
+	/*********************************
+	 *     Material parameters       *
+	 *********************************/
+
+	/// Parameters block of the dynamic materials of this beam. Values set here are written to the materials by FlushMaterialParameters()
+	FCPGDTFBeamParameterBlock& GetMaterialParameters();
+	/// Writes the staged material parameters. Called once per frame at the end of the fixture tick
+	void FlushMaterialParameters();
+
+	/// Lights mode used by this beam
+	FORCEINLINE ECPGDTFBeamLightMode GetLightMode() const { return this->LightMode; }
+	FORCEINLINE bool IsSingleSpotlight() const { return this->LightMode != ECPGDTFBeamLightMode::RGBSpotlights; }
+
+	/// Number of light components of this beam that are added to the scene
+	int32 GetActiveLightsNum() const;
 };
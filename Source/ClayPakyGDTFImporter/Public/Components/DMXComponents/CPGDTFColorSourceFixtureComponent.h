@@ -40,6 +40,14 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "DMX Channel")
 		ECPGDTFAttributeType ColorAttribute = ECPGDTFAttributeType::NoFeature;
 
+	/// Emitter of the first channel function using one, None if the channel doesn't reference any
+	UPROPERTY(BlueprintReadOnly, Category = "DMX Channel")
+		FName Emitter;
+
+	/// CIE XYZ of the emitter at full power, from its measured spectrum. Zero if unknown
+	UPROPERTY(BlueprintReadOnly, Category = "DMX Channel")
+		FVector3f EmitterXYZ = FVector3f::ZeroVector;
+
 	FCPDMXColorChannelData() {}
 
 	FCPDMXColorChannelData(FDMXImportGDTFDMXChannel Channel, ECPGDTFAttributeType ColorAttribute_);
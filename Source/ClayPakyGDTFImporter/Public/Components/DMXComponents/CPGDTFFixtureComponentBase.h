@@ -30,8 +30,11 @@ SOFTWARE.
 #include "CPGDTFInterpolation.h"
 #include "ClayPakyGDTFImporterLog.h"
 #include "Utils/CPGDTFDMXChannelTree.h"
+#include "Utils/CPGDTFDMXUniverseView.h"
 #include "CPGDTFFixtureComponentBase.generated.h"
 
+class UCPGDTFInterpolationSubsystem;
+
 #define DEFAULT_REAL_FADE 0.0001
 #define DEFAULT_REAL_ACCELERATION 0.00004
 
@@ -72,6 +75,7 @@ public:
 
 	FCPDMXChannelData(FDMXImportGDTFDMXChannel Channel) {
 		this->address = Channel.Offset.Num() > 0 ? FMath::Max(1, FMath::Min(512, Channel.Offset[0])) : -1;
+		for (int32 Offset : Channel.Offset) this->addresses.Add(FMath::Max(1, FMath::Min(512, Offset)));
 		this->DefaultValue = Channel.Default.Value;
 		updateMinMaxFadeAccelCalc(Channel);
 		finalizeMinMaxFadeAccelCalc();
@@ -143,6 +147,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Channels", meta=(ClampMin="0", ClampMax="512"))
 	int32 address = -1;
 
+	/// Addresses of all the bytes of the channel, most significant byte first. Empty if the channel wasn't built from a GDTF DMX channel
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX Channels")
+	TArray<int32> addresses;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Channel")
 	float interpolationFade = 0.0f;
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Channel")
@@ -160,6 +168,12 @@ public:
 	float DefaultValue = 0.0f;
 
 	inline bool IsAddressValid() { return this->address != -1; }
+
+	/// Addresses of the bytes of the channel, or only its first address if they're unknown
+	inline TArrayView<const int32> GetAddresses() const {
+		if (this->addresses.Num() > 0) return this->addresses;
+		return TArrayView<const int32>(&this->address, this->address != -1 ? 1 : 0);
+	}
 };
 
 /// Internally used by FAttributesData, it's not meant to be used elsewhere
@@ -236,7 +250,7 @@ public:
 			for (int i = 0; i < ch.LogicalChannels.Num(); i++) {
 				for (int j = 0; j < ch.LogicalChannels[i].ChannelFunctions.Num(); j++) {
 					FDMXImportGDTFChannelFunction cf = ch.LogicalChannels[i].ChannelFunctions[j];
-					ECPGDTFAttributeType attrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(cf.Attribute.Name.ToString());
+					ECPGDTFAttributeType attrType = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(cf.Attribute.Name);
 					FCPDMXChannelData* channelData = getChannelData(attrType);
 					channelData->updateMinMaxFadeAccelCalc(cf);
 				}
@@ -311,9 +325,15 @@ struct FCPComponentChannelData {
 	/// Last attribute type that this channel had. It's automatically updated by ApplyEffectToBeam
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Internal")
 	ECPGDTFAttributeType RunningEffectTypeChannel;
+	/// Index number of the last attribute that this channel had (eg. 1 for Blade1A). It's automatically updated by ApplyEffectToBeam
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Internal")
+	int32 RunningEffectIndexChannel = 0;
 
 	/// Last dmx value that this channel had
 	int32 lastDMXValue = -1;
+
+	/// Offsets of the bytes of this channel inside the patch (0 based, most significant first). Filled by compileChannelTrees
+	TArray<int32, TInlineAllocator<4>> universeOffsets;
 };
 
 //TODO Rewrite these, since they changed when I rewrote the interpolation
@@ -338,6 +358,7 @@ abstract class FixtureComponentBase{
 	+ class ACPGDTFFixtureActor* GetParentFixtureActor()
 	+ {virtual} void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap)
 	+ {virtual} void PushDMXRawValues(UDMXEntityFixturePatch* FixturePatch, const TMap<int32, int32>& RawValuesMap)
+	+ {virtual} void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView)
 	+ {virtual} {override} void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 	+ {virtual} void InterpolateComponent(float DeltaSeconds)
 	+ {virtual} const bool IsDMXInterpolationDone()
@@ -464,7 +485,7 @@ class AdditiveSourceFixtureComponent {
 
 	+ UCPGDTFAdditiveColorSourceFixtureComponent()
 	+ {virtual} {override} void Setup(TArray<FDMXImportGDTFDMXChannel> InputsAvailables)
-	+ {virtual} {override} void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap)
+	+ {virtual} {override} void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView)
 }
 
 class SubstractiveSourceFixtureComponent {
@@ -477,7 +498,7 @@ class SubstractiveSourceFixtureComponent {
 
 	+ UCPGDTFSubstractiveColorSourceFixtureComponent()
 	+ {virtual} {override} void Setup(TArray<FDMXImportGDTFDMXChannel> InputsAvailables)
-	+ {virtual} {override} void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap)
+	+ {virtual} {override} void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView)
 }
 
 class CIEColorSourceFixtureComponent {
@@ -487,7 +508,7 @@ class CIEColorSourceFixtureComponent {
 
 	+ UCPGDTFCIEColorSourceFixtureComponent()
 	+ {virtual} {override} void Setup(TArray<FDMXImportGDTFDMXChannel> InputsAvailables)
-	+ {virtual} {override} void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap)
+	+ {virtual} {override} void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView)
 }
 
 class HSVColorSourceFixtureComponent {
@@ -497,7 +518,7 @@ class HSVColorSourceFixtureComponent {
 
 	+ UCPGDTFHSVColorSourceFixtureComponent()
 	+ {virtual} {override} void Setup(TArray<FDMXImportGDTFDMXChannel> InputsAvailables)
-	+ {virtual} {override} void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap)
+	+ {virtual} {override} void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView)
 }
 
 class ColorWheelFixtureComponent {
@@ -637,9 +658,14 @@ protected:
 	/// Array of dmx channels info. Each channel is related to one "physical" input dmx channel of the light
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Internal")
 	TArray<FCPComponentChannelData> channels;
-	/// Array of interpolation objects. Each interpolation controls a "physical" feature of the light
-	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Internal")
-	TArray<FChannelInterpolation> interpolations;
+	/// Handles to the interpolation objects, stored in the world's FCPGDTFInterpolationEngine. Each interpolation controls a "physical" feature of the light
+	TArray<FCPGDTFInterpolationHandle> interpolations;
+	/// Engine where the interpolations are allocated, owned by the UCPGDTFInterpolationSubsystem of the world
+	FCPGDTFInterpolationEngine* InterpolationEngine = nullptr;
+	/// Owner of InterpolationEngine, to know if it's still alive when the component is destroyed
+	TWeakObjectPtr<UCPGDTFInterpolationSubsystem> InterpolationSubsystem;
+	/// Used instead of the world's engine when the world has no UCPGDTFInterpolationSubsystem (previews, commandlets)
+	TUniquePtr<FCPGDTFInterpolationEngine> OwnedInterpolationEngine;
 	/// Object containing the info about each attribute group
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Internal")
 	FAttributesData attributesData;
@@ -675,13 +701,24 @@ public:
 
 	UCPGDTFFixtureComponentBase();
 	void DestroyComponent(bool bPromoteChildren = false) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/// Invalidates the tick schedule of the parent fixture actor, which keeps a pointer to this component
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 private:
 	void lclDestroy() {
-		for (FChannelInterpolation& i : interpolations) i.destroyInterpolation();
+		// The handles must have been released by releaseInterpolations() before
+		interpolations.Empty();
+		InterpolationEngine = nullptr;
 		attributesData.destroy();
 	}
+	/// Releases the interpolations from the engine, if it's still alive, and forgets the engine
+	void releaseInterpolations();
+	/// Finds the engine where the interpolations are allocated, creating an own one if the world doesn't have any
+	FCPGDTFInterpolationEngine* findInterpolationEngine();
 public:
 	~UCPGDTFFixtureComponentBase() {
+		releaseInterpolations();
 		lclDestroy();
 	}
 
@@ -694,7 +731,7 @@ public:
 			TArray<UCPGDTFBeamSceneComponent*> bs = this->GetParentFixtureActor()->GeometryTree.GetBeamsUnderGeometry(geometryName);
 			for (UCPGDTFBeamSceneComponent* beam : bs) beams.Add(beam);
 			for (FDMXImportGDTFLogicalChannel lch : ch.GDTFDMXChannelDescription.LogicalChannels) {
-				ECPGDTFAttributeType type = CPGDTFDescription::GetGDTFAttributeTypeValueFromString(lch.Attribute.Name.ToString());
+				ECPGDTFAttributeType type = CPGDTFDescription::GetGDTFAttributeTypeValueFromName(lch.Attribute.Name);
 				USceneComponent** geometry = this->GetParentFixtureActor()->GeometryTree.Components.Find(geometryName);
 				if(geometry)
 					this->AttachedGeometries.Add(type, *geometry);
@@ -720,7 +757,7 @@ protected:
 	bool findWheelObject(FDMXImportGDTFWheel& dest);
 
 	/**
-	 * Sets the specified scalar/float parameter to all material instances attached to the beam
+	 * Sets the specified scalar/float parameter to all material instances attached to the beam. The value is staged and written at the end of the fixture tick
 	 * @author Luca Sorace - Clay Paky S.R.L.
 	 *
 	 * @param Beam Beam holding the material instances
@@ -827,6 +864,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DMX Component")
 	virtual void PushDMXRawValues(UDMXEntityFixturePatch* FixturePatch, const TMap<int32, int32>& RawValuesMap);
 
+	/**
+	 * Handles new DMX packets reading the bytes of our channels directly from the universe.
+	 * This is the path used by ACPGDTFFixtureActor, the view is built once per packet and shared by all the components of the fixture
+	 *
+	 * @param UniverseView Read-only view over the dmx universe of the fixture patch
+	 */
+	virtual void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView);
+
+	/**
+	 * Gets the bytes read by this component inside its fixture patch. Used by UCPGDTFDMXDispatcherSubsystem to wake up only the components whose bytes changed
+	 *
+	 * @param OutFirst First byte (0 based)
+	 * @param OutLast Last byte (0 based, included)
+	 * @returns False if the component doesn't read any byte
+	 */
+	bool GetUniverseByteRange(int32& OutFirst, int32& OutLast) const;
+
 protected:
 	/**
 	 * This is the function that's called each time we receive a DMX packet.
@@ -838,6 +892,11 @@ protected:
 	 * @param channel The channel where we have received the dmx value
 	 */
 	void ApplyEffectToBeam(int32 DMXValue, FCPComponentChannelData& channel);
+	/**
+	 * Builds the channel trees if needed and compiles them into their DMX lookup tables, so ApplyEffectToBeam doesn't have to walk them at runtime.
+	 * It also computes the offsets of the bytes of each channel read by PushDMXUniverseView
+	 */
+	void compileChannelTrees();
 
 	/*******************************************/
    /*          Interpolation Related          */
@@ -896,9 +955,31 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "DMX")
 	virtual void SetTargetValue(float value, int interpolationId);
 
+	/// Number of interpolations of this component. They aren't a UPROPERTY anymore, since they're stored inside the FCPGDTFInterpolationEngine
+	UFUNCTION(BlueprintPure, Category = "DMX")
+	int32 GetInterpolationsNum() const { return this->interpolations.Num(); }
+
+	/**
+	 * Returns the value the specified interpolation is currently sending to the light, without waking it up
+	 *
+	 * @param interpolationId id of the interpolation we're reading
+	 * @return The current value, or 0 if the interpolation doesn't exist
+	 */
+	UFUNCTION(BlueprintPure, Category = "DMX")
+	float GetInterpolationCurrentValue(int interpolationId) const;
+
+	/**
+	 * Returns the value the specified interpolation is moving to, without waking it up
+	 *
+	 * @param interpolationId id of the interpolation we're reading
+	 * @return The target value, or 0 if the interpolation doesn't exist
+	 */
+	UFUNCTION(BlueprintPure, Category = "DMX")
+	float GetInterpolationTargetValue(int interpolationId) const;
+
 	/**
-	 * Updates the specified interpolation, by making it travel, ending the interpolation if it is done and "sending" the updated values to the light.
-	 * It's called each tick by updateInterpolations()
+	 * "Sends" the current value of the specified interpolation to the light. The interpolation itself travels inside the FCPGDTFInterpolationEngine.
+	 * It's called each tick by InterpolateComponent()
 	 * @author Luca Sorace - Clay Paky S.R.L.
 	 * @date 02 february 2023
 	 *
@@ -982,6 +1063,21 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DMX")
 	void InterpolateComponent(float deltaSeconds);
 
+	/**
+	 * First half of InterpolateComponent(): updates the running effects of each channel, which may set new targets on the interpolations.
+	 * Used by the callers that advance the FCPGDTFInterpolationEngine by themselves between the two halves
+	 */
+	void InterpolateComponent_PrePass(float deltaSeconds);
+	/**
+	 * Second half of InterpolateComponent(): "sends" the current value of each interpolation to the light
+	 */
+	void InterpolateComponent_PostPass(float deltaSeconds);
+	/**
+	 * Advances only the interpolations of this component, if they haven't been advanced yet in this frame. To call between the two halves of InterpolateComponent()
+	 * when the rest of the world's FCPGDTFInterpolationEngine is not advanced at the same time
+	 */
+	void AdvanceInterpolations(float deltaSeconds);
+
 
 	/*
 	                ██████████████████
@@ -1004,9 +1100,10 @@ public:
 	- TArray<FCPComponentChannelData> channels: Since each light could have multiple channels to control a single feature (like gobo selector + a second channel to control the gobo rotation)
 		we store multiple FCPComponentChannelData. Each one contains information about that DMX channel, like its address, its description, its channel functions, etc.
 		This array is used widely inside the component: For each dmx packet we receive we have to handle again all of the dmx channels and each tick we have to update what the channels are doing
-	- TArray<FChannelInterpolation> interpolations: kinda unrelated to the channel concept, we have the interpolations. An interpolation is something that the light phisically moves irl. The pan?
+	- TArray<FCPGDTFInterpolationHandle> interpolations: kinda unrelated to the channel concept, we have the interpolations. An interpolation is something that the light phisically moves irl. The pan?
 		An interpolation. The gobo rotation? An interpolation. The gobo wheel rotation? Another interpolation! A component can have N channels and M interpolations, there's no relations between them.
 		Interpolation's targets are updated by the "user" each time we receive a dmx packet (ApplyEffectToBeam()) or at each tick (InterpolateComponent_BeamInternal()), and the value is updated automatically at each tick
+		The interpolation objects live in the world's FCPGDTFInterpolationEngine, which updates in a single pass only the ones that are still moving. Accessing an interpolation with -> wakes it up
 	- FAttributesData attributesData: A struct you can query to obtain the FCPDMXChannelData or the attribute group related to a single attribute. It can be used by the user in the BeginPlay phase to initialize the interpolations.
 		If no BeginPlay() method is reimplemented by the user, by default all of the attributesData found in the input channels are used to initialize the interpolations
 
@@ -1028,8 +1125,8 @@ public:
 
 	At this point, the component is running
 
-	- Each time we receive a DMX packet, ACPGDTFFixtureActor calls PushNormalizedRawValues on each component with the whole dmx universe. This function can be overridden by the user if they need directly the normalized value
-	- By default, PushNormalizedRawValues will call PushDMXRawValues
+	- Each time we receive a DMX packet, ACPGDTFFixtureActor builds a read-only view over the dmx universe and calls PushDMXUniverseView on each component. This function can be overridden by the user if they need directly the normalized value
+	- By default, PushDMXUniverseView reads the bytes of each channel from the view (PushNormalizedRawValues and PushDMXRawValues are still available from blueprints)
 	- Per each channel in the channels array, we obtain its dmx value from the universe and we call ApplyEffectToBeam(int32 DMXValue, FCPComponentChannelData& channel) with the value and the channel
 	- ApplyEffectToBeam(int32 DMXValue, FCPComponentChannelData& channel) will obtain the current dmx behaviour from the channel and value, parse the attribute type,
 	    and calc the physical value of the dmx behaviour. Later it will call the internal ApplyEffectToBeam, the one that the user MUST implement
@@ -1041,6 +1138,8 @@ public:
 	  - like ApplyEffectToBeam(), InterpolateComponent() will update, based on the channel's running effect, internal values to manage stuff like gobo shake, calling again settargetvalue on the interpolations, or setting values without interpolation on the component and/or on the interpolation object.
 		  This method could be omitted by the user, it's not mandatory to implement it if you don't need to update stuff at each tick
 	- After that, InterpolateComponent() will call updateInterpolation() on each interpolation in the interpolations array
+	- When the fixtures are ticked by UCPGDTFFixtureManagerSubsystem the two halves are called separately (InterpolateComponent_PrePass() and InterpolateComponent_PostPass()),
+	  and the interpolations of all the fixtures are advanced in between. Otherwise only the interpolations of the component are advanced in between (AdvanceInterpolations())
 
 	To "send" values to the light in the level, ApplyEffectToBeam(), updateInterpolations(), SetTargetValue() and InterpolateComponent_BeamInternal(), call SetValueNoInterp()
 	- SetValueNoInterp() calls, per each attached beam, SetValueNoInterp_BeamInternal()
@@ -54,6 +54,13 @@ protected:
 	UPROPERTY()
 	UTexture2D* WheelTextureFrosted;
 
+	/// Texture arrays of the disks, one slice per slot. Only imported with the 'Create Wheel Texture Arrays' option
+	UPROPERTY()
+	UTexture* WheelTextureArray;
+
+	UPROPERTY()
+	UTexture* WheelTextureFrostedArray;
+
 	UPROPERTY()
 	TArray<FLinearColor> WheelColors;
 
@@ -54,6 +54,16 @@ protected:
 	UTexture2D* WheelTexture;
 	UPROPERTY()
 	UTexture2D* WheelTextureFrosted;
+	/// Texture arrays of the disks, one slice per slot. Only imported with the 'Create Wheel Texture Arrays' option
+	UPROPERTY()
+	UTexture* WheelTextureArray;
+	UPROPERTY()
+	UTexture* WheelTextureFrostedArray;
+	/// Disk whose mips are stronger and stronger frosts of it, and its texture array. Only imported with 'Wheel Frost Levels' > 0
+	UPROPERTY()
+	UTexture* WheelTextureFrostChain;
+	UPROPERTY()
+	UTexture* WheelTextureFrostChainArray;
 
 	/// Number of gobos on the wheel
 	UPROPERTY()
@@ -89,6 +89,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DMX Channels")
 		FCPDMXColorChannelData DMXChannelUV; // ColorAdd_UV
 
+	/// True if every channel has a measured emitter, all with or all without luminous intensity: the LEDs are mixed with their spectra instead of the fixed colors of FCPColorWizard
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "DMX Channels")
+		bool bSpectralMixing = false;
+
+	/// Maximum RGB component of all the emitters at full power, to bring the spectral mix in range [0;1]
+	UPROPERTY()
+		float SpectralNormalization = 0;
+
 	UCPGDTFAdditiveColorSourceFixtureComponent();
 
 	/// The array is present for future support of more complex LED engines
@@ -98,6 +106,11 @@ public:
 	 /*               DMX Related               */
 	/*******************************************/
 
-	/// Pushes DMX Values to the Component. Expects normalized values in the range of 0.0f - 1.0f
-	virtual void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) override;
+	/// Reads the color channels directly from the DMX universe. Values are normalized in the range of 0.0f - 1.0f
+	virtual void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) override;
+
+private:
+
+	/// All the color channels, valid or not
+	TArray<FCPDMXColorChannelData*, TFixedAllocator<16>> GetColorChannels();
 };
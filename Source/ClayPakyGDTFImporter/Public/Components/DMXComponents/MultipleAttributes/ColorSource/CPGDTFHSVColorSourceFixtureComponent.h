@@ -57,8 +57,8 @@ public:
 	 /*               DMX Related               */
 	/*******************************************/
 
-	/// Pushes DMX Values to the Component. Expects normalized values in the range of 0.0f - 1.0f
-	virtual void PushNormalizedRawValues(UDMXEntityFixturePatch* FixturePatch, const FDMXNormalizedRawDMXValueMap& RawValuesMap) override;
+	/// Reads the color channels directly from the DMX universe. Values are normalized in the range of 0.0f - 1.0f
+	virtual void PushDMXUniverseView(const FCPDMXUniverseView& UniverseView) override;
 
 protected:
 	TArray<TSet<ECPGDTFAttributeType>> getAttributeGroups() override;
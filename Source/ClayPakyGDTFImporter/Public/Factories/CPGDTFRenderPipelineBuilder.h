@@ -33,6 +33,7 @@ SOFTWARE.
 #include "Materials/MaterialExpressionConstant.h"
 #include "Materials/MaterialExpressionOneMinus.h"
 #include "Materials/MaterialExpressionTransform.h"
+#include "Materials/MaterialExpressionTextureCoordinate.h"
 #include "Materials/MaterialExpressionFunctionOutput.h"
 #include "Materials/MaterialExpressionVectorParameter.h"
 #include "Materials/MaterialExpressionTextureSampleParameter2D.h"
@@ -119,6 +120,47 @@ private:
 	TArray<UCPGDTFShaperFixtureComponent *> shapers;
 	//If true it means that the fixture we're importing has an iris component
 	bool hasIris = false;
+	//Optimizations of the beam raymarch kernel (ECPGDTFBeamKernelFlags)
+	uint8 mKernelFlags = 0;
+	//HLSL code of the beam, generated once from the features above
+	FString mBeamHlslCode;
+	//Hash of the features of the pipeline. Fixtures/modes with the same hash share the same materials
+	FString mPipelineHash;
+	//Path where the materials shared between fixtures/modes with the same mPipelineHash are stored
+	FString mSharedPackagePath;
+
+	/**
+	 * Computes a hash of everything that shapes the generated materials: wheels, iris, shapers, the beam's HLSL code, the version of the expressions layout
+	 * and the saved hash of the master materials, so editing and saving one of them generates the shared materials again
+	 *
+	 * @return Hex string of the MD5 of the pipeline descriptor
+	*/
+	FString computePipelineHash();
+
+	/**
+	 * Generates the path of a master material cloned by cloneMaterialInterface
+	 *
+	 * @param materialType Beam|Lens|Light, with or without the leading '_'
+	 * @return Object path of the master material
+	*/
+	static FString getMasterMaterialPath(FString materialType);
+
+	/**
+	 * Loads the one slice texture array used as default value of the wheels texture arrays parameters, creating it from defaultTexture the first time
+	 *
+	 * @param defaultTexture Texture of the slice
+	 * @return The default texture array, or defaultTexture if the array can't be created
+	*/
+	UTexture* getDefaultWheelArrayTexture(UTexture2D* defaultTexture);
+
+	/**
+	 * Checks that the wheel textures needed by a kernel option have been created by the import
+	 *
+	 * @param fixturePath Path of the fixture in the content browser
+	 * @param frostChain If true checks the frost chains of the gobo wheels (in their array version with the WheelTextureArrays option), otherwise the texture arrays of the color and gobo wheels
+	 * @return True if every wheel has its texture
+	*/
+	bool areWheelTexturesImported(const FString& fixturePath, bool frostChain);
 
 	/**
 	 * Fully clones a Material Interface and its inner Material from CLAYPAKY_PLUGIN_CONTENT_BASEPATH/MaterialInstances/ to the fixture's Render lightRenderingPipeline folder
@@ -128,9 +170,10 @@ private:
 	 * @param materialType String with the name of the material (EG: in the material M_Beam_Master that string should be "Beam")
 	 * @param linkOutputFnc function to run to link outputs of the newly created material
 	 * @param middleCode function that should edit the newly created material, after it has been fully set up
+	 * @param dstMaterialType Name used for the newly created material and material instance, if different from materialType (EG: a variant of the same master material)
 	 * @return true if everything went well :)
 	*/
-	bool cloneMaterialInterface(FString materialType, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& linkOutputFnc, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode);
+	bool cloneMaterialInterface(FString materialType, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& linkOutputFnc, const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode, FString dstMaterialType = TEXT(""));
 
 	/**
 	 * Builds a new material function containing the rendering pipeline for the fixture we're importing
@@ -155,8 +198,10 @@ private:
 	 * Clones the Light's material instance and changes the rendering function material to the one we've previously created in buildMaterialInstancePipeline()
 	 * @author Luca Sorace - Clay Paky S.R.L.
 	 * @date 20 december 2022
+	 *
+	 * @param singleSpotlight if true builds the "LightSingle" variant used by ECPGDTFBeamLightMode::SingleSpotlight, with a white RGB mask
 	*/
-	bool linkSpotlightPipeline(const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode);
+	bool linkSpotlightPipeline(const std::function<bool(UMaterial*, UMaterialEditorOnlyData*, TArray<TObjectPtr<UMaterialExpression>>)>& middleCode, bool singleSpotlight = false);
 
 	/**
 	 * Searches a Material Expression by the given description and the given type
@@ -222,7 +267,7 @@ private:
 	 * @param defaultSamplerType Optional: The default sampler type of the texture. Default: Linear Color
 	 * @return The just added texture parameter
 	*/
-	UMaterialExpressionTextureObjectParameter* addTextureInputToBeamPipeline(UMaterial* beamMaterial, FString paramName, FString inputName, UMaterialExpressionCustom* meCustom, UTexture2D* defaultTexture, MeBlocksMover* mover = nullptr, EMaterialSamplerType defaultSamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor);
+	UMaterialExpressionTextureObjectParameter* addTextureInputToBeamPipeline(UMaterial* beamMaterial, FString paramName, FString inputName, UMaterialExpressionCustom* meCustom, UTexture* defaultTexture, MeBlocksMover* mover = nullptr, EMaterialSamplerType defaultSamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor);
 	/**
 	 * Adds a scalar parameter to the material instance pipeline, generating the parameter material with the input name
 	 * @author Luca Sorace - Clay Paky S.R.L.
@@ -248,6 +293,20 @@ private:
 	 * @return The just added scalar parameter
 	*/
 	UMaterialExpressionTextureObjectParameter* addTextureParameterToMiPipeline(UMaterialFunction* beamMaterial, FString paramName, UTexture2D* defaultTexture, MeBlocksMover* mover = nullptr, EMaterialSamplerType defaultSamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor);
+	/**
+	 * Adds a wheel sampling its frost chain to the material instance pipeline, in place of MF_DMXWheel and its frosted texture.
+	 * The sharp disk (mip 0) is blended by the frost value with the mips 1+, chosen like the beam does
+	 *
+	 * @param dstMaterial Material function of the pipeline
+	 * @param wheelType Wheel type
+	 * @param wheelNo number of wheel per wheelType (EG: Gobo0, Gobo1, Color0, etc)
+	 * @param previousParameter Previous node of the pipeline
+	 * @param frostParam Frost parameter of the pipeline
+	 * @param defaultTexture The default texture of the frost chain param
+	 * @param mover Automatically positions the new parameters
+	 * @return The custom expression sampling the wheel, next node of the pipeline
+	*/
+	UMaterialExpressionCustom* addFrostChainWheelToMiPipeline(UMaterialFunction* dstMaterial, FCPGDTFWheelImporter::WheelType wheelType, int wheelNo, UMaterialExpression* previousParameter, UMaterialExpression* frostParam, UTexture2D* defaultTexture, MeBlocksMover* mover);
 
 
 	/**
@@ -271,8 +330,9 @@ public:
 	 * @param selectedMode Index of the current active dmx mode/profile
 	 * @param components Components attached to this light
 	 * @param fixturePathOnContentBrowser base path of the fixture in the content brower
+	 * @param kernelOptions Optimizations of the beam raymarch kernel set on the fixture
 	*/
-	CPGDTFRenderPipelineBuilder(UCPGDTFDescription* gdtfDescription, int selectedMode, TArray<UActorComponent*> components, FString fixturePathOnContentBrowser);
+	CPGDTFRenderPipelineBuilder(UCPGDTFDescription* gdtfDescription, int selectedMode, TArray<UActorComponent*> components, FString fixturePathOnContentBrowser, FCPGDTFBeamKernelOptions kernelOptions = FCPGDTFBeamKernelOptions());
 	~CPGDTFRenderPipelineBuilder();
 
 	/**
@@ -297,15 +357,21 @@ public:
 	*/
 	FString getFileName(FString prepend, FString materialType, FString append, bool addPath);
 	/**
-	 * Generates the filename of a Material in the fixture's personal render pipeline builder folder
+	 * Generates the filename of a Material in the shared render pipeline folder of this pipeline hash
 	 * @author Luca Sorace - Clay Paky S.R.L.
 	 * @date 13 january 2023
 	 *
 	 * @param materialType Beam|Lens|Spotlight
-	 * @param addPath if true the full path to the fixture's personal render pipeline builder folder is prepended
+	 * @param addPath if true the full path to the shared render pipeline folder is prepended
 	 * @return The generated path/file name of the Material
 	*/
 	FString getMaterialFilename(FString materialType, bool addPath);
+	/**
+	 * Generates the filename of the Material Function containing the rendering pipeline, in the shared render pipeline folder
+	 *
+	 * @return The generated file name of the Material Function
+	*/
+	FString getRenderPipelineFunctionFilename();
 	/**
 	 * Generates the filename of a Material Interface in the fixture's personal render pipeline builder folder
 	 * @author Luca Sorace - Clay Paky S.R.L.
@@ -475,6 +541,29 @@ public:
 		FString ret = getDiskParamName(wheelType, frosted) + CPGDTFRenderPipelineBuilder::getParamNameFromId(wheelNo);
 		return ret;
 	}
+	/**
+	 * Generates the texture array parameter's name based on the wheel type and if the wheel is frosted or not and the wheel number. Used by the beams built with the WheelTextureArrays kernel option
+	 *
+	 * @param wheelType Wheel type
+	 * @param frosted true if the wheel is frosted
+	 * @param wheelNo number of wheel per wheelType (EG: Gobo0, Gobo1, Color0, etc)
+	 * @return The generated wheel texture array's name
+	*/
+	static inline FString getDiskArrayParamName(FCPGDTFWheelImporter::WheelType wheelType, bool frosted, int wheelNo) {
+		return getDiskParamName(wheelType, frosted, wheelNo) + TEXT(" Array");
+	}
+	/**
+	 * Generates the texture parameter's name of the frost chain of a wheel, sampled by the pipelines built with the FrostMipChain kernel option. <br>
+	 * The beam samples its mips 1+, the lens and the light functions blend its mip 0 with them by the frost value
+	 *
+	 * @param wheelType Wheel type
+	 * @param wheelNo number of wheel per wheelType (EG: Gobo0, Gobo1, Color0, etc)
+	 * @param array true for the texture array version, used with the WheelTextureArrays kernel option
+	 * @return The generated frost chain texture's name
+	*/
+	static inline FString getDiskFrostChainParamName(FCPGDTFWheelImporter::WheelType wheelType, int wheelNo, bool array) {
+		return getDiskParamName(wheelType, false) + TEXT(" Frost Chain") + CPGDTFRenderPipelineBuilder::getParamNameFromId(wheelNo) + (array ? TEXT(" Array") : TEXT(""));
+	}
 	/**
 	 * Generates the Scalar parameter wheel rotation's name based on the wheel type and the wheel number
 	 * @author Luca Sorace - Clay Paky S.R.L.
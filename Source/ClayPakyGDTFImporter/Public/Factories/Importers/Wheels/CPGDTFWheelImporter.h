@@ -25,7 +25,6 @@ SOFTWARE.
 #pragma once
 
 #include "CoreMinimal.h"
-#include "XMLFile.h"
 #include "Engine/Texture.h"
 #include "CPGDTFDescription.h"
 
@@ -44,8 +43,23 @@ private:
 	/** Path of the GDTF file on disk */
 	FString GDTFPath;
 
-	/** XML Description extracted from GDTF archive */
-	const FXmlFile* XMLFile;
+public:
+
+	/** Slot of a wheel with an image in the GDTF archive, read with the GDTF Description */
+	struct FWheelSlotMedia {
+		FString WheelName;
+		FString SlotName;
+		/** Name of the image in the wheels folder of the archive, without extension */
+		FString MediaFileName;
+	};
+
+private:
+
+	/** Slots to import */
+	TArray<FWheelSlotMedia> SlotsMedia;
+
+	/** Decoded pixels of each imported slot, already resized to the gobo size (BGRA8) */
+	TMap<const UTexture2D*, TArray<FColor>> DecodedSlots;
 
 public:
 
@@ -53,8 +67,10 @@ public:
 	 * Creates the Importer of GDTF textures (gobos, prisms, colors wheels ...)
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 06 may 2022
+	 *
+	 * @param SlotsMedia Slots with an image, read by the GDTF Description import
 	 */
-	FCPGDTFWheelImporter(UPackage* Package, FString GDTFPath, const FXmlFile* XMLFile);
+	FCPGDTFWheelImporter(UPackage* Package, FString GDTFPath, const TArray<FWheelSlotMedia>& SlotsMedia);
 
 	/**
 	 * Import the textures from a GDTF file
@@ -65,6 +81,11 @@ public:
 	 */
 	bool Import();
 
+	/**
+	 * Returns the pixels decoded during the Import, to be reused by CreateGDTFWheelsTextures
+	 */
+	inline const TMap<const UTexture2D*, TArray<FColor>>& GetDecodedSlots() const { return this->DecodedSlots; }
+
 	/**
 	 * Link the textures (Gobos, Colors... ) of a fixture to his GDTF Description
 	 * @author Dorian Gardes - Clay Paky S.R.L.
@@ -79,8 +100,11 @@ public:
 	 *
 	 * @param FixtureDescription GDTFDescription of the Fixture
 	 * @param FixturePackagePath Path of the fixture folder on Content Browser
+	 * @param DecodedSlots Pixels of the slots already decoded by the Import. Slots not in this map are read back from their texture.
+	 * @param bCreateTextureArrays If true each disk is also saved as a texture array, one slice per slot
+	 * @param FrostLevels If greater than 0 each gobo wheel gets a frost chain texture instead of its frosted texture, its mips being stronger and stronger frosts of the disk
 	 */
-	static void CreateGDTFWheelsTextures(UCPGDTFDescription* FixtureDescription, FString FixturePackagePath);
+	static void CreateGDTFWheelsTextures(UCPGDTFDescription* FixtureDescription, FString FixturePackagePath, const TMap<const UTexture2D*, TArray<FColor>>& DecodedSlots = TMap<const UTexture2D*, TArray<FColor>>(), bool bCreateTextureArrays = false, int32 FrostLevels = 0);
 
 	/**
 	 * Create an Array of Colors for the construction of the Color Wheel disk
@@ -92,6 +116,18 @@ public:
 	 */
 	static TArray<FLinearColor> GenerateColorArray(FDMXImportGDTFWheel Wheel);
 
+	/**
+	 * Generates the object path of a wheel texture created by CreateGDTFWheelsTextures
+	 *
+	 * @param FixturePackagePath Path of the fixture folder on Content Browser
+	 * @param WheelName Name of the wheel
+	 * @param bIsFrosted True for the frosted version
+	 * @param bIsArray True for the texture array version
+	 * @param bIsFrostChain True for the frost chain version
+	 * @return Object path of the texture (EG: /Game/MyFixture/textures/Gobo1/Wheel_Gobo1_Frosted.Wheel_Gobo1_Frosted)
+	 */
+	static FString GetWheelTexturePath(FString FixturePackagePath, FName WheelName, bool bIsFrosted, bool bIsArray, bool bIsFrostChain = false);
+
 	//DO NOT assign manual values to this enum
 	enum WheelType {
 		Color,
@@ -151,24 +187,63 @@ public:
 
 private:
 
+	/** Pixels of a wheel disk, built on a worker thread and saved on the game thread */
+	struct FWheelDisk {
+		/** Path of the texture on the content browser */
+		FString SavePath;
+		WheelType Type;
+		/** Gobos of the wheel (gobo wheels only) */
+		TArray<TArray<FColor>> Gobos;
+		/** Colors of the wheel (color wheels only) */
+		TArray<FLinearColor> Colors;
+		int32 SizeX = 0;
+		int32 SizeY = 0;
+		TArray<uint8> Pixels;
+		/** Empty when the disk has a frost chain */
+		TArray<uint8> FrostedPixels;
+		/** Number of frost levels of the frost chain. 0 to create the frosted texture instead */
+		int32 FrostLevels = 0;
+		/** Frosted mips of the disk, level 1 first */
+		TArray<TArray<uint8>> FrostMips;
+	};
+
 	/**
-	 * Import the GDTF textures related to a specific wheel if applicable
-	 * @author Dorian Gardes - Clay Paky S.R.L.
-	 * @date 06 may 2022
+	 * Decode a PNG image to BGRA8 pixels. Thread safe.
+	 *
+	 * @param ImageWrapperModule Image wrapper module, resolved on the game thread
+	 * @param Compressed PNG file content
+	 * @param OutPixels Decoded pixels
+	 * @param OutSizeX Width of the image
+	 * @param OutSizeY Height of the image
+	 * @return True if the image was decoded
+	 */
+	static bool DecodeSlotImage_Internal(class IImageWrapperModule& ImageWrapperModule, const TArray<uint8>& Compressed, TArray<FColor>& OutPixels, int32& OutSizeX, int32& OutSizeY);
+
+	/**
+	 * Read the pixels of a slot texture already on the Content Browser, from its source so the platform data doesn't need to be built. Must be called on the game thread.
 	 *
-	 * @param WheelXML XML Node representing the wheel
+	 * @param Texture Texture of the slot
+	 * @return Pixels of the gobo, resized to CP_GOBO_SIZE x CP_GOBO_SIZE, or an empty array if they can't be used
 	 */
-	bool ImportWheel(const FXmlNode* WheelXML);
+	static TArray<FColor> ReadSlotPixels_Internal(UTexture2D* Texture);
 
 	/**
-	 * Create a texture for a given array of SubTextures
+	 * Build the pixels of a wheel disk and its frosted version or frost mips. Thread safe.
+	 *
+	 * @param Disk Wheel disk to build
+	 */
+	static void BuildWheelDisk_Internal(FWheelDisk& Disk);
+
+	/**
+	 * Create the pixels of a wheel disk for a given array of gobos
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 12 july 2022
 	 *
-	 * @param SavePath		Path of the texture on the content browser
-	 * @param TexturesArray Array of textures used to build the wheel disk
+	 * @param Gobos Pixels of the gobos used to build the wheel disk
+	 * @param OutPixels Pixels of the wheel disk
+	 * @return Width of the wheel disk
 	 */
-	static void CreateGoboWheelTexture_Internal(FString SavePath, TArray<UTexture2D*> TexturesArray);
+	static int32 CreateGoboWheelPixels_Internal(const TArray<TArray<FColor>>& Gobos, TArray<uint8>& OutPixels);
 
 	/**
 	 * Frost the Gobo Wheel Texture
@@ -178,19 +253,21 @@ private:
 	 * @param PixelsArray Pixels to frost
 	 * @param SizeX Size of the Texture
 	 * @param SizeY Size of the Texture
+	 * @param SlotSizeX Size of each slot of the wheel. Slots are frosted independently
 	 * @param Strenght Strenght of the frost
 	 */
-	static void FrostWheelTexture_Internal(uint8* PixelsArray, int SizeX, int SizeY, float Strenght);
+	static void FrostWheelTexture_Internal(uint8* PixelsArray, int SizeX, int SizeY, int SlotSizeX, float Strenght);
 
 	/**
-	 * Create a texture for a given array of Colors
+	 * Create the pixels of a wheel disk for a given array of Colors
 	 * @author Dorian Gardes - Clay Paky S.R.L.
 	 * @date 06 july 2022
 	 *
-	 * @param SavePath		Path of the texture on the content browser
 	 * @param ColorsArray Array of colors used to build the wheel disk
+	 * @param OutPixels Pixels of the wheel disk
+	 * @return Width of the wheel disk
 	 */
-	static void CreateColorWheelTexture_Internal(FString SavePath, TArray<FLinearColor> ColorsArray);
+	static int32 CreateColorWheelPixels_Internal(const TArray<FLinearColor>& ColorsArray, TArray<uint8>& OutPixels);
 
 	/**
 	 * Create a texture for a given array of Pixels
@@ -202,6 +279,31 @@ private:
 	 * @param SizeX Size of the texture
 	 * @param SizeY Size of the texture
 	 * @param bIsFrosted
+	 * @param FrostMips Pixels of the following mips. If empty mips are generated by the engine, otherwise the texture is the frost chain of the disk
+	 */
+	static void SaveWheelToTexture_Internal(uint8* PixelsArray, FString SavePath, int SizeX, int SizeY, bool bIsFrosted = false, const TArray<TArray<uint8>>& FrostMips = TArray<TArray<uint8>>());
+
+	/**
+	 * Create a texture array for a given wheel strip, one slice per slot
+	 *
+	 * @param PixelsArray Pixels of the wheel strip
+	 * @param SavePath Path in the ContentBrowser
+	 * @param SizeX Size of the strip
+	 * @param SizeY Size of the strip
+	 * @param SlotSizeX Size of each slot of the strip
+	 * @param bIsFrosted
+	 * @param FrostMips Pixels of the following mips of the strip. If empty mips are generated by the engine, otherwise the texture is the frost chain of the disk
+	 */
+	static void SaveWheelToTextureArray_Internal(const uint8* PixelsArray, FString SavePath, int SizeX, int SizeY, int SlotSizeX, bool bIsFrosted = false, const TArray<TArray<uint8>>& FrostMips = TArray<TArray<uint8>>());
+
+	/**
+	 * Generates the asset name of a wheel texture
+	 *
+	 * @param SavePath Path of the wheel in the ContentBrowser. Its trailing '/' is removed
+	 * @param bIsFrosted True for the frosted version
+	 * @param bIsArray True for the texture array version
+	 * @param bIsFrostChain True for the frost chain version
+	 * @return Name of the asset: Wheel_{WheelName}[_Frosted|_FrostChain][_Array]
 	 */
-	static void SaveWheelToTexture_Internal(uint8* PixelsArray, FString SavePath, int SizeX, int SizeY, bool bIsFrosted = false);
+	static FString GetWheelAssetName_Internal(FString& SavePath, bool bIsFrosted, bool bIsArray, bool bIsFrostChain = false);
 };
@@ -0,0 +1,121 @@
+/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectPtr.h"
+
+class UMaterialInstanceDynamic;
+class UTexture;
+
+/**
+ * Material parameters of a beam, staged and written once per frame. <br>
+ * Each parameter is written only if its value changed since the last flush, only once per distinct material instance, and
+ * (for scalars and vectors) through the parameter index cached the first time it's written, so no search by name is done afterwards.
+ */
+struct CLAYPAKYGDTFIMPORTER_API FCPGDTFBeamParameterBlock {
+
+public:
+
+	/// Slots of the material instances of a beam. Used as bitmask to select where a parameter is written
+	enum EMaterialSlot : uint32 {
+		Beam = 1 << 0,
+		Lens = 1 << 1,
+		SpotLightR = 1 << 2,
+		SpotLightG = 1 << 3,
+		SpotLightB = 1 << 4,
+		PointLight = 1 << 5,
+		AllSlots = (1 << 6) - 1
+	};
+	static constexpr int32 SLOTS_NUM = 6;
+
+private:
+
+	enum class EParameterType : uint8 {
+		Scalar,
+		Vector,
+		Texture
+	};
+
+	struct FParameter {
+		FName Name;
+		EParameterType Type;
+		/// Slots this parameter is written to
+		uint32 SlotsMask;
+		bool bDirty = false;
+		bool bHasValue = false;
+		float Scalar = 0;
+		FLinearColor Vector = FLinearColor::Black;
+		/// Not reflected: reported to the garbage collector by AddReferencedObjects()
+		TObjectPtr<UTexture> Texture = nullptr;
+		/// Parameter index inside each distinct material, INDEX_NONE until the first write
+		int32 MaterialIndices[SLOTS_NUM];
+	};
+
+	/// Material instance bound to each slot, as given to Bind()
+	UMaterialInstanceDynamic* Slots[SLOTS_NUM] = { nullptr };
+	/// Distinct not-null material instances
+	TArray<UMaterialInstanceDynamic*, TInlineAllocator<SLOTS_NUM>> Materials;
+	/// Slots using each distinct material
+	TArray<uint32, TInlineAllocator<SLOTS_NUM>> MaterialsSlotsMask;
+
+	TArray<FParameter> Parameters;
+	/// Parameters indexed by name and type
+	TMap<TPair<FName, EParameterType>, int32> ParametersLookup;
+	/// Parameters changed since the last Flush()
+	TArray<int32> DirtyParameters;
+
+	FParameter& FindOrAddParameter(const FName& Name, EParameterType Type, uint32 SlotsMask);
+	void MarkDirty(int32 ParameterIndex);
+
+public:
+
+	/**
+	 * Binds the material instances of the beam, in EMaterialSlot order. Does nothing if they didn't change, otherwise all the cached indices are dropped and every known value is written again on the next flush
+	 */
+	void Bind(UMaterialInstanceDynamic* const (&NewSlots)[SLOTS_NUM]);
+
+	void SetScalar(const FName& Name, float Value, uint32 SlotsMask = AllSlots);
+	void SetVector(const FName& Name, const FLinearColor& Value, uint32 SlotsMask = AllSlots);
+	void SetTexture(const FName& Name, UTexture* Value, uint32 SlotsMask = AllSlots);
+
+	/// Reads the last value set on a scalar parameter, even if not flushed yet. Returns false if it has never been set
+	bool GetScalar(const FName& Name, float& OutValue) const;
+
+	/// Writes the changed parameters to the material instances
+	void Flush();
+
+	/// Reports the textures of the parameters to the garbage collector. Must be called by the AddReferencedObjects() of the owner
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	FORCEINLINE bool IsDirty() const { return this->DirtyParameters.Num() > 0; }
+
+	/// Parameter writes done by Flush() on any material instance since the start, for the CPGDTF.Beams.Benchmark console command. Game thread only
+	static uint64 GetTotalMaterialWrites() { return TotalMaterialWrites; }
+
+private:
+
+	static uint64 TotalMaterialWrites;
+};
@@ -37,6 +37,9 @@ protected:
 
 	FLinearColor Color;
 
+	/// Sum of the emitters added with AddEmitter()
+	FVector3f EmittersXYZ = FVector3f::ZeroVector;
+
 public:
 
 	/// Constructor. Set the default color to Black with no transparency.
@@ -206,6 +209,22 @@ public:
 	 */
 	void BlendColor(FLinearColor BlendingColor, float Intensity);
 
+	/**
+	 * Add the light of an emitter. Unlike the Blend methods the emitters are mixed linearly in the CIE XYZ space, like real LEDs
+	 *
+	 * @param XYZ CIE XYZ of the emitter at full power, see FCPGDTFEmitterSpectrum
+	 * @param Intensity Must be in range [0;1]
+	 */
+	void AddEmitter(const FVector3f& XYZ, float Intensity);
+
+	/**
+	 * Linear RGB color of the emitters added with AddEmitter()
+	 *
+	 * @param Normalization Divides the color, usually the maximum component of the color of all the emitters at full power
+	 * @return Color clamped in range [0;1]
+	 */
+	FLinearColor GetEmittersColor(float Normalization) const;
+
 	/**
 	 * Convert a HSV color representation to a RGB one
 	 * @author Dorian Gardes - Clay Paky S.R.L.
@@ -247,4 +266,21 @@ public:
 	 * @return Conversion result
 	 */
 	static FDMXColorCIE ColorRGBToCIE(FLinearColor RGB);
+
+	/**
+	 * Convert a CIE XYZ color to linear sRGB, without gamma nor clamping
+	 *
+	 * @param XYZ Color to convert
+	 * @return Conversion result, components may be negative or above 1 out of the sRGB gamut
+	 */
+	static FLinearColor ColorXYZToLinearRGB(const FVector3f& XYZ);
+
+	/**
+	 * Integrate a spectrum with the CIE 1931 2° color matching functions
+	 *
+	 * @param WaveLengths In nanometers, in increasing order
+	 * @param Energies Spectral energy at each wavelength
+	 * @return CIE XYZ of the spectrum
+	 */
+	static FVector3f SpectrumToXYZ(TArrayView<const float> WaveLengths, TArrayView<const float> Energies);
 };
\ No newline at end of file
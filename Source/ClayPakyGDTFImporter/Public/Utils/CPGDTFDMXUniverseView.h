@@ -0,0 +1,107 @@
+﻿/*
+MIT License
+
+Copyright (c) 2022 Clay Paky S.R.L.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDMXEntityFixturePatch;
+struct FDMXSignal;
+struct FDMXImportGDTFDMXChannel;
+
+/**
+ * Read-only view over the DMX universe of a fixture patch. <br>
+ * It's built once per DMX packet by the fixture actor and shared by all its components, so they can read their bytes directly
+ * without building a TMap of the channel values each.
+ */
+struct CLAYPAKYGDTFIMPORTER_API FCPDMXUniverseView {
+
+private:
+	/// Last signal received on the universe, keeps the viewed buffer alive
+	TSharedPtr<FDMXSignal, ESPMode::ThreadSafe> Signal;
+	/// Used only if no signal is available on the ports of the library
+	TArray<uint8> FallbackBuffer;
+
+public:
+	/// Bytes of the universe, index 0 is the first DMX channel
+	TArrayView<const uint8> Data;
+	/// Index in Data of the first channel of the fixture patch
+	int32 PatchOffset = 0;
+
+	FCPDMXUniverseView() {}
+
+	/**
+	 * Builds a view over the universe of a fixture patch
+	 *
+	 * @param FixturePatch Patch that received the DMX packet
+	 * @param DMXChannels DMX channels of the current mode of the fixture. Used to split the multi-byte values if no signal is available
+	 */
+	FCPDMXUniverseView(UDMXEntityFixturePatch* FixturePatch, TArrayView<const FDMXImportGDTFDMXChannel> DMXChannels);
+
+	// Data may point to FallbackBuffer, so the view can't be copied around
+	FCPDMXUniverseView(const FCPDMXUniverseView&) = delete;
+	FCPDMXUniverseView& operator=(const FCPDMXUniverseView&) = delete;
+
+	FORCEINLINE bool IsValid() const { return Data.Num() > 0; }
+
+	/// True if Data is the whole universe, false if it only contains the channels of the patch (PatchOffset is 0 in this case)
+	FORCEINLINE bool IsUniverseWide() const { return Signal.IsValid(); }
+
+	/**
+	 * Reads a DMX value stored on one or more bytes, most significant byte first
+	 *
+	 * @param ByteOffsets Offsets of the bytes, relative to the first channel of the patch (0 based)
+	 * @param OutValue The DMX value
+	 * @returns False if one of the bytes is outside of the universe
+	 */
+	FORCEINLINE bool GetValue(const TArrayView<const int32>& ByteOffsets, int32& OutValue) const {
+		OutValue = 0;
+		for (int32 ByteOffset : ByteOffsets) {
+			const int32 Index = this->PatchOffset + ByteOffset;
+			if (!this->Data.IsValidIndex(Index)) return false;
+			OutValue = (OutValue << 8) | this->Data[Index];
+		}
+		return ByteOffsets.Num() > 0;
+	}
+
+	/**
+	 * Reads a channel stored on one or more bytes in the 0.0f - 1.0f range
+	 *
+	 * @param Addresses DMX addresses of the bytes of the channel, relative to the patch (1 based), most significant byte first
+	 * @param OutValue The DMX value divided by 256^n - 1
+	 * @returns False if one of the bytes is outside of the universe
+	 */
+	FORCEINLINE bool GetNormalizedValue(const TArrayView<const int32>& Addresses, float& OutValue) const {
+		uint64 Value = 0, MaxValue = 0;
+		for (int32 Address : Addresses) {
+			const int32 Index = this->PatchOffset + Address - 1;
+			if (!this->Data.IsValidIndex(Index)) return false;
+			Value = (Value << 8) | this->Data[Index];
+			MaxValue = (MaxValue << 8) | 0xFF;
+		}
+		if (MaxValue == 0) return false;
+		OutValue = (float)((double)Value / (double)MaxValue);
+		return true;
+	}
+};